@@ -0,0 +1,389 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "chunked_map.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fov.h"
+#include "libtcod_int.h"
+#include "utility.h"
+
+/// One slot of the open addressing hash table of chunks.
+struct ChunkSlot {
+  TCOD_Map* chunk;  // NULL if this slot is empty.
+  int chunk_x;
+  int chunk_y;
+  uint64_t last_used;  // The clock of the last operation which used this chunk.
+};
+struct TCOD_ChunkedMap {
+  bool default_transparent;
+  bool default_walkable;
+  int capacity;  // The number of slots, zero or a power of two.
+  int count;  // The number of allocated chunks.
+  struct ChunkSlot* slots;
+  uint64_t clock;  // Incremented once per operation.
+  TCOD_ChunkFunc on_load;
+  TCOD_ChunkFunc on_evict;
+  void* userdata;
+  TCOD_Map* fov_window;  // The region which the last field-of-view was computed on, or NULL.
+  int fov_x;  // The position of fov_window on the chunked map.
+  int fov_y;
+};
+/**
+    Return the chunk index containing the cell index `n`, rounding towards negative infinity.
+ */
+static int chunk_of(int n) { return n >= 0 ? n / TCOD_CHUNK_SIZE : -1 - (-1 - n) / TCOD_CHUNK_SIZE; }
+/**
+    Return the preferred slot for a chunk.
+ */
+static int slot_hash(const TCOD_ChunkedMap* map, int chunk_x, int chunk_y) {
+  uint32_t hash = (uint32_t)chunk_x * 0x9E3779B1u ^ (uint32_t)chunk_y * 0x85EBCA77u;
+  hash ^= hash >> 15;
+  return (int)(hash & (uint32_t)(map->capacity - 1));
+}
+/**
+    Return the slot index of a chunk, or -1 if it is not allocated.
+ */
+static int find_slot(const TCOD_ChunkedMap* map, int chunk_x, int chunk_y) {
+  if (!map->capacity) {
+    return -1;
+  }
+  for (int i = slot_hash(map, chunk_x, chunk_y);; i = (i + 1) & (map->capacity - 1)) {
+    const struct ChunkSlot* slot = &map->slots[i];
+    if (!slot->chunk) {
+      return -1;
+    }
+    if (slot->chunk_x == chunk_x && slot->chunk_y == chunk_y) {
+      return i;
+    }
+  }
+}
+/**
+    Place `new_slot` into the first empty slot of its probe sequence.  The table must have room for it.
+ */
+static void insert_slot(TCOD_ChunkedMap* __restrict map, const struct ChunkSlot* __restrict new_slot) {
+  int i = slot_hash(map, new_slot->chunk_x, new_slot->chunk_y);
+  while (map->slots[i].chunk) {
+    i = (i + 1) & (map->capacity - 1);
+  }
+  map->slots[i] = *new_slot;
+}
+/**
+    Resize the hash table so that it can hold at least one more chunk.
+ */
+static TCOD_Error reserve_slot(TCOD_ChunkedMap* map) {
+  if ((map->count + 1) * 2 <= map->capacity) {
+    return TCOD_E_OK;
+  }
+  const int old_capacity = map->capacity;
+  struct ChunkSlot* old_slots = map->slots;
+  const int new_capacity = old_capacity ? old_capacity * 2 : 16;
+  struct ChunkSlot* new_slots = calloc(new_capacity, sizeof(*new_slots));
+  if (!new_slots) {
+    TCOD_set_errorv("Out of memory.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  map->slots = new_slots;
+  map->capacity = new_capacity;
+  for (int i = 0; i < old_capacity; ++i) {
+    if (old_slots[i].chunk) {
+      insert_slot(map, &old_slots[i]);
+    }
+  }
+  free(old_slots);
+  return TCOD_E_OK;
+}
+/**
+    Empty slot `index`, shifting back any later slots of the same probe sequence so that lookups still find them.
+ */
+static void remove_slot(TCOD_ChunkedMap* map, int index) {
+  const int mask = map->capacity - 1;
+  int hole = index;
+  for (int i = (index + 1) & mask; map->slots[i].chunk; i = (i + 1) & mask) {
+    const int home = slot_hash(map, map->slots[i].chunk_x, map->slots[i].chunk_y);
+    // Move this slot into the hole unless its home lies cyclically within (hole, i].
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      map->slots[hole] = map->slots[i];
+      hole = i;
+    }
+  }
+  memset(&map->slots[hole], 0, sizeof(map->slots[hole]));
+  --map->count;
+}
+TCOD_ChunkedMap* TCOD_chunked_map_new(bool default_transparent, bool default_walkable) {
+  TCOD_ChunkedMap* map = calloc(1, sizeof(*map));
+  if (!map) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  map->default_transparent = default_transparent;
+  map->default_walkable = default_walkable;
+  return map;
+}
+void TCOD_chunked_map_delete(TCOD_ChunkedMap* map) {
+  if (!map) {
+    return;
+  }
+  for (int i = 0; i < map->capacity; ++i) {
+    TCOD_map_delete(map->slots[i].chunk);
+  }
+  free(map->slots);
+  TCOD_map_delete(map->fov_window);
+  free(map);
+}
+void TCOD_chunked_map_set_callbacks(
+    TCOD_ChunkedMap* map, TCOD_ChunkFunc on_load, TCOD_ChunkFunc on_evict, void* userdata) {
+  if (!map) {
+    return;
+  }
+  map->on_load = on_load;
+  map->on_evict = on_evict;
+  map->userdata = userdata;
+}
+/**
+    Get the chunk at `{chunk_x, chunk_y}` and mark it as used by the current operation.
+
+    Missing chunks are allocated if `allocate` is true or if there is a load callback, otherwise `*out` is set to NULL.
+ */
+static TCOD_Error get_chunk(TCOD_ChunkedMap* __restrict map, int chunk_x, int chunk_y, bool allocate, TCOD_Map** out) {
+  const int index = find_slot(map, chunk_x, chunk_y);
+  if (index >= 0) {
+    map->slots[index].last_used = map->clock;
+    *out = map->slots[index].chunk;
+    return TCOD_E_OK;
+  }
+  *out = NULL;
+  if (!allocate && !map->on_load) {
+    return TCOD_E_OK;
+  }
+  TCOD_Error err = reserve_slot(map);
+  if (err < 0) {
+    return err;
+  }
+  struct ChunkSlot new_slot = {TCOD_map_new_bitpacked(TCOD_CHUNK_SIZE, TCOD_CHUNK_SIZE), chunk_x, chunk_y, map->clock};
+  if (!new_slot.chunk) {
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  TCOD_map_clear(new_slot.chunk, map->default_transparent, map->default_walkable);
+  if (map->on_load) {
+    map->on_load(new_slot.chunk, chunk_x, chunk_y, map->userdata);
+  }
+  insert_slot(map, &new_slot);
+  ++map->count;
+  *out = new_slot.chunk;
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_chunked_map_set_properties(TCOD_ChunkedMap* map, int x, int y, bool is_transparent, bool is_walkable) {
+  if (!map) {
+    TCOD_set_errorv("Map must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  ++map->clock;
+  const int chunk_x = chunk_of(x);
+  const int chunk_y = chunk_of(y);
+  TCOD_Map* chunk;
+  const TCOD_Error err = get_chunk(map, chunk_x, chunk_y, true, &chunk);
+  if (err < 0) {
+    return err;
+  }
+  TCOD_map_set_properties(
+      chunk, x - chunk_x * TCOD_CHUNK_SIZE, y - chunk_y * TCOD_CHUNK_SIZE, is_transparent, is_walkable);
+  return TCOD_E_OK;
+}
+bool TCOD_chunked_map_is_transparent(TCOD_ChunkedMap* map, int x, int y) {
+  if (!map) {
+    return false;
+  }
+  ++map->clock;
+  const int chunk_x = chunk_of(x);
+  const int chunk_y = chunk_of(y);
+  TCOD_Map* chunk;
+  if (get_chunk(map, chunk_x, chunk_y, false, &chunk) < 0 || !chunk) {
+    return map->default_transparent;
+  }
+  return TCOD_map_get_transparent_(chunk, x - chunk_x * TCOD_CHUNK_SIZE, y - chunk_y * TCOD_CHUNK_SIZE);
+}
+bool TCOD_chunked_map_is_walkable(TCOD_ChunkedMap* map, int x, int y) {
+  if (!map) {
+    return false;
+  }
+  ++map->clock;
+  const int chunk_x = chunk_of(x);
+  const int chunk_y = chunk_of(y);
+  TCOD_Map* chunk;
+  if (get_chunk(map, chunk_x, chunk_y, false, &chunk) < 0 || !chunk) {
+    return map->default_walkable;
+  }
+  return TCOD_map_get_walkable_(chunk, x - chunk_x * TCOD_CHUNK_SIZE, y - chunk_y * TCOD_CHUNK_SIZE);
+}
+/**
+    Assign the low `count` bits of `bits` to the bits `x` to `x + count - 1` of the bit-plane `row`.
+
+    `count` is at most 64, the bits can span two words of `row`.
+ */
+static void assign_bits(uint64_t* __restrict row, int x, uint64_t bits, int count) {
+  const uint64_t mask = count < 64 ? ((uint64_t)1 << count) - 1 : ~(uint64_t)0;
+  const int shift = x & 63;
+  uint64_t* word = &row[x >> 6];
+  bits &= mask;
+  word[0] = (word[0] & ~(mask << shift)) | (bits << shift);
+  if (shift + count > 64) {
+    word[1] = (word[1] & ~(mask >> (64 - shift))) | (bits >> (64 - shift));
+  }
+}
+/**
+    Copy a run of `count` cells of one chunk row into `dest` at `{dest_x, dest_y}`.
+
+    `transparent` and `walkable` hold the cells of the run in their low bits.
+    The version of `dest` is not changed.
+ */
+static void copy_run(
+    TCOD_Map* __restrict dest, int dest_x, int dest_y, uint64_t transparent, uint64_t walkable, int count) {
+  if (dest->transparent_bits) {
+    const ptrdiff_t row = (ptrdiff_t)dest_y * dest->bits_stride;
+    assign_bits(&dest->transparent_bits[row], dest_x, transparent, count);
+    assign_bits(&dest->walkable_bits[row], dest_x, walkable, count);
+    return;
+  }
+  struct TCOD_MapCell* __restrict cells = &dest->cells[dest_x + dest_y * dest->width];
+  for (int i = 0; i < count; ++i) {
+    cells[i].transparent = (transparent >> i) & 1;
+    cells[i].walkable = (walkable >> i) & 1;
+  }
+}
+/**
+    Copy a region of `map` into `dest` as part of the current operation.
+
+    Chunks are bit-packed and one word wide, so each row of a chunk is copied with a few shifts.
+    `dest` is cleared first, which also records the change to all of its cells at once.
+ */
+static TCOD_Error copy_region(TCOD_ChunkedMap* __restrict map, int x, int y, TCOD_Map* __restrict dest) {
+  TCOD_map_clear(dest, map->default_transparent, map->default_walkable);
+  for (int dest_y = 0; dest_y < dest->height; ++dest_y) {
+    const int chunk_y = chunk_of(y + dest_y);
+    const int local_y = y + dest_y - chunk_y * TCOD_CHUNK_SIZE;
+    // Visit the row one chunk at a time.
+    for (int dest_x = 0; dest_x < dest->width;) {
+      const int chunk_x = chunk_of(x + dest_x);
+      const int local_x = x + dest_x - chunk_x * TCOD_CHUNK_SIZE;
+      const int run = TCOD_MIN(TCOD_CHUNK_SIZE - local_x, dest->width - dest_x);
+      TCOD_Map* chunk;
+      const TCOD_Error err = get_chunk(map, chunk_x, chunk_y, false, &chunk);
+      if (err < 0) {
+        return err;
+      }
+      if (chunk) {
+        const ptrdiff_t index = TCOD_map_bits_index_(chunk, 0, local_y);
+        copy_run(
+            dest,
+            dest_x,
+            dest_y,
+            chunk->transparent_bits[index] >> local_x,
+            chunk->walkable_bits[index] >> local_x,
+            run);
+      }
+      dest_x += run;
+    }
+  }
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_chunked_map_copy_region(TCOD_ChunkedMap* __restrict map, int x, int y, TCOD_Map* __restrict dest) {
+  if (!map || !dest) {
+    TCOD_set_errorv("Maps must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  ++map->clock;
+  return copy_region(map, x, y, dest);
+}
+TCOD_Error TCOD_chunked_map_compute_fov(
+    TCOD_ChunkedMap* map, int pov_x, int pov_y, int max_radius, bool light_walls, TCOD_fov_algorithm_t algo) {
+  if (!map) {
+    TCOD_set_errorv("Map must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (max_radius <= 0) {
+    TCOD_set_errorvf("max_radius must be greater than zero on chunked maps, got %i.", max_radius);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  ++map->clock;
+  const int size = max_radius * 2 + 1;
+  if (map->fov_window && map->fov_window->width != size) {
+    TCOD_map_delete(map->fov_window);
+    map->fov_window = NULL;
+  }
+  if (!map->fov_window) {
+    map->fov_window = TCOD_map_new_bitpacked(size, size);
+    if (!map->fov_window) {
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+  }
+  map->fov_x = pov_x - max_radius;
+  map->fov_y = pov_y - max_radius;
+  const TCOD_Error err = copy_region(map, map->fov_x, map->fov_y, map->fov_window);
+  if (err < 0) {
+    TCOD_map_clear(map->fov_window, false, false);  // Don't leave a partial field-of-view.
+    return err;
+  }
+  return TCOD_map_compute_fov(map->fov_window, max_radius, max_radius, max_radius, light_walls, algo);
+}
+bool TCOD_chunked_map_is_in_fov(const TCOD_ChunkedMap* map, int x, int y) {
+  if (!map || !map->fov_window) {
+    return false;
+  }
+  const int local_x = x - map->fov_x;
+  const int local_y = y - map->fov_y;
+  return TCOD_map_in_bounds(map->fov_window, local_x, local_y) &&
+         TCOD_map_get_fov_(map->fov_window, local_x, local_y);
+}
+int TCOD_chunked_map_evict_idle(TCOD_ChunkedMap* map, int max_idle) {
+  if (!map) {
+    return 0;
+  }
+  int evicted = 0;
+  for (int i = 0; i < map->capacity;) {
+    struct ChunkSlot* slot = &map->slots[i];
+    if (!slot->chunk || map->clock - slot->last_used <= (uint64_t)TCOD_MAX(max_idle, 0)) {
+      ++i;
+      continue;
+    }
+    if (map->on_evict) {
+      map->on_evict(slot->chunk, slot->chunk_x, slot->chunk_y, map->userdata);
+    }
+    TCOD_map_delete(slot->chunk);
+    remove_slot(map, i);  // Another chunk may be shifted into this slot, so check it again.
+    ++evicted;
+  }
+  return evicted;
+}
+int TCOD_chunked_map_get_chunk_count(const TCOD_ChunkedMap* map) { return map ? map->count : 0; }
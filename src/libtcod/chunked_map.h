@@ -0,0 +1,188 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file chunked_map.h
+/// Sparse maps for very large or unbounded worlds.
+#pragma once
+#ifndef TCOD_CHUNKED_MAP_H_
+#define TCOD_CHUNKED_MAP_H_
+
+#include <stdbool.h>
+
+#include "config.h"
+#include "error.h"
+#include "fov_types.h"
+
+/// The width and height of each chunk of a TCOD_ChunkedMap.
+#define TCOD_CHUNK_SIZE 64
+/**
+    @brief A map which is split into chunks of TCOD_CHUNK_SIZE by TCOD_CHUNK_SIZE cells which are allocated on demand.
+
+    There are no bounds, any `int` coordinate including negative ones is valid.
+    Cells of chunks which have never been allocated have the default properties given to TCOD_chunked_map_new.
+
+    Field-of-view is computed with TCOD_chunked_map_compute_fov.
+
+    The A* and Dijkstra pathfinders are not chunk-aware.
+    They index a fixed width and height grid and keep per-cell state for all of it, so they can not search an
+    unbounded map.
+    Instead copy a bounded region, which may span any number of chunks, into a regular TCOD_Map with
+    TCOD_chunked_map_copy_region and run the pathfinder on that.
+    Paths leaving the copied region are not found, so pick a region with enough margin around the endpoints.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_ChunkedMap TCOD_ChunkedMap;
+/**
+    @brief A callback for chunks being loaded or evicted from a TCOD_ChunkedMap.
+
+    `chunk` is a bit-packed TCOD_Map of TCOD_CHUNK_SIZE by TCOD_CHUNK_SIZE cells.
+    The cell `{x, y}` of the chunk is the cell `{chunk_x * TCOD_CHUNK_SIZE + x, chunk_y * TCOD_CHUNK_SIZE + y}` of the
+    chunked map.
+
+    A load callback may fill `chunk` with TCOD_map_set_properties, it is already filled with the default properties.
+    An evict callback may save `chunk` before it is freed.
+    Callbacks must not call other functions on the chunked map.
+
+    @versionadded{Unreleased}
+ */
+typedef void (*TCOD_ChunkFunc)(TCOD_Map* chunk, int chunk_x, int chunk_y, void* userdata);
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup FOV
+/// @{
+/**
+    @brief Return a new chunked map with no chunks allocated.
+
+    `default_transparent` and `default_walkable` are the properties of cells in chunks which are not allocated.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_NODISCARD TCOD_ChunkedMap* TCOD_chunked_map_new(bool default_transparent, bool default_walkable);
+/**
+    @brief Delete a chunked map and all of its chunks.
+
+    The evict callback is not called.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_chunked_map_delete(TCOD_ChunkedMap* map);
+/**
+    @brief Set the callbacks used when chunks are loaded or evicted.
+
+    When `on_load` is set then reading a cell of an unallocated chunk loads that chunk,
+    otherwise chunks are only allocated when written to.
+    Either callback may be NULL.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_chunked_map_set_callbacks(
+    TCOD_ChunkedMap* map, TCOD_ChunkFunc on_load, TCOD_ChunkFunc on_evict, void* userdata);
+/**
+    @brief Change the properties of the cell at `{x, y}`, allocating its chunk if needed.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_chunked_map_set_properties(
+    TCOD_ChunkedMap* map, int x, int y, bool is_transparent, bool is_walkable);
+/**
+    @brief Return true if the cell at `{x, y}` is transparent.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_chunked_map_is_transparent(TCOD_ChunkedMap* map, int x, int y);
+/**
+    @brief Return true if the cell at `{x, y}` is walkable.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_chunked_map_is_walkable(TCOD_ChunkedMap* map, int x, int y);
+/**
+    @brief Copy the region of `map` starting at `{x, y}` into `dest`, the size of the region is the size of `dest`.
+
+    The fov attribute of `dest` is cleared.
+    Use this to run A*, Dijkstra, or any other algorithm taking a TCOD_Map over part of a chunked map.
+    A cell `{i, j}` of `dest` is the cell `{x + i, y + j}` of `map`.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_chunked_map_copy_region(
+    TCOD_ChunkedMap* __restrict map, int x, int y, TCOD_Map* __restrict dest);
+/**
+    @brief Calculate the field-of-view from `{pov_x, pov_y}`.
+
+    This takes the same parameters as TCOD_map_compute_fov except that `max_radius` must be greater than zero.
+    Check the results with TCOD_chunked_map_is_in_fov.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_chunked_map_compute_fov(
+    TCOD_ChunkedMap* map, int pov_x, int pov_y, int max_radius, bool light_walls, TCOD_fov_algorithm_t algo);
+/**
+    @brief Return true if the cell at `{x, y}` was in the last field-of-view computed on `map`.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_chunked_map_is_in_fov(const TCOD_ChunkedMap* map, int x, int y);
+/**
+    @brief Evict every chunk which has not been used in the last `max_idle` operations on `map`.
+
+    Reads, writes, region copies, and field-of-view each count as one operation and mark every chunk they touch as
+    used.  `max_idle` of zero evicts every chunk not used by the most recent operation.
+
+    The evict callback is called for each chunk before it is freed.
+    Without an evict callback changes to evicted chunks are lost.
+
+    Returns the number of chunks evicted.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_chunked_map_evict_idle(TCOD_ChunkedMap* map, int max_idle);
+/**
+    @brief Return the number of chunks currently allocated by `map`.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_chunked_map_get_chunk_count(const TCOD_ChunkedMap* map);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_CHUNKED_MAP_H_
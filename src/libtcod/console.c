@@ -31,10 +31,22 @@
  */
 #include "console.h"
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "libtcod_int.h"
 #include "utility.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BLIT_VEC_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BLIT_VEC_NEON 1
+#endif
 
 static TCOD_Error TCOD_console_data_alloc(struct TCOD_Console* console) {
   if (!console) {
@@ -98,6 +110,7 @@ void TCOD_console_delete(TCOD_Console* con) {
       console->on_delete(console);
     }
     TCOD_console_data_free(console);
+    free(console->row_versions);
     free(console);
   }
   if (console == TCOD_ctx.root) {
@@ -120,6 +133,82 @@ void TCOD_console_resize_(TCOD_Console* console, int width, int height) {
   console->h = height;
   console->elements = width * height;
   TCOD_console_data_alloc(console);
+  if (console->row_versions) {
+    free(console->row_versions);
+    console->row_versions = NULL;
+    TCOD_console_set_change_tracking(console, true);
+  }
+}
+/// The latest version given to a change of any console.
+static uint64_t console_version_counter = 0;
+/**
+    Return a version which was never given before, this is safe to call from multiple threads.
+ */
+static uint64_t next_console_version(void) {
+#if defined(_MSC_VER)
+  return (uint64_t)_InterlockedIncrement64((volatile __int64*)&console_version_counter);
+#elif defined(__GNUC__) || defined(__clang__)
+  return __atomic_add_fetch(&console_version_counter, 1, __ATOMIC_RELAXED);
+#else
+  return ++console_version_counter;
+#endif
+}
+void TCOD_console_stamp_rows_(TCOD_Console* console, int y, int height) {
+  const uint64_t version = next_console_version();
+  console->version = version;
+  for (int i = y; i < y + height; ++i) {
+    console->row_versions[i] = version;
+  }
+}
+TCOD_Error TCOD_console_set_change_tracking(TCOD_Console* con, bool enabled) {
+  con = TCOD_console_validate_(con);
+  if (!con) {
+    TCOD_set_errorv("Console must not be NULL or root console must exist.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!enabled) {
+    free(con->row_versions);
+    con->row_versions = NULL;
+    return TCOD_E_OK;
+  }
+  if (con->row_versions) {
+    return TCOD_E_OK;
+  }
+  con->row_versions = malloc(sizeof(*con->row_versions) * TCOD_MAX(con->h, 1));
+  if (!con->row_versions) {
+    TCOD_set_errorv("Out of memory.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  TCOD_console_stamp_rows_(con, 0, con->h);
+  return TCOD_E_OK;
+}
+void TCOD_console_mark_changed(TCOD_Console* con, int x, int y, int width, int height) {
+  con = TCOD_console_validate_(con);
+  if (!con || !con->row_versions) {
+    return;
+  }
+  if (TCOD_MAX(x, 0) >= TCOD_MIN(x + width, con->w)) {
+    return;
+  }
+  const int y_begin = TCOD_MAX(y, 0);
+  const int y_end = TCOD_MIN(y + height, con->h);
+  if (y_begin < y_end) {
+    TCOD_console_stamp_rows_(con, y_begin, y_end - y_begin);
+  }
+}
+uint64_t TCOD_console_get_version(const TCOD_Console* con, int x, int y, int width, int height) {
+  con = TCOD_console_validate_(con);
+  if (!con || !con->row_versions) {
+    return UINT64_MAX;
+  }
+  if (TCOD_MAX(x, 0) >= TCOD_MIN(x + width, con->w)) {
+    return 0;
+  }
+  uint64_t version = 0;
+  for (int i = TCOD_MAX(y, 0); i < TCOD_MIN(y + height, con->h); ++i) {
+    version = TCOD_MAX(version, con->row_versions[i]);
+  }
+  return version;
 }
 int TCOD_console_get_width(const TCOD_Console* con) {
   con = TCOD_console_validate_(con);
@@ -175,21 +264,16 @@ static struct TCOD_ColorRGBA TCOD_console_blit_lerp_(
 }
 /**
  *  Return the tile for a blit operation between src and dst.
+ *
+ *  The caller has already handled key colors and tiles which are copied without alpha.
  */
 static struct TCOD_ConsoleTile TCOD_console_blit_cell_(
     const struct TCOD_ConsoleTile* __restrict src,
     const struct TCOD_ConsoleTile* __restrict dst,
     float fg_alpha,
-    float bg_alpha,
-    const struct TCOD_ColorRGB* __restrict key_color) {
-  if (key_color && key_color->r == src->bg.r && key_color->g == src->bg.g && key_color->b == src->bg.b) {
-    return *dst;  // Source pixel is transparent.
-  }
+    float bg_alpha) {
   fg_alpha *= src->fg.a / 255.0f;
   bg_alpha *= src->bg.a / 255.0f;
-  if (fg_alpha > 254.5f / 255.0f && bg_alpha > 254.5f / 255.0f) {
-    return *src;  // No alpha. Perform a plain copy.
-  }
   struct TCOD_ConsoleTile out = *dst;
   out.bg = TCOD_console_blit_lerp_(out.bg, src->bg, bg_alpha);
   if (src->ch == ' ') {
@@ -212,6 +296,171 @@ static struct TCOD_ConsoleTile TCOD_console_blit_cell_(
   }
   return out;
 }
+/**
+ *  Blend `n` colors from `src` onto opaque `dst` colors using `src_a` as the alpha of each `src` color.
+ *
+ *  This matches TCOD_console_blit_lerp_ when `dst` is opaque, where `out_a` is always 255 and each channel simplifies
+ *  to `(src_c * src_a + dst_c * (255 - src_a)) / 255`.
+ *  These sums fit in 16-bit lanes and `(x + 1 + ((x + 1) >> 8)) >> 8` divides them by 255 exactly.
+ */
+static void blend_onto_opaque_(
+    int n,
+    const struct TCOD_ColorRGBA* __restrict dst,
+    const struct TCOD_ColorRGBA* __restrict src,
+    const uint8_t* __restrict src_a,
+    struct TCOD_ColorRGBA* __restrict out) {
+  int i = 0;
+#if defined(BLIT_VEC_SSE2)
+  // 4 colors at a time, each color is 4 lanes of 16-bit channels.
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i max = _mm_set1_epi16(255);
+  const __m128i opaque = _mm_set1_epi32((int)0xFF000000);  // The alpha channel, SSE2 is always little-endian.
+  for (; i + 4 <= n; i += 4) {
+    const __m128i dst_c = _mm_loadu_si128((const __m128i*)&dst[i]);
+    const __m128i src_c = _mm_loadu_si128((const __m128i*)&src[i]);
+    int32_t alphas_i32;
+    memcpy(&alphas_i32, &src_a[i], sizeof(alphas_i32));
+    __m128i alphas = _mm_cvtsi32_si128(alphas_i32);
+    alphas = _mm_unpacklo_epi8(alphas, alphas);
+    alphas = _mm_unpacklo_epi16(alphas, alphas);  // Each alpha repeated for all 4 channels of its color.
+    const __m128i alpha_lo = _mm_unpacklo_epi8(alphas, zero);
+    const __m128i alpha_hi = _mm_unpackhi_epi8(alphas, zero);
+    __m128i sum_lo = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(src_c, zero), alpha_lo),
+        _mm_mullo_epi16(_mm_unpacklo_epi8(dst_c, zero), _mm_sub_epi16(max, alpha_lo)));
+    __m128i sum_hi = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(src_c, zero), alpha_hi),
+        _mm_mullo_epi16(_mm_unpackhi_epi8(dst_c, zero), _mm_sub_epi16(max, alpha_hi)));
+    sum_lo = _mm_add_epi16(sum_lo, one);
+    sum_hi = _mm_add_epi16(sum_hi, one);
+    sum_lo = _mm_srli_epi16(_mm_add_epi16(sum_lo, _mm_srli_epi16(sum_lo, 8)), 8);
+    sum_hi = _mm_srli_epi16(_mm_add_epi16(sum_hi, _mm_srli_epi16(sum_hi, 8)), 8);
+    _mm_storeu_si128((__m128i*)&out[i], _mm_or_si128(_mm_packus_epi16(sum_lo, sum_hi), opaque));
+  }
+#elif defined(BLIT_VEC_NEON)
+  // 8 colors at a time, deinterleaved into one register per channel.
+  for (; i + 8 <= n; i += 8) {
+    const uint8x8x4_t dst_c = vld4_u8((const uint8_t*)&dst[i]);
+    const uint8x8x4_t src_c = vld4_u8((const uint8_t*)&src[i]);
+    const uint8x8_t alpha = vld1_u8(&src_a[i]);
+    const uint8x8_t inverse = vsub_u8(vdup_n_u8(255), alpha);
+    uint8x8x4_t result;
+    for (int channel = 0; channel < 3; ++channel) {
+      uint16x8_t sum = vmlal_u8(vmull_u8(src_c.val[channel], alpha), dst_c.val[channel], inverse);
+      sum = vaddq_u16(sum, vdupq_n_u16(1));
+      result.val[channel] = vshrn_n_u16(vaddq_u16(sum, vshrq_n_u16(sum, 8)), 8);
+    }
+    result.val[3] = vdup_n_u8(255);
+    vst4_u8((uint8_t*)&out[i], result);
+  }
+#endif
+  for (; i < n; ++i) {
+    const int alpha = src_a[i];
+    out[i] = (struct TCOD_ColorRGBA){
+        (uint8_t)((src[i].r * alpha + dst[i].r * (255 - alpha)) / 255),
+        (uint8_t)((src[i].g * alpha + dst[i].g * (255 - alpha)) / 255),
+        (uint8_t)((src[i].b * alpha + dst[i].b * (255 - alpha)) / 255),
+        255,
+    };
+  }
+}
+/**
+ *  Per-blit tables indexed by the alpha of a source color, these give the alpha each blend step uses.
+ *
+ *  They're filled with the same float expressions as TCOD_console_blit_cell_ so that results are identical.
+ */
+struct BlitAlphaTables {
+  bool initialized;
+  uint8_t bg[256];  // Background, and foreground of space glyphs.
+  uint8_t fg[256];  // Foreground when the glyph is kept.
+  uint8_t fg_mix[256];  // Foreground when the glyphs differ.
+  bool fg_mix_keeps_glyph[256];  // True when the glyphs differ and the destination glyph is kept.
+};
+static void blit_alpha_tables_init_(struct BlitAlphaTables* tables, float foreground_alpha, float background_alpha) {
+  for (int a = 0; a < 256; ++a) {
+    const float fg_alpha = foreground_alpha * (a / 255.0f);
+    const float bg_alpha = background_alpha * (a / 255.0f);
+    tables->bg[a] = (uint8_t)(a * bg_alpha);
+    tables->fg[a] = (uint8_t)(a * fg_alpha);
+    tables->fg_mix_keeps_glyph[a] = fg_alpha < 0.5f;
+    // When the glyph is kept the blend is against the new background, which is always opaque here.
+    tables->fg_mix[a] =
+        tables->fg_mix_keeps_glyph[a] ? (uint8_t)(255 * (fg_alpha * 2)) : (uint8_t)(a * ((fg_alpha - 0.5f) * 2));
+  }
+  tables->initialized = true;
+}
+/**
+ *  The most tiles TCOD_console_blit_opaque_chunk_ handles at once.
+ */
+#define BLIT_CHUNK_SIZE 64
+/**
+ *  Blend a chunk of `n` source tiles onto destination tiles whose colors are all opaque.
+ *
+ *  Only integer operations are used: alphas come from `tables`, and the background and foreground steps each run
+ *  through blend_onto_opaque_ for the whole chunk.
+ */
+static void TCOD_console_blit_opaque_chunk_(
+    int n,
+    const struct TCOD_ConsoleTile* const* __restrict src_tiles,
+    struct TCOD_ConsoleTile* const* __restrict dst_tiles,
+    const struct BlitAlphaTables* __restrict tables) {
+  struct TCOD_ColorRGBA base[BLIT_CHUNK_SIZE];
+  struct TCOD_ColorRGBA color[BLIT_CHUNK_SIZE];
+  uint8_t alpha[BLIT_CHUNK_SIZE];
+  struct TCOD_ColorRGBA bg[BLIT_CHUNK_SIZE];
+  struct TCOD_ColorRGBA fg[BLIT_CHUNK_SIZE];
+  for (int i = 0; i < n; ++i) {
+    base[i] = dst_tiles[i]->bg;
+    color[i] = src_tiles[i]->bg;
+    alpha[i] = tables->bg[src_tiles[i]->bg.a];
+  }
+  blend_onto_opaque_(n, base, color, alpha, bg);
+  for (int i = 0; i < n; ++i) {
+    const struct TCOD_ConsoleTile* src = src_tiles[i];
+    struct TCOD_ConsoleTile* dst = dst_tiles[i];
+    base[i] = dst->fg;
+    color[i] = src->fg;
+    if (src->ch == ' ') {
+      // Source is space, so keep the current glyph.
+      color[i] = src->bg;
+      alpha[i] = tables->bg[src->bg.a];
+    } else if (dst->ch == ' ') {
+      // Destination is space, so use the glyph from source.
+      dst->ch = src->ch;
+      base[i] = bg[i];
+      alpha[i] = tables->fg[src->fg.a];
+    } else if (dst->ch == src->ch) {
+      alpha[i] = tables->fg[src->fg.a];
+    } else {
+      // Pick the glyph based on foreground_alpha.
+      alpha[i] = tables->fg_mix[src->fg.a];
+      if (tables->fg_mix_keeps_glyph[src->fg.a]) {
+        color[i] = bg[i];
+      } else {
+        dst->ch = src->ch;
+        base[i] = bg[i];
+      }
+    }
+  }
+  blend_onto_opaque_(n, base, color, alpha, fg);
+  for (int i = 0; i < n; ++i) {
+    dst_tiles[i]->bg = bg[i];
+    dst_tiles[i]->fg = fg[i];
+  }
+}
+/**
+ *  Return the lowest color alpha where `alpha * color_alpha / 255` is treated as fully opaque, or 256 if none are.
+ *
+ *  Tiles with both colors at or above these thresholds are copied instead of blended.
+ */
+static int blit_opaque_threshold_(float alpha) {
+  int color_alpha = 256;
+  while (color_alpha > 0 && alpha * ((color_alpha - 1) / 255.0f) > 254.5f / 255.0f) {
+    --color_alpha;
+  }
+  return color_alpha;
+}
 void TCOD_console_blit_key_color(
     const TCOD_Console* __restrict src,
     int xSrc,
@@ -238,22 +487,70 @@ void TCOD_console_blit_key_color(
   if (wSrc <= 0 || hSrc <= 0) {
     return;
   }
-  if (xDst + wSrc < 0 || yDst + hSrc < 0 || xDst >= dst->w || yDst >= dst->h) {
+  // Clip the source rectangle to both consoles once, everything after this is in bounds.
+  const int x_begin = TCOD_MAX(xSrc, TCOD_MAX(0, xSrc - xDst));
+  const int x_end = TCOD_MIN(xSrc + wSrc, TCOD_MIN(src->w, xSrc - xDst + dst->w));
+  const int y_begin = TCOD_MAX(ySrc, TCOD_MAX(0, ySrc - yDst));
+  const int y_end = TCOD_MIN(ySrc + hSrc, TCOD_MIN(src->h, ySrc - yDst + dst->h));
+  if (x_begin >= x_end || y_begin >= y_end) {
     return;
   }
-  for (int cx = xSrc; cx < xSrc + wSrc; ++cx) {
-    for (int cy = ySrc; cy < ySrc + hSrc; ++cy) {
-      /* Check if we're outside the dest console. */
-      int dx = cx - xSrc + xDst;
-      int dy = cy - ySrc + yDst;
-      if (!TCOD_console_is_index_valid_(src, cx, cy)) {
-        continue;
+  TCOD_console_rows_changed_(dst, y_begin - ySrc + yDst, y_end - y_begin);
+  const int fg_opaque = blit_opaque_threshold_(foreground_alpha);
+  const int bg_opaque = blit_opaque_threshold_(background_alpha);
+  const int dx_offset = xDst - xSrc;
+  struct BlitAlphaTables tables;
+  tables.initialized = false;
+  const struct TCOD_ConsoleTile* chunk_src[BLIT_CHUNK_SIZE];
+  struct TCOD_ConsoleTile* chunk_dst[BLIT_CHUNK_SIZE];
+  for (int cy = y_begin; cy < y_end; ++cy) {
+    const struct TCOD_ConsoleTile* src_row = &src->tiles[cy * src->w];
+    struct TCOD_ConsoleTile* dst_row = &dst->tiles[(cy - ySrc + yDst) * dst->w];
+    int cx = x_begin;
+    while (cx < x_end) {
+      if (!key_color) {
+        // Copy runs of opaque tiles with a single memmove.
+        int run_end = cx;
+        while (run_end < x_end && src_row[run_end].fg.a >= fg_opaque && src_row[run_end].bg.a >= bg_opaque) {
+          ++run_end;
+        }
+        if (run_end > cx) {
+          // memmove since consoles blitted onto themselves have been tolerated in the past.
+          memmove(&dst_row[cx + dx_offset], &src_row[cx], sizeof(*src_row) * (run_end - cx));
+          cx = run_end;
+          continue;
+        }
+      }
+      // Collect tiles which need blending until the next run of opaque tiles.
+      int chunk_size = 0;
+      for (; cx < x_end && chunk_size < BLIT_CHUNK_SIZE; ++cx) {
+        const struct TCOD_ConsoleTile* src_tile = &src_row[cx];
+        struct TCOD_ConsoleTile* dst_tile = &dst_row[cx + dx_offset];
+        if (key_color && key_color->r == src_tile->bg.r && key_color->g == src_tile->bg.g &&
+            key_color->b == src_tile->bg.b) {
+          continue;  // Source pixel is transparent.
+        }
+        if (src_tile->fg.a >= fg_opaque && src_tile->bg.a >= bg_opaque) {
+          if (!key_color) {
+            break;  // Start a new run of opaque tiles.
+          }
+          *dst_tile = *src_tile;  // No alpha. Perform a plain copy.
+          continue;
+        }
+        if (dst_tile->fg.a != 255 || dst_tile->bg.a != 255) {
+          *dst_tile = TCOD_console_blit_cell_(src_tile, dst_tile, foreground_alpha, background_alpha);
+          continue;  // Translucent destinations are rare and use the general blend.
+        }
+        chunk_src[chunk_size] = src_tile;
+        chunk_dst[chunk_size] = dst_tile;
+        ++chunk_size;
       }
-      if (!TCOD_console_is_index_valid_(dst, dx, dy)) {
-        continue;
+      if (chunk_size) {
+        if (!tables.initialized) {
+          blit_alpha_tables_init_(&tables, foreground_alpha, background_alpha);
+        }
+        TCOD_console_blit_opaque_chunk_(chunk_size, chunk_src, chunk_dst, &tables);
       }
-      dst->tiles[dy * dst->w + dx] = TCOD_console_blit_cell_(
-          &src->tiles[cy * src->w + cx], &dst->tiles[dy * dst->w + dx], foreground_alpha, background_alpha, key_color);
     }
   }
 }
@@ -316,6 +613,7 @@ void TCOD_console_clear(TCOD_Console* con) {
   for (int i = 0; i < con->elements; ++i) {
     con->tiles[i] = fill;
   }
+  TCOD_console_rows_changed_(con, 0, con->h);
 }
 TCOD_color_t TCOD_console_get_char_background(const TCOD_Console* con, int x, int y) {
   con = TCOD_console_validate_(con);
@@ -331,6 +629,7 @@ void TCOD_console_set_char_foreground(TCOD_Console* con, int x, int y, TCOD_colo
   if (!TCOD_console_is_index_valid_(con, x, y)) {
     return;
   }
+  TCOD_console_rows_changed_(con, y, 1);
   struct TCOD_ColorRGBA* out = &con->tiles[y * con->w + x].fg;
   out->r = col.r;
   out->g = col.g;
@@ -400,6 +699,7 @@ void TCOD_console_set_char_background(TCOD_Console* con, int x, int y, TCOD_colo
   if (!TCOD_console_is_index_valid_(con, x, y)) {
     return;
   }
+  TCOD_console_rows_changed_(con, y, 1);
   struct TCOD_ColorRGBA* bg = &con->tiles[y * con->w + x].bg;
   if (flag == TCOD_BKGND_DEFAULT) {
     flag = con->bkgnd_flag;
@@ -466,6 +766,7 @@ void TCOD_console_set_char(TCOD_Console* con, int x, int y, int c) {
   if (!TCOD_console_is_index_valid_(con, x, y)) {
     return;
   }
+  TCOD_console_rows_changed_(con, y, 1);
   con->tiles[y * con->w + x].ch = c;
 }
 void TCOD_console_set_default_foreground(TCOD_Console* con, TCOD_color_t col) {
@@ -35,6 +35,7 @@
 #ifndef TCOD_CONSOLE_H_
 #define TCOD_CONSOLE_H_
 #include <stdbool.h>
+#include <stdint.h>
 #ifdef __cplusplus
 #include <algorithm>
 #include <array>
@@ -250,6 +251,20 @@ struct TCOD_Console {
   void* userdata;
   /** Internal use. */
   void (*on_delete)(struct TCOD_Console* self);
+  /**
+      @brief The version of the most recent change to this console, while change tracking is enabled.
+
+      See TCOD_console_set_change_tracking.
+
+      @versionadded{Unreleased}
+   */
+  uint64_t version;
+  /**
+      @brief The version of the most recent change to each row, or NULL if change tracking is disabled.
+
+      @versionadded{Unreleased}
+   */
+  uint64_t* row_versions;
 };
 typedef struct TCOD_Console TCOD_Console;
 typedef struct TCOD_Console* TCOD_console_t;
@@ -448,6 +463,42 @@ TCOD_PUBLIC TCOD_NODISCARD TCOD_color_t TCOD_console_get_char_foreground(const T
  *  \return The character code.
  */
 TCOD_PUBLIC TCOD_NODISCARD int TCOD_console_get_char(const TCOD_Console* con, int x, int y);
+/**
+    @brief Enable or disable tracking which rows of a console are changed.
+
+    While enabled, every row keeps the version of its most recent change.
+    This is updated by libtcod's functions which write to the console, such as TCOD_console_put_rgb,
+    TCOD_console_printn, TCOD_console_blit, and TCOD_console_clear.
+    Tiles written directly through the `tiles` array must be reported with TCOD_console_mark_changed.
+
+    Renderers use this to compare only the rows which changed since the last frame, instead of every tile.
+    Enabling tracking counts as a change to every row.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_console_set_change_tracking(TCOD_Console* con, bool enabled);
+/**
+    @brief Report that the tiles within `{x, y, width, height}` of a console were changed.
+
+    This does nothing if change tracking is disabled.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_console_mark_changed(TCOD_Console* con, int x, int y, int width, int height);
+/**
+    @brief Return the version of the most recent change to the tiles within `{x, y, width, height}`.
+
+    Changes are tracked per row, so a change to a tile in the same rows but outside of the rectangle is also reported.
+    Versions are shared by all consoles, so a version is never reused by any change to any console.
+
+    Returns `UINT64_MAX` if change tracking is disabled, since any tile might have changed.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_NODISCARD uint64_t
+TCOD_console_get_version(const TCOD_Console* con, int x, int y, int width, int height);
 void TCOD_console_resize_(TCOD_Console* console, int width, int height);
 /// @}
 #ifdef __cplusplus
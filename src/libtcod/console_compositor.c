@@ -0,0 +1,447 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "console_compositor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "console.h"
+#include "libtcod_int.h"
+#include "utility.h"
+
+/// The most dirty regions kept per layer, any more are merged into the existing ones.
+#define LAYER_DIRTY_MAX 8
+
+/// A region of a console.
+struct CompositorRect {
+  int x;
+  int y;
+  int width;
+  int height;
+};
+/// Where a layer is drawn and how it's blended.
+struct LayerPlacement {
+  bool visible;
+  int x;
+  int y;
+  int width;  // The size of the layer's console.
+  int height;
+  float foreground_alpha;
+  float background_alpha;
+  bool has_key_color;
+  TCOD_ColorRGB key_color;
+};
+struct Layer {
+  const TCOD_Console* console;
+  struct LayerPlacement placement;  // The placement for the next draw.
+  struct LayerPlacement drawn;  // The placement the output currently shows, not visible for new layers.
+  int dirty_count;
+  struct CompositorRect dirty[LAYER_DIRTY_MAX];  // Changed regions in the coordinates of the layer's console.
+  uint64_t seen_version;  // The console version of the last draw, for consoles which track their changes.
+};
+struct TCOD_Compositor {
+  int layers_count;
+  int layers_capacity;
+  struct Layer* layers;
+  const TCOD_Console* output;  // The output of the last draw.
+  int output_width;
+  int output_height;
+  bool invalidated;  // True if the whole output must be redrawn.
+  TCOD_ConsoleTile clear_tile;  // The tile dirty regions are cleared to, from the default colors of the output.
+  int* span_begin;  // The half-open dirty span of each output row, empty when begin >= end.
+  int* span_end;
+  int dirty_y_min;  // Half-open bounds of the rows with dirty spans, empty when min >= max.
+  int dirty_y_max;
+};
+TCOD_Compositor* TCOD_compositor_new(void) {
+  TCOD_Compositor* compositor = calloc(1, sizeof(*compositor));
+  if (!compositor) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  compositor->invalidated = true;
+  return compositor;
+}
+void TCOD_compositor_delete(TCOD_Compositor* compositor) {
+  if (!compositor) {
+    return;
+  }
+  free(compositor->layers);
+  free(compositor->span_begin);
+  free(compositor->span_end);
+  free(compositor);
+}
+/**
+    Return layer `layer` of `compositor`, or NULL.
+ */
+static struct Layer* get_layer(const TCOD_Compositor* compositor, int layer) {
+  if (!compositor || layer < 0 || layer >= compositor->layers_count) {
+    return NULL;
+  }
+  return &compositor->layers[layer];
+}
+/**
+    Set the blending parameters of a layer placement.
+ */
+static void set_placement(
+    struct LayerPlacement* placement,
+    int x,
+    int y,
+    float foreground_alpha,
+    float background_alpha,
+    const TCOD_ColorRGB* key_color) {
+  placement->x = x;
+  placement->y = y;
+  placement->foreground_alpha = foreground_alpha;
+  placement->background_alpha = background_alpha;
+  placement->has_key_color = key_color != NULL;
+  placement->key_color = key_color ? *key_color : (TCOD_ColorRGB){0, 0, 0};
+}
+int TCOD_compositor_add_layer(
+    TCOD_Compositor* compositor,
+    const TCOD_Console* console,
+    int x,
+    int y,
+    float foreground_alpha,
+    float background_alpha,
+    const TCOD_ColorRGB* key_color) {
+  if (!compositor) {
+    TCOD_set_errorv("Compositor must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!console) {
+    TCOD_set_errorv("Layer console must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (compositor->layers_count == compositor->layers_capacity) {
+    const int new_capacity = compositor->layers_capacity ? compositor->layers_capacity * 2 : 8;
+    struct Layer* new_layers = realloc(compositor->layers, sizeof(*new_layers) * new_capacity);
+    if (!new_layers) {
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+    compositor->layers = new_layers;
+    compositor->layers_capacity = new_capacity;
+  }
+  struct Layer* layer = &compositor->layers[compositor->layers_count];
+  memset(layer, 0, sizeof(*layer));
+  layer->console = console;
+  layer->placement.visible = true;
+  set_placement(&layer->placement, x, y, foreground_alpha, background_alpha, key_color);
+  return compositor->layers_count++;
+}
+TCOD_Error TCOD_compositor_set_layer(
+    TCOD_Compositor* compositor,
+    int layer_id,
+    int x,
+    int y,
+    float foreground_alpha,
+    float background_alpha,
+    const TCOD_ColorRGB* key_color) {
+  struct Layer* layer = get_layer(compositor, layer_id);
+  if (!layer) {
+    TCOD_set_errorvf("Layer %i does not exist.", layer_id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  set_placement(&layer->placement, x, y, foreground_alpha, background_alpha, key_color);
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_compositor_set_layer_visible(TCOD_Compositor* compositor, int layer_id, bool visible) {
+  struct Layer* layer = get_layer(compositor, layer_id);
+  if (!layer) {
+    TCOD_set_errorvf("Layer %i does not exist.", layer_id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  layer->placement.visible = visible;
+  return TCOD_E_OK;
+}
+/**
+    Return the area of the bounding box of `a` and `b`.
+ */
+static long long union_area(const struct CompositorRect* a, const struct CompositorRect* b) {
+  const int width = TCOD_MAX(a->x + a->width, b->x + b->width) - TCOD_MIN(a->x, b->x);
+  const int height = TCOD_MAX(a->y + a->height, b->y + b->height) - TCOD_MIN(a->y, b->y);
+  return (long long)width * height;
+}
+TCOD_Error TCOD_compositor_layer_changed(
+    TCOD_Compositor* compositor, int layer_id, int x, int y, int width, int height) {
+  struct Layer* layer = get_layer(compositor, layer_id);
+  if (!layer) {
+    TCOD_set_errorvf("Layer %i does not exist.", layer_id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (width == 0) {
+    width = layer->console->w - x;
+  }
+  if (height == 0) {
+    height = layer->console->h - y;
+  }
+  if (width <= 0 || height <= 0) {
+    return TCOD_E_OK;
+  }
+  struct CompositorRect rect = {x, y, width, height};
+  if (layer->dirty_count < LAYER_DIRTY_MAX) {
+    layer->dirty[layer->dirty_count++] = rect;
+    return TCOD_E_OK;
+  }
+  // Merge with the region which grows the least.
+  int best = 0;
+  long long best_growth = 0;
+  for (int i = 0; i < layer->dirty_count; ++i) {
+    const struct CompositorRect* dirty = &layer->dirty[i];
+    const long long growth = union_area(dirty, &rect) - (long long)dirty->width * dirty->height;
+    if (i == 0 || growth < best_growth) {
+      best = i;
+      best_growth = growth;
+    }
+  }
+  struct CompositorRect* merged = &layer->dirty[best];
+  const int x_max = TCOD_MAX(merged->x + merged->width, rect.x + rect.width);
+  const int y_max = TCOD_MAX(merged->y + merged->height, rect.y + rect.height);
+  merged->x = TCOD_MIN(merged->x, rect.x);
+  merged->y = TCOD_MIN(merged->y, rect.y);
+  merged->width = x_max - merged->x;
+  merged->height = y_max - merged->y;
+  return TCOD_E_OK;
+}
+void TCOD_compositor_invalidate(TCOD_Compositor* compositor) {
+  if (compositor) {
+    compositor->invalidated = true;
+  }
+}
+/**
+    Mark the region `{x, y, width, height}` of the output as needing to be redrawn.
+ */
+static void mark_output(TCOD_Compositor* compositor, int x, int y, int width, int height) {
+  const int x_min = TCOD_MAX(x, 0);
+  const int y_min = TCOD_MAX(y, 0);
+  const int x_max = TCOD_MIN(x + width, compositor->output_width);
+  const int y_max = TCOD_MIN(y + height, compositor->output_height);
+  if (x_min >= x_max || y_min >= y_max) {
+    return;
+  }
+  for (int j = y_min; j < y_max; ++j) {
+    compositor->span_begin[j] = TCOD_MIN(compositor->span_begin[j], x_min);
+    compositor->span_end[j] = TCOD_MAX(compositor->span_end[j], x_max);
+  }
+  if (compositor->dirty_y_min >= compositor->dirty_y_max) {
+    compositor->dirty_y_min = y_min;
+    compositor->dirty_y_max = y_max;
+    return;
+  }
+  compositor->dirty_y_min = TCOD_MIN(compositor->dirty_y_min, y_min);
+  compositor->dirty_y_max = TCOD_MAX(compositor->dirty_y_max, y_max);
+}
+/**
+    Return true if a layer with these placements would draw the same tiles.
+ */
+static bool placement_equal(const struct LayerPlacement* a, const struct LayerPlacement* b) {
+  if (!a->visible || !b->visible) {
+    return a->visible == b->visible;
+  }
+  return a->x == b->x && a->y == b->y && a->width == b->width && a->height == b->height &&
+         a->foreground_alpha == b->foreground_alpha && a->background_alpha == b->background_alpha &&
+         a->has_key_color == b->has_key_color &&
+         (!a->has_key_color ||
+          (a->key_color.r == b->key_color.r && a->key_color.g == b->key_color.g && a->key_color.b == b->key_color.b));
+}
+/**
+    Set `output` as the console to draw to, resetting the dirty spans if it has changed.
+ */
+static TCOD_Error set_output(TCOD_Compositor* compositor, const TCOD_Console* output) {
+  if (output == compositor->output && output->w == compositor->output_width && output->h == compositor->output_height) {
+    return TCOD_E_OK;
+  }
+  if (output->h != compositor->output_height || !compositor->span_begin) {
+    int* new_begin = realloc(compositor->span_begin, sizeof(*new_begin) * TCOD_MAX(output->h, 1));
+    if (new_begin) {
+      compositor->span_begin = new_begin;
+    }
+    int* new_end = realloc(compositor->span_end, sizeof(*new_end) * TCOD_MAX(output->h, 1));
+    if (new_end) {
+      compositor->span_end = new_end;
+    }
+    if (!new_begin || !new_end) {
+      compositor->output = NULL;
+      compositor->output_width = compositor->output_height = 0;
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+  }
+  compositor->output = output;
+  compositor->output_width = output->w;
+  compositor->output_height = output->h;
+  for (int j = 0; j < output->h; ++j) {
+    compositor->span_begin[j] = output->w;
+    compositor->span_end[j] = 0;
+  }
+  compositor->dirty_y_min = compositor->dirty_y_max = 0;
+  compositor->invalidated = true;
+  return TCOD_E_OK;
+}
+/**
+    Clear the region `{x, y, width, height}` of `output` and blit every visible layer onto it.
+ */
+static void redraw_region(
+    const TCOD_Compositor* __restrict compositor,
+    TCOD_Console* __restrict output,
+    int x,
+    int y,
+    int width,
+    int height) {
+  for (int j = y; j < y + height; ++j) {
+    TCOD_ConsoleTile* row = &output->tiles[j * output->w];
+    for (int i = x; i < x + width; ++i) {
+      row[i] = compositor->clear_tile;
+    }
+  }
+  TCOD_console_mark_changed(output, x, y, width, height);
+  for (int i = 0; i < compositor->layers_count; ++i) {
+    const struct Layer* layer = &compositor->layers[i];
+    const struct LayerPlacement* placement = &layer->placement;
+    if (!placement->visible) {
+      continue;
+    }
+    const int x_min = TCOD_MAX(x, placement->x);
+    const int y_min = TCOD_MAX(y, placement->y);
+    const int x_max = TCOD_MIN(x + width, placement->x + placement->width);
+    const int y_max = TCOD_MIN(y + height, placement->y + placement->height);
+    if (x_min >= x_max || y_min >= y_max) {
+      continue;
+    }
+    TCOD_console_blit_key_color(
+        layer->console,
+        x_min - placement->x,
+        y_min - placement->y,
+        x_max - x_min,
+        y_max - y_min,
+        output,
+        x_min,
+        y_min,
+        placement->foreground_alpha,
+        placement->background_alpha,
+        placement->has_key_color ? &placement->key_color : NULL);
+  }
+}
+int TCOD_compositor_draw(TCOD_Compositor* compositor, TCOD_Console* output) {
+  if (!compositor) {
+    TCOD_set_errorv("Compositor must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  output = TCOD_console_validate_(output);
+  if (!output) {
+    TCOD_set_errorv("Output console must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  for (int i = 0; i < compositor->layers_count; ++i) {
+    if (compositor->layers[i].console == output) {
+      TCOD_set_errorvf("Output console must not be the console of layer %i.", i);
+      return TCOD_E_INVALID_ARGUMENT;
+    }
+  }
+  TCOD_Error err = set_output(compositor, output);
+  if (err < 0) {
+    return err;
+  }
+  // Clear the same way as TCOD_console_clear, everything is redrawn when the default colors change.
+  const TCOD_ConsoleTile clear_tile = {
+      ' ',
+      {output->fore.r, output->fore.g, output->fore.b, 255},
+      {output->back.r, output->back.g, output->back.b, 255},
+  };
+  if (memcmp(&clear_tile, &compositor->clear_tile, sizeof(clear_tile)) != 0) {
+    compositor->clear_tile = clear_tile;
+    compositor->invalidated = true;
+  }
+  if (compositor->invalidated) {
+    mark_output(compositor, 0, 0, output->w, output->h);
+  }
+  // Convert the changes of each layer into dirty spans of the output.
+  for (int i = 0; i < compositor->layers_count; ++i) {
+    struct Layer* layer = &compositor->layers[i];
+    struct LayerPlacement* placement = &layer->placement;
+    placement->width = layer->console->w;
+    placement->height = layer->console->h;
+    if (!placement_equal(placement, &layer->drawn)) {
+      // The layer moved or blends differently, so redraw what it covered before and what it covers now.
+      if (layer->drawn.visible) {
+        mark_output(compositor, layer->drawn.x, layer->drawn.y, layer->drawn.width, layer->drawn.height);
+      }
+      if (placement->visible) {
+        mark_output(compositor, placement->x, placement->y, placement->width, placement->height);
+      }
+    } else if (placement->visible) {
+      for (int j = 0; j < layer->dirty_count; ++j) {
+        const struct CompositorRect* dirty = &layer->dirty[j];
+        const int x_min = TCOD_MAX(dirty->x, 0);
+        const int y_min = TCOD_MAX(dirty->y, 0);
+        const int x_max = TCOD_MIN(dirty->x + dirty->width, placement->width);
+        const int y_max = TCOD_MIN(dirty->y + dirty->height, placement->height);
+        mark_output(compositor, placement->x + x_min, placement->y + y_min, x_max - x_min, y_max - y_min);
+      }
+      if (layer->console->row_versions && layer->console->version != layer->seen_version) {
+        for (int j = 0; j < layer->console->h; ++j) {
+          if (layer->console->row_versions[j] > layer->seen_version) {
+            mark_output(compositor, placement->x, placement->y + j, placement->width, 1);
+          }
+        }
+      }
+    }
+    layer->seen_version = layer->console->version;
+    layer->drawn = *placement;
+    layer->dirty_count = 0;
+  }
+  // Redraw rows with identical spans together.
+  int redrawn = 0;
+  int y = compositor->dirty_y_min;
+  while (y < compositor->dirty_y_max) {
+    const int span_begin = compositor->span_begin[y];
+    const int span_end = compositor->span_end[y];
+    int y_end = y + 1;
+    while (y_end < compositor->dirty_y_max && compositor->span_begin[y_end] == span_begin &&
+           compositor->span_end[y_end] == span_end) {
+      ++y_end;
+    }
+    if (span_begin < span_end) {
+      redraw_region(compositor, output, span_begin, y, span_end - span_begin, y_end - y);
+      redrawn += (span_end - span_begin) * (y_end - y);
+    }
+    for (int j = y; j < y_end; ++j) {
+      compositor->span_begin[j] = output->w;
+      compositor->span_end[j] = 0;
+    }
+    y = y_end;
+  }
+  compositor->dirty_y_min = compositor->dirty_y_max = 0;
+  compositor->invalidated = false;
+  return redrawn;
+}
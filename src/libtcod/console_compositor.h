@@ -0,0 +1,165 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file console_compositor.h
+/// Compositing a stack of console layers, redrawing only what changed.
+#pragma once
+#ifndef TCOD_CONSOLE_COMPOSITOR_H_
+#define TCOD_CONSOLE_COMPOSITOR_H_
+
+#include <stdbool.h>
+
+#include "color.h"
+#include "config.h"
+#include "console_types.h"
+#include "error.h"
+
+/**
+    @brief An ordered stack of console layers which are blitted onto an output console.
+
+    Each layer has its own offset, alpha, and key color, which work the same as in TCOD_console_blit_key_color.
+    The compositor keeps the dirty regions of every layer and redraws only those regions of the output, so drawing a
+    frame where nothing changed does no work.
+
+    Changes to a layer's placement, alpha, key color, visibility, or console size are detected by the compositor.
+    Changes to the tiles of a layer's console must be reported with TCOD_compositor_layer_changed, unless that console
+    has change tracking enabled with TCOD_console_set_change_tracking, in which case its changed rows are found
+    automatically.
+
+    The compositor owns the output console it draws to: anything else written to the output will remain until that
+    region is redrawn, call TCOD_compositor_invalidate to redraw everything.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_Compositor TCOD_Compositor;
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup Console
+/// @{
+/**
+    @brief Return a new compositor with no layers.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_NODISCARD TCOD_Compositor* TCOD_compositor_new(void);
+/**
+    @brief Delete a compositor.  The consoles of its layers are not deleted.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_compositor_delete(TCOD_Compositor* compositor);
+/**
+    @brief Add `console` on top of the other layers, returning its layer id.
+
+    Layer ids count up from 0 at the bottom of the stack.
+    `console` is not copied and must outlive the compositor.
+
+    The whole console is drawn with its top-left corner at `{x, y}` of the output.
+    `foreground_alpha`, `background_alpha`, and `key_color` are the same as in TCOD_console_blit_key_color,
+    `key_color` can be NULL.
+
+    Returns a negative error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_compositor_add_layer(
+    TCOD_Compositor* compositor,
+    const TCOD_Console* console,
+    int x,
+    int y,
+    float foreground_alpha,
+    float background_alpha,
+    const TCOD_ColorRGB* key_color);
+/**
+    @brief Change the placement and blending of layer `layer`.
+
+    The regions of the output it covered before and after this change are redrawn by the next TCOD_compositor_draw.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_compositor_set_layer(
+    TCOD_Compositor* compositor,
+    int layer,
+    int x,
+    int y,
+    float foreground_alpha,
+    float background_alpha,
+    const TCOD_ColorRGB* key_color);
+/**
+    @brief Show or hide layer `layer`.  Layers are visible when added.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_compositor_set_layer_visible(TCOD_Compositor* compositor, int layer, bool visible);
+/**
+    @brief Report that the tiles within `{x, y, width, height}` of the console of layer `layer` were changed.
+
+    The region is in the coordinates of the layer's console.
+    A `width` or `height` of zero extends the region to the edge of the console, the same as TCOD_console_blit.
+
+    This is not needed for consoles with change tracking enabled, other than for tiles which were written directly.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_compositor_layer_changed(
+    TCOD_Compositor* compositor, int layer, int x, int y, int width, int height);
+/**
+    @brief Make the next TCOD_compositor_draw redraw the whole output.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_compositor_invalidate(TCOD_Compositor* compositor);
+/**
+    @brief Redraw the regions of `output` which changed since the last call.
+
+    Each region is cleared the same way as TCOD_console_clear, to a space with the default foreground and background
+    colors of `output`, then every visible layer is blitted onto it from the bottom of the stack to the top.
+    The result is the same as clearing all of `output` and blitting every layer.
+
+    Everything is redrawn the first time this is called, or when `output` is a different console, has been resized, or
+    has different default colors.
+
+    `output` must not be the console of one of the layers.
+
+    Returns the number of output tiles which were redrawn.
+    Returns a negative error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_compositor_draw(TCOD_Compositor* compositor, TCOD_Console* output);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_CONSOLE_COMPOSITOR_H_
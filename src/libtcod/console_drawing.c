@@ -68,6 +68,7 @@ void TCOD_console_put_rgb(
   if (!TCOD_console_is_index_valid_(console, x, y)) {
     return;
   }
+  TCOD_console_rows_changed_(console, y, 1);
   int console_index = y * console->w + x;
   if (ch > 0) {
     console->tiles[console_index].ch = ch;
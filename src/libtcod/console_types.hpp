@@ -125,6 +125,7 @@ class Console {
       *this = Console{{rhs.console_->w, rhs.console_->h}};
     }
     std::copy(rhs.console_->begin(), rhs.console_->end(), console_->begin());
+    TCOD_console_mark_changed(console_.get(), 0, 0, console_->w, console_->h);
     return *this;
   }
   /***************************************************************************
@@ -53,6 +53,24 @@ extern "C" {
     Return a new TCOD_Map with `width` and `height`.
  */
 TCOD_PUBLIC TCOD_Map* TCOD_map_new(int width, int height);
+/**
+    @brief Return a new bit-packed TCOD_Map with `width` and `height`.
+
+    The transparent, walkable, and fov attributes are each stored in their own bit-plane of 64-bit words instead of
+    the `cells` array, using 3 bits per cell instead of 3 bytes.
+    All other TCOD_map functions work the same on either layout.
+
+    Returns NULL on invalid sizes or if memory could not be allocated.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Map* TCOD_map_new_bitpacked(int width, int height);
+/**
+    @brief Return true if `map` stores its attributes in bit-planes instead of the `cells` array.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_map_is_bitpacked(const TCOD_Map* map);
 /**
     Set all cell values on `map` to the given parameters.
 
@@ -63,6 +81,7 @@ TCOD_PUBLIC void TCOD_map_clear(TCOD_Map* map, bool transparent, bool walkable);
     Clone map data from `source` to `dest`.
 
     `dest` will be resized to match `source` if necessary.
+    `dest` also takes on the storage layout of `source`.
  */
 TCOD_PUBLIC TCOD_Error TCOD_map_copy(const TCOD_Map* __restrict source, TCOD_Map* __restrict dest);
 /**
@@ -73,6 +92,20 @@ TCOD_PUBLIC void TCOD_map_set_properties(TCOD_Map* map, int x, int y, bool is_tr
     Free a TCOD_Map object.
  */
 TCOD_PUBLIC void TCOD_map_delete(TCOD_Map* map);
+/**
+    @brief Return the version of the most recent change to the cells within the rectangle `{x, y, width, height}`.
+
+    Changes are tracked in square regions of TCOD_MAP_REGION_SIZE cells, so a change to a cell just outside of the
+    rectangle may also be reported.
+    The version is zero if nothing in the rectangle has been changed, it increases with every change made by
+    TCOD_map_set_properties, TCOD_map_clear, and TCOD_map_copy.
+    Writing to `cells` directly bypasses this tracking.
+
+    This lets cached results which depend on a region of the map, such as paths, be checked for staleness cheaply.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC uint64_t TCOD_map_get_version(const TCOD_Map* map, int x, int y, int width, int height);
 /**
     Calculate the field-of-view.
 
@@ -90,11 +123,68 @@ TCOD_PUBLIC void TCOD_map_delete(TCOD_Map* map);
     After this call you may check if a cell is within the field-of-view by
     calling TCOD_map_is_in_fov.
 
+    Only the region returned by TCOD_map_get_fov_bounds is cleared before the
+    new field-of-view is computed, so the cost of this call depends on
+    `max_radius` rather than the size of the map.
+
     Returns an error code on failure.  See TCOD_get_error for details.
     \endrst
  */
 TCOD_PUBLIC TCOD_Error TCOD_map_compute_fov(
     TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls, TCOD_fov_algorithm_t algo);
+/**
+    @brief Calculate the field-of-view into a caller owned buffer, leaving `map` unchanged.
+
+    This takes the same parameters as TCOD_map_compute_fov, but writes the results to `out` instead of the fov
+    attribute of `map`.
+    `out` must be an array of `width * height` bools indexed by `x + y * width`, it is overwritten completely.
+
+    Since `map` is only read from, multiple threads may call this function on the same map at the same time as long
+    as each thread has its own `out` and nothing modifies `map` during these calls.
+    Note that the message returned by TCOD_get_error is shared between threads.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_map_compute_fov_to_buffer(
+    const TCOD_Map* __restrict map,
+    int pov_x,
+    int pov_y,
+    int max_radius,
+    bool light_walls,
+    TCOD_fov_algorithm_t algo,
+    bool* __restrict out);
+/**
+    @brief Compute the field-of-view of many points of view at once, spreading the work across multiple threads.
+
+    `map` is only read from, its own fov attribute is left untouched.
+    Each of the `n` `origins` must be within the map.
+    `light_walls` and `algo` are the same as in TCOD_map_compute_fov and apply to every origin.
+
+    `out_bits` may be NULL, otherwise it must point to `n * height * stride` 64-bit words where
+    `stride = (width + 63) / 64`.
+    The field-of-view of `origins[i]` is written to the `i`th plane, the cell `{x, y}` is visible if bit `x % 64` of
+    word `(i * height + y) * stride + x / 64` is set.
+
+    `out_counts` may be NULL, otherwise it must point to `width * height` ints which are overwritten with the number of
+    origins which can see each cell, indexed by `x + y * width`.
+
+    This is equivalent to calling TCOD_map_compute_fov once per origin.
+    Do not modify `map` from another thread while this call is running.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_map_compute_fov_batch(
+    const TCOD_Map* __restrict map,
+    int n,
+    const TCOD_FovOrigin* __restrict origins,
+    bool light_walls,
+    TCOD_fov_algorithm_t algo,
+    uint64_t* __restrict out_bits,
+    int* __restrict out_counts);
 /**
     Return true if this cell was touched by the current field-of-view.
  */
@@ -103,6 +193,31 @@ TCOD_PUBLIC bool TCOD_map_is_in_fov(const TCOD_Map* map, int x, int y);
     Set the fov flag on a specific cell.
  */
 TCOD_PUBLIC void TCOD_map_set_in_fov(TCOD_Map* map, int x, int y, bool fov);
+/**
+    @brief Get the bounding box of every cell which may be in the field-of-view of `map`.
+
+    All cells outside of the rectangle `{x, y, width, height}` are guaranteed to not be in the field-of-view,
+    so renderers and AI can scan only this region after TCOD_map_compute_fov.
+    The rectangle is empty with all outputs set to zero when no cell is in the field-of-view.
+
+    The bounds are tracked by TCOD_map_compute_fov, TCOD_map_set_in_fov, TCOD_map_clear, and TCOD_map_copy.
+    Writing to `cells[i].fov` directly bypasses this tracking, call TCOD_map_invalidate_fov_bounds after such writes.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_map_get_fov_bounds(const TCOD_Map* map, int* x, int* y, int* width, int* height);
+/**
+    @brief Report that the fov flags of `map` were written without going through libtcod.
+
+    Any cell may then be in the field-of-view, so the next TCOD_map_compute_fov clears the whole map and
+    TCOD_map_get_fov_bounds returns the whole map until then.
+    Code which writes to `cells[i].fov` or `fov_bits` directly must call this, or set `fov_bounds_valid` to false.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_map_invalidate_fov_bounds(TCOD_Map* map);
 /**
     Return true if this cell is transparent.
  */
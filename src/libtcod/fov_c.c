@@ -35,24 +35,143 @@
 #include "fov.h"
 #include "libtcod_int.h"
 #include "utility.h"
+/**
+    Copy the tracked field-of-view bounds from `source` to `dest`.
+ */
+static void map_copy_fov_bounds(const struct TCOD_Map* __restrict source, struct TCOD_Map* __restrict dest) {
+  dest->fov_x_min = source->fov_x_min;
+  dest->fov_y_min = source->fov_y_min;
+  dest->fov_x_max = source->fov_x_max;
+  dest->fov_y_max = source->fov_y_max;
+  dest->fov_bounds_valid = source->fov_bounds_valid;
+}
+/**
+    Mark the field-of-view of `map` as having no cells set.
+ */
+static void map_reset_fov_bounds(struct TCOD_Map* map) {
+  map->fov_x_min = map->fov_y_min = map->fov_x_max = map->fov_y_max = 0;
+  map->fov_bounds_valid = true;
+}
+/**
+    Return the number of change tracking regions along each row of a map with `width`.
+ */
+static int regions_stride_for(int width) { return (width + TCOD_MAP_REGION_SIZE - 1) / TCOD_MAP_REGION_SIZE; }
+/**
+    Return the number of change tracking regions of a map with `width` and `height`.
+ */
+static size_t regions_count_for(int width, int height) {
+  return (size_t)regions_stride_for(width) * regions_stride_for(height);
+}
+/**
+    Record a change to every cell of `map`.
+ */
+static void map_touch_all(struct TCOD_Map* map) {
+  ++map->version;
+  if (!map->region_versions) {
+    return;
+  }
+  const size_t count = regions_count_for(map->width, map->height);
+  for (size_t i = 0; i < count; ++i) {
+    map->region_versions[i] = map->version;
+  }
+}
 struct TCOD_Map* TCOD_map_new(int width, int height) {
   if (width <= 0 || height <= 0) {
     return NULL;
   }
   struct TCOD_Map* map = calloc(1, sizeof(*map));
+  if (!map) {
+    return NULL;
+  }
   map->width = width;
   map->height = height;
   map->nbcells = width * height;
   map->cells = calloc(map->nbcells, sizeof(*map->cells));
+  map->region_versions = calloc(regions_count_for(width, height), sizeof(*map->region_versions));
+  if (!map->cells || !map->region_versions) {
+    TCOD_map_delete(map);
+    return NULL;
+  }
+  map_reset_fov_bounds(map);
+  return map;
+}
+/**
+    Return the number of 64-bit words needed for each bit-plane row of `width` cells.
+ */
+static int bits_stride_for(int width) { return (width + 63) / 64; }
+/**
+    Point the bit-plane pointers of `map` into a single block of 3 planes.
+ */
+static void map_assign_planes(struct TCOD_Map* __restrict map, uint64_t* __restrict block) {
+  const ptrdiff_t plane_size = (ptrdiff_t)map->bits_stride * map->height;
+  map->transparent_bits = block;
+  map->walkable_bits = block + plane_size;
+  map->fov_bits = block + plane_size * 2;
+}
+struct TCOD_Map* TCOD_map_new_bitpacked(int width, int height) {
+  if (width <= 0 || height <= 0) {
+    return NULL;
+  }
+  struct TCOD_Map* map = calloc(1, sizeof(*map));
+  if (!map) {
+    return NULL;
+  }
+  map->width = width;
+  map->height = height;
+  map->nbcells = width * height;
+  map->bits_stride = bits_stride_for(width);
+  uint64_t* block = calloc((size_t)map->bits_stride * height * 3, sizeof(*block));
+  map->region_versions = calloc(regions_count_for(width, height), sizeof(*map->region_versions));
+  if (!block || !map->region_versions) {
+    free(block);
+    TCOD_map_delete(map);
+    return NULL;
+  }
+  map_assign_planes(map, block);
+  map_reset_fov_bounds(map);
   return map;
 }
+bool TCOD_map_is_bitpacked(const struct TCOD_Map* map) { return map && map->transparent_bits; }
 TCOD_Error TCOD_map_copy(const struct TCOD_Map* __restrict source, struct TCOD_Map* __restrict dest) {
   if (!source || !dest) {
     TCOD_set_errorv("source and dest must be non-NULL.");
     return TCOD_E_INVALID_ARGUMENT;
   }
-  if (dest->nbcells != source->nbcells) {
-    struct TCOD_MapCell* new_cells = malloc(sizeof(*dest->cells) * dest->nbcells);
+  const size_t regions_count = regions_count_for(source->width, source->height);
+  if (!dest->region_versions || regions_count_for(dest->width, dest->height) != regions_count) {
+    uint64_t* new_versions = malloc(sizeof(*new_versions) * regions_count);
+    if (!new_versions) {
+      TCOD_set_errorv("Out of memory while reallocating dest.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+    free(dest->region_versions);
+    dest->region_versions = new_versions;
+  }
+  if (source->transparent_bits) {
+    const size_t block_size = (size_t)source->bits_stride * source->height * 3;
+    uint64_t* block = dest->transparent_bits;
+    if (!block || (size_t)dest->bits_stride * dest->height * 3 != block_size) {
+      block = malloc(sizeof(*block) * block_size);
+      if (!block) {
+        TCOD_set_errorv("Out of memory while reallocating dest.");
+        return TCOD_E_OUT_OF_MEMORY;
+      }
+      free(dest->transparent_bits);
+    }
+    free(dest->cells);
+    dest->cells = NULL;
+    dest->width = source->width;
+    dest->height = source->height;
+    dest->nbcells = source->nbcells;
+    dest->bits_stride = source->bits_stride;
+    map_assign_planes(dest, block);
+    memcpy(block, source->transparent_bits, sizeof(*block) * block_size);
+    map_copy_fov_bounds(source, dest);
+    map_touch_all(dest);
+    return TCOD_E_OK;
+  }
+  if (!dest->cells || dest->nbcells != source->nbcells) {
+    struct TCOD_MapCell* new_cells = malloc(sizeof(*dest->cells) * source->nbcells);
     if (!new_cells) {
       TCOD_set_errorv("Out of memory while reallocating dest.");
       return TCOD_E_OUT_OF_MEMORY;
@@ -60,27 +179,77 @@ TCOD_Error TCOD_map_copy(const struct TCOD_Map* __restrict source, struct TCOD_M
     free(dest->cells);
     dest->cells = new_cells;
   }
+  free(dest->transparent_bits);
+  dest->bits_stride = 0;
+  dest->transparent_bits = dest->walkable_bits = dest->fov_bits = NULL;
   dest->width = source->width;
   dest->height = source->height;
   dest->nbcells = source->nbcells;
   memcpy(dest->cells, source->cells, sizeof(*dest->cells) * source->nbcells);
+  map_copy_fov_bounds(source, dest);
+  map_touch_all(dest);
   return TCOD_E_OK;
 }
+/**
+    Return the mask of valid bits for the last word of each bit-plane row.
+ */
+static uint64_t row_tail_mask(const struct TCOD_Map* map) {
+  const int tail_bits = map->width & 63;
+  return tail_bits ? (((uint64_t)1 << tail_bits) - 1) : ~(uint64_t)0;
+}
+/**
+    Fill a bit-plane of `map` with `value`, keeping row padding bits zeroed.
+ */
+static void map_fill_plane(const struct TCOD_Map* map, uint64_t* __restrict plane, bool value) {
+  if (!value) {
+    memset(plane, 0, sizeof(*plane) * map->bits_stride * map->height);
+    return;
+  }
+  const uint64_t tail_mask = row_tail_mask(map);
+  for (int y = 0; y < map->height; ++y) {
+    uint64_t* row = plane + (ptrdiff_t)y * map->bits_stride;
+    for (int i = 0; i < map->bits_stride - 1; ++i) {
+      row[i] = ~(uint64_t)0;
+    }
+    row[map->bits_stride - 1] = tail_mask;
+  }
+}
 void TCOD_map_clear(struct TCOD_Map* map, bool transparent, bool walkable) {
   int i;
   if (!map) {
     return;
   }
+  if (map->transparent_bits) {
+    map_fill_plane(map, map->transparent_bits, transparent);
+    map_fill_plane(map, map->walkable_bits, walkable);
+    map_fill_plane(map, map->fov_bits, false);
+    map_reset_fov_bounds(map);
+    map_touch_all(map);
+    return;
+  }
   for (i = 0; i < map->nbcells; ++i) {
     map->cells[i].transparent = transparent;
     map->cells[i].walkable = walkable;
     map->cells[i].fov = 0;
   }
+  map_reset_fov_bounds(map);
+  map_touch_all(map);
 }
 void TCOD_map_set_properties(struct TCOD_Map* map, int x, int y, bool is_transparent, bool is_walkable) {
   if (!TCOD_map_in_bounds(map, x, y)) {
     return;
   }
+  ++map->version;
+  if (map->region_versions) {
+    map->region_versions[(y / TCOD_MAP_REGION_SIZE) * regions_stride_for(map->width) + x / TCOD_MAP_REGION_SIZE] =
+        map->version;
+  }
+  if (map->transparent_bits) {
+    const ptrdiff_t index = TCOD_map_bits_index_(map, x, y);
+    TCOD_map_assign_bit_(&map->transparent_bits[index], x, is_transparent);
+    TCOD_map_assign_bit_(&map->walkable_bits[index], x, is_walkable);
+    return;
+  }
   map->cells[x + y * map->width].transparent = is_transparent;
   map->cells[x + y * map->width].walkable = is_walkable;
 }
@@ -89,8 +258,37 @@ void TCOD_map_delete(struct TCOD_Map* map) {
     return;
   }
   free(map->cells);
+  free(map->transparent_bits);  // Also frees the other bit-planes.
+  free(map->region_versions);
   free(map);
 }
+uint64_t TCOD_map_get_version(const struct TCOD_Map* map, int x, int y, int width, int height) {
+  if (!map) {
+    return 0;
+  }
+  if (!map->region_versions) {
+    return map->version;
+  }
+  const int x_begin = TCOD_MAX(x, 0);
+  const int y_begin = TCOD_MAX(y, 0);
+  const int x_end = TCOD_MIN(x + width, map->width);
+  const int y_end = TCOD_MIN(y + height, map->height);
+  if (x_begin >= x_end || y_begin >= y_end) {
+    return 0;
+  }
+  const int x_min = x_begin / TCOD_MAP_REGION_SIZE;
+  const int y_min = y_begin / TCOD_MAP_REGION_SIZE;
+  const int x_max = (x_end - 1) / TCOD_MAP_REGION_SIZE;
+  const int y_max = (y_end - 1) / TCOD_MAP_REGION_SIZE;
+  const int stride = regions_stride_for(map->width);
+  uint64_t version = 0;
+  for (int region_y = y_min; region_y <= y_max; ++region_y) {
+    for (int region_x = x_min; region_x <= x_max; ++region_x) {
+      version = TCOD_MAX(version, map->region_versions[region_y * stride + region_x]);
+    }
+  }
+  return version;
+}
 /**
     Spread lighting to walls to avoid lighting artifacts.
 
@@ -98,7 +296,8 @@ void TCOD_map_delete(struct TCOD_Map* map) {
 
     `dx`, `dy` is the cast direction.
  */
-static void TCOD_map_postprocess_quadrant(TCOD_Map* __restrict map, int x0, int y0, int x1, int y1, int dx, int dy) {
+static void TCOD_map_postprocess_quadrant(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int x0, int y0, int x1, int y1, int dx, int dy) {
   if (abs(dx) != 1 || abs(dy) != 1) {
     return;  // Bad parameters.
   }
@@ -106,24 +305,20 @@ static void TCOD_map_postprocess_quadrant(TCOD_Map* __restrict map, int x0, int
     for (int cy = y0; cy <= y1; cy++) {
       const int x2 = cx + dx;
       const int y2 = cy + dy;
-      const int offset = cx + cy * map->width;
-      if (offset < map->nbcells && map->cells[offset].fov == 1 && map->cells[offset].transparent) {
+      if (TCOD_fov_output_get_(out, cx, cy) && TCOD_map_get_transparent_(map, cx, cy)) {
         if (x2 >= x0 && x2 <= x1) {
-          const int offset2 = x2 + cy * map->width;
-          if (offset2 < map->nbcells && !map->cells[offset2].transparent) {
-            map->cells[offset2].fov = 1;
+          if (!TCOD_map_get_transparent_(map, x2, cy)) {
+            TCOD_fov_output_set_(out, x2, cy, true);
           }
         }
         if (y2 >= y0 && y2 <= y1) {
-          const int offset2 = cx + y2 * map->width;
-          if (offset2 < map->nbcells && !map->cells[offset2].transparent) {
-            map->cells[offset2].fov = 1;
+          if (!TCOD_map_get_transparent_(map, cx, y2)) {
+            TCOD_fov_output_set_(out, cx, y2, true);
           }
         }
         if (x2 >= x0 && x2 <= x1 && y2 >= y0 && y2 <= y1) {
-          const int offset2 = x2 + y2 * map->width;
-          if (offset2 < map->nbcells && !map->cells[offset2].transparent) {
-            map->cells[offset2].fov = 1;
+          if (!TCOD_map_get_transparent_(map, x2, y2)) {
+            TCOD_fov_output_set_(out, x2, y2, true);
           }
         }
       }
@@ -133,7 +328,8 @@ static void TCOD_map_postprocess_quadrant(TCOD_Map* __restrict map, int x0, int
 /**
     Spread lighting to walls to avoid lighting artifacts.
  */
-TCOD_Error TCOD_map_postprocess(TCOD_Map* __restrict map, int pov_x, int pov_y, int radius) {
+TCOD_Error TCOD_map_postprocess(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int radius) {
   int x_min = 0;
   int y_min = 0;
   int x_max = map->width;
@@ -144,46 +340,71 @@ TCOD_Error TCOD_map_postprocess(TCOD_Map* __restrict map, int pov_x, int pov_y,
     x_max = TCOD_MIN(x_max, pov_x + radius + 1);
     y_max = TCOD_MIN(y_max, pov_y + radius + 1);
   }
-  TCOD_map_postprocess_quadrant(map, x_min, y_min, pov_x, pov_y, -1, -1);
-  TCOD_map_postprocess_quadrant(map, pov_x, y_min, x_max - 1, pov_y, 1, -1);
-  TCOD_map_postprocess_quadrant(map, x_min, pov_y, pov_x, y_max - 1, -1, 1);
-  TCOD_map_postprocess_quadrant(map, pov_x, pov_y, x_max - 1, y_max - 1, 1, 1);
+  TCOD_map_postprocess_quadrant(map, out, x_min, y_min, pov_x, pov_y, -1, -1);
+  TCOD_map_postprocess_quadrant(map, out, pov_x, y_min, x_max - 1, pov_y, 1, -1);
+  TCOD_map_postprocess_quadrant(map, out, x_min, pov_y, pov_x, y_max - 1, -1, 1);
+  TCOD_map_postprocess_quadrant(map, out, pov_x, pov_y, x_max - 1, y_max - 1, 1, 1);
   return TCOD_E_OK;
 }
 /**
-    Reset the map FOV flag to zeros.
+    Unset the fov flags of `map` within the given half-open bounds.
  */
-static void TCOD_map_clear_fov(TCOD_Map* __restrict map) {
-  if (!map) {
+static void map_clear_fov_region(struct TCOD_Map* __restrict map, int x_min, int y_min, int x_max, int y_max) {
+  if (x_min >= x_max || y_min >= y_max) {
     return;
   }
-  for (int i = 0; i < map->nbcells; ++i) {
-    map->cells[i].fov = 0;
+  if (map->fov_bits) {
+    const int word_min = x_min / 64;
+    const int word_max = (x_max - 1) / 64;
+    for (int y = y_min; y < y_max; ++y) {
+      uint64_t* __restrict row = map->fov_bits + (ptrdiff_t)y * map->bits_stride;
+      for (int i = word_min; i <= word_max; ++i) {
+        const int begin = TCOD_MAX(x_min - i * 64, 0);
+        const int end = TCOD_MIN(x_max - i * 64, 64);
+        const uint64_t upper = end == 64 ? ~(uint64_t)0 : (((uint64_t)1 << end) - 1);
+        row[i] &= ~(upper & ~(((uint64_t)1 << begin) - 1));
+      }
+    }
+    return;
+  }
+  for (int y = y_min; y < y_max; ++y) {
+    struct TCOD_MapCell* __restrict row = map->cells + (ptrdiff_t)y * map->width;
+    for (int x = x_min; x < x_max; ++x) {
+      row[x].fov = false;
+    }
   }
 }
-TCOD_Error TCOD_map_compute_fov(
-    struct TCOD_Map* __restrict map,
+/**
+    Unset every fov flag of `map`, only visiting the tracked bounds when they are known.
+ */
+static void map_clear_fov(struct TCOD_Map* __restrict map) {
+  if (map->fov_bounds_valid) {
+    map_clear_fov_region(
+        map,
+        TCOD_MAX(map->fov_x_min, 0),
+        TCOD_MAX(map->fov_y_min, 0),
+        TCOD_MIN(map->fov_x_max, map->width),
+        TCOD_MIN(map->fov_y_max, map->height));
+  } else {
+    map_clear_fov_region(map, 0, 0, map->width, map->height);
+  }
+  map_reset_fov_bounds(map);
+}
+TCOD_Error TCOD_map_compute_fov_to_output_(
+    const TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
     int pov_x,
     int pov_y,
     int max_radius,
     bool light_walls,
     TCOD_fov_algorithm_t algo) {
-  if (!map) {
-    TCOD_set_errorv("Map must not be NULL.");
-    return TCOD_E_INVALID_ARGUMENT;
-  }
-  if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
-    TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
-    return TCOD_E_INVALID_ARGUMENT;
-  }
-  TCOD_map_clear_fov(map);
   switch (algo) {
     case FOV_BASIC:
-      return TCOD_map_compute_fov_circular_raycasting(map, pov_x, pov_y, max_radius, light_walls);
+      return TCOD_map_compute_fov_circular_raycasting(map, out, pov_x, pov_y, max_radius, light_walls);
     case FOV_DIAMOND:
-      return TCOD_map_compute_fov_diamond_raycasting(map, pov_x, pov_y, max_radius, light_walls);
+      return TCOD_map_compute_fov_diamond_raycasting(map, out, pov_x, pov_y, max_radius, light_walls);
     case FOV_SHADOW:
-      return TCOD_map_compute_fov_recursive_shadowcasting(map, pov_x, pov_y, max_radius, light_walls);
+      return TCOD_map_compute_fov_recursive_shadowcasting(map, out, pov_x, pov_y, max_radius, light_walls);
     case FOV_PERMISSIVE_0:
     case FOV_PERMISSIVE_1:
     case FOV_PERMISSIVE_2:
@@ -193,38 +414,241 @@ TCOD_Error TCOD_map_compute_fov(
     case FOV_PERMISSIVE_6:
     case FOV_PERMISSIVE_7:
     case FOV_PERMISSIVE_8:
-      return TCOD_map_compute_fov_permissive2(map, pov_x, pov_y, max_radius, light_walls, algo - FOV_PERMISSIVE_0);
+      return TCOD_map_compute_fov_permissive2(
+          map, out, pov_x, pov_y, max_radius, light_walls, algo - FOV_PERMISSIVE_0);
     case FOV_RESTRICTIVE:
-      return TCOD_map_compute_fov_restrictive_shadowcasting(map, pov_x, pov_y, max_radius, light_walls);
+      return TCOD_map_compute_fov_restrictive_shadowcasting(map, out, pov_x, pov_y, max_radius, light_walls);
     case FOV_SYMMETRIC_SHADOWCAST:
-      return TCOD_map_compute_fov_symmetric_shadowcast(map, pov_x, pov_y, max_radius, light_walls);
+      return TCOD_map_compute_fov_symmetric_shadowcast(map, out, pov_x, pov_y, max_radius, light_walls);
+    case FOV_SHADOW_TABLE:
+      return TCOD_map_compute_fov_shadow_table(map, out, pov_x, pov_y, max_radius, light_walls);
     default:
       return TCOD_E_INVALID_ARGUMENT;
   }
 }
+TCOD_Error TCOD_map_compute_fov(
+    struct TCOD_Map* __restrict map,
+    int pov_x,
+    int pov_y,
+    int max_radius,
+    bool light_walls,
+    TCOD_fov_algorithm_t algo) {
+  if (!map) {
+    TCOD_set_errorv("Map must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
+    TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  map_clear_fov(map);
+  TCOD_FovOutput out = TCOD_fov_output_from_map_(map);
+  const TCOD_Error err = TCOD_map_compute_fov_to_output_(map, &out, pov_x, pov_y, max_radius, light_walls, algo);
+  if (out.touched_x_min <= out.touched_x_max) {
+    map->fov_x_min = out.touched_x_min;
+    map->fov_y_min = out.touched_y_min;
+    map->fov_x_max = out.touched_x_max + 1;
+    map->fov_y_max = out.touched_y_max + 1;
+  }
+  return err;
+}
+TCOD_Error TCOD_map_compute_fov_to_buffer(
+    const TCOD_Map* __restrict map,
+    int pov_x,
+    int pov_y,
+    int max_radius,
+    bool light_walls,
+    TCOD_fov_algorithm_t algo,
+    bool* __restrict out) {
+  if (!map || !out) {
+    TCOD_set_errorv("Map and output must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
+    TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  TCOD_FovOutput fov_out = TCOD_fov_output_new_(0, 0, map->width, map->height);
+  fov_out.cells = out;
+  fov_out.cells_stride_x = 1;
+  fov_out.cells_stride_y = map->width;
+  memset(out, 0, sizeof(*out) * map->width * map->height);
+  return TCOD_map_compute_fov_to_output_(map, &fov_out, pov_x, pov_y, max_radius, light_walls, algo);
+}
+/// Shared state of TCOD_map_compute_fov_batch.
+struct FovBatch {
+  const TCOD_Map* map;
+  const TCOD_FovOrigin* origins;
+  bool light_walls;
+  TCOD_fov_algorithm_t algo;
+  ptrdiff_t plane_words;  // The length of each bit-plane.
+  uint64_t* out_bits;  // The callers bit-planes, or NULL.
+  uint64_t* worker_bits;  // One scratch bit-plane per worker, used when out_bits is NULL.
+  int** worker_counts;  // One count grid per worker, or NULL if counts were not requested.
+  TCOD_Error* worker_errors;  // The first error seen by each worker.
+};
+/**
+    Compute the FOV of one origin of a batch on the given worker.
+ */
+static void fov_batch_task(void* userdata, int index, int worker) {
+  struct FovBatch* batch = userdata;
+  const TCOD_Map* map = batch->map;
+  uint64_t* plane = batch->out_bits ? batch->out_bits + batch->plane_words * index
+                                    : batch->worker_bits + batch->plane_words * worker;
+  memset(plane, 0, sizeof(*plane) * batch->plane_words);
+  TCOD_FovOutput out = TCOD_fov_output_new_(0, 0, map->width, map->height);
+  out.bits = plane;
+  out.bits_stride = bits_stride_for(map->width);
+  const TCOD_FovOrigin* origin = &batch->origins[index];
+  const TCOD_Error err = TCOD_map_compute_fov_to_output_(
+      map, &out, origin->x, origin->y, origin->max_radius, batch->light_walls, batch->algo);
+  if (err < 0) {
+    if (batch->worker_errors[worker] >= 0) batch->worker_errors[worker] = err;
+    return;
+  }
+  if (!batch->worker_counts) return;
+  int* counts = batch->worker_counts[worker];
+  for (int y = 0; y < out.height; ++y) {
+    for (int word_x = 0; word_x < out.bits_stride; ++word_x) {
+      uint64_t word = plane[word_x + (ptrdiff_t)y * out.bits_stride];
+      for (int x = word_x * 64; word; ++x, word >>= 1) {
+        counts[x + y * map->width] += (int)(word & 1);
+      }
+    }
+  }
+}
+TCOD_Error TCOD_map_compute_fov_batch(
+    const TCOD_Map* __restrict map,
+    int n,
+    const TCOD_FovOrigin* __restrict origins,
+    bool light_walls,
+    TCOD_fov_algorithm_t algo,
+    uint64_t* __restrict out_bits,
+    int* __restrict out_counts) {
+  if (!map) {
+    TCOD_set_errorv("Map must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (n < 0 || (n > 0 && !origins)) {
+    TCOD_set_errorvf("Expected %i origins but origins was NULL or n was negative.", n);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (algo < 0 || algo >= NB_FOV_ALGORITHMS) {
+    TCOD_set_errorvf("Unknown FOV algorithm %i.", (int)algo);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  for (int i = 0; i < n; ++i) {
+    if (!TCOD_map_in_bounds(map, origins[i].x, origins[i].y)) {
+      TCOD_set_errorvf("Point of view {%i, %i} at index %i is out of bounds.", origins[i].x, origins[i].y, i);
+      return TCOD_E_INVALID_ARGUMENT;
+    }
+  }
+  const size_t grid_size = (size_t)map->width * map->height;
+  if (out_counts) memset(out_counts, 0, sizeof(*out_counts) * grid_size);
+  if (n == 0) return TCOD_E_OK;
+  const int workers = TCOD_parallel_worker_count_(n);
+  struct FovBatch batch = {
+      map, origins, light_walls, algo, (ptrdiff_t)bits_stride_for(map->width) * map->height, out_bits, NULL, NULL,
+      NULL};
+  int* worker_counts[TCOD_PARALLEL_MAX_WORKERS_] = {NULL};
+  TCOD_Error worker_errors[TCOD_PARALLEL_MAX_WORKERS_] = {TCOD_E_OK};
+  batch.worker_errors = worker_errors;
+  if (!out_bits) {
+    batch.worker_bits = malloc(sizeof(*batch.worker_bits) * batch.plane_words * workers);
+  }
+  bool out_of_memory = !out_bits && !batch.worker_bits;
+  if (out_counts) {
+    // Worker 0 counts directly into the output, the other workers are merged into it afterwards.
+    worker_counts[0] = out_counts;
+    for (int i = 1; i < workers; ++i) {
+      worker_counts[i] = calloc(grid_size, sizeof(*worker_counts[i]));
+      out_of_memory |= !worker_counts[i];
+    }
+    batch.worker_counts = worker_counts;
+  }
+  TCOD_Error err = TCOD_E_OK;
+  if (out_of_memory) {
+    TCOD_set_errorv("Out of memory.");
+    err = TCOD_E_OUT_OF_MEMORY;
+  } else {
+    TCOD_parallel_for_(n, workers, fov_batch_task, &batch);
+    for (int i = 0; i < workers && err >= 0; ++i) err = worker_errors[i];
+    if (err < 0) {
+      TCOD_set_errorv("Failed to compute the field-of-view of a batch.");
+    } else if (out_counts) {
+      for (int i = 1; i < workers; ++i) {
+        for (size_t j = 0; j < grid_size; ++j) out_counts[j] += worker_counts[i][j];
+      }
+    }
+  }
+  for (int i = 1; i < workers; ++i) free(worker_counts[i]);
+  free(batch.worker_bits);
+  return err;
+}
 bool TCOD_map_is_in_fov(const struct TCOD_Map* map, int x, int y) {
   if (!TCOD_map_in_bounds(map, x, y)) {
     return 0;
   }
-  return map->cells[x + y * map->width].fov;
+  return TCOD_map_get_fov_(map, x, y);
 }
 void TCOD_map_set_in_fov(struct TCOD_Map* map, int x, int y, bool fov) {
   if (!TCOD_map_in_bounds(map, x, y)) {
     return;
   }
-  map->cells[x + y * map->width].fov = fov;
+  TCOD_map_set_fov_(map, x, y, fov);
+  if (!fov || !map->fov_bounds_valid) {
+    return;
+  }
+  if (map->fov_x_min >= map->fov_x_max || map->fov_y_min >= map->fov_y_max) {
+    map->fov_x_min = x;
+    map->fov_y_min = y;
+    map->fov_x_max = x + 1;
+    map->fov_y_max = y + 1;
+    return;
+  }
+  map->fov_x_min = TCOD_MIN(map->fov_x_min, x);
+  map->fov_y_min = TCOD_MIN(map->fov_y_min, y);
+  map->fov_x_max = TCOD_MAX(map->fov_x_max, x + 1);
+  map->fov_y_max = TCOD_MAX(map->fov_y_max, y + 1);
+}
+void TCOD_map_invalidate_fov_bounds(struct TCOD_Map* map) {
+  if (map) {
+    map->fov_bounds_valid = false;
+  }
+}
+TCOD_Error TCOD_map_get_fov_bounds(const struct TCOD_Map* map, int* x, int* y, int* width, int* height) {
+  if (!map || !x || !y || !width || !height) {
+    TCOD_set_errorv("Map and outputs must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  int x_min = 0;
+  int y_min = 0;
+  int x_max = map->width;
+  int y_max = map->height;
+  if (map->fov_bounds_valid) {
+    x_min = TCOD_MAX(map->fov_x_min, 0);
+    y_min = TCOD_MAX(map->fov_y_min, 0);
+    x_max = TCOD_MIN(map->fov_x_max, map->width);
+    y_max = TCOD_MIN(map->fov_y_max, map->height);
+  }
+  *x = x_min;
+  *y = y_min;
+  *width = TCOD_MAX(x_max - x_min, 0);
+  *height = TCOD_MAX(y_max - y_min, 0);
+  if (*width == 0 || *height == 0) *x = *y = *width = *height = 0;
+  return TCOD_E_OK;
 }
 bool TCOD_map_is_transparent(const struct TCOD_Map* map, int x, int y) {
   if (!TCOD_map_in_bounds(map, x, y)) {
     return 0;
   }
-  return map->cells[x + y * map->width].transparent;
+  return TCOD_map_get_transparent_(map, x, y);
 }
 bool TCOD_map_is_walkable(struct TCOD_Map* map, int x, int y) {
   if (!TCOD_map_in_bounds(map, x, y)) {
     return 0;
   }
-  return map->cells[x + y * map->width].walkable;
+  return TCOD_map_get_walkable_(map, x, y);
 }
 int TCOD_map_get_width(const struct TCOD_Map* map) {
   if (!map) {
@@ -31,56 +31,246 @@
  */
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "bresenham.h"
 #include "fov.h"
 #include "libtcod_int.h"
 #include "utility.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAY_VEC_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RAY_VEC_NEON 1
+#endif
 /**
-    Cast a Bresenham ray marking tiles along the line as lit.
+    4 lanes of 32-bit integers.
+
+    Uses SSE2 or NEON when the compiler targets them by default, otherwise falls back to plain C.
+    Comparisons return lanes which are all bits set for true and zero for false.
+ */
+#if defined(RAY_VEC_SSE2)
+typedef __m128i RayVec;
+static inline RayVec vec_load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void vec_store(int32_t* p, RayVec v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline RayVec vec_set1(int32_t n) { return _mm_set1_epi32(n); }
+static inline RayVec vec_add(RayVec a, RayVec b) { return _mm_add_epi32(a, b); }
+static inline RayVec vec_sub(RayVec a, RayVec b) { return _mm_sub_epi32(a, b); }
+static inline RayVec vec_and(RayVec a, RayVec b) { return _mm_and_si128(a, b); }
+static inline RayVec vec_or(RayVec a, RayVec b) { return _mm_or_si128(a, b); }
+static inline RayVec vec_lt(RayVec a, RayVec b) { return _mm_cmplt_epi32(a, b); }
+static inline RayVec vec_gt(RayVec a, RayVec b) { return _mm_cmpgt_epi32(a, b); }
+static inline RayVec vec_eq(RayVec a, RayVec b) { return _mm_cmpeq_epi32(a, b); }
+static inline RayVec vec_mul(RayVec a, RayVec b) {
+  // SSE2 lacks a 32-bit multiply, multiply the even and odd lanes separately and then interleave them.
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(
+      _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+static inline bool vec_any(RayVec v) { return _mm_movemask_epi8(v) != 0; }
+#elif defined(RAY_VEC_NEON)
+typedef int32x4_t RayVec;
+static inline RayVec vec_load(const int32_t* p) { return vld1q_s32(p); }
+static inline void vec_store(int32_t* p, RayVec v) { vst1q_s32(p, v); }
+static inline RayVec vec_set1(int32_t n) { return vdupq_n_s32(n); }
+static inline RayVec vec_add(RayVec a, RayVec b) { return vaddq_s32(a, b); }
+static inline RayVec vec_sub(RayVec a, RayVec b) { return vsubq_s32(a, b); }
+static inline RayVec vec_and(RayVec a, RayVec b) { return vandq_s32(a, b); }
+static inline RayVec vec_or(RayVec a, RayVec b) { return vorrq_s32(a, b); }
+static inline RayVec vec_lt(RayVec a, RayVec b) { return vreinterpretq_s32_u32(vcltq_s32(a, b)); }
+static inline RayVec vec_gt(RayVec a, RayVec b) { return vreinterpretq_s32_u32(vcgtq_s32(a, b)); }
+static inline RayVec vec_eq(RayVec a, RayVec b) { return vreinterpretq_s32_u32(vceqq_s32(a, b)); }
+static inline RayVec vec_mul(RayVec a, RayVec b) { return vmulq_s32(a, b); }
+static inline bool vec_any(RayVec v) {
+  const uint32x2_t folded = vorr_u32(vget_low_u32(vreinterpretq_u32_s32(v)), vget_high_u32(vreinterpretq_u32_s32(v)));
+  return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+}
+#else
+typedef struct RayVec {
+  int32_t v[4];
+} RayVec;
+static inline RayVec vec_load(const int32_t* p) {
+  RayVec r;
+  memcpy(r.v, p, sizeof(r.v));
+  return r;
+}
+static inline void vec_store(int32_t* p, RayVec v) { memcpy(p, v.v, sizeof(v.v)); }
+static inline RayVec vec_set1(int32_t n) {
+  RayVec r = {{n, n, n, n}};
+  return r;
+}
+#define RAY_VEC_BINARY_OP(name, expr)              \
+  static inline RayVec name(RayVec a, RayVec b) {  \
+    RayVec r;                                      \
+    for (int i = 0; i < 4; ++i) r.v[i] = (expr);   \
+    return r;                                      \
+  }
+RAY_VEC_BINARY_OP(vec_add, (int32_t)((uint32_t)a.v[i] + (uint32_t)b.v[i]))
+RAY_VEC_BINARY_OP(vec_sub, (int32_t)((uint32_t)a.v[i] - (uint32_t)b.v[i]))
+RAY_VEC_BINARY_OP(vec_and, a.v[i] & b.v[i])
+RAY_VEC_BINARY_OP(vec_or, a.v[i] | b.v[i])
+RAY_VEC_BINARY_OP(vec_lt, -(a.v[i] < b.v[i]))
+RAY_VEC_BINARY_OP(vec_gt, -(a.v[i] > b.v[i]))
+RAY_VEC_BINARY_OP(vec_eq, -(a.v[i] == b.v[i]))
+RAY_VEC_BINARY_OP(vec_mul, (int32_t)((uint32_t)a.v[i] * (uint32_t)b.v[i]))
+#undef RAY_VEC_BINARY_OP
+static inline bool vec_any(RayVec v) { return (v.v[0] | v.v[1] | v.v[2] | v.v[3]) != 0; }
+#endif
+/// The number of rays traced together, this must be a multiple of 4.
+#define RAY_LANES 8
+/**
+    A batch of Bresenham rays traced in lockstep.
+
+    Each lane follows the same steps as TCOD_line_step_mt, rewritten without branches:
+    every step moves along the major axis, and moves along the minor axis when the error term goes negative.
+ */
+typedef struct RayBatch {
+  int32_t x[RAY_LANES];  // Current position.
+  int32_t y[RAY_LANES];
+  int32_t e[RAY_LANES];  // Bresenham error term.
+  int32_t major_x[RAY_LANES];  // Step taken every iteration.
+  int32_t major_y[RAY_LANES];
+  int32_t minor_x[RAY_LANES];  // Step taken when the error term goes negative.
+  int32_t minor_y[RAY_LANES];
+  int32_t major_delta[RAY_LANES];  // Twice the length of the line along its major and minor axes.
+  int32_t minor_delta[RAY_LANES];
+  int32_t remaining[RAY_LANES];  // Steps left before the destination is reached.
+  int32_t live[RAY_LANES];  // All bits set while this ray is still being traced.
+  int count;  // The number of lanes which have been assigned a ray.
+} RayBatch;
+/**
+    Assign a ray from `{x_origin, y_origin}` to `{x_dest, y_dest}` to the next free lane of `batch`.
+
+    Matches TCOD_line_init_mt.
+ */
+static void ray_batch_push(RayBatch* __restrict batch, int x_origin, int y_origin, int x_dest, int y_dest) {
+  const int i = batch->count++;
+  const int delta_x = x_dest - x_origin;
+  const int delta_y = y_dest - y_origin;
+  const int step_x = (delta_x > 0) - (delta_x < 0);
+  const int step_y = (delta_y > 0) - (delta_y < 0);
+  const bool x_major = step_x * delta_x > step_y * delta_y;
+  batch->x[i] = x_origin;
+  batch->y[i] = y_origin;
+  batch->major_x[i] = x_major ? step_x : 0;
+  batch->major_y[i] = x_major ? 0 : step_y;
+  batch->minor_x[i] = x_major ? 0 : step_x;
+  batch->minor_y[i] = x_major ? step_y : 0;
+  batch->major_delta[i] = 2 * (x_major ? step_x * delta_x : step_y * delta_y);
+  batch->minor_delta[i] = 2 * (x_major ? step_y * delta_y : step_x * delta_x);
+  batch->e[i] = batch->major_delta[i] / 2;
+  batch->remaining[i] = batch->major_delta[i] / 2;
+  batch->live[i] = -1;
+}
+/**
+    Advance 4 lanes of `batch` starting at `lane` by one step.
+
+    Lanes which reach their destination, leave the map, or leave the radius are no longer live.
+    Returns true if any of these lanes are still live.
+ */
+static bool ray_batch_step4(
+    RayBatch* __restrict batch, int lane, RayVec origin_x, RayVec origin_y, RayVec width, RayVec height,
+    RayVec radius_squared) {
+  const RayVec zero = vec_set1(0);
+  const RayVec one = vec_set1(1);
+  RayVec live = vec_load(batch->live + lane);
+  RayVec remaining = vec_load(batch->remaining + lane);
+  live = vec_and(live, vec_gt(remaining, zero));
+  RayVec x = vec_add(vec_load(batch->x + lane), vec_and(vec_load(batch->major_x + lane), live));
+  RayVec y = vec_add(vec_load(batch->y + lane), vec_and(vec_load(batch->major_y + lane), live));
+  RayVec e = vec_sub(vec_load(batch->e + lane), vec_and(vec_load(batch->minor_delta + lane), live));
+  remaining = vec_sub(remaining, vec_and(one, live));
+  const RayVec carry = vec_and(vec_lt(e, zero), live);
+  x = vec_add(x, vec_and(vec_load(batch->minor_x + lane), carry));
+  y = vec_add(y, vec_and(vec_load(batch->minor_y + lane), carry));
+  e = vec_add(e, vec_and(vec_load(batch->major_delta + lane), carry));
+  // Keep lanes which are in bounds and within the radius, a zero radius is unlimited.
+  const RayVec in_bounds =
+      vec_and(vec_and(vec_gt(x, vec_set1(-1)), vec_lt(x, width)), vec_and(vec_gt(y, vec_set1(-1)), vec_lt(y, height)));
+  const RayVec dx = vec_sub(x, origin_x);
+  const RayVec dy = vec_sub(y, origin_y);
+  const RayVec distance_squared = vec_add(vec_mul(dx, dx), vec_mul(dy, dy));
+  const RayVec in_radius = vec_or(vec_eq(radius_squared, zero), vec_gt(vec_add(radius_squared, one), distance_squared));
+  live = vec_and(live, vec_and(in_bounds, in_radius));
+  vec_store(batch->x + lane, x);
+  vec_store(batch->y + lane, y);
+  vec_store(batch->e + lane, e);
+  vec_store(batch->remaining + lane, remaining);
+  vec_store(batch->live + lane, live);
+  return vec_any(live);
+}
+/**
+    Trace every ray of `batch` to completion, marking the tiles along each ray as lit.
 
     `radius_squared` is the max distance or zero if there is no limit.
 
     If `light_walls` is true then blocking walls are marked as visible.
  */
-static void cast_ray(
-    struct TCOD_Map* __restrict map,
+static void ray_batch_cast(
+    const struct TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
+    RayBatch* __restrict batch,
     int x_origin,
     int y_origin,
-    int x_dest,
-    int y_dest,
     int radius_squared,
     bool light_walls) {
-  TCOD_bresenham_data_t bresenham_data;
-  int current_x;
-  int current_y;
-  TCOD_line_init_mt(x_origin, y_origin, x_dest, y_dest, &bresenham_data);
-  while (!TCOD_line_step_mt(&current_x, &current_y, &bresenham_data)) {
-    if (!TCOD_map_in_bounds(map, current_x, current_y)) {
-      return;  // Out of bounds.
-    }
-    if (radius_squared > 0) {
-      const int current_radius =
-          (current_x - x_origin) * (current_x - x_origin) + (current_y - y_origin) * (current_y - y_origin);
-      if (current_radius > radius_squared) {
-        return;  // Outside of radius.
-      }
+  for (int i = batch->count; i < RAY_LANES; ++i) {
+    batch->live[i] = batch->remaining[i] = 0;  // Unused lanes.
+    batch->x[i] = batch->y[i] = batch->e[i] = 0;
+    batch->major_x[i] = batch->major_y[i] = batch->minor_x[i] = batch->minor_y[i] = 0;
+    batch->major_delta[i] = batch->minor_delta[i] = 0;
+  }
+  const RayVec origin_x = vec_set1(x_origin);
+  const RayVec origin_y = vec_set1(y_origin);
+  const RayVec width = vec_set1(map->width);
+  const RayVec height = vec_set1(map->height);
+  const RayVec radius_vec = vec_set1(radius_squared);
+  bool any_live = true;
+  while (any_live) {
+    any_live = false;
+    for (int lane = 0; lane < RAY_LANES; lane += 4) {
+      ray_batch_step4(batch, lane, origin_x, origin_y, width, height, radius_vec);
     }
-    const int map_index = current_x + current_y * map->width;
-    if (!map->cells[map_index].transparent) {
-      if (light_walls) {
-        map->cells[map_index].fov = true;
+    // Visiting the map is done one lane at a time.
+    for (int i = 0; i < RAY_LANES; ++i) {
+      if (!batch->live[i]) continue;
+      if (!TCOD_map_get_transparent_(map, batch->x[i], batch->y[i])) {
+        if (light_walls) {
+          TCOD_fov_output_set_(out, batch->x[i], batch->y[i], true);
+        }
+        batch->live[i] = 0;  // Blocked by wall.
+        continue;
       }
-      return;  // Blocked by wall.
+      TCOD_fov_output_set_(out, batch->x[i], batch->y[i], true);
+      any_live = true;
     }
-    // Tile is transparent.
-    map->cells[map_index].fov = true;
+  }
+  batch->count = 0;
+}
+/**
+    Queue a ray, casting the batch once it is full.
+ */
+static void queue_ray(
+    const struct TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
+    RayBatch* __restrict batch,
+    int x_origin,
+    int y_origin,
+    int x_dest,
+    int y_dest,
+    int radius_squared,
+    bool light_walls) {
+  ray_batch_push(batch, x_origin, y_origin, x_dest, y_dest);
+  if (batch->count == RAY_LANES) {
+    ray_batch_cast(map, out, batch, x_origin, y_origin, radius_squared, light_walls);
   }
 }
 TCOD_Error TCOD_map_compute_fov_circular_raycasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls) {
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls) {
   int x_min = 0;  // Field-of-view bounds.
   int y_min = 0;
   int x_max = map->width;
@@ -95,24 +285,29 @@ TCOD_Error TCOD_map_compute_fov_circular_raycasting(
     TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
     return TCOD_E_INVALID_ARGUMENT;
   }
-  map->cells[pov_x + pov_y * map->width].fov = true;  // Mark point-of-view as visible.
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);  // Mark point-of-view as visible.
 
-  // Cast rays along the perimeter.
+  // Cast rays along the perimeter.  Rays only add visible tiles so the order they are traced in does not matter.
   const int radius_squared = max_radius * max_radius;
+  RayBatch batch;
+  batch.count = 0;
   for (int x = x_min; x < x_max; ++x) {
-    cast_ray(map, pov_x, pov_y, x, y_min, radius_squared, light_walls);
+    queue_ray(map, out, &batch, pov_x, pov_y, x, y_min, radius_squared, light_walls);
   }
   for (int y = y_min + 1; y < y_max; ++y) {
-    cast_ray(map, pov_x, pov_y, x_max - 1, y, radius_squared, light_walls);
+    queue_ray(map, out, &batch, pov_x, pov_y, x_max - 1, y, radius_squared, light_walls);
   }
   for (int x = x_max - 2; x >= x_min; --x) {
-    cast_ray(map, pov_x, pov_y, x, y_max - 1, radius_squared, light_walls);
+    queue_ray(map, out, &batch, pov_x, pov_y, x, y_max - 1, radius_squared, light_walls);
   }
   for (int y = y_max - 2; y > y_min; --y) {
-    cast_ray(map, pov_x, pov_y, x_min, y, radius_squared, light_walls);
+    queue_ray(map, out, &batch, pov_x, pov_y, x_min, y, radius_squared, light_walls);
+  }
+  if (batch.count) {
+    ray_batch_cast(map, out, &batch, pov_x, pov_y, radius_squared, light_walls);
   }
   if (light_walls) {
-    TCOD_map_postprocess(map, pov_x, pov_y, max_radius);
+    TCOD_map_postprocess(map, out, pov_x, pov_y, max_radius);
   }
   return TCOD_E_OK;
 }
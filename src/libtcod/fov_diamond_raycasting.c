@@ -59,7 +59,7 @@ static int ray_length_sq(const RaycastTile* __restrict ray) {
     The diamond raycast state.
  */
 typedef struct DiamondFov {
-  TCOD_Map* __restrict const map;
+  const TCOD_Map* __restrict const map;
   const int pov_x, pov_y;  // Fov origin point, the POV.
   RaycastTile* __restrict const raymap_grid;  // Grid of temporary rays.
   RaycastTile* perimeter_last;  // Pointer to the last tile on the perimeter.
@@ -149,8 +149,6 @@ static void merge_input(const DiamondFov* __restrict fov, RaycastTile* __restric
   const TCOD_Map* map = fov->map;
   const int x = ray->x_relative + fov->pov_x;
   const int y = ray->y_relative + fov->pov_y;
-  const int ray_index = x + y * map->width;
-
   if (ray->x_input) {
     process_x_input(ray, ray->x_input);
   }
@@ -168,7 +166,7 @@ static void merge_input(const DiamondFov* __restrict fov, RaycastTile* __restric
   } else if (is_obscured(ray->x_input) && is_obscured(ray->y_input)) {
     ray->ignore = true;
   }
-  if (!ray->ignore && !map->cells[ray_index].transparent) {
+  if (!ray->ignore && !TCOD_map_get_transparent_(map, x, y)) {
     ray->x_error = ray->x_obscurity = TCOD_ABS(ray->x_relative);
     ray->y_error = ray->y_obscurity = TCOD_ABS(ray->y_relative);
   }
@@ -194,14 +192,15 @@ static void expand_perimeter_from(DiamondFov* __restrict fov, const RaycastTile*
   }
 }
 TCOD_Error TCOD_map_compute_fov_diamond_raycasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls) {
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls) {
   const int radius_squared = max_radius * max_radius;
 
   if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
     TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
     return TCOD_E_INVALID_ARGUMENT;
   }
-  map->cells[pov_x + pov_y * map->width].fov = true;
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
 
   DiamondFov fov = {
       .map = map,
@@ -242,11 +241,11 @@ TCOD_Error TCOD_map_compute_fov_diamond_raycasting(
     }
     const int map_x = pov_x + current_ray->x_relative;
     const int map_y = pov_y + current_ray->y_relative;
-    map->cells[map_x + map_y * map->width].fov = true;
+    TCOD_fov_output_set_(out, map_x, map_y, true);
   }
   free(fov.raymap_grid);
   if (light_walls) {
-    TCOD_map_postprocess(map, pov_x, pov_y, max_radius);
+    TCOD_map_postprocess(map, out, pov_x, pov_y, max_radius);
   }
   return TCOD_E_OK;
 }
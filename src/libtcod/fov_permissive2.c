@@ -102,13 +102,13 @@ static void view_array_insert(ActiveViewArray* view_array, ptrdiff_t index, View
 static View** view_array_end(const ActiveViewArray* view_array) { return view_array->view_ptrs + view_array->count; }
 
 /// @brief Set a maps FOV-bit and return true if the tile is blocked.
-static bool is_blocked(TCOD_Map* map, int pov_x, int pov_y, int x, int y, int dx, int dy, bool light_walls) {
+static bool is_blocked(
+    const TCOD_Map* map, TCOD_FovOutput* out, int pov_x, int pov_y, int x, int y, int dx, int dy, bool light_walls) {
   const int pos_x = x * dx / STEP_SIZE + pov_x;
   const int pos_y = y * dy / STEP_SIZE + pov_y;
-  const int cells_offset = pos_x + pos_y * map->width;
-  const bool blocked = !map->cells[cells_offset].transparent;
+  const bool blocked = !TCOD_map_get_transparent_(map, pos_x, pos_y);
   if (!blocked || light_walls) {
-    map->cells[cells_offset].fov = 1;
+    TCOD_fov_output_set_(out, pos_x, pos_y, true);
   }
   return blocked;
 }
@@ -163,7 +163,8 @@ static bool check_view(ActiveViewArray* active_views, View** it, int offset, int
 }
 
 static void visit_coords(
-    TCOD_Map* __restrict map,
+    const TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
     int pov_x,
     int pov_y,
     int x,
@@ -194,7 +195,7 @@ static void visit_coords(
   if (*current_view == view_array_end(active_views) || ABOVE_OR_COLINEAR(&view->shallow_line, tlx, tly)) {
     return; /* no more active view */
   }
-  if (!is_blocked(map, pov_x, pov_y, x, y, dx, dy, light_walls)) {
+  if (!is_blocked(map, out, pov_x, pov_y, x, y, dx, dy, light_walls)) {
     return;
   }
   if (ABOVE(&view->shallow_line, brx, bry) && BELOW(&view->steep_line, tlx, tly)) {
@@ -233,7 +234,8 @@ static void visit_coords(
 }
 
 static void check_quadrant(
-    TCOD_Map* __restrict map,
+    const TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
     int pov_x,
     int pov_y,
     int dx,
@@ -274,13 +276,14 @@ static void check_quadrant(
       const int x = (i - j) * STEP_SIZE;
       const int y = j * STEP_SIZE;
       visit_coords(
-          map, pov_x, pov_y, x, y, dx, dy, active_views, &current_view, light_walls, offset, limit, views, bumps);
+          map, out, pov_x, pov_y, x, y, dx, dy, active_views, &current_view, light_walls, offset, limit, views, bumps);
     }
   }
 }
 
 TCOD_Error TCOD_map_compute_fov_permissive2(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls, int permissiveness) {
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls, int permissiveness) {
   if (!(0 <= permissiveness && permissiveness <= 8)) {
     TCOD_set_errorvf("Bad permissiveness %d for FOV_PERMISSIVE. Accepted range is [0,8].", permissiveness);
     return TCOD_E_INVALID_ARGUMENT;
@@ -294,7 +297,7 @@ TCOD_Error TCOD_map_compute_fov_permissive2(
     TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
     return TCOD_E_INVALID_ARGUMENT;
   }
-  map->cells[pov_x + pov_y * map->width].fov = 1;
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
 
   // Preallocate views and bumps, assuming there will be no more bumps or active views than the number of map tiles.
   View* views = malloc(map->width * map->height * sizeof(*views));
@@ -319,10 +322,24 @@ TCOD_Error TCOD_map_compute_fov_permissive2(
     max_y = TCOD_MIN(max_y, max_radius);
   }
   /* calculate fov. precise permissive field of view */
-  check_quadrant(map, pov_x, pov_y, 1, 1, max_x, max_y, light_walls, offset, limit, views, &bumps, &active_views);
-  check_quadrant(map, pov_x, pov_y, 1, -1, max_x, min_y, light_walls, offset, limit, views, &bumps, &active_views);
-  check_quadrant(map, pov_x, pov_y, -1, -1, min_x, min_y, light_walls, offset, limit, views, &bumps, &active_views);
-  check_quadrant(map, pov_x, pov_y, -1, 1, min_x, max_y, light_walls, offset, limit, views, &bumps, &active_views);
+  check_quadrant(map, out, pov_x, pov_y, 1, 1, max_x, max_y, light_walls, offset, limit, views, &bumps, &active_views);
+  check_quadrant(map, out, pov_x, pov_y, 1, -1, max_x, min_y, light_walls, offset, limit, views, &bumps, &active_views);
+  check_quadrant(
+      map,
+      out,
+      pov_x,
+      pov_y,
+      -1,
+      -1,
+      min_x,
+      min_y,
+      light_walls,
+      offset,
+      limit,
+      views,
+      &bumps,
+      &active_views);
+  check_quadrant(map, out, pov_x, pov_y, -1, 1, min_x, max_y, light_walls, offset, limit, views, &bumps, &active_views);
   free(bumps.data);
   free(views);
   free(active_views.view_ptrs);
@@ -31,6 +31,7 @@
  */
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -56,7 +57,8 @@ static const int matrix_table[8][4] = {
     Cast visiblity using shadowcasting.
  */
 static void cast_light(
-    struct TCOD_Map* __restrict map,
+    const struct TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
     int pov_x,
     int pov_y,
     int distance,  // Polar distance from POV.
@@ -79,6 +81,13 @@ static void cast_light(
   if (!TCOD_map_in_bounds(map, pov_x + distance * xy, pov_y + distance * yy)) {
     return;  // Distance is out-of-bounds.
   }
+  // Octants which scan along a row of a bit-packed map load each word of the row once.
+  const uint64_t* row_bits = NULL;
+  if (map->transparent_bits && yx == 0) {
+    row_bits = &map->transparent_bits[TCOD_map_bits_index_(map, 0, pov_y + distance * yy)];
+  }
+  ptrdiff_t word_index = -1;
+  uint64_t word = 0;
   bool prev_tile_blocked = false;
   for (int angle = distance; angle >= 0; --angle) {  // Polar angle coordinates from high to low.
     const float tile_slope_high = (angle + 0.5f) / (distance - 0.5f);
@@ -95,40 +104,79 @@ static void cast_light(
     if (!TCOD_map_in_bounds(map, map_x, map_y)) {
       continue;  // Angle is out-of-bounds.
     }
-    const int map_index = map_x + map_y * map->width;
-    if (angle * angle + distance * distance <= radius_squared && (light_walls || map->cells[map_index].transparent)) {
-      map->cells[map_index].fov = true;
+    bool is_transparent;
+    if (row_bits) {
+      if (map_x >> 6 != word_index) {
+        word_index = map_x >> 6;
+        word = row_bits[word_index];
+      }
+      TCOD_fov_output_record_read_(out, map_x, map_y);
+      is_transparent = (word >> (map_x & 63)) & 1;
+    } else {
+      is_transparent = TCOD_fov_output_read_transparent_(map, out, map_x, map_y);
+    }
+    if (angle * angle + distance * distance <= radius_squared && (light_walls || is_transparent)) {
+      TCOD_fov_output_set_(out, map_x, map_y, true);
     }
-    if (prev_tile_blocked && map->cells[map_index].transparent) {  // Wall -> floor.
+    if (prev_tile_blocked && is_transparent) {  // Wall -> floor.
       view_slope_high = prev_tile_slope_low;  // Reduce the view size.
     }
-    if (!prev_tile_blocked && !map->cells[map_index].transparent) {  // Floor -> wall.
+    if (!prev_tile_blocked && !is_transparent) {  // Floor -> wall.
       // Get the last sequence of floors as a view and recurse into them.
-      cast_light(map, pov_x, pov_y, distance + 1, view_slope_high, tile_slope_high, max_radius, octant, light_walls);
+      cast_light(
+          map,
+          out,
+          pov_x,
+          pov_y,
+          distance + 1,
+          view_slope_high,
+          tile_slope_high,
+          max_radius,
+          octant,
+          light_walls);
     }
-    prev_tile_blocked = !map->cells[map_index].transparent;
+    prev_tile_blocked = !is_transparent;
   }
   if (!prev_tile_blocked) {
     // Tail-recurse into the current view.
-    cast_light(map, pov_x, pov_y, distance + 1, view_slope_high, view_slope_low, max_radius, octant, light_walls);
+    cast_light(map, out, pov_x, pov_y, distance + 1, view_slope_high, view_slope_low, max_radius, octant, light_walls);
   }
 }
 
+/**
+    Return the radius to use for `max_radius`, replacing zero with a radius which covers the whole map.
+ */
+static int effective_radius(const struct TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius) {
+  if (max_radius > 0) {
+    return max_radius;
+  }
+  int max_radius_x = TCOD_MAX(map->width - pov_x, pov_x);
+  int max_radius_y = TCOD_MAX(map->height - pov_y, pov_y);
+  return (int)(sqrt(max_radius_x * max_radius_x + max_radius_y * max_radius_y)) + 1;
+}
 TCOD_Error TCOD_map_compute_fov_recursive_shadowcasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls) {
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls) {
   if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
     TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
     return TCOD_E_INVALID_ARGUMENT;
   }
-  if (max_radius <= 0) {
-    int max_radius_x = TCOD_MAX(map->width - pov_x, pov_x);
-    int max_radius_y = TCOD_MAX(map->height - pov_y, pov_y);
-    max_radius = (int)(sqrt(max_radius_x * max_radius_x + max_radius_y * max_radius_y)) + 1;
-  }
+  max_radius = effective_radius(map, pov_x, pov_y, max_radius);
   /* recursive shadow casting */
   for (int octant = 0; octant < 8; ++octant) {
-    cast_light(map, pov_x, pov_y, 1, 1.0, 0.0, max_radius, octant, light_walls);
+    cast_light(map, out, pov_x, pov_y, 1, 1.0, 0.0, max_radius, octant, light_walls);
+  }
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_map_compute_fov_recursive_shadowcasting_octant_(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls, int octant) {
+  if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
+    TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
+    return TCOD_E_INVALID_ARGUMENT;
   }
-  map->cells[pov_x + pov_y * map->width].fov = 1;
+  cast_light(map, out, pov_x, pov_y, 1, 1.0, 0.0, effective_radius(map, pov_x, pov_y, max_radius), octant, light_walls);
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
   return TCOD_E_OK;
 }
@@ -37,9 +37,16 @@
 #include "fov.h"
 #include "libtcod_int.h"
 #include "utility.h"
+/**
+    Return true if `{x, y}` is a lit transparent cell.  Out-of-bounds cells return false.
+ */
+static bool is_lit_floor(const TCOD_Map* __restrict map, const TCOD_FovOutput* __restrict out, int x, int y) {
+  return TCOD_map_in_bounds(map, x, y) && TCOD_fov_output_get_(out, x, y) && TCOD_map_get_transparent_(map, x, y);
+}
 
 static void compute_quadrant(
-    TCOD_Map* __restrict map,
+    const TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
     int pov_x,
     int pov_y,
     int max_radius,
@@ -73,7 +80,7 @@ static void compute_quadrant(
       int maxx = TCOD_MIN(map->width - 1, pov_x + iteration);
       done = true;
       for (x = pov_x + (processed_cell * dx); x >= minx && x <= maxx; x += dx) {
-        int c = x + (y * map->width);
+        const bool is_transparent = TCOD_map_get_transparent_(map, x, y);
         /* calculate slopes per cell */
         bool visible = true;
         bool extended = false;
@@ -81,14 +88,13 @@ static void compute_quadrant(
         double start_slope = centre_slope - half_slopes;
         double end_slope = centre_slope + half_slopes;
         if (obstacles_in_last_line > 0) {
-          if (!(map->cells[c - (map->width * dy)].fov && map->cells[c - (map->width * dy)].transparent) &&
-              !(map->cells[c - (map->width * dy) - dx].fov && map->cells[c - (map->width * dy) - dx].transparent)) {
+          if (!is_lit_floor(map, out, x, y - dy) && !is_lit_floor(map, out, x - dx, y - dy)) {
             visible = false;
           } else {
             int idx;
             for (idx = 0; idx < obstacles_in_last_line && visible; ++idx) {
               if (start_slope <= end_angle[idx] && end_slope >= start_angle[idx]) {
-                if (map->cells[c].transparent) {
+                if (is_transparent) {
                   if (centre_slope > start_angle[idx] && centre_slope < end_angle[idx]) {
                     visible = false;
                   }
@@ -107,9 +113,9 @@ static void compute_quadrant(
         }
         if (visible) {
           done = false;
-          map->cells[c].fov = true;
+          TCOD_fov_output_set_(out, x, y, true);
           /* if the cell is opaque, block the adjacent slopes */
-          if (!map->cells[c].transparent) {
+          if (!is_transparent) {
             if (min_angle >= start_slope) {
               min_angle = end_slope;
               /* if min_angle is applied to the last cell in line, nothing more
@@ -122,7 +128,7 @@ static void compute_quadrant(
               end_angle[total_obstacles++] = end_slope;
             }
             if (!light_walls) {
-              map->cells[c].fov = false;
+              TCOD_fov_output_set_(out, x, y, false);
             }
           }
         }
@@ -165,7 +171,7 @@ static void compute_quadrant(
       int maxy = TCOD_MIN(map->height - 1, pov_y + iteration);
       done = true;
       for (y = pov_y + (processed_cell * dy); y >= miny && y <= maxy; y += dy) {
-        int c = x + (y * map->width);
+        const bool is_transparent = TCOD_map_get_transparent_(map, x, y);
         /* calculate slopes per cell */
         bool visible = true;
         bool extended = false;
@@ -173,14 +179,13 @@ static void compute_quadrant(
         double start_slope = centre_slope - half_slopes;
         double end_slope = centre_slope + half_slopes;
         if (obstacles_in_last_line > 0) {
-          if (!(map->cells[c - dx].fov && map->cells[c - dx].transparent) &&
-              !(map->cells[c - (map->width * dy) - dx].fov && map->cells[c - (map->width * dy) - dx].transparent)) {
+          if (!is_lit_floor(map, out, x - dx, y) && !is_lit_floor(map, out, x - dx, y - dy)) {
             visible = false;
           } else {
             int idx;
             for (idx = 0; idx < obstacles_in_last_line && visible; ++idx) {
               if (start_slope <= end_angle[idx] && end_slope >= start_angle[idx]) {
-                if (map->cells[c].transparent) {
+                if (is_transparent) {
                   if (centre_slope > start_angle[idx] && centre_slope < end_angle[idx]) {
                     visible = false;
                   }
@@ -200,9 +205,9 @@ static void compute_quadrant(
         }
         if (visible) {
           done = false;
-          map->cells[c].fov = true;
+          TCOD_fov_output_set_(out, x, y, true);
           /* if the cell is opaque, block the adjacent slopes */
-          if (!map->cells[c].transparent) {
+          if (!is_transparent) {
             if (min_angle >= start_slope) {
               min_angle = end_slope;
               /* if min_angle is applied to the last cell in line, nothing more
@@ -215,7 +220,7 @@ static void compute_quadrant(
               end_angle[total_obstacles++] = end_slope;
             }
             if (!light_walls) {
-              map->cells[c].fov = false;
+              TCOD_fov_output_set_(out, x, y, false);
             }
           }
         }
@@ -235,13 +240,14 @@ static void compute_quadrant(
 }
 
 TCOD_Error TCOD_map_compute_fov_restrictive_shadowcasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls) {
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls) {
   if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
     TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
     return TCOD_E_INVALID_ARGUMENT;
   }
   /* set PC's position as visible */
-  map->cells[pov_x + (pov_y * map->width)].fov = true;
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
 
   /* calculate an approximated (excessive, just in case) maximum number of obstacles per octant */
   const int max_obstacles = map->nbcells / 7;
@@ -254,10 +260,10 @@ TCOD_Error TCOD_map_compute_fov_restrictive_shadowcasting(
     return TCOD_E_OUT_OF_MEMORY;
   }
   /* compute the 4 quadrants of the map */
-  compute_quadrant(map, pov_x, pov_y, max_radius, light_walls, 1, 1, start_angle, end_angle);
-  compute_quadrant(map, pov_x, pov_y, max_radius, light_walls, 1, -1, start_angle, end_angle);
-  compute_quadrant(map, pov_x, pov_y, max_radius, light_walls, -1, 1, start_angle, end_angle);
-  compute_quadrant(map, pov_x, pov_y, max_radius, light_walls, -1, -1, start_angle, end_angle);
+  compute_quadrant(map, out, pov_x, pov_y, max_radius, light_walls, 1, 1, start_angle, end_angle);
+  compute_quadrant(map, out, pov_x, pov_y, max_radius, light_walls, 1, -1, start_angle, end_angle);
+  compute_quadrant(map, out, pov_x, pov_y, max_radius, light_walls, -1, 1, start_angle, end_angle);
+  compute_quadrant(map, out, pov_x, pov_y, max_radius, light_walls, -1, -1, start_angle, end_angle);
 
   free(end_angle);
   free(start_angle);
@@ -0,0 +1,224 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "bresenham.h"
+#include "fov.h"
+#include "libtcod_int.h"
+#include "utility.h"
+/**
+    The cells shadowed by one opaque cell, as row masks of the window.
+ */
+typedef struct ShadowCaster {
+  uint8_t row_begin;  // The first window row with shadowed cells.
+  uint8_t row_count;  // The number of rows from `row_begin`, zero if this cell shadows nothing.
+  uint32_t pool_index;  // Where the row masks begin in the tables pool.
+} ShadowCaster;
+/**
+    The precomputed shadows for one radius.
+
+    Cells are addressed in a square window of `side * side` cells centered on the point of view.
+    Bit `dx + radius` of row `dy + radius` is the cell at offset `{dx, dy}`.
+    A cell is in the shadow of an opaque cell if that cell is on the Bresenham line from the point of view to it.
+ */
+typedef struct ShadowTable {
+  int radius;
+  int side;  // The width and height of the window.
+  uint64_t in_range[FOV_SHADOW_TABLE_MAX_RADIUS * 2 + 1];  // The cells of each row within `radius`.
+  ShadowCaster* casters;  // The shadow of each cell of the window, row-major.
+  uint64_t* pool;  // The row masks of every shadow.
+} ShadowTable;
+/**
+    Return the index of the lowest set bit of `n`, which must not be zero.
+ */
+static int lowest_bit(uint64_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(n);
+#elif defined(_MSC_VER) && defined(_WIN64)
+  unsigned long index;
+  _BitScanForward64(&index, n);
+  return (int)index;
+#else
+  int index = 0;
+  while (!(n & 1)) {
+    n >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+/// Lazily built tables for each radius, guarded by TCOD_parallel_lock_.
+static ShadowTable* shadow_tables_[FOV_SHADOW_TABLE_MAX_RADIUS + 1];
+/**
+    Free a shadow table.
+ */
+static void shadow_table_delete(ShadowTable* table) {
+  if (!table) return;
+  free(table->casters);
+  free(table->pool);
+  free(table);
+}
+/**
+    Build the shadow table for `radius`, returns NULL if memory could not be allocated.
+ */
+static ShadowTable* shadow_table_new(int radius) {
+  ShadowTable* table = calloc(1, sizeof(*table));
+  if (!table) return NULL;
+  table->radius = radius;
+  table->side = radius * 2 + 1;
+  const int side = table->side;
+  const int radius_squared = radius * radius;
+  // Collect every shadow as whole window masks first, then keep only the rows which are used.
+  uint64_t* shadows = calloc((size_t)side * side * side, sizeof(*shadows));
+  table->casters = calloc((size_t)side * side, sizeof(*table->casters));
+  if (!shadows || !table->casters) {
+    free(shadows);
+    shadow_table_delete(table);
+    return NULL;
+  }
+  for (int dy = -radius; dy <= radius; ++dy) {
+    for (int dx = -radius; dx <= radius; ++dx) {
+      if (dx * dx + dy * dy > radius_squared) continue;
+      table->in_range[dy + radius] |= (uint64_t)1 << (dx + radius);
+      if (dx == 0 && dy == 0) continue;
+      TCOD_bresenham_data_t bresenham;
+      TCOD_line_init_mt(0, 0, dx, dy, &bresenham);
+      int x;
+      int y;
+      while (!TCOD_line_step_mt(&x, &y, &bresenham) && (x != dx || y != dy)) {
+        const int caster = (y + radius) * side + (x + radius);
+        shadows[(size_t)caster * side + (dy + radius)] |= (uint64_t)1 << (dx + radius);
+      }
+    }
+  }
+  size_t pool_used = 0;
+  for (int caster = 0; caster < side * side; ++caster) {
+    const uint64_t* rows = &shadows[(size_t)caster * side];
+    int begin = 0;
+    int end = side;
+    while (begin < end && !rows[begin]) ++begin;
+    while (end > begin && !rows[end - 1]) --end;
+    table->casters[caster] = (ShadowCaster){(uint8_t)begin, (uint8_t)(end - begin), (uint32_t)pool_used};
+    pool_used += end - begin;
+  }
+  table->pool = malloc(sizeof(*table->pool) * TCOD_MAX(pool_used, 1));
+  if (!table->pool) {
+    free(shadows);
+    shadow_table_delete(table);
+    return NULL;
+  }
+  for (int caster = 0; caster < side * side; ++caster) {
+    const ShadowCaster* shadow = &table->casters[caster];
+    memcpy(
+        &table->pool[shadow->pool_index],
+        &shadows[(size_t)caster * side + shadow->row_begin],
+        sizeof(*table->pool) * shadow->row_count);
+  }
+  free(shadows);
+  return table;
+}
+/**
+    Return the shared shadow table for `radius`, building it if needed.
+ */
+static const ShadowTable* get_shadow_table(int radius) {
+  TCOD_parallel_lock_();
+  if (!shadow_tables_[radius]) {
+    shadow_tables_[radius] = shadow_table_new(radius);
+  }
+  const ShadowTable* table = shadow_tables_[radius];
+  TCOD_parallel_unlock_();
+  return table;
+}
+void TCOD_fov_shadow_tables_free_(void) {
+  TCOD_parallel_lock_();
+  for (int i = 0; i <= FOV_SHADOW_TABLE_MAX_RADIUS; ++i) {
+    shadow_table_delete(shadow_tables_[i]);
+    shadow_tables_[i] = NULL;
+  }
+  TCOD_parallel_unlock_();
+}
+TCOD_Error TCOD_map_compute_fov_shadow_table(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls) {
+  if (!TCOD_map_in_bounds(map, pov_x, pov_y)) {
+    TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (max_radius < 1 || max_radius > FOV_SHADOW_TABLE_MAX_RADIUS) {
+    TCOD_set_errorvf(
+        "FOV_SHADOW_TABLE requires a max_radius between 1 and %i, got %i.", FOV_SHADOW_TABLE_MAX_RADIUS, max_radius);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  const ShadowTable* table = get_shadow_table(max_radius);
+  if (!table) {
+    TCOD_set_errorv("Out of memory.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  // Propagate the shadow of every opaque cell around the point of view into one bitset of the window.
+  // Cells outside of the map are left out, lines to cells within the map never leave it.
+  uint64_t shadow[FOV_SHADOW_TABLE_MAX_RADIUS * 2 + 1] = {0};
+  uint64_t lit[FOV_SHADOW_TABLE_MAX_RADIUS * 2 + 1] = {0};  // Cells which are lit when not in shadow.
+  const int x_min = TCOD_MAX(pov_x - max_radius, 0);
+  const int x_max = TCOD_MIN(pov_x + max_radius + 1, map->width);
+  const int y_min = TCOD_MAX(pov_y - max_radius, 0);
+  const int y_max = TCOD_MIN(pov_y + max_radius + 1, map->height);
+  for (int y = y_min; y < y_max; ++y) {
+    const int row = y - pov_y + max_radius;
+    for (int x = x_min; x < x_max; ++x) {
+      const int column = x - pov_x + max_radius;
+      if (TCOD_map_get_transparent_(map, x, y)) {
+        lit[row] |= (uint64_t)1 << column;
+        continue;
+      }
+      if (light_walls) lit[row] |= (uint64_t)1 << column;
+      const ShadowCaster* caster = &table->casters[row * table->side + column];
+      const uint64_t* __restrict masks = &table->pool[caster->pool_index];
+      uint64_t* __restrict shadow_rows = &shadow[caster->row_begin];
+      for (int i = 0; i < caster->row_count; ++i) {
+        shadow_rows[i] |= masks[i];
+      }
+    }
+  }
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
+  for (int y = y_min; y < y_max; ++y) {
+    const int row = y - pov_y + max_radius;
+    for (uint64_t visible = table->in_range[row] & lit[row] & ~shadow[row]; visible; visible &= visible - 1) {
+      TCOD_fov_output_set_(out, pov_x - max_radius + lowest_bit(visible), y, true);
+    }
+  }
+  return TCOD_E_OK;
+}
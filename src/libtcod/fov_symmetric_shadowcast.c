@@ -40,6 +40,7 @@
 
 #include "fov.h"
 #include "libtcod_int.h"
+#include "utility.h"
 /**
     Quadrant transformation matrixes.
 
@@ -58,6 +59,7 @@ typedef struct Row {
   const int pov_x;  // The origin point-of-view.
   const int pov_y;
   const int quadrant;  // The quadrant index.
+  const int max_depth;  // Rows at or past this depth are outside of the radius, or zero for no limit.
   int depth;  // The depth of this row.
   float slope_low;
   const float slope_high;
@@ -91,7 +93,7 @@ static int round_half_down(float n) { return (int)roundf(n * (1 - FLT_EPSILON));
 
     If you think of each quadrant as a tree of rows, this essentially is a depth-first tree traversal.
  */
-static void scan(TCOD_Map* __restrict map, Row* __restrict row) {
+static void scan(const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, Row* __restrict row) {
   const int xx = quadrant_table[row->quadrant][0];
   const int xy = quadrant_table[row->quadrant][1];
   const int yx = quadrant_table[row->quadrant][2];
@@ -99,6 +101,9 @@ static void scan(TCOD_Map* __restrict map, Row* __restrict row) {
   if (!TCOD_map_in_bounds(map, row->pov_x + row->depth * xx, row->pov_y + row->depth * yx)) {
     return;  // Row->depth is out-of-bounds.
   }
+  if (row->max_depth > 0 && row->depth >= row->max_depth) {
+    return;  // Every tile of this row would be trimmed by the radius.
+  }
   const int column_min = round_half_up(row->depth * row->slope_low);
   const int column_max = round_half_down(row->depth * row->slope_high);
   bool prev_tile_is_wall = false;
@@ -108,10 +113,9 @@ static void scan(TCOD_Map* __restrict map, Row* __restrict row) {
     if (!TCOD_map_in_bounds(map, map_x, map_y)) {
       continue;  // Tile is out-of-bounds.
     }
-    struct TCOD_MapCell* map_cell = &map->cells[map_x + map_y * map->width];
-    const bool is_wall = !map_cell->transparent;
+    const bool is_wall = !TCOD_fov_output_read_transparent_(map, out, map_x, map_y);
     if (is_wall || is_symmetric(row, column)) {
-      map_cell->fov = true;
+      TCOD_fov_output_set_(out, map_x, map_y, true);
     }
     if (prev_tile_is_wall && !is_wall) {  // Floor tile to wall tile.
       row->slope_low = slope(row->depth, column);  // Shrink the view.
@@ -122,23 +126,114 @@ static void scan(TCOD_Map* __restrict map, Row* __restrict row) {
           .pov_x = row->pov_x,
           .pov_y = row->pov_y,
           .quadrant = row->quadrant,
+          .max_depth = row->max_depth,
           .depth = row->depth + 1,
           .slope_low = row->slope_low,
           .slope_high = slope(row->depth, column),
       };
-      scan(map, &next_row);
+      scan(map, out, &next_row);
     }
     prev_tile_is_wall = is_wall;
   }
   if (!prev_tile_is_wall) {
     // Tail recuse into the next row.
     row->depth += 1;
-    scan(map, row);
+    scan(map, out, row);
+  }
+}
+/**
+    Return a mask of the bits in word `word_x` which are within `[x_min, x_max)`.
+ */
+static uint64_t span_mask(int word_x, int x_min, int x_max) {
+  const int begin = TCOD_CLAMP(0, 64, x_min - word_x * 64);
+  const int end = TCOD_CLAMP(0, 64, x_max - word_x * 64);
+  if (begin >= end) {
+    return 0;
+  }
+  const uint64_t upper = end == 64 ? ~(uint64_t)0 : (((uint64_t)1 << end) - 1);
+  return upper & ~(((uint64_t)1 << begin) - 1);
+}
+/**
+    Return the transparency of 64 cells starting at `{word_x * 64, y}` as a bit-plane word.
+ */
+static uint64_t get_transparent_word(const TCOD_Map* __restrict map, int word_x, int y) {
+  if (map->transparent_bits) {
+    return map->transparent_bits[(ptrdiff_t)word_x + (ptrdiff_t)y * map->bits_stride];
+  }
+  uint64_t word = 0;
+  const int x_end = TCOD_MIN(map->width, word_x * 64 + 64);
+  for (int x = word_x * 64; x < x_end; ++x) {
+    word |= (uint64_t)TCOD_map_get_transparent_(map, x, y) << (x & 63);
+  }
+  return word;
+}
+/**
+    Remove walls when `light_walls` is false and remove cells outside of `max_radius`.
+
+    Bit-plane outputs are trimmed one 64-bit word at a time.
+ */
+static void trim_fov(
+    const TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
+    int pov_x,
+    int pov_y,
+    int max_radius,
+    bool light_walls) {
+  // Scanning stops at the radius, so nothing outside of this box has been set.
+  int box_x_min = 0;
+  int box_y_min = 0;
+  int box_x_max = map->width;
+  int box_y_max = map->height;
+  if (max_radius > 0) {
+    box_x_min = TCOD_MAX(box_x_min, pov_x - max_radius + 1);
+    box_y_min = TCOD_MAX(box_y_min, pov_y - max_radius + 1);
+    box_x_max = TCOD_MIN(box_x_max, pov_x + max_radius);
+    box_y_max = TCOD_MIN(box_y_max, pov_y + max_radius);
+  }
+  const int radius_squared = max_radius * max_radius;
+  for (int y = box_y_min; y < box_y_max; ++y) {
+    int x_min = 0;  // The span of this row within the radius.
+    int x_max = map->width;
+    if (max_radius > 0) {
+      const int dy = y - pov_y;
+      const int remaining = radius_squared - 1 - dy * dy;  // dx * dx must be <= this.
+      if (remaining < 0) {
+        x_max = 0;
+      } else {
+        int dx_max = (int)sqrtf((float)remaining);
+        while (dx_max * dx_max > remaining) --dx_max;
+        while ((dx_max + 1) * (dx_max + 1) <= remaining) ++dx_max;
+        x_min = TCOD_MAX(0, pov_x - dx_max);
+        x_max = TCOD_MIN(map->width, pov_x + dx_max + 1);
+      }
+    }
+    if (out->bits && out->x_offset == 0) {  // Output words line up with the words of the map.
+      uint64_t* __restrict fov_row = out->bits + (ptrdiff_t)(y - out->y_offset) * out->bits_stride;
+      for (int i = box_x_min / 64; i <= (box_x_max - 1) / 64; ++i) {
+        uint64_t keep = span_mask(i, x_min, x_max);
+        if (keep && !light_walls) {
+          keep &= get_transparent_word(map, i, y);
+        }
+        fov_row[i] &= keep;
+      }
+      continue;
+    }
+    for (int x = box_x_min; x < box_x_max; ++x) {
+      if (x < x_min || x >= x_max || (!light_walls && !TCOD_map_get_transparent_(map, x, y))) {
+        TCOD_fov_output_set_(out, x, y, false);
+      }
+    }
   }
 }
 
 TCOD_Error TCOD_map_compute_fov_symmetric_shadowcast(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls) {
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls) {
+  return TCOD_map_compute_fov_symmetric_shadowcast_quadrant_(map, out, pov_x, pov_y, max_radius, light_walls, -1);
+}
+TCOD_Error TCOD_map_compute_fov_symmetric_shadowcast_quadrant_(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls, int quadrant) {
   if (!map) {
     TCOD_set_errorv("Map must not be NULL.");
     return TCOD_E_INVALID_ARGUMENT;
@@ -147,33 +242,20 @@ TCOD_Error TCOD_map_compute_fov_symmetric_shadowcast(
     TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", pov_x, pov_y);
     return TCOD_E_INVALID_ARGUMENT;
   }
-  map->cells[pov_x + pov_y * map->width].fov = true;
-  for (int quadrant = 0; quadrant < 4; ++quadrant) {
+  TCOD_fov_output_set_(out, pov_x, pov_y, true);
+  for (int i = 0; i < 4; ++i) {
+    if (quadrant >= 0 && i != quadrant) continue;
     Row row = {
         .pov_x = pov_x,
         .pov_y = pov_y,
-        .quadrant = quadrant,
+        .quadrant = i,
+        .max_depth = TCOD_MAX(max_radius, 0),
         .depth = 1,
         .slope_low = -1.0f,
         .slope_high = 1.0f,
     };
-    scan(map, &row);
-  }
-  const int radius_squared = max_radius * max_radius;
-  for (int y = 0; y < map->height; ++y) {
-    for (int x = 0; x < map->width; ++x) {
-      int i = x + y * map->width;
-      if (!light_walls && !map->cells[i].transparent) {
-        map->cells[i].fov = false;
-      }
-      if (max_radius > 0) {
-        const int dx = x - pov_x;
-        const int dy = y - pov_y;
-        if (dx * dx + dy * dy >= radius_squared) {
-          map->cells[i].fov = false;
-        }
-      }
-    }
+    scan(map, out, &row);
   }
+  trim_fov(map, out, pov_x, pov_y, max_radius, light_walls);
   return TCOD_E_OK;
 }
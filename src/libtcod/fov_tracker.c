@@ -0,0 +1,388 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fov_tracker.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libtcod_int.h"
+#include "utility.h"
+
+/// The state of one viewer of a TCOD_FovTracker.
+struct FovViewer {
+  bool active;
+  int x;
+  int y;
+  int max_radius;
+  int box_x;  // The region of the map which this viewer can see, all planes cover only this region.
+  int box_y;
+  int box_width;
+  int box_height;
+  int stride;  // The number of 64-bit words per row of each plane.
+  uint32_t dirty_sectors;  // A bit-mask of the sectors which need to be recomputed.
+  uint64_t* visible;  // One visibility plane per sector followed by the combined visibility plane.
+  uint64_t* reads;  // One plane per sector of the cells each sector depends on, or NULL to depend on the whole box.
+  TCOD_Error error;  // The last error from computing this viewer.
+};
+struct TCOD_FovTracker {
+  const TCOD_Map* map;
+  bool light_walls;
+  TCOD_fov_algorithm_t algo;
+  int sectors;  // The number of independently computed sectors of each viewer.
+  int viewers_count;
+  int viewers_capacity;
+  struct FovViewer* viewers;
+};
+/**
+    Return the number of independent sectors which `algo` can be split into.
+ */
+static int sectors_for(TCOD_fov_algorithm_t algo) {
+  switch (algo) {
+    case FOV_SHADOW:
+      return 8;
+    case FOV_SYMMETRIC_SHADOWCAST:
+      return 4;
+    default:
+      return 1;
+  }
+}
+/**
+    Return the number of words in each plane of `viewer`.
+ */
+static ptrdiff_t plane_words(const struct FovViewer* viewer) {
+  return (ptrdiff_t)viewer->stride * viewer->box_height;
+}
+/**
+    Return the combined visibility plane of `viewer`.
+ */
+static uint64_t* combined_plane(const TCOD_FovTracker* tracker, const struct FovViewer* viewer) {
+  return viewer->visible + plane_words(viewer) * tracker->sectors;
+}
+TCOD_FovTracker* TCOD_fov_tracker_new(const TCOD_Map* map, bool light_walls, TCOD_fov_algorithm_t algo) {
+  if (!map) {
+    TCOD_set_errorv("Map must not be NULL.");
+    return NULL;
+  }
+  if (algo < 0 || algo >= NB_FOV_ALGORITHMS) {
+    TCOD_set_errorvf("Unknown FOV algorithm %i.", (int)algo);
+    return NULL;
+  }
+  TCOD_FovTracker* tracker = calloc(1, sizeof(*tracker));
+  if (!tracker) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  tracker->map = map;
+  tracker->light_walls = light_walls;
+  tracker->algo = algo;
+  tracker->sectors = sectors_for(algo);
+  return tracker;
+}
+/**
+    Free the planes of a viewer and mark it as inactive.
+ */
+static void viewer_release(struct FovViewer* viewer) {
+  free(viewer->visible);
+  free(viewer->reads);
+  memset(viewer, 0, sizeof(*viewer));
+}
+void TCOD_fov_tracker_delete(TCOD_FovTracker* tracker) {
+  if (!tracker) {
+    return;
+  }
+  for (int i = 0; i < tracker->viewers_count; ++i) {
+    viewer_release(&tracker->viewers[i]);
+  }
+  free(tracker->viewers);
+  free(tracker);
+}
+/**
+    Place `viewer` at a new position and allocate its planes, marking every sector as dirty.
+ */
+static TCOD_Error viewer_assign(
+    const TCOD_FovTracker* __restrict tracker, struct FovViewer* __restrict viewer, int x, int y, int max_radius) {
+  if (!TCOD_map_in_bounds(tracker->map, x, y)) {
+    TCOD_set_errorvf("Point of view {%i, %i} is out of bounds.", x, y);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  struct FovViewer new_viewer = {0};
+  new_viewer.active = true;
+  new_viewer.x = x;
+  new_viewer.y = y;
+  new_viewer.max_radius = max_radius;
+  new_viewer.box_width = tracker->map->width;
+  new_viewer.box_height = tracker->map->height;
+  if (max_radius > 0) {
+    new_viewer.box_x = TCOD_MAX(x - max_radius, 0);
+    new_viewer.box_y = TCOD_MAX(y - max_radius, 0);
+    new_viewer.box_width = TCOD_MIN(x + max_radius + 1, tracker->map->width) - new_viewer.box_x;
+    new_viewer.box_height = TCOD_MIN(y + max_radius + 1, tracker->map->height) - new_viewer.box_y;
+  }
+  new_viewer.stride = (new_viewer.box_width + 63) / 64;
+  new_viewer.dirty_sectors = (uint32_t)((1ull << tracker->sectors) - 1);
+  const size_t words = (size_t)plane_words(&new_viewer);
+  new_viewer.visible = calloc(words * (tracker->sectors + 1), sizeof(*new_viewer.visible));
+  if (tracker->sectors > 1) {
+    new_viewer.reads = calloc(words * tracker->sectors, sizeof(*new_viewer.reads));
+  }
+  if (!new_viewer.visible || (tracker->sectors > 1 && !new_viewer.reads)) {
+    viewer_release(&new_viewer);
+    TCOD_set_errorv("Out of memory.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  viewer_release(viewer);
+  *viewer = new_viewer;
+  return TCOD_E_OK;
+}
+int TCOD_fov_tracker_add_viewer(TCOD_FovTracker* tracker, int x, int y, int max_radius) {
+  if (!tracker) {
+    TCOD_set_errorv("Tracker must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  int id = 0;
+  while (id < tracker->viewers_count && tracker->viewers[id].active) {
+    ++id;
+  }
+  if (id == tracker->viewers_capacity) {
+    const int new_capacity = tracker->viewers_capacity ? tracker->viewers_capacity * 2 : 8;
+    struct FovViewer* new_viewers = realloc(tracker->viewers, sizeof(*new_viewers) * new_capacity);
+    if (!new_viewers) {
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+    memset(
+        new_viewers + tracker->viewers_capacity,
+        0,
+        sizeof(*new_viewers) * (new_capacity - tracker->viewers_capacity));
+    tracker->viewers = new_viewers;
+    tracker->viewers_capacity = new_capacity;
+  }
+  const TCOD_Error err = viewer_assign(tracker, &tracker->viewers[id], x, y, max_radius);
+  if (err < 0) {
+    return err;
+  }
+  if (id == tracker->viewers_count) {
+    ++tracker->viewers_count;
+  }
+  return id;
+}
+/**
+    Return the active viewer `id` of `tracker`, or NULL.
+ */
+static struct FovViewer* get_viewer(const TCOD_FovTracker* tracker, int id) {
+  if (!tracker || id < 0 || id >= tracker->viewers_count || !tracker->viewers[id].active) {
+    return NULL;
+  }
+  return &tracker->viewers[id];
+}
+TCOD_Error TCOD_fov_tracker_set_viewer(TCOD_FovTracker* tracker, int id, int x, int y, int max_radius) {
+  struct FovViewer* viewer = get_viewer(tracker, id);
+  if (!viewer) {
+    TCOD_set_errorvf("Viewer %i does not exist.", id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  return viewer_assign(tracker, viewer, x, y, max_radius);
+}
+TCOD_Error TCOD_fov_tracker_remove_viewer(TCOD_FovTracker* tracker, int id) {
+  struct FovViewer* viewer = get_viewer(tracker, id);
+  if (!viewer) {
+    TCOD_set_errorvf("Viewer %i does not exist.", id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  viewer_release(viewer);
+  while (tracker->viewers_count > 0 && !tracker->viewers[tracker->viewers_count - 1].active) {
+    --tracker->viewers_count;
+  }
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_fov_tracker_cell_changed(TCOD_FovTracker* tracker, int x, int y) {
+  if (!tracker) {
+    TCOD_set_errorv("Tracker must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!TCOD_map_in_bounds(tracker->map, x, y)) {
+    TCOD_set_errorvf("Cell {%i, %i} is out of bounds.", x, y);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  for (int i = 0; i < tracker->viewers_count; ++i) {
+    struct FovViewer* viewer = &tracker->viewers[i];
+    const int local_x = x - viewer->box_x;
+    const int local_y = y - viewer->box_y;
+    if (!viewer->active || local_x < 0 || local_y < 0 || local_x >= viewer->box_width ||
+        local_y >= viewer->box_height) {
+      continue;
+    }
+    if (!viewer->reads) {
+      viewer->dirty_sectors = 1;
+      continue;
+    }
+    const ptrdiff_t index = (ptrdiff_t)(local_x >> 6) + (ptrdiff_t)local_y * viewer->stride;
+    const uint64_t mask = (uint64_t)1 << (local_x & 63);
+    for (int sector = 0; sector < tracker->sectors; ++sector) {
+      if (viewer->reads[plane_words(viewer) * sector + index] & mask) {
+        viewer->dirty_sectors |= (uint32_t)1 << sector;
+      }
+    }
+  }
+  return TCOD_E_OK;
+}
+/// Shared state of TCOD_fov_tracker_update.
+struct TrackerUpdate {
+  const TCOD_FovTracker* tracker;
+  const int* dirty_ids;  // The viewers to recompute.
+};
+/**
+    Recompute the dirty sectors of one viewer, then rebuild its combined visibility.
+ */
+static void update_viewer(void* userdata, int index, int worker) {
+  (void)worker;
+  const struct TrackerUpdate* update = userdata;
+  const TCOD_FovTracker* tracker = update->tracker;
+  struct FovViewer* viewer = &tracker->viewers[update->dirty_ids[index]];
+  const ptrdiff_t words = plane_words(viewer);
+  viewer->error = TCOD_E_OK;
+  for (int sector = 0; sector < tracker->sectors; ++sector) {
+    if (!(viewer->dirty_sectors & ((uint32_t)1 << sector))) {
+      continue;
+    }
+    TCOD_FovOutput out = TCOD_fov_output_new_(viewer->box_x, viewer->box_y, viewer->box_width, viewer->box_height);
+    out.bits = viewer->visible + words * sector;
+    out.bits_stride = viewer->stride;
+    memset(out.bits, 0, sizeof(*out.bits) * words);
+    if (viewer->reads) {
+      out.reads = viewer->reads + words * sector;
+      memset(out.reads, 0, sizeof(*out.reads) * words);
+    }
+    TCOD_Error err;
+    switch (tracker->algo) {
+      case FOV_SHADOW:
+        err = TCOD_map_compute_fov_recursive_shadowcasting_octant_(
+            tracker->map, &out, viewer->x, viewer->y, viewer->max_radius, tracker->light_walls, sector);
+        break;
+      case FOV_SYMMETRIC_SHADOWCAST:
+        err = TCOD_map_compute_fov_symmetric_shadowcast_quadrant_(
+            tracker->map, &out, viewer->x, viewer->y, viewer->max_radius, tracker->light_walls, sector);
+        break;
+      default:
+        err = TCOD_map_compute_fov_to_output_(
+            tracker->map, &out, viewer->x, viewer->y, viewer->max_radius, tracker->light_walls, tracker->algo);
+        break;
+    }
+    if (err < 0) {
+      viewer->error = err;
+    }
+  }
+  viewer->dirty_sectors = 0;
+  uint64_t* __restrict combined = combined_plane(tracker, viewer);
+  memcpy(combined, viewer->visible, sizeof(*combined) * words);
+  for (int sector = 1; sector < tracker->sectors; ++sector) {
+    const uint64_t* __restrict plane = viewer->visible + words * sector;
+    for (ptrdiff_t i = 0; i < words; ++i) {
+      combined[i] |= plane[i];
+    }
+  }
+}
+int TCOD_fov_tracker_update(TCOD_FovTracker* tracker) {
+  if (!tracker) {
+    TCOD_set_errorv("Tracker must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  int* dirty_ids = malloc(sizeof(*dirty_ids) * (tracker->viewers_count + 1));
+  if (!dirty_ids) {
+    TCOD_set_errorv("Out of memory.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  int dirty_count = 0;
+  int sectors_updated = 0;
+  for (int i = 0; i < tracker->viewers_count; ++i) {
+    const struct FovViewer* viewer = &tracker->viewers[i];
+    if (!viewer->active || !viewer->dirty_sectors) {
+      continue;
+    }
+    dirty_ids[dirty_count++] = i;
+    for (int sector = 0; sector < tracker->sectors; ++sector) {
+      sectors_updated += (viewer->dirty_sectors >> sector) & 1;
+    }
+  }
+  struct TrackerUpdate update = {tracker, dirty_ids};
+  TCOD_parallel_for_(dirty_count, TCOD_parallel_worker_count_(dirty_count), update_viewer, &update);
+  TCOD_Error err = TCOD_E_OK;
+  for (int i = 0; i < dirty_count; ++i) {
+    if (tracker->viewers[dirty_ids[i]].error < 0) {
+      err = tracker->viewers[dirty_ids[i]].error;
+    }
+  }
+  free(dirty_ids);
+  if (err < 0) {
+    TCOD_set_errorv("Failed to compute the field-of-view of a viewer.");
+    return err;
+  }
+  return sectors_updated;
+}
+bool TCOD_fov_tracker_is_in_fov(const TCOD_FovTracker* tracker, int id, int x, int y) {
+  const struct FovViewer* viewer = get_viewer(tracker, id);
+  if (!viewer) {
+    return false;
+  }
+  const int local_x = x - viewer->box_x;
+  const int local_y = y - viewer->box_y;
+  if (local_x < 0 || local_y < 0 || local_x >= viewer->box_width || local_y >= viewer->box_height) {
+    return false;
+  }
+  const uint64_t word =
+      combined_plane(tracker, viewer)[(ptrdiff_t)(local_x >> 6) + (ptrdiff_t)local_y * viewer->stride];
+  return (word >> (local_x & 63)) & 1;
+}
+bool TCOD_fov_tracker_viewer_dirty_(const TCOD_FovTracker* tracker, int id) {
+  const struct FovViewer* viewer = get_viewer(tracker, id);
+  return viewer && viewer->dirty_sectors;
+}
+const uint64_t* TCOD_fov_tracker_viewer_plane_(
+    const TCOD_FovTracker* tracker,
+    int id,
+    int* __restrict box_x,
+    int* __restrict box_y,
+    int* __restrict box_width,
+    int* __restrict box_height,
+    int* __restrict stride) {
+  const struct FovViewer* viewer = get_viewer(tracker, id);
+  if (!viewer) {
+    return NULL;
+  }
+  *box_x = viewer->box_x;
+  *box_y = viewer->box_y;
+  *box_width = viewer->box_width;
+  *box_height = viewer->box_height;
+  *stride = viewer->stride;
+  return combined_plane(tracker, viewer);
+}
@@ -0,0 +1,137 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file fov_tracker.h
+/// Incremental field-of-view for many viewers.
+#pragma once
+#ifndef TCOD_FOV_TRACKER_H_
+#define TCOD_FOV_TRACKER_H_
+
+#include <stdbool.h>
+
+#include "config.h"
+#include "error.h"
+#include "fov_types.h"
+
+/**
+    @brief Tracks the field-of-view of many viewers on one map, recomputing only what a map change affects.
+
+    Each viewer remembers which cells its field-of-view depends on.
+    When a cell changes transparency only the viewers which depended on that cell are recomputed.
+    FOV_SHADOW and FOV_SYMMETRIC_SHADOWCAST go further and only recompute the octants or quadrants which depended
+    on the cell, other algorithms recompute the whole viewer whenever a cell within its radius changes.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_FovTracker TCOD_FovTracker;
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup FOV
+/// @{
+/**
+    @brief Return a new tracker for viewers on `map`.
+
+    `map` is not copied and must outlive the tracker.
+    `light_walls` and `algo` are the same as in TCOD_map_compute_fov and apply to every viewer.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_NODISCARD TCOD_FovTracker* TCOD_fov_tracker_new(
+    const TCOD_Map* map, bool light_walls, TCOD_fov_algorithm_t algo);
+/**
+    @brief Delete a tracker and all of its viewers.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_fov_tracker_delete(TCOD_FovTracker* tracker);
+/**
+    @brief Add a viewer at `{x, y}` with `max_radius`, returning its id.
+
+    The viewers field-of-view is computed on the next call to TCOD_fov_tracker_update.
+    Ids of removed viewers are reused.
+
+    Returns a negative error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_fov_tracker_add_viewer(TCOD_FovTracker* tracker, int x, int y, int max_radius);
+/**
+    @brief Move viewer `id` to `{x, y}` and change its radius to `max_radius`.
+
+    The viewer is fully recomputed on the next call to TCOD_fov_tracker_update.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_fov_tracker_set_viewer(TCOD_FovTracker* tracker, int id, int x, int y, int max_radius);
+/**
+    @brief Remove viewer `id` from the tracker.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_fov_tracker_remove_viewer(TCOD_FovTracker* tracker, int id);
+/**
+    @brief Notify the tracker that the transparency of the cell at `{x, y}` has changed.
+
+    Call this after TCOD_map_set_properties, then call TCOD_fov_tracker_update once all changes are made.
+    Changes to walkability do not need to be reported.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_fov_tracker_cell_changed(TCOD_FovTracker* tracker, int x, int y);
+/**
+    @brief Recompute every part of every viewer which is out of date.
+
+    Multiple viewers are recomputed in parallel.
+    The map must not be modified while this call is running.
+
+    Returns the number of octants, quadrants, or whole viewers which were recomputed.
+    Returns a negative error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_fov_tracker_update(TCOD_FovTracker* tracker);
+/**
+    @brief Return true if viewer `id` can see the cell at `{x, y}`.
+
+    This reflects the state of the last call to TCOD_fov_tracker_update.
+    Returns false for invalid viewers and out-of-bounds cells.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_fov_tracker_is_in_fov(const TCOD_FovTracker* tracker, int id, int x, int y);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_FOV_TRACKER_H_
@@ -45,14 +45,47 @@ struct TCOD_MapCell {
   bool walkable;
   bool fov;
 };
+/**
+    @brief The width and height of the regions which TCOD_Map tracks changes in.
+
+    @versionadded{Unreleased}
+ */
+#define TCOD_MAP_REGION_SIZE 16
 /**
  *  Private map struct.
+ *
+ *  A map stores its cells in one of two layouts.  Maps from TCOD_map_new use
+ *  the `cells` array.  Maps from TCOD_map_new_bitpacked leave `cells` as NULL
+ *  and instead store each attribute in its own bit-plane, where the cell at
+ *  `{x, y}` is bit `x % 64` of word `x / 64 + y * bits_stride`.
+ *  Padding bits past the end of each row are always zero.
+ *
+ *  When `fov_bounds_valid` is true every fov flag outside of the half-open
+ *  rectangle `[fov_x_min, fov_x_max) x [fov_y_min, fov_y_max)` is known to be
+ *  unset, which lets TCOD_map_compute_fov clear only that region.
+ *  Anything which writes fov flags without TCOD_map_set_in_fov must set
+ *  `fov_bounds_valid` to false, see TCOD_map_invalidate_fov_bounds.
+ *  Maps which are zero initialized outside of libtcod start with it false.
+ *
+ *  `region_versions` may be NULL for maps which were not made by libtcod, in
+ *  which case only `version` is tracked.
  */
 typedef struct TCOD_Map {
   int width;
   int height;
   int nbcells;
   struct TCOD_MapCell* __restrict cells;
+  int bits_stride;  // The number of 64-bit words per row in the bit-planes, or zero.
+  uint64_t* __restrict transparent_bits;  // Bit-planes, these are NULL unless the map is bit-packed.
+  uint64_t* __restrict walkable_bits;
+  uint64_t* __restrict fov_bits;
+  int fov_x_min;  // Bounds of the cells which may be in the field-of-view.
+  int fov_y_min;
+  int fov_x_max;
+  int fov_y_max;
+  bool fov_bounds_valid;  // If false then any cell may be in the field-of-view.
+  uint64_t version;  // Incremented by every change to the transparent or walkable attributes.
+  uint64_t* region_versions;  // The version of the last change in each TCOD_MAP_REGION_SIZE region, row-major.
 } TCOD_Map;
 typedef TCOD_Map* TCOD_map_t;
 /**
@@ -108,8 +141,33 @@ typedef enum {
       \endrst
    */
   FOV_SYMMETRIC_SHADOWCAST,
+  /**
+      Bresenham line-of-sight using precomputed shadow tables.
+
+      A cell is visible when the Bresenham line from the point of view to the cell has no opaque cells between them.
+      The cells shadowed by each cell around the point of view are precomputed once per radius as row bitsets,
+      so each computation only ORs together the shadows of the opaque cells within the radius.
+
+      `max_radius` must be between 1 and 20 (FOV_SHADOW_TABLE_MAX_RADIUS) for this algorithm.
+      The tables are kept until TCOD_quit is called.
+
+      @versionadded{Unreleased}
+   */
+  FOV_SHADOW_TABLE,
   NB_FOV_ALGORITHMS
 } TCOD_fov_algorithm_t;
 #define FOV_PERMISSIVE(x) ((TCOD_fov_algorithm_t)(FOV_PERMISSIVE_0 + (x)))
+/// The largest `max_radius` supported by FOV_SHADOW_TABLE.
+#define FOV_SHADOW_TABLE_MAX_RADIUS 20
+/**
+    @brief A point of view used by TCOD_map_compute_fov_batch.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_FovOrigin {
+  int x;  // The point of view, this must be within the map.
+  int y;
+  int max_radius;  // The maximum view distance, or zero for no limit.
+} TCOD_FovOrigin;
 /// @}
 #endif /* TCOD_FOV_TYPES_H_ */
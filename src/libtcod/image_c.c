@@ -838,6 +838,7 @@ void TCOD_image_blit_2x(
   TCOD_IFNOT(dest_x + max_x / 2 >= 0 && dest_y + max_y / 2 >= 0 && dest_x < console->w && dest_y < console->h) {
     return;
   }
+  TCOD_console_mark_changed(console, dest_x, dest_y, (max_x + 1) / 2, (max_y + 1) / 2);
   max_x += src_x;
   max_y += src_y;
 
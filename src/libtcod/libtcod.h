@@ -35,8 +35,10 @@
 
 #include "bresenham.h"
 #include "bsp.h"
+#include "chunked_map.h"
 #include "color.h"
 #include "console.h"
+#include "console_compositor.h"
 #include "console_drawing.h"
 #include "console_etc.h"
 #include "console_init.h"
@@ -46,10 +48,12 @@
 #include "context_init.h"
 #include "error.h"
 #include "fov.h"
+#include "fov_tracker.h"
 #include "globals.h"
 #include "heightmap.h"
 #include "image.h"
 #include "lex.h"
+#include "lightmap.h"
 #include "list.h"
 #include "logging.h"
 #include "mersenne.h"
@@ -58,6 +62,9 @@
 #include "noise.h"
 #include "parser.h"
 #include "path.h"
+#include "path_flow_field.h"
+#include "path_hierarchical.h"
+#include "path_incremental.h"
 #include "pathfinder.h"
 #include "pathfinder_frontier.h"
 #include "portability.h"
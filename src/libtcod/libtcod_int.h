@@ -34,6 +34,7 @@
 #define TCODLIB_INT_H_
 #include <assert.h>
 #include <stdarg.h>
+#include <stddef.h>
 #ifdef __cplusplus
 #include <stdexcept>
 #include <string>
@@ -132,19 +133,80 @@ extern TCOD_internal_context_t TCOD_ctx;
 #endif
 
 /* fov internal stuff */
+/**
+    The destination of a field-of-view computation.
+
+    FOV algorithms read cell transparency from a const map and write visibility
+    here, so that several computations may share one map.
+    Visibility is written to the bytes of `cells` or to the bit-plane `bits`.
+    The bounding box of every cell set to true is tracked so that it can be cleared cheaply later.
+
+    Algorithms must only write to cells within their radius, which lets an output cover only that region of the map.
+ */
+typedef struct TCOD_FovOutput {
+  int width;  // The size of the output region, this is the whole map unless an offset is used.
+  int height;
+  int x_offset;  // The map position of the top-left cell of the output region.
+  int y_offset;
+  bool* __restrict cells;  // The byte of local `{x, y}` is `cells[x * cells_stride_x + y * cells_stride_y]`, or NULL.
+  ptrdiff_t cells_stride_x;
+  ptrdiff_t cells_stride_y;
+  uint64_t* __restrict bits;  // Bit-plane output using `bits_stride` words per row, or NULL.
+  int bits_stride;
+  uint64_t* __restrict reads;  // Optional bit-plane laid out like `bits` recording which cells the algorithm read.
+  int touched_x_min;  // Inclusive map bounds of the cells set to true, these are empty when min > max.
+  int touched_y_min;
+  int touched_x_max;
+  int touched_y_max;
+} TCOD_FovOutput;
 TCOD_Error TCOD_map_compute_fov_circular_raycasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls);
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls);
 TCOD_Error TCOD_map_compute_fov_diamond_raycasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls);
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls);
 TCOD_Error TCOD_map_compute_fov_recursive_shadowcasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls);
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls);
 TCOD_Error TCOD_map_compute_fov_permissive2(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls, int permissiveness);
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls, int permissiveness);
 TCOD_Error TCOD_map_compute_fov_restrictive_shadowcasting(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls);
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls);
 TCOD_Error TCOD_map_compute_fov_symmetric_shadowcast(
-    TCOD_Map* __restrict map, int pov_x, int pov_y, int max_radius, bool light_walls);
-TCOD_Error TCOD_map_postprocess(TCOD_Map* __restrict map, int pov_x, int pov_y, int radius);
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls);
+/**
+    Compute only one of the 8 octants of FOV_SHADOW.
+ */
+TCOD_Error TCOD_map_compute_fov_recursive_shadowcasting_octant_(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls, int octant);
+/**
+    Compute only one of the 4 quadrants of FOV_SYMMETRIC_SHADOWCAST, or all of them if `quadrant` is negative.
+ */
+TCOD_Error TCOD_map_compute_fov_symmetric_shadowcast_quadrant_(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls, int quadrant);
+TCOD_Error TCOD_map_compute_fov_shadow_table(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int max_radius,
+    bool light_walls);
+/// Free the tables built by FOV_SHADOW_TABLE, they will be rebuilt when needed again.
+void TCOD_fov_shadow_tables_free_(void);
+TCOD_Error TCOD_map_postprocess(
+    const TCOD_Map* __restrict map, TCOD_FovOutput* __restrict out, int pov_x, int pov_y, int radius);
+/**
+    Run a FOV algorithm writing to `out` without clearing it first.
+ */
+TCOD_Error TCOD_map_compute_fov_to_output_(
+    const TCOD_Map* __restrict map,
+    TCOD_FovOutput* __restrict out,
+    int pov_x,
+    int pov_y,
+    int max_radius,
+    bool light_walls,
+    TCOD_fov_algorithm_t algo);
 /**
     Return true if `x` and `y` are in the boundaries of `map`.
 
@@ -153,6 +215,176 @@ TCOD_Error TCOD_map_postprocess(TCOD_Map* __restrict map, int pov_x, int pov_y,
 static inline bool TCOD_map_in_bounds(const struct TCOD_Map* map, int x, int y) {
   return map && 0 <= x && x < map->width && 0 <= y && y < map->height;
 }
+/**
+    Return the bit-plane word index of `{x, y}` on a bit-packed map.
+ */
+static inline ptrdiff_t TCOD_map_bits_index_(const struct TCOD_Map* map, int x, int y) {
+  return (ptrdiff_t)(x >> 6) + (ptrdiff_t)y * map->bits_stride;
+}
+/**
+    Return the transparent flag of an in-bounds cell, for either map layout.
+ */
+static inline bool TCOD_map_get_transparent_(const struct TCOD_Map* map, int x, int y) {
+  if (map->transparent_bits) {
+    return (map->transparent_bits[TCOD_map_bits_index_(map, x, y)] >> (x & 63)) & 1;
+  }
+  return map->cells[x + y * map->width].transparent;
+}
+/**
+    Return the walkable flag of an in-bounds cell, for either map layout.
+ */
+static inline bool TCOD_map_get_walkable_(const struct TCOD_Map* map, int x, int y) {
+  if (map->walkable_bits) {
+    return (map->walkable_bits[TCOD_map_bits_index_(map, x, y)] >> (x & 63)) & 1;
+  }
+  return map->cells[x + y * map->width].walkable;
+}
+/**
+    Return the fov flag of an in-bounds cell, for either map layout.
+ */
+static inline bool TCOD_map_get_fov_(const struct TCOD_Map* map, int x, int y) {
+  if (map->fov_bits) {
+    return (map->fov_bits[TCOD_map_bits_index_(map, x, y)] >> (x & 63)) & 1;
+  }
+  return map->cells[x + y * map->width].fov;
+}
+/**
+    Assign a bit on a bit-plane.
+ */
+static inline void TCOD_map_assign_bit_(uint64_t* __restrict word, int x, bool value) {
+  const uint64_t mask = (uint64_t)1 << (x & 63);
+  *word = value ? (*word | mask) : (*word & ~mask);
+}
+/**
+    Set the fov flag of an in-bounds cell, for either map layout.
+ */
+static inline void TCOD_map_set_fov_(struct TCOD_Map* map, int x, int y, bool fov) {
+  if (map->fov_bits) {
+    TCOD_map_assign_bit_(&map->fov_bits[TCOD_map_bits_index_(map, x, y)], x, fov);
+    return;
+  }
+  map->cells[x + y * map->width].fov = fov;
+}
+/**
+    Return a FOV output covering the given region of a map with no destination assigned yet.
+ */
+static inline TCOD_FovOutput TCOD_fov_output_new_(int x_offset, int y_offset, int width, int height) {
+  TCOD_FovOutput out = {
+      width, height, x_offset, y_offset, NULL, 0, 0, NULL, 0, NULL, x_offset + width, y_offset + height, -1, -1};
+  return out;
+}
+/**
+    Return the visibility of an in-bounds cell of a FOV output.
+ */
+static inline bool TCOD_fov_output_get_(const TCOD_FovOutput* out, int x, int y) {
+  x -= out->x_offset;
+  y -= out->y_offset;
+  if (out->bits) {
+    return (out->bits[(ptrdiff_t)(x >> 6) + (ptrdiff_t)y * out->bits_stride] >> (x & 63)) & 1;
+  }
+  return out->cells[x * out->cells_stride_x + y * out->cells_stride_y];
+}
+/**
+    Set the visibility of an in-bounds cell of a FOV output.
+ */
+static inline void TCOD_fov_output_set_(TCOD_FovOutput* out, int x, int y, bool fov) {
+  if (fov) {
+    if (x < out->touched_x_min) out->touched_x_min = x;
+    if (x > out->touched_x_max) out->touched_x_max = x;
+    if (y < out->touched_y_min) out->touched_y_min = y;
+    if (y > out->touched_y_max) out->touched_y_max = y;
+  }
+  x -= out->x_offset;
+  y -= out->y_offset;
+  if (out->bits) {
+    TCOD_map_assign_bit_(&out->bits[(ptrdiff_t)(x >> 6) + (ptrdiff_t)y * out->bits_stride], x, fov);
+    return;
+  }
+  out->cells[x * out->cells_stride_x + y * out->cells_stride_y] = fov;
+}
+/**
+    Record a read of the in-bounds cell `{x, y}` in `out->reads` when it is tracked.
+ */
+static inline void TCOD_fov_output_record_read_(TCOD_FovOutput* out, int x, int y) {
+  if (out->reads) {
+    const int local_x = x - out->x_offset;
+    const int local_y = y - out->y_offset;
+    out->reads[(ptrdiff_t)(local_x >> 6) + (ptrdiff_t)local_y * out->bits_stride] |= (uint64_t)1 << (local_x & 63);
+  }
+}
+/**
+    Return the transparent flag of an in-bounds cell, recording the read in `out->reads` when it is tracked.
+ */
+static inline bool TCOD_fov_output_read_transparent_(
+    const struct TCOD_Map* map, TCOD_FovOutput* out, int x, int y) {
+  TCOD_fov_output_record_read_(out, x, y);
+  return TCOD_map_get_transparent_(map, x, y);
+}
+/**
+    Return a FOV output which writes to the fov attribute of `map`.
+ */
+static inline TCOD_FovOutput TCOD_fov_output_from_map_(TCOD_Map* map) {
+  TCOD_FovOutput out = TCOD_fov_output_new_(0, 0, map->width, map->height);
+  if (map->fov_bits) {
+    out.bits = map->fov_bits;
+    out.bits_stride = map->bits_stride;
+  } else {
+    out.cells = &map->cells[0].fov;
+    out.cells_stride_x = sizeof(*map->cells) / sizeof(bool);
+    out.cells_stride_y = out.cells_stride_x * map->width;
+  }
+  return out;
+}
+
+/* parallel helpers */
+/// The upper limit of workers used by TCOD_parallel_for_.
+#define TCOD_PARALLEL_MAX_WORKERS_ 64
+/**
+    A task callback for TCOD_parallel_for_.
+
+    `index` is the task being run and `worker` is the index of the worker running it, which is less than the number of
+    workers passed to TCOD_parallel_for_.  A worker only runs one task at a time.
+ */
+typedef void (*TCOD_ParallelFunc_)(void* userdata, int index, int worker);
+/**
+    Return the number of workers worth using for `count` independent tasks.
+
+    This is always at least 1 and never more than `count` or the number of logical cores.
+ */
+int TCOD_parallel_worker_count_(int count);
+/**
+    Call `func` once for each index in `[0, count)` spread over up to `workers` threads, then wait for all calls to
+    finish.  The calling thread participates as worker 0.
+
+    The global error message is not thread-safe, tasks should report failures back through `userdata` instead.
+    Runs everything on the calling thread when libtcod is built with TCOD_NO_THREADS.
+ */
+void TCOD_parallel_for_(int count, int workers, TCOD_ParallelFunc_ func, void* userdata);
+/**
+    Lock or unlock a global mutex, used to guard lazily initialized shared data.
+ */
+void TCOD_parallel_lock_(void);
+void TCOD_parallel_unlock_(void);
+
+/* fov tracker helpers */
+struct TCOD_FovTracker;
+/**
+    Return true if viewer `id` will be recomputed by the next call to TCOD_fov_tracker_update.
+ */
+bool TCOD_fov_tracker_viewer_dirty_(const struct TCOD_FovTracker* tracker, int id);
+/**
+    Return the combined visibility plane of viewer `id`, or NULL if it does not exist.
+
+    The plane covers the map region `{box_x, box_y, box_width, box_height}` with `stride` 64-bit words per row.
+ */
+const uint64_t* TCOD_fov_tracker_viewer_plane_(
+    const struct TCOD_FovTracker* tracker,
+    int id,
+    int* __restrict box_x,
+    int* __restrict box_y,
+    int* __restrict box_width,
+    int* __restrict box_height,
+    int* __restrict stride);
 
 /* switch fullscreen mode */
 TCOD_key_t TCOD_sys_check_for_keypress(int flags);
@@ -463,6 +695,34 @@ static inline TCOD_Console* TCOD_console_validate_(const TCOD_Console* console)
 static inline bool TCOD_console_is_index_valid_(const TCOD_Console* console, int x, int y) {
   return console && 0 <= x && x < console->w && 0 <= y && y < console->h;
 }
+/**
+ *  Give rows `[y, y + height)` of a console with change tracking a new version.  The rows must be in bounds.
+ */
+void TCOD_console_stamp_rows_(TCOD_Console* console, int y, int height);
+/**
+ *  Record a change to rows `[y, y + height)` of a console if it tracks changes.  The rows must be in bounds.
+ */
+static inline void TCOD_console_rows_changed_(TCOD_Console* console, int y, int height) {
+  if (console->row_versions) {
+    TCOD_console_stamp_rows_(console, y, height);
+  }
+}
+/**
+ *  Return true if row `y` of `console` is known to be unchanged since `cache` last copied it.
+ *
+ *  `cache` must track changes and holds the version of each source row it last copied, or 0 if a row must be redrawn.
+ */
+static inline bool TCOD_console_row_is_cached_(const TCOD_Console* console, const TCOD_Console* cache, int y) {
+  return console->row_versions && cache->row_versions && console->row_versions[y] == cache->row_versions[y];
+}
+/**
+ *  Remember which version of row `y` of `console` has been copied to `cache`.
+ */
+static inline void TCOD_console_row_set_cached_(const TCOD_Console* console, TCOD_Console* cache, int y) {
+  if (cache->row_versions) {
+    cache->row_versions[y] = console->row_versions ? console->row_versions[y] : 0;
+  }
+}
 TCOD_event_t TCOD_sys_handle_mouse_event(const union SDL_Event* ev, TCOD_mouse_t* mouse);
 TCOD_event_t TCOD_sys_handle_key_event(const union SDL_Event* ev, TCOD_key_t* key);
 #ifdef __cplusplus
@@ -0,0 +1,367 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "lightmap.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fov_tracker.h"
+#include "libtcod_int.h"
+#include "utility.h"
+
+/// One light of a TCOD_Lightmap.
+struct Light {
+  bool active;
+  bool changed;  // True if this light must be reapplied to the light grid on the next update.
+  int x;
+  int y;
+  int radius;
+  TCOD_ColorRGB color;
+  float falloff;
+  int viewer;  // The id of this lights viewer in the FOV tracker.
+  int applied_x;  // The region of the light grid which this light currently contributes to.
+  int applied_y;
+  int applied_width;
+  int applied_height;
+};
+struct TCOD_Lightmap {
+  const TCOD_Map* map;
+  TCOD_FovTracker* tracker;  // Holds the field-of-view of each light.
+  int lights_count;
+  int lights_capacity;
+  struct Light* lights;
+  float* rgb;  // The light grid, 3 floats per cell.
+  uint8_t* dirty;  // Cells of the light grid which must be rebuilt, one byte per cell.
+  int dirty_x_min;  // Half-open bounds of the dirty cells, empty when min >= max.
+  int dirty_y_min;
+  int dirty_x_max;
+  int dirty_y_max;
+};
+TCOD_Lightmap* TCOD_lightmap_new(const TCOD_Map* map, bool light_walls, TCOD_fov_algorithm_t algo) {
+  TCOD_FovTracker* tracker = TCOD_fov_tracker_new(map, light_walls, algo);
+  if (!tracker) {
+    return NULL;
+  }
+  TCOD_Lightmap* lightmap = calloc(1, sizeof(*lightmap));
+  const size_t cells = (size_t)map->width * map->height;
+  if (lightmap) {
+    lightmap->rgb = calloc(cells * 3, sizeof(*lightmap->rgb));
+    lightmap->dirty = calloc(cells, sizeof(*lightmap->dirty));
+  }
+  if (!lightmap || !lightmap->rgb || !lightmap->dirty) {
+    if (lightmap) {
+      free(lightmap->rgb);
+      free(lightmap->dirty);
+    }
+    free(lightmap);
+    TCOD_fov_tracker_delete(tracker);
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  lightmap->map = map;
+  lightmap->tracker = tracker;
+  return lightmap;
+}
+void TCOD_lightmap_delete(TCOD_Lightmap* lightmap) {
+  if (!lightmap) {
+    return;
+  }
+  TCOD_fov_tracker_delete(lightmap->tracker);
+  free(lightmap->lights);
+  free(lightmap->rgb);
+  free(lightmap->dirty);
+  free(lightmap);
+}
+/**
+    Mark the cells of the light grid within `{x, y, width, height}` as needing to be rebuilt.
+ */
+static void mark_dirty(TCOD_Lightmap* lightmap, int x, int y, int width, int height) {
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  const int map_width = lightmap->map->width;
+  for (int j = y; j < y + height; ++j) {
+    memset(lightmap->dirty + x + (ptrdiff_t)j * map_width, 1, width);
+  }
+  if (lightmap->dirty_x_min >= lightmap->dirty_x_max) {
+    lightmap->dirty_x_min = x;
+    lightmap->dirty_y_min = y;
+    lightmap->dirty_x_max = x + width;
+    lightmap->dirty_y_max = y + height;
+    return;
+  }
+  lightmap->dirty_x_min = TCOD_MIN(lightmap->dirty_x_min, x);
+  lightmap->dirty_y_min = TCOD_MIN(lightmap->dirty_y_min, y);
+  lightmap->dirty_x_max = TCOD_MAX(lightmap->dirty_x_max, x + width);
+  lightmap->dirty_y_max = TCOD_MAX(lightmap->dirty_y_max, y + height);
+}
+/**
+    Mark the region a light currently contributes to as dirty, then forget that region.
+ */
+static void unapply_light(TCOD_Lightmap* __restrict lightmap, struct Light* __restrict light) {
+  mark_dirty(lightmap, light->applied_x, light->applied_y, light->applied_width, light->applied_height);
+  light->applied_width = light->applied_height = 0;
+}
+/**
+    Check the parameters shared by TCOD_lightmap_add_light and TCOD_lightmap_set_light.
+ */
+static TCOD_Error check_light_parameters(int radius, float falloff) {
+  if (radius <= 0) {
+    TCOD_set_errorvf("Light radius must be greater than zero, got %i.", radius);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!(falloff > 0)) {
+    TCOD_set_errorvf("Light falloff must be greater than zero, got %f.", (double)falloff);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  return TCOD_E_OK;
+}
+int TCOD_lightmap_add_light(TCOD_Lightmap* lightmap, int x, int y, int radius, TCOD_ColorRGB color, float falloff) {
+  if (!lightmap) {
+    TCOD_set_errorv("Lightmap must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  TCOD_Error err = check_light_parameters(radius, falloff);
+  if (err < 0) {
+    return err;
+  }
+  int id = 0;
+  while (id < lightmap->lights_count && lightmap->lights[id].active) {
+    ++id;
+  }
+  if (id == lightmap->lights_capacity) {
+    const int new_capacity = lightmap->lights_capacity ? lightmap->lights_capacity * 2 : 8;
+    struct Light* new_lights = realloc(lightmap->lights, sizeof(*new_lights) * new_capacity);
+    if (!new_lights) {
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+    memset(new_lights + lightmap->lights_capacity, 0, sizeof(*new_lights) * (new_capacity - lightmap->lights_capacity));
+    lightmap->lights = new_lights;
+    lightmap->lights_capacity = new_capacity;
+  }
+  const int viewer = TCOD_fov_tracker_add_viewer(lightmap->tracker, x, y, radius);
+  if (viewer < 0) {
+    return viewer;
+  }
+  struct Light* light = &lightmap->lights[id];
+  memset(light, 0, sizeof(*light));
+  light->active = true;
+  light->changed = true;
+  light->x = x;
+  light->y = y;
+  light->radius = radius;
+  light->color = color;
+  light->falloff = falloff;
+  light->viewer = viewer;
+  if (id == lightmap->lights_count) {
+    ++lightmap->lights_count;
+  }
+  return id;
+}
+/**
+    Return the active light `id` of `lightmap`, or NULL.
+ */
+static struct Light* get_light(const TCOD_Lightmap* lightmap, int id) {
+  if (!lightmap || id < 0 || id >= lightmap->lights_count || !lightmap->lights[id].active) {
+    return NULL;
+  }
+  return &lightmap->lights[id];
+}
+TCOD_Error TCOD_lightmap_set_light(
+    TCOD_Lightmap* lightmap, int id, int x, int y, int radius, TCOD_ColorRGB color, float falloff) {
+  struct Light* light = get_light(lightmap, id);
+  if (!light) {
+    TCOD_set_errorvf("Light %i does not exist.", id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  TCOD_Error err = check_light_parameters(radius, falloff);
+  if (err < 0) {
+    return err;
+  }
+  if (light->x != x || light->y != y || light->radius != radius) {
+    err = TCOD_fov_tracker_set_viewer(lightmap->tracker, light->viewer, x, y, radius);
+    if (err < 0) {
+      return err;
+    }
+  }
+  light->changed = true;
+  light->x = x;
+  light->y = y;
+  light->radius = radius;
+  light->color = color;
+  light->falloff = falloff;
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_lightmap_remove_light(TCOD_Lightmap* lightmap, int id) {
+  struct Light* light = get_light(lightmap, id);
+  if (!light) {
+    TCOD_set_errorvf("Light %i does not exist.", id);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  unapply_light(lightmap, light);
+  TCOD_fov_tracker_remove_viewer(lightmap->tracker, light->viewer);
+  memset(light, 0, sizeof(*light));
+  while (lightmap->lights_count > 0 && !lightmap->lights[lightmap->lights_count - 1].active) {
+    --lightmap->lights_count;
+  }
+  return TCOD_E_OK;
+}
+TCOD_Error TCOD_lightmap_cell_changed(TCOD_Lightmap* lightmap, int x, int y) {
+  if (!lightmap) {
+    TCOD_set_errorv("Lightmap must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  return TCOD_fov_tracker_cell_changed(lightmap->tracker, x, y);
+}
+/**
+    Add the contribution of `light` to the dirty cells of the light grid.
+ */
+static void accumulate_light(TCOD_Lightmap* __restrict lightmap, const struct Light* __restrict light) {
+  int box_x;
+  int box_y;
+  int box_width;
+  int box_height;
+  int stride;
+  const uint64_t* visible = TCOD_fov_tracker_viewer_plane_(
+      lightmap->tracker, light->viewer, &box_x, &box_y, &box_width, &box_height, &stride);
+  // Only visit the part of this light which overlaps the dirty region.
+  const int x_min = TCOD_MAX(box_x, lightmap->dirty_x_min);
+  const int y_min = TCOD_MAX(box_y, lightmap->dirty_y_min);
+  const int x_max = TCOD_MIN(box_x + box_width, lightmap->dirty_x_max);
+  const int y_max = TCOD_MIN(box_y + box_height, lightmap->dirty_y_max);
+  const float offset = 1.0f / (1.0f + (float)(light->radius * light->radius) / light->falloff);
+  const float factor = 1.0f / (1.0f - offset);
+  const int map_width = lightmap->map->width;
+  for (int y = y_min; y < y_max; ++y) {
+    const uint64_t* row = visible + (ptrdiff_t)(y - box_y) * stride;
+    for (int x = x_min; x < x_max; ++x) {
+      const ptrdiff_t index = x + (ptrdiff_t)y * map_width;
+      if (!lightmap->dirty[index] || !((row[(x - box_x) >> 6] >> ((x - box_x) & 63)) & 1)) {
+        continue;
+      }
+      const int distance_squared = (x - light->x) * (x - light->x) + (y - light->y) * (y - light->y);
+      const float coef = (1.0f / (1.0f + (float)distance_squared / light->falloff) - offset) * factor;
+      if (coef <= 0) {
+        continue;
+      }
+      float* rgb = lightmap->rgb + index * 3;
+      rgb[0] += light->color.r * coef;
+      rgb[1] += light->color.g * coef;
+      rgb[2] += light->color.b * coef;
+    }
+  }
+}
+int TCOD_lightmap_update(TCOD_Lightmap* lightmap) {
+  if (!lightmap) {
+    TCOD_set_errorv("Lightmap must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  int lights_recomputed = 0;
+  for (int i = 0; i < lightmap->lights_count; ++i) {
+    struct Light* light = &lightmap->lights[i];
+    if (!light->active) {
+      continue;
+    }
+    if (TCOD_fov_tracker_viewer_dirty_(lightmap->tracker, light->viewer)) {
+      light->changed = true;
+      ++lights_recomputed;
+    }
+    if (light->changed) {
+      unapply_light(lightmap, light);
+    }
+  }
+  const int err = TCOD_fov_tracker_update(lightmap->tracker);
+  if (err < 0) {
+    return err;
+  }
+  for (int i = 0; i < lightmap->lights_count; ++i) {
+    struct Light* light = &lightmap->lights[i];
+    if (!light->active || !light->changed) {
+      continue;
+    }
+    int stride;
+    TCOD_fov_tracker_viewer_plane_(
+        lightmap->tracker,
+        light->viewer,
+        &light->applied_x,
+        &light->applied_y,
+        &light->applied_width,
+        &light->applied_height,
+        &stride);
+    mark_dirty(lightmap, light->applied_x, light->applied_y, light->applied_width, light->applied_height);
+    light->changed = false;
+  }
+  if (lightmap->dirty_x_min >= lightmap->dirty_x_max) {
+    return lights_recomputed;
+  }
+  // Rebuild every dirty cell from all lights which overlap the dirty region.
+  const int map_width = lightmap->map->width;
+  for (int y = lightmap->dirty_y_min; y < lightmap->dirty_y_max; ++y) {
+    for (int x = lightmap->dirty_x_min; x < lightmap->dirty_x_max; ++x) {
+      const ptrdiff_t index = x + (ptrdiff_t)y * map_width;
+      if (lightmap->dirty[index]) {
+        lightmap->rgb[index * 3 + 0] = lightmap->rgb[index * 3 + 1] = lightmap->rgb[index * 3 + 2] = 0;
+      }
+    }
+  }
+  for (int i = 0; i < lightmap->lights_count; ++i) {
+    const struct Light* light = &lightmap->lights[i];
+    if (!light->active || light->applied_x >= lightmap->dirty_x_max ||
+        light->applied_x + light->applied_width <= lightmap->dirty_x_min || light->applied_y >= lightmap->dirty_y_max ||
+        light->applied_y + light->applied_height <= lightmap->dirty_y_min) {
+      continue;
+    }
+    accumulate_light(lightmap, light);
+  }
+  for (int y = lightmap->dirty_y_min; y < lightmap->dirty_y_max; ++y) {
+    memset(
+        lightmap->dirty + lightmap->dirty_x_min + (ptrdiff_t)y * map_width,
+        0,
+        lightmap->dirty_x_max - lightmap->dirty_x_min);
+  }
+  lightmap->dirty_x_min = lightmap->dirty_y_min = lightmap->dirty_x_max = lightmap->dirty_y_max = 0;
+  return lights_recomputed;
+}
+const float* TCOD_lightmap_get_data(const TCOD_Lightmap* lightmap) { return lightmap ? lightmap->rgb : NULL; }
+TCOD_ColorRGB TCOD_lightmap_get_color(const TCOD_Lightmap* lightmap, int x, int y) {
+  TCOD_ColorRGB color = {0, 0, 0};
+  if (!lightmap || !TCOD_map_in_bounds(lightmap->map, x, y)) {
+    return color;
+  }
+  const float* rgb = lightmap->rgb + (x + (ptrdiff_t)y * lightmap->map->width) * 3;
+  color.r = (uint8_t)TCOD_CLAMP(0.0f, 255.0f, rgb[0]);
+  color.g = (uint8_t)TCOD_CLAMP(0.0f, 255.0f, rgb[1]);
+  color.b = (uint8_t)TCOD_CLAMP(0.0f, 255.0f, rgb[2]);
+  return color;
+}
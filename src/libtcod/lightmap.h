@@ -0,0 +1,154 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file lightmap.h
+/// Colored lighting from many lights built on field-of-view.
+#pragma once
+#ifndef TCOD_LIGHTMAP_H_
+#define TCOD_LIGHTMAP_H_
+
+#include <stdbool.h>
+
+#include "color.h"
+#include "config.h"
+#include "error.h"
+#include "fov_types.h"
+
+/**
+    @brief Accumulates the light of many colored lights on a map into an RGB grid.
+
+    Each light is lit by its own field-of-view, which is kept between updates and only recomputed when the light moves
+    or when a cell its field-of-view depended on changes.
+    The light grid is only rebuilt in the regions of lights which changed.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_Lightmap TCOD_Lightmap;
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup FOV
+/// @{
+/**
+    @brief Return a new lightmap for lights on `map`.
+
+    `map` is not copied and must outlive the lightmap.
+    `light_walls` and `algo` are the same as in TCOD_map_compute_fov and apply to every light.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_NODISCARD TCOD_Lightmap* TCOD_lightmap_new(
+    const TCOD_Map* map, bool light_walls, TCOD_fov_algorithm_t algo);
+/**
+    @brief Delete a lightmap and all of its lights.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_lightmap_delete(TCOD_Lightmap* lightmap);
+/**
+    @brief Add a light at `{x, y}` returning its id.
+
+    `radius` is the distance at which the light fades out completely and must be greater than zero.
+
+    The intensity of the light at a squared distance of `d2` is
+    `(1 / (1 + d2 / falloff) - k) / (1 - k)` where `k = 1 / (1 + radius * radius / falloff)`,
+    which is the standard shader of the rad sample.
+    `falloff` must be greater than zero, larger values give a flatter falloff.  The rad sample uses 20.
+
+    The light is added on the next call to TCOD_lightmap_update.
+    Ids of removed lights are reused.
+
+    Returns a negative error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_lightmap_add_light(
+    TCOD_Lightmap* lightmap, int x, int y, int radius, TCOD_ColorRGB color, float falloff);
+/**
+    @brief Change the parameters of light `id`.
+
+    The field-of-view of the light is reused if its position and radius are unchanged.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_lightmap_set_light(
+    TCOD_Lightmap* lightmap, int id, int x, int y, int radius, TCOD_ColorRGB color, float falloff);
+/**
+    @brief Remove light `id` from the lightmap.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_lightmap_remove_light(TCOD_Lightmap* lightmap, int id);
+/**
+    @brief Notify the lightmap that the transparency of the cell at `{x, y}` has changed.
+
+    Call this after TCOD_map_set_properties, then call TCOD_lightmap_update once all changes are made.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_lightmap_cell_changed(TCOD_Lightmap* lightmap, int x, int y);
+/**
+    @brief Bring the light grid up to date with all changes since the last update.
+
+    The field-of-view of multiple lights is computed in parallel.
+    The map must not be modified while this call is running.
+
+    Returns the number of lights which had their field-of-view recomputed.
+    Returns a negative error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_lightmap_update(TCOD_Lightmap* lightmap);
+/**
+    @brief Return the light grid as `width * height` RGB triples indexed by `(x + y * width) * 3`.
+
+    Values are the sum of every light on that cell and are not clamped, a single light at full intensity adds its own
+    color in the range of 0 to 255.
+    This reflects the state of the last call to TCOD_lightmap_update.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC const float* TCOD_lightmap_get_data(const TCOD_Lightmap* lightmap);
+/**
+    @brief Return the light on the cell at `{x, y}` clamped to a color.
+
+    Returns black for out-of-bounds cells.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_ColorRGB TCOD_lightmap_get_color(const TCOD_Lightmap* lightmap, int x, int y);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_LIGHTMAP_H_
@@ -0,0 +1,193 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdlib.h>
+
+#include "libtcod_int.h"
+#include "portability.h"
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+#define NOMINMAX 1
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+
+/// Shared state of a single TCOD_parallel_for_ call.
+struct ParallelJob {
+  TCOD_ParallelFunc_ func;
+  void* userdata;
+  int count;
+  int next_index;  // The next index to be claimed, protected by `lock`.
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+  CRITICAL_SECTION lock;
+#else
+  pthread_mutex_t lock;
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+};
+/// Per-thread state of a parallel job.
+struct ParallelWorker {
+  struct ParallelJob* job;
+  int worker;
+};
+/**
+    Claim the next index of `job`, returns -1 once all indexes have been claimed.
+ */
+static int parallel_claim(struct ParallelJob* job) {
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+  EnterCriticalSection(&job->lock);
+#else
+  pthread_mutex_lock(&job->lock);
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+  const int index = job->next_index < job->count ? job->next_index++ : -1;
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+  LeaveCriticalSection(&job->lock);
+#else
+  pthread_mutex_unlock(&job->lock);
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+  return index;
+}
+/**
+    Run claimed indexes until the job is exhausted.
+ */
+static void parallel_run(struct ParallelWorker* worker) {
+  for (int index = parallel_claim(worker->job); index >= 0; index = parallel_claim(worker->job)) {
+    worker->job->func(worker->job->userdata, index, worker->worker);
+  }
+}
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+static DWORD WINAPI parallel_thread(LPVOID worker) {
+  parallel_run(worker);
+  return 0;
+}
+#else
+static void* parallel_thread(void* worker) {
+  parallel_run(worker);
+  return NULL;
+}
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+int TCOD_parallel_worker_count_(int count) {
+  int cores = 1;
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  cores = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+  if (cores > TCOD_PARALLEL_MAX_WORKERS_) cores = TCOD_PARALLEL_MAX_WORKERS_;
+  if (cores > count) cores = count;
+  return cores < 1 ? 1 : cores;
+}
+void TCOD_parallel_for_(int count, int workers, TCOD_ParallelFunc_ func, void* userdata) {
+  if (count <= 0) return;
+  if (workers > TCOD_PARALLEL_MAX_WORKERS_) workers = TCOD_PARALLEL_MAX_WORKERS_;
+  if (workers < 1) workers = 1;
+  struct ParallelJob job;
+  job.func = func;
+  job.userdata = userdata;
+  job.count = count;
+  job.next_index = 0;
+  struct ParallelWorker worker_data[TCOD_PARALLEL_MAX_WORKERS_];
+  for (int i = 0; i < workers; ++i) {
+    worker_data[i].job = &job;
+    worker_data[i].worker = i;
+  }
+#ifdef TCOD_NO_THREADS
+  parallel_run(&worker_data[0]);
+#else
+  // The calling thread is worker 0.  Extra threads which fail to start are skipped, their share of the work is taken
+  // by the remaining workers.
+#ifdef TCOD_WINDOWS
+  InitializeCriticalSection(&job.lock);
+  HANDLE threads[TCOD_PARALLEL_MAX_WORKERS_] = {0};
+  for (int i = 1; i < workers; ++i) {
+    threads[i] = CreateThread(NULL, 0, parallel_thread, &worker_data[i], 0, NULL);
+  }
+  parallel_run(&worker_data[0]);
+  for (int i = 1; i < workers; ++i) {
+    if (!threads[i]) continue;
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+  }
+  DeleteCriticalSection(&job.lock);
+#else
+  pthread_mutex_init(&job.lock, NULL);
+  pthread_t threads[TCOD_PARALLEL_MAX_WORKERS_];
+  bool started[TCOD_PARALLEL_MAX_WORKERS_] = {0};
+  for (int i = 1; i < workers; ++i) {
+    started[i] = pthread_create(&threads[i], NULL, parallel_thread, &worker_data[i]) == 0;
+  }
+  parallel_run(&worker_data[0]);
+  for (int i = 1; i < workers; ++i) {
+    if (started[i]) pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&job.lock);
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+}
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+static SRWLOCK global_lock_ = SRWLOCK_INIT;
+#else
+static pthread_mutex_t global_lock_ = PTHREAD_MUTEX_INITIALIZER;
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+void TCOD_parallel_lock_(void) {
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+  AcquireSRWLockExclusive(&global_lock_);
+#else
+  pthread_mutex_lock(&global_lock_);
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+}
+void TCOD_parallel_unlock_(void) {
+#ifndef TCOD_NO_THREADS
+#ifdef TCOD_WINDOWS
+  ReleaseSRWLockExclusive(&global_lock_);
+#else
+  pthread_mutex_unlock(&global_lock_);
+#endif  // TCOD_WINDOWS
+#endif  // TCOD_NO_THREADS
+}
@@ -31,8 +31,13 @@
  */
 #include "path.hpp"
 
+#include "error.hpp"
+
 TCODPath::TCODPath(const TCODMap* map, float diagonalCost) : data{TCOD_path_new_using_map(map->data, diagonalCost)} {}
 
+TCODPath::TCODPath(const TCODMap* map, float diagonalCost, TCOD_PathAlgorithm algorithm)
+    : data{TCOD_path_new_using_map_ex(map->data, diagonalCost, algorithm)} {}
+
 TCODPath::~TCODPath() {
   if (data) TCOD_path_delete(data);
 }
@@ -90,6 +95,10 @@ TCODDijkstra::~TCODDijkstra(void) {
 // compute distances grid
 void TCODDijkstra::compute(int rootX, int rootY) { TCOD_dijkstra_compute(data, rootX, rootY); }
 
+void TCODDijkstra::compute(const std::vector<TCOD_DijkstraRoot>& roots) {
+  tcod::check_throw_error(TCOD_dijkstra_compute_multi(data, static_cast<int>(roots.size()), roots.data()));
+}
+
 // retrieve distance to a given cell
 float TCODDijkstra::getDistance(int x, int y) { return TCOD_dijkstra_get_distance(data, x, y); }
 
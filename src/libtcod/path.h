@@ -35,6 +35,9 @@
 #ifndef TCOD_PATH_H_
 #define TCOD_PATH_H_
 
+#include <stddef.h>
+
+#include "error.h"
 #include "fov_types.h"
 #include "list.h"
 #include "portability.h"
@@ -46,10 +49,116 @@ extern "C" {
 typedef float (*TCOD_path_func_t)(int xFrom, int yFrom, int xTo, int yTo, void* user_data);
 struct TCOD_Path;
 typedef struct TCOD_Path* TCOD_path_t;
+/**
+    @brief Search grids and open lists which can be shared by many pathfinders.
+
+    By default every TCOD_Path keeps grids the size of its map.
+    A workspace can instead be shared by many TCOD_Path and TCOD_Dijkstra objects, it grows to fit the largest map
+    searched with it.
+    Starting a search doesn't clear the grids, cells are reset when a search first reaches them, so short searches on
+    large maps only cost as much as the cells they visit.
+
+    A workspace can only run one search at a time, share one workspace per thread.
+    It must outlive every object using it.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_PathWorkspace TCOD_PathWorkspace;
 
 TCODLIB_API TCOD_path_t TCOD_path_new_using_map(TCOD_Map* map, float diagonalCost);
+/**
+    @brief Search algorithms for TCOD_path_new_using_map_ex.
+
+    @versionadded{Unreleased}
+ */
+typedef enum TCOD_PathAlgorithm {
+  /**
+      Plain A*, this is what TCOD_path_new_using_map uses.
+   */
+  TCOD_PATH_ASTAR = 0,
+  /**
+      Jump Point Search.
+
+      Skips over straight and diagonal runs of open cells instead of adding every cell to the open list, which
+      expands far fewer nodes on maps with large open areas.
+      Bit-packed maps are scanned 64 cells at a time along rows.
+
+      The returned paths are always the shortest possible, but when several paths have the same length this can
+      return a different one than TCOD_PATH_ASTAR.
+
+      Only supported when `diagonalCost` is between 1 and 2, otherwise this falls back to TCOD_PATH_ASTAR.
+   */
+  TCOD_PATH_JUMP_POINT = 1,
+} TCOD_PathAlgorithm;
+/**
+    @brief Return a new A* pathfinder for `map` which uses the given search algorithm.
+
+    This works like TCOD_path_new_using_map.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_path_t TCOD_path_new_using_map_ex(TCOD_Map* map, float diagonalCost, TCOD_PathAlgorithm algorithm);
 TCODLIB_API TCOD_path_t
 TCOD_path_new_using_function(int map_width, int map_height, TCOD_path_func_t func, void* user_data, float diagonalCost);
+/**
+    @brief Types of the values of a TCOD_PathCostGrid.
+
+    @versionadded{Unreleased}
+ */
+typedef enum TCOD_PathCostType {
+  TCOD_PATH_COST_UINT8 = 0,
+  TCOD_PATH_COST_UINT16 = 1,
+  TCOD_PATH_COST_FLOAT = 2,
+} TCOD_PathCostType;
+/**
+    @brief A dense grid of step costs which pathfinders read directly instead of calling a TCOD_path_func_t.
+
+    The cost of `{x, y}` is the cost of stepping onto that cell, it's multiplied by the diagonal cost for diagonal steps
+    the same way a TCOD_path_func_t return value is.
+    Costs of zero or less block the cell.
+
+    The grid is not copied, `data` and `heuristic` must outlive every pathfinder using them.
+    Their values can be changed between searches.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_PathCostGrid {
+  const void* data;  // The first cost, at `{0, 0}`.
+  TCOD_PathCostType type;
+  int width;
+  int height;
+  /**
+      The number of bytes between costs along each axis, the cost of `{x, y}` is at
+      `(const char*)data + x * stride_x + y * stride_y`.
+
+      Zero strides are replaced with those of a contiguous row-major array.
+   */
+  ptrdiff_t stride_x;
+  ptrdiff_t stride_y;
+  /**
+      An optional estimate of the remaining cost from each cell to the destination, `width * height` floats in
+      row-major order.
+
+      When not NULL A* uses this instead of the straight-line distance to the destination, the grid must have been
+      made for the destination of every search using it, such as a Dijkstra map from that destination.
+      The estimates must never be higher than the real costs or A* might not return the shortest path.
+      Dijkstra ignores this.
+   */
+  const float* heuristic;
+} TCOD_PathCostGrid;
+/**
+    @brief Return a new A* pathfinder reading its step costs from `costs`.
+
+    This works like TCOD_path_new_using_function with a callback returning the costs of the grid, without the overhead
+    of calling it for every step.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_path_t TCOD_path_new_using_costs(const TCOD_PathCostGrid* costs, float diagonalCost);
 
 TCODLIB_API bool TCOD_path_compute(TCOD_path_t path, int ox, int oy, int dx, int dy);
 TCODLIB_API bool TCOD_path_walk(TCOD_path_t path, int* x, int* y, bool recalculate_when_needed);
@@ -60,6 +169,145 @@ TCODLIB_API void TCOD_path_get(TCOD_path_t path, int index, int* x, int* y);
 TCODLIB_API void TCOD_path_get_origin(TCOD_path_t path, int* x, int* y);
 TCODLIB_API void TCOD_path_get_destination(TCOD_path_t path, int* x, int* y);
 TCODLIB_API void TCOD_path_delete(TCOD_path_t path);
+/**
+    @brief Return a new empty workspace.
+
+    Its grids are allocated by the first search using it and grow to fit larger maps.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_PathWorkspace* TCOD_path_workspace_new(void);
+/**
+    @brief Free a workspace.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_path_workspace_delete(TCOD_PathWorkspace* workspace);
+/**
+    @brief Make `path` search using `workspace`, or using its own grids again if `workspace` is NULL.
+
+    The grids `path` allocated for itself are freed while it uses a shared workspace.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_path_set_workspace(TCOD_path_t path, TCOD_PathWorkspace* workspace);
+/**
+    @brief A cache of A* results for a TCOD_Path, keyed by their endpoints.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_PathCache TCOD_PathCache;
+/**
+    @brief Return a new cache of up to `capacity` paths computed by `path`.
+
+    `path` must outlive the cache.
+    Each pair of endpoints maps to one of `capacity` slots, a new result replaces whatever was in its slot.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_PathCache* TCOD_path_cache_new(TCOD_path_t path, int capacity);
+/**
+    @brief Free a path cache.  The TCOD_Path it was made with is not freed.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_path_cache_delete(TCOD_PathCache* cache);
+/**
+    @brief Compute a path like TCOD_path_compute, reusing a cached result if nothing it depends on has changed.
+
+    A result is reused when it has the same endpoints and no cell which the original search read has changed since,
+    as reported by TCOD_map_get_version.
+    A reused result is copied into the cache's TCOD_Path without searching again, so it is identical to what
+    TCOD_path_compute would return.
+
+    Paths made with TCOD_path_new_using_function or TCOD_path_new_using_costs can't detect changes to their costs, call
+    TCOD_path_cache_clear whenever the costs change.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_path_cache_compute(TCOD_PathCache* cache, int ox, int oy, int dx, int dy);
+/**
+    @brief Remove every result from a path cache.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_path_cache_clear(TCOD_PathCache* cache);
+/**
+    @brief Output the number of calls to TCOD_path_cache_compute which did and did not reuse a cached result.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_path_cache_get_stats(const TCOD_PathCache* cache, int* hits, int* misses);
+/**
+    @brief The endpoints of one query of TCOD_path_compute_batch.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_PathQuery {
+  int ox, oy;  // Origin.
+  int dx, dy;  // Destination.
+} TCOD_PathQuery;
+/**
+    @brief A route output by TCOD_path_compute_batch.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_PathRoute {
+  /**
+      The number of steps in this route, or -1 if there is no path.
+   */
+  int length;
+  /**
+      `length` pairs of `{x, y}` coordinates, from the first step after the origin up to the destination.
+
+      Free this with TCOD_path_route_clear.
+   */
+  int* xy;
+} TCOD_PathRoute;
+/**
+    @brief Compute the A* paths of many queries on the same map at once, spreading the work across multiple threads.
+
+    `map` is only read from.
+    `diagonalCost` and `algorithm` are the same as in TCOD_path_new_using_map_ex and apply to every query.
+    Each of the `n` `queries` must have both endpoints within the map.
+
+    `out` must point to `n` routes which are overwritten, `out[i]` is the route of `queries[i]`.
+    Each route must be freed with TCOD_path_route_clear afterwards.
+
+    `workspaces` must point to `n_workspaces` distinct workspaces made with TCOD_path_workspace_new.
+    Each thread searches in one of them, so at most `n_workspaces` threads are used.
+    Keep the same workspaces between calls so that repeated batches reuse their grids instead of allocating new ones.
+    If `n_workspaces` is zero then `workspaces` may be NULL and temporary workspaces are allocated for this call only.
+
+    The routes are the same as TCOD_path_compute would return for each query.
+    Do not modify `map` or use the workspaces from another thread while this call is running.
+
+    If libtcod was built without threads (the `LIBTCOD_THREADS` CMake option is OFF) then this falls back to computing
+    the queries one after another on the calling thread, with the same results.
+
+    Returns an error code on failure, in which case no routes are output.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_path_compute_batch(
+    const TCOD_Map* map,
+    float diagonalCost,
+    TCOD_PathAlgorithm algorithm,
+    int n,
+    const TCOD_PathQuery* queries,
+    TCOD_PathRoute* out,
+    int n_workspaces,
+    TCOD_PathWorkspace* const* workspaces);
+/**
+    @brief Free the coordinates of a route and set it to have no path.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_path_route_clear(TCOD_PathRoute* route);
 
 /* Dijkstra stuff - by Mingos*/
 /**
@@ -74,15 +322,65 @@ typedef struct TCOD_Dijkstra {
   TCOD_path_func_t func;
   void* user_data;
   unsigned int* distances; /* distances grid */
-  unsigned int* nodes; /* the processed nodes */
+  unsigned int* nodes; /* unused, always NULL */
   TCOD_list_t path;
+  TCOD_PathWorkspace* workspace; /* holds the frontier between computations, may be NULL */
+  TCOD_PathCostGrid costs; /* step costs, data is NULL unless made with TCOD_dijkstra_new_using_costs */
 } TCOD_Dijkstra;
 typedef struct TCOD_Dijkstra* TCOD_dijkstra_t;
 
 TCODLIB_API TCOD_Dijkstra* TCOD_dijkstra_new(TCOD_Map* map, float diagonalCost);
 TCODLIB_API TCOD_Dijkstra* TCOD_dijkstra_new_using_function(
     int map_width, int map_height, TCOD_path_func_t func, void* user_data, float diagonalCost);
+/**
+    @brief Return a new Dijkstra map reading its step costs from `costs`.
+
+    This works like TCOD_dijkstra_new_using_function with a callback returning the costs of the grid.
+    The heuristic of `costs` is ignored.
+
+    Distances are stored in hundredths in 32-bit integers, so the maximum total cost is 42949672.94.
+    A cell further than that, such as over a long run of high 16-bit costs, is given this maximum instead of wrapping.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Dijkstra* TCOD_dijkstra_new_using_costs(const TCOD_PathCostGrid* costs, float diagonalCost);
+/**
+    @brief Compute the distances of every cell of `dijkstra` from `{root_x, root_y}`.
+
+    If `dijkstra` is NULL or the root is out of bounds then nothing is computed.
+    If the queue of nodes runs out of memory then the distances are incomplete.
+    Both cases set TCOD_get_error, use TCOD_dijkstra_compute_multi with one root to get an error code instead.
+ */
 TCODLIB_API void TCOD_dijkstra_compute(TCOD_Dijkstra* dijkstra, int root_x, int root_y);
+/**
+    @brief A root of a multi-source Dijkstra map and its initial distance.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_DijkstraRoot {
+  int x;
+  int y;
+  float distance;  // Initial distance of this root, in the same units as TCOD_dijkstra_get_distance.
+} TCOD_DijkstraRoot;
+/**
+    @brief Compute a Dijkstra map from many roots at once.
+
+    Every cell ends up with the lowest distance from any of the `n` `roots`, where each root starts with its own initial
+    distance instead of zero.
+    This is the same as calling TCOD_dijkstra_compute once per root and keeping the lowest distance of each cell, but
+    is done in a single pass.
+    TCOD_dijkstra_path_set will then find a path to the root which is closest to the given cell.
+
+    Initial distances must not be negative.
+    If `n` is zero then every cell is left unreachable.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_dijkstra_compute_multi(TCOD_Dijkstra* dijkstra, int n, const TCOD_DijkstraRoot* roots);
 TCODLIB_API float TCOD_dijkstra_get_distance(TCOD_Dijkstra* dijkstra, int x, int y);
 TCODLIB_API bool TCOD_dijkstra_path_set(TCOD_Dijkstra* dijkstra, int x, int y);
 TCODLIB_API bool TCOD_dijkstra_is_empty(TCOD_Dijkstra* path);
@@ -91,6 +389,15 @@ TCODLIB_API void TCOD_dijkstra_reverse(TCOD_Dijkstra* path);
 TCODLIB_API void TCOD_dijkstra_get(TCOD_Dijkstra* path, int index, int* x, int* y);
 TCODLIB_API bool TCOD_dijkstra_path_walk(TCOD_Dijkstra* dijkstra, int* x, int* y);
 TCODLIB_API void TCOD_dijkstra_delete(TCOD_Dijkstra* dijkstra);
+/**
+    @brief Make `dijkstra` keep its frontier in `workspace` between computations, or allocate it per computation if
+    `workspace` is NULL.
+
+    The distance grid belongs to `dijkstra` since it is the result of TCOD_dijkstra_compute.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_dijkstra_set_workspace(TCOD_Dijkstra* dijkstra, TCOD_PathWorkspace* workspace);
 #ifdef __cplusplus
 }
 #endif
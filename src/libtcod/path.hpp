@@ -36,6 +36,7 @@
 #define TCOD_PATH_HPP_
 
 #include <utility>
+#include <vector>
 
 #include "fov.hpp"
 #include "path.h"
@@ -119,6 +120,12 @@ public :
 	*/
 	TCODPath(const TCODMap *map, float diagonalCost=1.41f);
 	/**
+	@brief Allocate a pathfinder from a map using a specific search algorithm, see TCOD_PathAlgorithm.
+
+	@versionadded{Unreleased}
+	*/
+	TCODPath(const TCODMap *map, float diagonalCost, TCOD_PathAlgorithm algorithm);
+	/**
 	@PageName path_init
 	@FuncTitle Allocating a pathfinder using a callback
 	@FuncDesc Since the walkable status of a cell may depend on a lot of parameters (the creature type, the weather, the terrain type...), you can also create a path by providing a function rather than relying on a TCODMap.
@@ -532,6 +539,15 @@ class TCODLIB_API TCODDijkstra {
 			The coordinates should be inside the map, at a walkable position. Otherwise, the function's behaviour will be undefined.
         */
         void compute (int rootX, int rootY);
+        /**
+            @brief Compute the distances from many roots in a single pass, each with its own initial distance.
+
+            Every cell gets the lowest distance from any root, setPath will then lead to the closest root.
+            Throws std::invalid_argument if a root is out of bounds or has a negative distance.
+
+            @versionadded{Unreleased}
+         */
+        void compute(const std::vector<TCOD_DijkstraRoot>& roots);
 
         /**
         @PageName path_compute
@@ -36,6 +36,7 @@
 
 #include "libtcod_int.h"
 #include "path.h"
+#include "utility.h"
 enum { NORTH_WEST, NORTH, NORTH_EAST, WEST, NONE, EAST, SOUTH_WEST, SOUTH, SOUTH_EAST };
 typedef unsigned char dir_t;
 
@@ -44,43 +45,219 @@ static const int dir_x[] = {-1, 0, 1, -1, 0, 1, -1, 0, 1};
 static const int dir_y[] = {-1, -1, -1, 0, 0, 0, 1, 1, 1};
 static const int invert_dir[] = {SOUTH_EAST, SOUTH, SOUTH_WEST, EAST, NONE, WEST, NORTH_EAST, NORTH, NORTH_WEST};
 
+/* a queued Dijkstra node, stale entries are skipped when their distance no longer matches the distances grid */
+struct DijkstraNode {
+  unsigned int distance;
+  unsigned int index;
+};
+/* a growable array of queued nodes, popped from the front when used as a FIFO */
+struct DijkstraBucket {
+  struct DijkstraNode* nodes;
+  int head;
+  int size;
+  int capacity;
+};
+/*
+  The Dijkstra frontier.
+
+  With a map every step costs either the straight or the diagonal cost, nodes are pushed in order of distance onto one
+  FIFO per step cost, so the next node is always at the front of one of them.
+  Roots are sorted by their initial distance and go into a third FIFO.
+  With a callback the step costs are arbitrary so a radix heap is used instead, which only needs every key pushed to be
+  at least the last key popped.
+ */
+struct DijkstraQueue {
+  bool use_fifos;
+  int size;
+  unsigned int last; /* the last distance popped from the radix heap */
+  struct DijkstraBucket buckets[33]; /* fifos use 0 to 2, otherwise bucket i holds keys first differing at bit i-1 */
+};
+/*
+  Per-cell search state and open lists, shared by every TCOD_Path and TCOD_Dijkstra using it.
+
+  Cells are reset lazily: a cell whose stamp isn't the current generation hasn't been reached by the current search,
+  so starting a new search only increments the generation.
+ */
+struct TCOD_PathWorkspace {
+  int capacity; /* number of cells the node arrays can hold */
+  int jump_capacity; /* number of cells jump_parent and jump_arrivals can hold */
+  uint32_t generation;
+  uint32_t* stamps; /* the generation each cell was last reset in */
+  float* grid; /* dijkstra distance grid (covered distance) */
+  float* heuristic; /* A* score grid (covered distance + estimated remaining distance) */
+  dir_t* prev; /* A*: direction to the previous cell, Jump Point Search: directions not yet expanded */
+  uint32_t* jump_parent; /* Jump Point Search parents */
+  /* directions each jump point was reached from at its best cost, as jps_arrival_bit bits, set once grid is set */
+  dir_t* jump_arrivals;
+  uint32_t* heap; /* min_heap used by A*. stores the offset in grid/heuristic (offset=x+y*w) */
+  int heap_size;
+  struct DijkstraQueue dijkstra_queue; /* kept between searches to reuse its buckets */
+};
+
 typedef struct TCOD_Path {
   int ox, oy; /* coordinates of the creature position */
   int dx, dy; /* coordinates of the creature's destination */
   TCOD_list_t path; /* list of dir_t to follow the path */
   int w, h; /* map size */
-  float* grid; /* wxh dijkstra distance grid (covered distance) */
-  float* heuristic; /* wxh A* score grid (covered distance + estimated remaining distance) */
-  dir_t* prev; /* wxh 'previous' grid : direction to the previous cell */
   float diagonalCost;
-  TCOD_list_t heap; /* min_heap used in the algorithm. stores the offset in grid/heuristic (offset=x+y*w) */
+  bool jump_point; /* true if Jump Point Search is used */
+  TCOD_PathWorkspace* workspace; /* the workspace searches run in, either own_workspace or a shared one */
+  TCOD_PathWorkspace* own_workspace;
   TCOD_Map* map;
   TCOD_path_func_t func;
   void* user_data;
+  TCOD_PathCostGrid costs; /* step costs, data is NULL unless made with TCOD_path_new_using_costs */
+  int read_x_min, read_y_min, read_x_max, read_y_max; /* bounding box of the cells the last search expanded */
 } TCOD_Path;
 
-/* small layer on top of TCOD_list_t to implement a binary heap (min_heap) */
-static void heap_sift_down(TCOD_Path* path, TCOD_list_t heap) {
+/* return the cost of stepping onto {x, y}, type is a constant in the specialized search loops */
+static inline float path_cost_get(const TCOD_PathCostGrid* costs, TCOD_PathCostType type, int x, int y) {
+  const unsigned char* cost = (const unsigned char*)costs->data + x * costs->stride_x + y * costs->stride_y;
+  switch (type) {
+    case TCOD_PATH_COST_UINT8:
+      return (float)*cost;
+    case TCOD_PATH_COST_UINT16:
+      return (float)*(const uint16_t*)cost;
+    default:
+      return *(const float*)cost;
+  }
+}
+
+/* validate a cost grid and fill in its default strides */
+static bool path_cost_grid_init(TCOD_PathCostGrid* out, const TCOD_PathCostGrid* costs) {
+  if (!costs || !costs->data) {
+    TCOD_set_errorv("costs and its data must not be NULL.");
+    return false;
+  }
+  if (costs->width <= 0 || costs->height <= 0) {
+    TCOD_set_errorvf("Invalid cost grid size {%i, %i}.", costs->width, costs->height);
+    return false;
+  }
+  static const ptrdiff_t type_sizes[] = {sizeof(uint8_t), sizeof(uint16_t), sizeof(float)};
+  if ((unsigned)costs->type >= sizeof(type_sizes) / sizeof(*type_sizes)) {
+    TCOD_set_errorvf("Unknown cost type %i.", (int)costs->type);
+    return false;
+  }
+  *out = *costs;
+  if (!out->stride_x) out->stride_x = type_sizes[costs->type];
+  if (!out->stride_y) out->stride_y = out->stride_x * costs->width;
+  return true;
+}
+
+/* free the node arrays of a workspace, they are allocated again by the next search */
+static void path_workspace_release(TCOD_PathWorkspace* ws) {
+  free(ws->stamps);
+  free(ws->grid);
+  free(ws->heuristic);
+  free(ws->prev);
+  free(ws->jump_parent);
+  free(ws->jump_arrivals);
+  free(ws->heap);
+  ws->stamps = NULL;
+  ws->grid = ws->heuristic = NULL;
+  ws->prev = ws->jump_arrivals = NULL;
+  ws->jump_parent = ws->heap = NULL;
+  ws->capacity = ws->jump_capacity = 0;
+}
+
+/* make room in a workspace for searches over `cells` cells, the Jump Point Search arrays are only reserved if used */
+static bool path_workspace_reserve(TCOD_PathWorkspace* ws, int cells, bool jump_point) {
+  if (ws->capacity < cells) {
+    uint32_t* stamps = calloc(cells, sizeof(*stamps));
+    float* grid = malloc(cells * sizeof(*grid));
+    float* heuristic = malloc(cells * sizeof(*heuristic));
+    dir_t* prev = malloc(cells * sizeof(*prev));
+    uint32_t* heap = malloc(cells * sizeof(*heap));
+    if (!stamps || !grid || !heuristic || !prev || !heap) {
+      free(stamps);
+      free(grid);
+      free(heuristic);
+      free(prev);
+      free(heap);
+      TCOD_set_errorvf("Cannot allocate pathfinding grids of %i cells.", cells);
+      return false;
+    }
+    free(ws->stamps);
+    free(ws->grid);
+    free(ws->heuristic);
+    free(ws->prev);
+    free(ws->heap);
+    ws->stamps = stamps;
+    ws->grid = grid;
+    ws->heuristic = heuristic;
+    ws->prev = prev;
+    ws->heap = heap;
+    ws->capacity = cells;
+    ws->generation = 0; /* the new stamps are all zero, so generation zero is never used for a search */
+  }
+  if (jump_point && ws->jump_capacity < cells) {
+    uint32_t* jump_parent = malloc(cells * sizeof(*jump_parent));
+    dir_t* jump_arrivals = malloc(cells * sizeof(*jump_arrivals));
+    if (!jump_parent || !jump_arrivals) {
+      free(jump_parent);
+      free(jump_arrivals);
+      TCOD_set_errorvf("Cannot allocate Jump Point Search grids of %i cells.", cells);
+      return false;
+    }
+    free(ws->jump_parent);
+    free(ws->jump_arrivals);
+    ws->jump_parent = jump_parent;
+    ws->jump_arrivals = jump_arrivals;
+    ws->jump_capacity = cells;
+  }
+  return true;
+}
+
+/* start a new search over `cells` cells, every cell becomes unreached */
+static bool path_workspace_begin(TCOD_PathWorkspace* ws, int cells, bool jump_point) {
+  if (!path_workspace_reserve(ws, cells, jump_point)) return false;
+  ws->heap_size = 0;
+  if (++ws->generation == 0) {
+    /* the generation wrapped around, old stamps could match again */
+    memset(ws->stamps, 0, ws->capacity * sizeof(*ws->stamps));
+    ws->generation = 1;
+  }
+  return true;
+}
+
+/* reset the state of a cell the first time the current search reaches it */
+static void path_touch(TCOD_PathWorkspace* ws, uint32_t offset) {
+  if (ws->stamps[offset] == ws->generation) return;
+  ws->stamps[offset] = ws->generation;
+  ws->grid[offset] = 0;
+  ws->prev[offset] = 0;
+}
+
+/* record that the search looked at the cell {x, y} and its neighbors */
+static void path_mark_read(TCOD_Path* path, int x, int y) {
+  path->read_x_min = TCOD_MIN(path->read_x_min, x);
+  path->read_x_max = TCOD_MAX(path->read_x_max, x);
+  path->read_y_min = TCOD_MIN(path->read_y_min, y);
+  path->read_y_max = TCOD_MAX(path->read_y_max, y);
+}
+
+/* binary heap (min_heap) of cell offsets ordered by the A* score */
+static void heap_sift_down(TCOD_PathWorkspace* ws) {
   /* sift-down : move the first element of the heap down to its right place */
   int cur = 0;
-  int end = TCOD_list_size(heap) - 1;
+  int end = ws->heap_size - 1;
   int child = 1;
-  uintptr_t* array = (uintptr_t*)TCOD_list_begin(heap);
+  uint32_t* array = ws->heap;
   while (child <= end) {
     int toSwap = cur;
-    uintptr_t off_cur = array[cur];
-    float cur_dist = path->heuristic[off_cur];
+    uint32_t off_cur = array[cur];
+    float cur_dist = ws->heuristic[off_cur];
     float swapValue = cur_dist;
-    uintptr_t off_child = array[child];
-    float child_dist = path->heuristic[off_child];
+    uint32_t off_child = array[child];
+    float child_dist = ws->heuristic[off_child];
     if (child_dist < cur_dist) {
       toSwap = child;
       swapValue = child_dist;
     }
     if (child < end) {
       /* get the min between child and child+1 */
-      uintptr_t off_child2 = array[child + 1];
-      float child2_dist = path->heuristic[off_child2];
+      uint32_t off_child2 = array[child + 1];
+      float child2_dist = ws->heuristic[off_child2];
       if (swapValue > child2_dist) {
         toSwap = child + 1;
         swapValue = child2_dist;
@@ -88,7 +265,7 @@ static void heap_sift_down(TCOD_Path* path, TCOD_list_t heap) {
     }
     if (toSwap != cur) {
       /* get down one level */
-      uintptr_t tmp = array[toSwap];
+      uint32_t tmp = array[toSwap];
       array[toSwap] = array[cur];
       array[cur] = tmp;
       cur = toSwap;
@@ -98,20 +275,19 @@ static void heap_sift_down(TCOD_Path* path, TCOD_list_t heap) {
   }
 }
 
-static void heap_sift_up(TCOD_Path* path, TCOD_list_t heap) {
+static void heap_sift_up(TCOD_PathWorkspace* ws) {
   /* sift-up : move the last element of the heap up to its right place */
-  int end = TCOD_list_size(heap) - 1;
-  int child = end;
-  uintptr_t* array = (uintptr_t*)TCOD_list_begin(heap);
+  int child = ws->heap_size - 1;
+  uint32_t* array = ws->heap;
   while (child > 0) {
-    uintptr_t off_child = array[child];
-    float child_dist = path->heuristic[off_child];
+    uint32_t off_child = array[child];
+    float child_dist = ws->heuristic[off_child];
     int parent = (child - 1) / 2;
-    uintptr_t off_parent = array[parent];
-    float parent_dist = path->heuristic[off_parent];
+    uint32_t off_parent = array[parent];
+    float parent_dist = ws->heuristic[off_parent];
     if (parent_dist > child_dist) {
       /* get up one level */
-      uintptr_t tmp = array[child];
+      uint32_t tmp = array[child];
       array[child] = array[parent];
       array[parent] = tmp;
       child = parent;
@@ -121,51 +297,42 @@ static void heap_sift_up(TCOD_Path* path, TCOD_list_t heap) {
 }
 
 /* add a coordinate pair in the heap so that the heap root always contains the minimum A* score */
-static void heap_add(TCOD_Path* path, TCOD_list_t heap, int x, int y) {
-  /* append the new value to the end of the heap */
-  uintptr_t off = x + y * path->w;
-  TCOD_list_push(heap, (void*)off);
+static void heap_add(TCOD_Path* path, int x, int y) {
+  /* append the new value to the end of the heap, a cell is never in the heap twice so it always fits */
+  TCOD_PathWorkspace* ws = path->workspace;
+  ws->heap[ws->heap_size++] = x + y * path->w;
   /* bubble the value up to its real position */
-  heap_sift_up(path, heap);
+  heap_sift_up(ws);
 }
 
 /* get the coordinate pair with the minimum A* score from the heap */
-static uint32_t heap_get(TCOD_Path* path, TCOD_list_t heap) {
+static uint32_t heap_get(TCOD_PathWorkspace* ws) {
   /* return the first value of the heap (minimum score) */
-  uintptr_t* array = (uintptr_t*)TCOD_list_begin(heap);
-  int end = TCOD_list_size(heap) - 1;
-  uint32_t off = (uint32_t)(array[0]);
+  uint32_t off = ws->heap[0];
   /* take the last element and put it at first position (heap root) */
-  array[0] = array[end];
-  TCOD_list_pop(heap);
+  ws->heap[0] = ws->heap[--ws->heap_size];
   /* and bubble it down to its real position */
-  heap_sift_down(path, heap);
+  heap_sift_down(ws);
   return off;
 }
 
 /* this is the slow part, when we change the heuristic of a cell already in the heap */
-static void heap_reorder(TCOD_Path* path, uint32_t offset) {
-  uintptr_t* array = (uintptr_t*)TCOD_list_begin(path->heap);
-  uintptr_t* end = (uintptr_t*)TCOD_list_end(path->heap);
-  uintptr_t* cur = array;
-  uintptr_t off_idx = 0;
+static void heap_reorder(TCOD_PathWorkspace* ws, uint32_t offset) {
+  uint32_t* array = ws->heap;
+  uint32_t off_idx = 0;
   float value;
   int idx = 0;
-  int heap_size = TCOD_list_size(path->heap);
+  int heap_size = ws->heap_size;
   /* find the node corresponding to offset ... SLOW !! */
-  while (cur != end) {
-    if (*cur == offset) break;
-    cur++;
-    idx++;
-  }
-  if (cur == end) return;
+  while (idx < heap_size && array[idx] != offset) idx++;
+  if (idx == heap_size) return;
   off_idx = array[idx];
-  value = path->heuristic[off_idx];
+  value = ws->heuristic[off_idx];
   if (idx > 0) {
     int parent = (idx - 1) / 2;
     /* compare to its parent */
-    uintptr_t off_parent = array[parent];
-    float parent_value = path->heuristic[off_parent];
+    uint32_t off_parent = array[parent];
+    float parent_value = ws->heuristic[off_parent];
     if (value < parent_value) {
       /* smaller. bubble it up */
       while (idx > 0 && value < parent_value) {
@@ -176,7 +343,7 @@ static void heap_reorder(TCOD_Path* path, uint32_t offset) {
         if (idx > 0) {
           parent = (idx - 1) / 2;
           off_parent = array[parent];
-          parent_value = path->heuristic[off_parent];
+          parent_value = ws->heuristic[off_parent];
         }
       }
       return;
@@ -185,26 +352,26 @@ static void heap_reorder(TCOD_Path* path, uint32_t offset) {
   /* compare to its sons */
   while (idx * 2 + 1 < heap_size) {
     int child = idx * 2 + 1;
-    uintptr_t off_child = array[child];
+    uint32_t off_child = array[child];
     int toSwap = idx;
     int child2;
     float swapValue = value;
-    if (path->heuristic[off_child] < value) {
+    if (ws->heuristic[off_child] < value) {
       /* swap with son1 ? */
       toSwap = child;
-      swapValue = path->heuristic[off_child];
+      swapValue = ws->heuristic[off_child];
     }
     child2 = child + 1;
     if (child2 < heap_size) {
-      uintptr_t off_child2 = array[child2];
-      if (path->heuristic[off_child2] < swapValue) {
+      uint32_t off_child2 = array[child2];
+      if (ws->heuristic[off_child2] < swapValue) {
         /* swap with son2 */
         toSwap = child2;
       }
     }
     if (toSwap != idx) {
       /* bigger. bubble it down */
-      uintptr_t tmp = array[toSwap];
+      uint32_t tmp = array[toSwap];
       array[toSwap] = array[idx];
       array[idx] = tmp;
       idx = toSwap;
@@ -217,25 +384,26 @@ static void heap_reorder(TCOD_Path* path, uint32_t offset) {
 static void TCOD_path_push_cell(TCOD_Path* path, int x, int y);
 static void TCOD_path_get_cell(TCOD_Path* path, int* x, int* y, float* distance);
 static void TCOD_path_set_cells(TCOD_Path* path);
+static void path_set_cells_(TCOD_Path* path, int cost_type);
 static float TCOD_path_walk_cost(TCOD_Path* path, int xFrom, int yFrom, int xTo, int yTo);
+static void TCOD_path_set_cells_jps(TCOD_Path* path);
+static void TCOD_path_build_jps(TCOD_Path* path);
 
 static TCOD_Path* TCOD_path_new_intern(int w, int h) {
   TCOD_Path* path = (TCOD_Path*)calloc(1, sizeof(TCOD_Path));
+  if (!path) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
   path->w = w;
   path->h = h;
-  path->grid = calloc(w * h, sizeof(*path->grid));
-  path->heuristic = calloc(w * h, sizeof(*path->heuristic));
-  path->prev = calloc(w * h, sizeof(*path->prev));
-  if (!path->grid || !path->heuristic || !path->prev) {
-    free(path->grid);
-    free(path->heuristic);
-    free(path->prev);
+  path->own_workspace = TCOD_path_workspace_new(); /* its grids are allocated by the first search */
+  if (!path->own_workspace) {
     free(path);
-    TCOD_set_errorvf("Cannot allocate dijkstra grids of size {%d, %d}", w, h);
     return NULL;
   }
+  path->workspace = path->own_workspace;
   path->path = TCOD_list_new();
-  path->heap = TCOD_list_new();
   return path;
 }
 
@@ -250,6 +418,29 @@ TCOD_Path* TCOD_path_new_using_map(TCOD_Map* map, float diagonalCost) {
   return path;
 }
 
+/* return 1 if `algorithm` searches with Jump Point Search, 0 if it uses A*, or set an error and return -1 */
+static int path_uses_jump_point(TCOD_PathAlgorithm algorithm, float diagonalCost) {
+  if (algorithm != TCOD_PATH_ASTAR && algorithm != TCOD_PATH_JUMP_POINT) {
+    TCOD_set_errorvf("Unknown path algorithm %i.", (int)algorithm);
+    return -1;
+  }
+  /* the pruning rules of Jump Point Search assume diagonal steps cost no less than one step and no more than two */
+  return algorithm == TCOD_PATH_JUMP_POINT && diagonalCost >= 1.0f && diagonalCost <= 2.0f;
+}
+
+TCOD_Path* TCOD_path_new_using_map_ex(TCOD_Map* map, float diagonalCost, TCOD_PathAlgorithm algorithm) {
+  if (!map) {
+    TCOD_set_errorv("map must not be NULL.");
+    return NULL;
+  }
+  const int jump_point = path_uses_jump_point(algorithm, diagonalCost);
+  if (jump_point < 0) return NULL;
+  TCOD_Path* path = TCOD_path_new_using_map(map, diagonalCost);
+  if (!path) return NULL;
+  path->jump_point = jump_point;
+  return path;
+}
+
 TCOD_Path* TCOD_path_new_using_function(
     int map_width, int map_height, TCOD_path_func_t func, void* user_data, float diagonalCost) {
   TCOD_IFNOT(func != NULL && map_width > 0 && map_height > 0) return NULL;
@@ -263,6 +454,16 @@ TCOD_Path* TCOD_path_new_using_function(
   return path;
 }
 
+TCOD_Path* TCOD_path_new_using_costs(const TCOD_PathCostGrid* costs, float diagonalCost) {
+  TCOD_PathCostGrid grid;
+  if (!path_cost_grid_init(&grid, costs)) return NULL;
+  TCOD_Path* path = TCOD_path_new_intern(grid.width, grid.height);
+  if (!path) return NULL;
+  path->costs = grid;
+  path->diagonalCost = diagonalCost;
+  return path;
+}
+
 bool TCOD_path_compute(TCOD_Path* path, int ox, int oy, int dx, int dy) {
   TCOD_IFNOT(path != NULL) return false;
   path->ox = ox;
@@ -270,23 +471,32 @@ bool TCOD_path_compute(TCOD_Path* path, int ox, int oy, int dx, int dy) {
   path->dx = dx;
   path->dy = dy;
   TCOD_list_clear(path->path);
-  TCOD_list_clear(path->heap);
   if (ox == dx && oy == dy) return true; /* trivial case */
   /* check that origin and destination are inside the map */
   TCOD_IFNOT((unsigned)ox < (unsigned)path->w && (unsigned)oy < (unsigned)path->h) return false;
   TCOD_IFNOT((unsigned)dx < (unsigned)path->w && (unsigned)dy < (unsigned)path->h) return false;
-  /* initialize dijkstra grids */
-  memset(path->grid, 0, sizeof(float) * path->w * path->h);
-  memset(path->prev, NONE, sizeof(dir_t) * path->w * path->h);
-  path->heuristic[ox + oy * path->w] = 1.0f; /* anything != 0 */
+  /* initialize dijkstra grids, cells are only reset once the search reaches them */
+  TCOD_PathWorkspace* ws = path->workspace;
+  if (!path_workspace_begin(ws, path->w * path->h, path->jump_point)) return false;
+  path_touch(ws, ox + oy * path->w);
+  path_touch(ws, dx + dy * path->w);
+  path->read_x_min = path->read_x_max = ox;
+  path->read_y_min = path->read_y_max = oy;
+  if (path->jump_point) {
+    TCOD_path_set_cells_jps(path);
+    if (ws->grid[dx + dy * path->w] == 0) return false; /* no path found */
+    TCOD_path_build_jps(path);
+    return true;
+  }
+  ws->heuristic[ox + oy * path->w] = 1.0f; /* anything != 0 */
   TCOD_path_push_cell(path, ox, oy); /* put the origin cell as a bootstrap */
   /* fill the dijkstra grid until we reach dx,dy */
   TCOD_path_set_cells(path);
-  if (path->grid[dx + dy * path->w] == 0) return false; /* no path found */
+  if (ws->grid[dx + dy * path->w] == 0) return false; /* no path found */
   /* there is a path. retrieve it */
   do {
     /* walk from destination to origin, using the 'prev' array */
-    int step = path->prev[dx + dy * path->w];
+    int step = ws->prev[dx + dy * path->w];
     TCOD_list_push(path->path, (void*)(uintptr_t)step);
     dx -= dir_x[step];
     dy -= dir_y[step];
@@ -356,33 +566,70 @@ void TCOD_path_get(TCOD_Path* path, int index, int* x, int* y) {
 
 void TCOD_path_delete(TCOD_Path* path) {
   TCOD_IFNOT(path != NULL) return;
-  if (path->grid) free(path->grid);
-  if (path->heuristic) free(path->heuristic);
-  if (path->prev) free(path->prev);
+  TCOD_path_workspace_delete(path->own_workspace);
   if (path->path) TCOD_list_delete(path->path);
-  if (path->heap) TCOD_list_delete(path->heap);
   free(path);
 }
 
+TCOD_PathWorkspace* TCOD_path_workspace_new(void) {
+  TCOD_PathWorkspace* workspace = calloc(1, sizeof(*workspace));
+  if (!workspace) TCOD_set_errorv("Out of memory.");
+  return workspace;
+}
+
+void TCOD_path_workspace_delete(TCOD_PathWorkspace* workspace) {
+  if (!workspace) return;
+  path_workspace_release(workspace);
+  for (int i = 0; i < 33; ++i) free(workspace->dijkstra_queue.buckets[i].nodes);
+  free(workspace);
+}
+
+void TCOD_path_set_workspace(TCOD_Path* path, TCOD_PathWorkspace* workspace) {
+  TCOD_IFNOT(path != NULL) return;
+  path->workspace = workspace ? workspace : path->own_workspace;
+  /* the private grids are allocated again by the next search which needs them */
+  if (workspace && workspace != path->own_workspace) path_workspace_release(path->own_workspace);
+}
+
 /* private stuff */
 /* add a new unvisited cells to the cells-to-treat list
  * the list is in fact a min_heap. Cell at index i has its sons at 2*i+1 and 2*i+2
  */
-static void TCOD_path_push_cell(TCOD_Path* path, int x, int y) { heap_add(path, path->heap, x, y); }
+static void TCOD_path_push_cell(TCOD_Path* path, int x, int y) { heap_add(path, x, y); }
 
 /* get the best cell from the heap */
 static void TCOD_path_get_cell(TCOD_Path* path, int* x, int* y, float* distance) {
-  uint32_t offset = heap_get(path, path->heap);
+  uint32_t offset = heap_get(path->workspace);
   *x = (offset % path->w);
   *y = (offset / path->w);
-  *distance = path->grid[offset];
+  *distance = path->workspace->grid[offset];
 }
 /* fill the grid, starting from the origin until we reach the destination */
 static void TCOD_path_set_cells(TCOD_Path* path) {
-  while (path->grid[path->dx + path->dy * path->w] == 0 && !TCOD_list_is_empty(path->heap)) {
+  /* pick the loop specialized for the cost grid type, or -1 for maps and callbacks */
+  if (!path->costs.data) {
+    path_set_cells_(path, -1);
+    return;
+  }
+  switch (path->costs.type) {
+    case TCOD_PATH_COST_UINT8:
+      path_set_cells_(path, TCOD_PATH_COST_UINT8);
+      break;
+    case TCOD_PATH_COST_UINT16:
+      path_set_cells_(path, TCOD_PATH_COST_UINT16);
+      break;
+    default:
+      path_set_cells_(path, TCOD_PATH_COST_FLOAT);
+      break;
+  }
+}
+static inline void path_set_cells_(TCOD_Path* path, int cost_type) {
+  TCOD_PathWorkspace* ws = path->workspace;
+  while (ws->grid[path->dx + path->dy * path->w] == 0 && ws->heap_size > 0) {
     int x, y;
     float distance;
     TCOD_path_get_cell(path, &x, &y, &distance);
+    path_mark_read(path, x, y);
     int i_max = (path->diagonalCost == 0.0f ? 4 : 8);
     for (int i = 0; i < i_max; i++) {
       /* convert i to dx,dy */
@@ -394,28 +641,33 @@ static void TCOD_path_set_cells(TCOD_Path* path) {
       int cx = x + i_dir_x[i];
       int cy = y + i_dir_y[i];
       if (cx >= 0 && cy >= 0 && cx < path->w && cy < path->h) {
-        float walk_cost = TCOD_path_walk_cost(path, x, y, cx, cy);
+        const float walk_cost = cost_type < 0 ? TCOD_path_walk_cost(path, x, y, cx, cy)
+                                              : path_cost_get(&path->costs, (TCOD_PathCostType)cost_type, cx, cy);
         if (walk_cost > 0.0f) {
           /* in of the map and walkable */
           float covered = distance + walk_cost * (i >= 4 ? path->diagonalCost : 1.0f);
-          float previousCovered = path->grid[cx + cy * path->w];
+          path_touch(ws, cx + cy * path->w);
+          float previousCovered = ws->grid[cx + cy * path->w];
           if (previousCovered == 0) {
             /* put a new cell in the heap */
             int offset = cx + cy * path->w;
             /* A* heuristic : remaining distance */
-            float remaining = (float)sqrt((cx - path->dx) * (cx - path->dx) + (cy - path->dy) * (cy - path->dy));
-            path->grid[offset] = covered;
-            path->heuristic[offset] = covered + remaining;
-            path->prev[offset] = previous_dirs[i];
+            const float remaining =
+                path->costs.heuristic
+                    ? path->costs.heuristic[offset]
+                    : (float)sqrt((cx - path->dx) * (cx - path->dx) + (cy - path->dy) * (cy - path->dy));
+            ws->grid[offset] = covered;
+            ws->heuristic[offset] = covered + remaining;
+            ws->prev[offset] = previous_dirs[i];
             TCOD_path_push_cell(path, cx, cy);
           } else if (previousCovered > covered) {
             /* we found a better path to a cell already in the heap */
             int offset = cx + cy * path->w;
-            path->grid[offset] = covered;
-            path->heuristic[offset] -= (previousCovered - covered); /* fix the A* score */
-            path->prev[offset] = previous_dirs[i];
+            ws->grid[offset] = covered;
+            ws->heuristic[offset] -= (previousCovered - covered); /* fix the A* score */
+            ws->prev[offset] = previous_dirs[i];
             /* reorder the heap */
-            heap_reorder(path, offset);
+            heap_reorder(ws, offset);
           }
         }
       }
@@ -426,9 +678,289 @@ static void TCOD_path_set_cells(TCOD_Path* path) {
 /* check if a cell is walkable (from the pathfinder point of view) */
 static float TCOD_path_walk_cost(TCOD_Path* path, int xFrom, int yFrom, int xTo, int yTo) {
   if (path->map) return TCOD_map_is_walkable(path->map, xTo, yTo) ? 1.0f : 0.0f;
+  if (path->costs.data) return path_cost_get(&path->costs, path->costs.type, xTo, yTo);
   return path->func(xFrom, yFrom, xTo, yTo, path->user_data);
 }
 
+/* ------------------------------------------------------- *
+ * Jump Point Search                                       *
+ * -----------------                                       *
+ * A* on uniform cost maps which only adds the cells where *
+ * the shortest paths can turn to the open list.           *
+ * Harabor & Grastien, "Online Graph Pruning for           *
+ * Pathfinding on Grid Maps", 2011.                        *
+ * ------------------------------------------------------- */
+
+/* return true if {x, y} is in bounds and walkable */
+static bool jps_walkable(const TCOD_Map* map, int x, int y) {
+  return TCOD_map_in_bounds(map, x, y) && TCOD_map_get_walkable_(map, x, y);
+}
+
+static int jps_sign(int n) { return (n > 0) - (n < 0); }
+
+/* return the dir_t of the step {dx, dy} */
+static int jps_dir(int dx, int dy) { return (dy + 1) * 3 + dx + 1; }
+
+/* return the bit for arriving by the dir_t `dir`, NONE is skipped so that all 8 directions fit in a dir_t */
+static dir_t jps_arrival_bit(int dir) { return (dir_t)(1u << (dir < NONE ? dir : dir - 1)); }
+
+/* return the walkable flags of the cells {x..x+63, y} of a bit-packed map, out-of-bounds cells are unwalkable */
+static uint64_t jps_walkable_word(const TCOD_Map* map, int x, int y) {
+  if (y < 0 || y >= map->height || x >= map->width || x <= -64) return 0;
+  if (x < 0) return jps_walkable_word(map, 0, y) << -x;
+  const uint64_t* row = &map->walkable_bits[(ptrdiff_t)y * map->bits_stride];
+  const int word = x >> 6;
+  const int shift = x & 63;
+  uint64_t bits = row[word] >> shift;
+  if (shift && word + 1 < map->bits_stride) bits |= row[word + 1] << (64 - shift);
+  return bits;
+}
+
+/* return the number of bits needed to represent n */
+static int bit_length(uint64_t n) {
+  int length = 0;
+  if (n >= (uint64_t)1 << 32) {
+    length += 32;
+    n >>= 32;
+  }
+  if (n >= (uint64_t)1 << 16) {
+    length += 16;
+    n >>= 16;
+  }
+  if (n >= (uint64_t)1 << 8) {
+    length += 8;
+    n >>= 8;
+  }
+  if (n >= (uint64_t)1 << 4) {
+    length += 4;
+    n >>= 4;
+  }
+  if (n >= (uint64_t)1 << 2) {
+    length += 2;
+    n >>= 2;
+  }
+  if (n >= (uint64_t)1 << 1) {
+    length += 1;
+    n >>= 1;
+  }
+  return length + (int)n;
+}
+
+/* scan a bit-packed row 64 cells at a time, see jps_jump_horizontal */
+static int jps_jump_horizontal_bits(TCOD_Path* path, int x, int y, int dx) {
+  const TCOD_Map* map = path->map;
+  if (dx > 0) {
+    for (int base = x + 1;; base += 64) {
+      /* bit i is the cell {base + i, y} */
+      const uint64_t open = jps_walkable_word(map, base, y);
+      const uint64_t forced = (~jps_walkable_word(map, base, y - 1) & jps_walkable_word(map, base + 1, y - 1)) |
+                              (~jps_walkable_word(map, base, y + 1) & jps_walkable_word(map, base + 1, y + 1));
+      uint64_t stops = ~open | forced;
+      if (y == path->dy && path->dx >= base && path->dx - base < 64) stops |= (uint64_t)1 << (path->dx - base);
+      if (!stops) continue;
+      const int i = bit_length(stops & (~stops + 1)) - 1;
+      path_mark_read(path, base + i, y);
+      return (open >> i) & 1 ? base + i : -1;
+    }
+  }
+  for (int last = x - 1;; last -= 64) {
+    /* bit i is the cell {last - 63 + i, y} */
+    const int base = last - 63;
+    const uint64_t open = jps_walkable_word(map, base, y);
+    const uint64_t forced = (~jps_walkable_word(map, base, y - 1) & jps_walkable_word(map, base - 1, y - 1)) |
+                            (~jps_walkable_word(map, base, y + 1) & jps_walkable_word(map, base - 1, y + 1));
+    uint64_t stops = ~open | forced;
+    if (y == path->dy && path->dx <= last && last - path->dx < 64) stops |= (uint64_t)1 << (path->dx - base);
+    if (!stops) continue;
+    const int i = bit_length(stops) - 1;
+    path_mark_read(path, base + i, y);
+    return (open >> i) & 1 ? base + i : -1;
+  }
+}
+
+/* return the x of the first jump point from {x, y} going in the direction dx, or -1 if there isn't one */
+static int jps_jump_horizontal(TCOD_Path* path, int x, int y, int dx) {
+  const TCOD_Map* map = path->map;
+  if (map->walkable_bits) return jps_jump_horizontal_bits(path, x, y, dx);
+  for (int cx = x + dx;; cx += dx) {
+    if (!jps_walkable(map, cx, y)) {
+      path_mark_read(path, cx, y);
+      return -1;
+    }
+    if ((cx == path->dx && y == path->dy) || (!jps_walkable(map, cx, y - 1) && jps_walkable(map, cx + dx, y - 1)) ||
+        (!jps_walkable(map, cx, y + 1) && jps_walkable(map, cx + dx, y + 1))) {
+      path_mark_read(path, cx, y);
+      return cx;
+    }
+  }
+}
+
+/* return the y of the first jump point from {x, y} going in the direction dy, or -1 if there isn't one */
+static int jps_jump_vertical(TCOD_Path* path, int x, int y, int dy) {
+  const TCOD_Map* map = path->map;
+  for (int cy = y + dy;; cy += dy) {
+    if (!jps_walkable(map, x, cy)) {
+      path_mark_read(path, x, cy);
+      return -1;
+    }
+    if ((x == path->dx && cy == path->dy) || (!jps_walkable(map, x - 1, cy) && jps_walkable(map, x - 1, cy + dy)) ||
+        (!jps_walkable(map, x + 1, cy) && jps_walkable(map, x + 1, cy + dy))) {
+      path_mark_read(path, x, cy);
+      return cy;
+    }
+  }
+}
+
+/* find the first jump point from {*x, *y} in the direction {dx, dy} and move {*x, *y} to it, return false if none */
+static bool jps_jump(TCOD_Path* path, int* x, int* y, int dx, int dy) {
+  if (dy == 0) {
+    *x = jps_jump_horizontal(path, *x, *y, dx);
+    return *x >= 0;
+  }
+  if (dx == 0) {
+    *y = jps_jump_vertical(path, *x, *y, dy);
+    return *y >= 0;
+  }
+  const TCOD_Map* map = path->map;
+  int cx = *x;
+  int cy = *y;
+  for (;;) {
+    cx += dx;
+    cy += dy;
+    path_mark_read(path, cx, cy);
+    if (!jps_walkable(map, cx, cy)) return false;
+    /* stop at the destination, at forced neighbors, or where a straight jump finds something */
+    if ((cx == path->dx && cy == path->dy) ||
+        (!jps_walkable(map, cx - dx, cy) && jps_walkable(map, cx - dx, cy + dy)) ||
+        (!jps_walkable(map, cx, cy - dy) && jps_walkable(map, cx + dx, cy - dy)) ||
+        jps_jump_horizontal(path, cx, cy, dx) >= 0 || jps_jump_vertical(path, cx, cy, dy) >= 0) {
+      *x = cx;
+      *y = cy;
+      return true;
+    }
+  }
+}
+
+/* return the dir_t bits of the directions worth searching from {x, y} when it was reached going in {dx, dy} */
+static unsigned jps_successors(const TCOD_Map* map, int x, int y, int dx, int dy) {
+  if (dx != 0 && dy != 0) {
+    unsigned dirs = (1u << jps_dir(dx, 0)) | (1u << jps_dir(0, dy)) | (1u << jps_dir(dx, dy));
+    if (!jps_walkable(map, x - dx, y) && jps_walkable(map, x - dx, y + dy)) dirs |= 1u << jps_dir(-dx, dy);
+    if (!jps_walkable(map, x, y - dy) && jps_walkable(map, x + dx, y - dy)) dirs |= 1u << jps_dir(dx, -dy);
+    return dirs;
+  }
+  unsigned dirs = 1u << jps_dir(dx, dy);
+  /* the two cells on either side of the move, as offsets perpendicular to it */
+  const int side_x = dy;
+  const int side_y = dx;
+  for (int side = -1; side <= 1; side += 2) {
+    if (!jps_walkable(map, x + side * side_x, y + side * side_y) &&
+        jps_walkable(map, x + side * side_x + dx, y + side * side_y + dy)) {
+      dirs |= 1u << jps_dir(dx + side * side_x, dy + side * side_y);
+    }
+  }
+  return dirs;
+}
+
+/* return the octile distance from {x, y} to the destination */
+static float jps_heuristic(const TCOD_Path* path, int x, int y) {
+  const int distance_x = abs(x - path->dx);
+  const int distance_y = abs(y - path->dy);
+  const int diagonal = TCOD_MIN(distance_x, distance_y);
+  return (float)(TCOD_MAX(distance_x, distance_y) - diagonal) + (float)diagonal * path->diagonalCost;
+}
+
+
+/*
+  fill grid and jump_parent for the jump points, starting from the origin until the destination is reached
+
+  A jump point only prunes the successors which are reached at least as cheaply from the direction it was entered by.
+  When a diagonal step costs exactly 1 or 2 steps then different mixes of steps can tie, so a jump point is expanded
+  once for every direction it is reached from at its best cost.
+  The directions not yet expanded are kept in prev, a non-zero value means the cell is queued.
+*/
+static void TCOD_path_set_cells_jps(TCOD_Path* path) {
+  TCOD_PathWorkspace* ws = path->workspace;
+  const int w = path->w;
+  const uint32_t origin = path->ox + path->oy * w;
+  const uint32_t destination = path->dx + path->dy * w;
+  ws->jump_parent[origin] = origin;
+  ws->heuristic[origin] = jps_heuristic(path, path->ox, path->oy);
+  heap_add(path, path->ox, path->oy);
+  while (ws->heap_size > 0) {
+    const uint32_t offset = heap_get(ws);
+    if (offset == destination) break;
+    const int x = offset % w;
+    const int y = offset / w;
+    unsigned dirs = 0;
+    if (offset == origin) {
+      dirs = ((1u << 9) - 1) & ~(1u << NONE); /* search everywhere */
+    } else {
+      for (int arrival = 0; arrival < 9; ++arrival) {
+        if (arrival != NONE && ws->prev[offset] & jps_arrival_bit(arrival)) {
+          dirs |= jps_successors(path->map, x, y, dir_x[arrival], dir_y[arrival]);
+        }
+      }
+    }
+    ws->prev[offset] = 0;
+    for (int dir = 0; dir < 9; ++dir) {
+      if (!(dirs & (1u << dir))) continue;
+      int jump_x = x;
+      int jump_y = y;
+      if (!jps_jump(path, &jump_x, &jump_y, dir_x[dir], dir_y[dir])) continue;
+      const uint32_t jump = jump_x + jump_y * w;
+      if (jump == origin) continue;
+      path_touch(ws, jump);
+      const int steps = TCOD_MAX(abs(jump_x - x), abs(jump_y - y));
+      const float covered = ws->grid[offset] + (float)steps * (dir_x[dir] && dir_y[dir] ? path->diagonalCost : 1.0f);
+      const float previousCovered = ws->grid[jump];
+      const float tolerance = covered * 1e-5f; /* sums of the same steps in a different order can round differently */
+      if (previousCovered == 0 || previousCovered > covered + tolerance) {
+        /* a new jump point or a better path to one */
+        const bool queued = ws->prev[jump] != 0;
+        ws->heuristic[jump] = covered + jps_heuristic(path, jump_x, jump_y);
+        ws->grid[jump] = covered;
+        ws->jump_parent[jump] = offset;
+        ws->jump_arrivals[jump] = ws->prev[jump] = jps_arrival_bit(dir);
+        if (queued) {
+          heap_reorder(ws, jump);
+        } else {
+          heap_add(path, jump_x, jump_y);
+        }
+      } else if (previousCovered >= covered - tolerance && !(ws->jump_arrivals[jump] & jps_arrival_bit(dir))) {
+        /* an equally good path from another direction */
+        if (!ws->prev[jump]) heap_add(path, jump_x, jump_y);
+        ws->prev[jump] |= jps_arrival_bit(dir);
+        ws->jump_arrivals[jump] |= jps_arrival_bit(dir);
+      }
+    }
+  }
+}
+
+/* fill the path list by walking the straight lines between jump points from the destination back to the origin */
+static void TCOD_path_build_jps(TCOD_Path* path) {
+  const TCOD_PathWorkspace* ws = path->workspace;
+  const int w = path->w;
+  const uint32_t origin = path->ox + path->oy * w;
+  uint32_t jump = path->dx + path->dy * w;
+  while (jump != origin) {
+    const uint32_t parent = ws->jump_parent[jump];
+    int x = jump % w;
+    int y = jump / w;
+    const int parent_x = parent % w;
+    const int parent_y = parent / w;
+    const int step_x = jps_sign(x - parent_x);
+    const int step_y = jps_sign(y - parent_y);
+    const int step = jps_dir(step_x, step_y);
+    while (x != parent_x || y != parent_y) {
+      TCOD_list_push(path->path, (void*)(uintptr_t)step);
+      x -= step_x;
+      y -= step_y;
+    }
+    jump = parent;
+  }
+}
+
 void TCOD_path_get_origin(TCOD_Path* path, int* x, int* y) {
   TCOD_IFNOT(path != NULL) return;
   if (x) *x = path->ox;
@@ -441,6 +973,270 @@ void TCOD_path_get_destination(TCOD_Path* path, int* x, int* y) {
   if (y) *y = path->dy;
 }
 
+/* a cached A* result */
+struct PathCacheEntry {
+  bool used;
+  bool found;
+  int ox, oy, dx, dy; /* the endpoints this entry is keyed by */
+  uint64_t version; /* the map version when this was computed */
+  int x, y, w, h; /* bounding box of every cell the search read */
+  int length;
+  dir_t* steps; /* the path list, in the same order as TCOD_Path.path */
+};
+
+struct TCOD_PathCache {
+  TCOD_Path* path;
+  int capacity;
+  struct PathCacheEntry* entries;
+  int hits;
+  int misses;
+};
+
+TCOD_PathCache* TCOD_path_cache_new(TCOD_Path* path, int capacity) {
+  if (!path) {
+    TCOD_set_errorv("path must not be NULL.");
+    return NULL;
+  }
+  if (capacity <= 0) {
+    TCOD_set_errorvf("capacity must be positive, got %i.", capacity);
+    return NULL;
+  }
+  TCOD_PathCache* cache = calloc(1, sizeof(*cache));
+  if (!cache) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  cache->entries = calloc(capacity, sizeof(*cache->entries));
+  if (!cache->entries) {
+    free(cache);
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  cache->path = path;
+  cache->capacity = capacity;
+  return cache;
+}
+
+void TCOD_path_cache_clear(TCOD_PathCache* cache) {
+  if (!cache) return;
+  for (int i = 0; i < cache->capacity; ++i) {
+    free(cache->entries[i].steps);
+    cache->entries[i].steps = NULL;
+    cache->entries[i].used = false;
+  }
+}
+
+void TCOD_path_cache_delete(TCOD_PathCache* cache) {
+  if (!cache) return;
+  TCOD_path_cache_clear(cache);
+  free(cache->entries);
+  free(cache);
+}
+
+/* return the cache slot for a pair of endpoints */
+static struct PathCacheEntry* path_cache_slot(TCOD_PathCache* cache, int ox, int oy, int dx, int dy) {
+  uint32_t hash = 2166136261u;
+  const int keys[4] = {ox, oy, dx, dy};
+  for (int i = 0; i < 4; ++i) hash = (hash ^ (uint32_t)keys[i]) * 16777619u;
+  return &cache->entries[hash % (uint32_t)cache->capacity];
+}
+
+/* return true if nothing the search for entry read has changed since */
+static bool path_cache_entry_is_valid(const TCOD_PathCache* cache, const struct PathCacheEntry* entry) {
+  const TCOD_Map* map = cache->path->map;
+  if (!map) return true; /* changes to a callback's data can't be tracked */
+  if (map->version == entry->version) return true;
+  return TCOD_map_get_version(map, entry->x, entry->y, entry->w, entry->h) <= entry->version;
+}
+
+/* store the result of the last TCOD_path_compute in entry */
+static void path_cache_store(TCOD_PathCache* cache, struct PathCacheEntry* entry, bool found) {
+  const TCOD_Path* path = cache->path;
+  const int length = TCOD_list_size(path->path);
+  dir_t* steps = entry->steps;
+  if (length > entry->length || !steps) {
+    steps = realloc(entry->steps, length ? length : 1);
+    if (!steps) {
+      free(entry->steps);
+      entry->steps = NULL;
+      entry->used = false;
+      return; /* not caching a result is always safe */
+    }
+  }
+  /* the search reads the cells it expanded and their neighbors */
+  const int x_min = path->read_x_min;
+  const int y_min = path->read_y_min;
+  const int x_max = path->read_x_max;
+  const int y_max = path->read_y_max;
+  for (int i = 0; i < length; ++i) steps[i] = (dir_t)(uintptr_t)TCOD_list_get(path->path, i);
+  entry->used = true;
+  entry->found = found;
+  entry->ox = path->ox;
+  entry->oy = path->oy;
+  entry->dx = path->dx;
+  entry->dy = path->dy;
+  entry->version = path->map ? path->map->version : 0;
+  entry->x = x_min - 1;
+  entry->y = y_min - 1;
+  entry->w = x_max - x_min + 3;
+  entry->h = y_max - y_min + 3;
+  entry->length = length;
+  entry->steps = steps;
+}
+
+bool TCOD_path_cache_compute(TCOD_PathCache* cache, int ox, int oy, int dx, int dy) {
+  TCOD_IFNOT(cache != NULL) return false;
+  TCOD_Path* path = cache->path;
+  if ((ox == dx && oy == dy) || (unsigned)ox >= (unsigned)path->w || (unsigned)oy >= (unsigned)path->h ||
+      (unsigned)dx >= (unsigned)path->w || (unsigned)dy >= (unsigned)path->h) {
+    return TCOD_path_compute(path, ox, oy, dx, dy); /* trivial cases aren't cached */
+  }
+  struct PathCacheEntry* entry = path_cache_slot(cache, ox, oy, dx, dy);
+  if (entry->used && entry->ox == ox && entry->oy == oy && entry->dx == dx && entry->dy == dy &&
+      path_cache_entry_is_valid(cache, entry)) {
+    ++cache->hits;
+    path->ox = ox;
+    path->oy = oy;
+    path->dx = dx;
+    path->dy = dy;
+    TCOD_list_clear(path->path);
+    for (int i = 0; i < entry->length; ++i) TCOD_list_push(path->path, (void*)(uintptr_t)entry->steps[i]);
+    return entry->found;
+  }
+  ++cache->misses;
+  const bool found = TCOD_path_compute(path, ox, oy, dx, dy);
+  path_cache_store(cache, entry, found);
+  return found;
+}
+
+void TCOD_path_cache_get_stats(const TCOD_PathCache* cache, int* hits, int* misses) {
+  if (hits) *hits = cache ? cache->hits : 0;
+  if (misses) *misses = cache ? cache->misses : 0;
+}
+
+/* shared state of TCOD_path_compute_batch */
+struct PathBatch {
+  const TCOD_PathQuery* queries;
+  TCOD_PathRoute* out;
+  TCOD_Path* paths; /* one pathfinder per worker, each with its own workspace */
+  TCOD_Error* worker_errors; /* the first error seen by each worker */
+};
+
+/* compute one query of a batch on the given worker */
+static void path_batch_task(void* userdata, int index, int worker) {
+  struct PathBatch* batch = userdata;
+  TCOD_Path* path = &batch->paths[worker];
+  const TCOD_PathQuery* query = &batch->queries[index];
+  TCOD_PathRoute* route = &batch->out[index];
+  if (!TCOD_path_compute(path, query->ox, query->oy, query->dx, query->dy)) return;
+  const int length = TCOD_list_size(path->path);
+  if (length > 0) {
+    route->xy = malloc(sizeof(*route->xy) * 2 * length);
+    if (!route->xy) {
+      batch->worker_errors[worker] = TCOD_E_OUT_OF_MEMORY;
+      return;
+    }
+  }
+  /* the steps are stored from the destination back to the origin */
+  int x = query->ox;
+  int y = query->oy;
+  for (int i = 0; i < length; ++i) {
+    const int step = (int)(uintptr_t)TCOD_list_get(path->path, length - 1 - i);
+    x += dir_x[step];
+    y += dir_y[step];
+    route->xy[i * 2] = x;
+    route->xy[i * 2 + 1] = y;
+  }
+  route->length = length;
+}
+
+TCOD_Error TCOD_path_compute_batch(
+    const TCOD_Map* map,
+    float diagonalCost,
+    TCOD_PathAlgorithm algorithm,
+    int n,
+    const TCOD_PathQuery* queries,
+    TCOD_PathRoute* out,
+    int n_workspaces,
+    TCOD_PathWorkspace* const* workspaces) {
+  if (!map) {
+    TCOD_set_errorv("map must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (n < 0 || (n > 0 && (!queries || !out))) {
+    TCOD_set_errorvf("Expected %i queries but queries or out was NULL or n was negative.", n);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (n_workspaces < 0 || (n_workspaces > 0 && !workspaces)) {
+    TCOD_set_errorvf("Expected %i workspaces but workspaces was NULL or n_workspaces was negative.", n_workspaces);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  for (int i = 0; i < n_workspaces; ++i) {
+    if (!workspaces[i]) {
+      TCOD_set_errorvf("Workspace at index %i is NULL.", i);
+      return TCOD_E_INVALID_ARGUMENT;
+    }
+  }
+  const int jump_point = path_uses_jump_point(algorithm, diagonalCost);
+  if (jump_point < 0) return TCOD_E_INVALID_ARGUMENT;
+  for (int i = 0; i < n; ++i) {
+    const TCOD_PathQuery* query = &queries[i];
+    if (!TCOD_map_in_bounds(map, query->ox, query->oy) || !TCOD_map_in_bounds(map, query->dx, query->dy)) {
+      TCOD_set_errorvf(
+          "Query {%i, %i} to {%i, %i} at index %i is out of bounds.", query->ox, query->oy, query->dx, query->dy, i);
+      return TCOD_E_INVALID_ARGUMENT;
+    }
+  }
+  for (int i = 0; i < n; ++i) out[i] = (TCOD_PathRoute){-1, NULL};
+  if (n == 0) return TCOD_E_OK;
+  int workers = TCOD_parallel_worker_count_(n);
+  if (n_workspaces > 0 && n_workspaces < workers) workers = n_workspaces;
+  const int width = TCOD_map_get_width(map);
+  const int height = TCOD_map_get_height(map);
+  /* each pathfinder searches in a workspace of the caller, or a temporary one, instead of allocating its own grids */
+  TCOD_Path paths[TCOD_PARALLEL_MAX_WORKERS_] = {{0}};
+  TCOD_PathWorkspace* temporary_workspaces[TCOD_PARALLEL_MAX_WORKERS_] = {NULL};
+  TCOD_Error worker_errors[TCOD_PARALLEL_MAX_WORKERS_] = {TCOD_E_OK};
+  TCOD_Error err = TCOD_E_OK;
+  for (int i = 0; i < workers && err >= 0; ++i) {
+    TCOD_Path* path = &paths[i];
+    path->w = width;
+    path->h = height;
+    path->diagonalCost = diagonalCost;
+    path->jump_point = jump_point;
+    path->map = (TCOD_Map*)map; /* the map is only read from, the pathfinders never modify it */
+    path->workspace = n_workspaces > 0 ? workspaces[i] : (temporary_workspaces[i] = TCOD_path_workspace_new());
+    path->path = TCOD_list_new();
+    if (!path->workspace || !path->path) {
+      TCOD_set_errorv("Out of memory.");
+      err = TCOD_E_OUT_OF_MEMORY;
+    } else if (!path_workspace_reserve(path->workspace, width * height, jump_point)) {
+      err = TCOD_E_OUT_OF_MEMORY;
+    }
+  }
+  if (err >= 0) {
+    struct PathBatch batch = {queries, out, paths, worker_errors};
+    TCOD_parallel_for_(n, workers, path_batch_task, &batch);
+    for (int i = 0; i < workers && err >= 0; ++i) err = worker_errors[i];
+    if (err < 0) {
+      TCOD_set_errorv("Out of memory.");
+      for (int i = 0; i < n; ++i) TCOD_path_route_clear(&out[i]);
+    }
+  }
+  for (int i = 0; i < workers; ++i) {
+    if (paths[i].path) TCOD_list_delete(paths[i].path);
+    TCOD_path_workspace_delete(temporary_workspaces[i]);
+  }
+  return err;
+}
+
+void TCOD_path_route_clear(TCOD_PathRoute* route) {
+  if (!route) return;
+  free(route->xy);
+  route->xy = NULL;
+  route->length = -1;
+}
+
 /* ------------------------------------------------------- *
  * Dijkstra                                                *
  * written by Mingos                                       *
@@ -457,12 +1253,14 @@ TCOD_Dijkstra* TCOD_dijkstra_new(TCOD_map_t map, float diagonalCost) {
   data->func = NULL;
   data->user_data = NULL;
   data->distances = malloc(TCOD_map_get_nb_cells(data->map) * sizeof(int));
-  data->nodes = malloc(TCOD_map_get_nb_cells(data->map) * sizeof(int));
+  data->nodes = NULL;
   data->diagonal_cost = (int)((diagonalCost * 100.0f) + 0.1f); /* because (int)(1.41f*100.0f) == 140!!! */
   data->width = TCOD_map_get_width(data->map);
   data->height = TCOD_map_get_height(data->map);
   data->nodes_max = TCOD_map_get_nb_cells(data->map);
   data->path = TCOD_list_new();
+  data->workspace = NULL;
+  data->costs = (TCOD_PathCostGrid){0};
   return data;
 }
 
@@ -473,104 +1271,288 @@ TCOD_dijkstra_t TCOD_dijkstra_new_using_function(
   data->map = NULL;
   data->func = func;
   data->user_data = user_data;
-  data->distances = malloc(map_width * map_height * sizeof(int) * 4);
-  data->nodes = malloc(map_width * map_height * sizeof(int) * 4);
+  data->distances = malloc(map_width * map_height * sizeof(int));
+  data->nodes = NULL;
   data->diagonal_cost = (int)((diagonalCost * 100.0f) + 0.1f); /* because (int)(1.41f*100.0f) == 140!!! */
   data->width = map_width;
   data->height = map_height;
   data->nodes_max = map_width * map_height;
   data->path = TCOD_list_new();
+  data->workspace = NULL;
+  data->costs = (TCOD_PathCostGrid){0};
   return data;
 }
 
-/* compute a Dijkstra grid */
-void TCOD_dijkstra_compute(TCOD_Dijkstra* data, int root_x, int root_y) {
+TCOD_Dijkstra* TCOD_dijkstra_new_using_costs(const TCOD_PathCostGrid* costs, float diagonalCost) {
+  TCOD_PathCostGrid grid;
+  if (!path_cost_grid_init(&grid, costs)) return NULL;
+  TCOD_Dijkstra* data = calloc(1, sizeof(*data));
+  if (!data) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  data->costs = grid;
+  data->distances = malloc(grid.width * grid.height * sizeof(*data->distances));
+  data->diagonal_cost = (int)((diagonalCost * 100.0f) + 0.1f);
+  data->width = grid.width;
+  data->height = grid.height;
+  data->nodes_max = grid.width * grid.height;
+  data->path = TCOD_list_new();
+  if (!data->distances || !data->path) {
+    TCOD_dijkstra_delete(data);
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  return data;
+}
+
+static bool dijkstra_bucket_push(struct DijkstraBucket* bucket, struct DijkstraNode node) {
+  if (bucket->size == bucket->capacity) {
+    if (bucket->head >= bucket->capacity / 2 && bucket->head > 0) {
+      /* reclaim the space of already popped nodes */
+      memmove(bucket->nodes, bucket->nodes + bucket->head, (bucket->size - bucket->head) * sizeof(*bucket->nodes));
+      bucket->size -= bucket->head;
+      bucket->head = 0;
+    } else {
+      int new_capacity = bucket->capacity ? bucket->capacity * 2 : 256;
+      struct DijkstraNode* new_nodes = realloc(bucket->nodes, new_capacity * sizeof(*new_nodes));
+      if (!new_nodes) return false;
+      bucket->nodes = new_nodes;
+      bucket->capacity = new_capacity;
+    }
+  }
+  bucket->nodes[bucket->size++] = node;
+  return true;
+}
+/* push a node, fifo is 0 for straight steps, 1 for diagonal steps, or 2 for roots */
+static bool dijkstra_queue_push(struct DijkstraQueue* queue, struct DijkstraNode node, int fifo) {
+  const int bucket = queue->use_fifos ? fifo : bit_length(node.distance ^ queue->last);
+  if (!dijkstra_bucket_push(&queue->buckets[bucket], node)) return false;
+  ++queue->size;
+  return true;
+}
+/* pop the closest node into `out`, return false if out of memory */
+static bool dijkstra_queue_pop(struct DijkstraQueue* queue, struct DijkstraNode* out) {
+  --queue->size;
+  if (queue->use_fifos) {
+    /* take the closest node from the fronts of the straight, diagonal, and root FIFOs */
+    struct DijkstraBucket* front = NULL;
+    for (int i = 0; i < 3; ++i) {
+      struct DijkstraBucket* bucket = &queue->buckets[i];
+      if (bucket->head == bucket->size) continue;
+      if (!front || bucket->nodes[bucket->head].distance < front->nodes[front->head].distance) front = bucket;
+    }
+    *out = front->nodes[front->head++];
+    if (front->head == front->size) front->head = front->size = 0;
+    return true;
+  }
+  struct DijkstraBucket* front = &queue->buckets[0];
+  if (front->size == 0) {
+    /* move the smallest keys into bucket 0 by redistributing the first non-empty bucket around its minimum */
+    struct DijkstraBucket* bucket = &queue->buckets[1];
+    while (bucket->size == 0) ++bucket;
+    unsigned int lowest = bucket->nodes[0].distance;
+    for (int i = 1; i < bucket->size; ++i) {
+      if (bucket->nodes[i].distance < lowest) lowest = bucket->nodes[i].distance;
+    }
+    queue->last = lowest;
+    /* every node moves to a lower bucket */
+    for (int i = 0; i < bucket->size; ++i) {
+      struct DijkstraBucket* dest = &queue->buckets[bit_length(bucket->nodes[i].distance ^ lowest)];
+      if (dest->size == dest->capacity) {
+        if (!dijkstra_bucket_push(dest, bucket->nodes[i])) return false;
+      } else {
+        dest->nodes[dest->size++] = bucket->nodes[i];
+      }
+    }
+    bucket->size = 0;
+  }
+  *out = front->nodes[--front->size];
+  return true;
+}
+static void dijkstra_queue_delete(struct DijkstraQueue* queue) {
+  for (int i = 0; i < 33; ++i) free(queue->buckets[i].nodes);
+}
+/* return an empty queue, reusing the buckets of the workspace if there is one */
+static struct DijkstraQueue* dijkstra_queue_begin(TCOD_Dijkstra* data, struct DijkstraQueue* local_queue) {
+  struct DijkstraQueue* queue = local_queue;
+  if (data->workspace) {
+    queue = &data->workspace->dijkstra_queue;
+    for (int i = 0; i < 33; ++i) queue->buckets[i].head = queue->buckets[i].size = 0;
+  } else {
+    memset(local_queue, 0, sizeof(*local_queue));
+  }
+  queue->size = 0;
+  queue->last = 0;
+  queue->use_fifos = data->map != NULL;
+  return queue;
+}
+/* free the queue unless it belongs to a workspace */
+static void dijkstra_queue_end(TCOD_Dijkstra* data, struct DijkstraQueue* queue) {
+  if (!data->workspace) dijkstra_queue_delete(queue);
+}
+
+/* the largest distance of a reached cell in hundredths, UINT32_MAX marks unreached cells */
+#define DIJKSTRA_MAX_DISTANCE 0xFFFFFFFEu
+
+/* return `distance` plus a positive step of `cost` hundredths, saturating at DIJKSTRA_MAX_DISTANCE */
+static inline unsigned int dijkstra_add_step(unsigned int distance, float cost) {
+  if (!(cost < (float)DIJKSTRA_MAX_DISTANCE)) return DIJKSTRA_MAX_DISTANCE;
+  const uint64_t sum = (uint64_t)distance + (uint64_t)cost;
+  return sum < DIJKSTRA_MAX_DISTANCE ? (unsigned int)sum : DIJKSTRA_MAX_DISTANCE;
+}
+
+/* compute a Dijkstra grid from roots which are sorted by distance, duplicate roots are allowed
+   cost_type is the type of the cost grid, or -1 for maps and callbacks */
+static inline TCOD_Error dijkstra_compute_from_(
+    TCOD_Dijkstra* data, int n_roots, const struct DijkstraNode* roots, int cost_type) {
   /* map size data */
-  unsigned int mx = data->width;
-  unsigned int my = data->height;
-  unsigned int m_max = data->nodes_max;
-  /* encode the root coords in one integer */
-  unsigned int root = (root_y * mx) + root_x;
-  /* some stuff to walk through the nodes table */
-  unsigned int index = 0; /* the index of the first node in queue */
-  unsigned int last_index = 1; /* total nb of registered queue indices */
-  unsigned int* nodes = data->nodes; /* table of nodes to which the indices above apply */
+  const unsigned int mx = data->width;
+  const unsigned int my = data->height;
   /* ok, here's the order of node processing: W, S, E, N, NW, NE, SE, SW */
-  static int dx[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
-  static int dy[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+  static const int dx[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+  static const int dy[8] = {0, -1, 0, 1, -1, -1, 1, 1};
   /* and distances for each index */
-  int dd[8] = {100, 100, 100, 100, data->diagonal_cost, data->diagonal_cost, data->diagonal_cost, data->diagonal_cost};
+  const int dd[8] = {
+      100, 100, 100, 100, data->diagonal_cost, data->diagonal_cost, data->diagonal_cost, data->diagonal_cost};
   /* if diagonal_cost is 0, disallow diagonal moves */
-  int i_max = (data->diagonal_cost == 0 ? 4 : 8);
+  const int i_max = (data->diagonal_cost == 0 ? 4 : 8);
   /* alright, now set the distances table and set everything to infinity */
   unsigned int* distances = data->distances;
-  TCOD_IFNOT(data != NULL) return;
-  TCOD_IFNOT((unsigned)root_x < (unsigned)mx && (unsigned)root_y < (unsigned)my) return;
-  memset(distances, 0xFFFFFFFF, m_max * sizeof(int));
-  memset(nodes, 0xFFFFFFFF, m_max * sizeof(int));
-  /* data for root node is known... */
-  distances[root] = 0;
-  nodes[index] = root; /*set starting note to root */
+  memset(distances, 0xFFFFFFFF, data->nodes_max * sizeof(*distances));
+  /* nodes are processed in order of distance */
+  struct DijkstraQueue local_queue;
+  struct DijkstraQueue* queue = dijkstra_queue_begin(data, &local_queue);
+  /* data for root nodes is known... */
+  for (int i = 0; i < n_roots; ++i) {
+    if (distances[roots[i].index] <= roots[i].distance) continue;
+    distances[roots[i].index] = roots[i].distance;
+    if (!dijkstra_queue_push(queue, roots[i], 2)) {
+      dijkstra_queue_end(data, queue);
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+  }
+  struct DijkstraNode node;
   /* and the loop */
-  do {
-    unsigned int x, y;
-    int i;
-    if (nodes[index] == 0xFFFFFFFF) {
-      continue;
+  while (queue->size) {
+    if (!dijkstra_queue_pop(queue, &node)) {
+      dijkstra_queue_end(data, queue);
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+    if (node.distance != distances[node.index]) {
+      continue; /* this node was queued again with a shorter distance */
     }
-
     /* coordinates of currently processed node */
-    x = nodes[index] % mx;
-    y = nodes[index] / mx;
-
+    const unsigned int x = node.index % mx;
+    const unsigned int y = node.index / mx;
     /* check adjacent nodes */
-    for (i = 0; i < i_max; i++) {
+    for (int i = 0; i < i_max; i++) {
       /* checked node's coordinates */
-      unsigned int tx = x + dx[i];
-      unsigned int ty = y + dy[i];
-      if ((unsigned)tx < (unsigned)mx && (unsigned)ty < (unsigned)my) {
-        /* otherwise, calculate distance, ... */
-        unsigned int dt = distances[nodes[index]], new_node;
-        float userDist = 0.0f;
-        if (data->map)
-          dt += dd[i];
-        else {
-          /* distance given by the user callback */
-          userDist = data->func(x, y, tx, ty, data->user_data);
-          dt += (unsigned int)(userDist * dd[i]);
-        }
-        /* ..., encode coordinates, ... */
-        new_node = (ty * mx) + tx;
-        /* and check if the node's eligible for queuing */
-        if (distances[new_node] > dt) {
-          unsigned int j;
-          /* if not walkable, don't process it */
-          if (data->map && !TCOD_map_is_walkable(data->map, tx, ty))
-            continue;
-          else if (data->func && userDist <= 0.0f)
-            continue;
-          distances[new_node] = dt; /* set processed node's distance */
-          /* place the processed node in the queue before the last queued node with greater distance */
-          j = last_index - 1;
-          while (distances[nodes[j]] >= distances[new_node]) {
-            /* this ensures that if the node has been queued previously, but with a higher distance, it's removed */
-            if (nodes[j] == new_node) {
-              int k = j;
-              while ((unsigned)k <= last_index) {
-                nodes[k] = nodes[k + 1];
-                k++;
-              }
-              last_index--;
-            } else
-              nodes[j + 1] = nodes[j];
-            j--;
-          }
-          last_index++; /* increase total indices count */
-          nodes[j + 1] = new_node; /* and finally put the node where it belongs in the queue */
-        }
+      const unsigned int tx = x + dx[i];
+      const unsigned int ty = y + dy[i];
+      if (tx >= mx || ty >= my) continue;
+      /* otherwise, calculate distance, ... */
+      unsigned int dt = node.distance;
+      float userDist = 0.0f;
+      if (cost_type >= 0) {
+        /* distance given by the cost grid */
+        userDist = path_cost_get(&data->costs, (TCOD_PathCostType)cost_type, tx, ty);
+        if (userDist <= 0.0f) continue;
+        dt = dijkstra_add_step(dt, userDist * dd[i]);
+      } else if (data->map)
+        dt += dd[i];
+      else {
+        /* distance given by the user callback */
+        userDist = data->func(x, y, tx, ty, data->user_data);
+        if (userDist <= 0.0f) continue;
+        dt = dijkstra_add_step(dt, userDist * dd[i]);
+      }
+      /* ..., encode coordinates, ... */
+      const struct DijkstraNode new_node = {dt, (ty * mx) + tx};
+      /* and check if the node's eligible for queuing */
+      if (distances[new_node.index] <= dt) continue;
+      /* if not walkable, don't process it */
+      if (data->map && !TCOD_map_get_walkable_(data->map, tx, ty)) continue;
+      distances[new_node.index] = dt; /* set processed node's distance */
+      if (!dijkstra_queue_push(queue, new_node, i < 4 ? 0 : 1)) {
+        dijkstra_queue_end(data, queue);
+        TCOD_set_errorv("Out of memory.");
+        return TCOD_E_OUT_OF_MEMORY;
       }
     }
-  } while (m_max > ++index);
+  }
+  dijkstra_queue_end(data, queue);
+  return TCOD_E_OK;
+}
+
+/* compute a Dijkstra grid using the loop specialized for its cost grid type */
+static TCOD_Error dijkstra_compute_from(TCOD_Dijkstra* data, int n_roots, const struct DijkstraNode* roots) {
+  if (!data->costs.data) return dijkstra_compute_from_(data, n_roots, roots, -1);
+  switch (data->costs.type) {
+    case TCOD_PATH_COST_UINT8:
+      return dijkstra_compute_from_(data, n_roots, roots, TCOD_PATH_COST_UINT8);
+    case TCOD_PATH_COST_UINT16:
+      return dijkstra_compute_from_(data, n_roots, roots, TCOD_PATH_COST_UINT16);
+    default:
+      return dijkstra_compute_from_(data, n_roots, roots, TCOD_PATH_COST_FLOAT);
+  }
+}
+
+/* compute a Dijkstra grid */
+void TCOD_dijkstra_compute(TCOD_Dijkstra* data, int root_x, int root_y) {
+  if (!data) {
+    TCOD_set_errorv("Dijkstra data must not be NULL.");
+    return;
+  }
+  if ((unsigned)root_x >= (unsigned)data->width || (unsigned)root_y >= (unsigned)data->height) {
+    TCOD_set_errorvf("Root {%i, %i} is out of bounds.", root_x, root_y);
+    return;
+  }
+  const struct DijkstraNode root = {0, (root_y * data->width) + root_x};
+  dijkstra_compute_from(data, 1, &root); /* errors are reported through TCOD_set_error */
+}
+
+static int compare_dijkstra_nodes(const void* a, const void* b) {
+  const unsigned int distance_a = ((const struct DijkstraNode*)a)->distance;
+  const unsigned int distance_b = ((const struct DijkstraNode*)b)->distance;
+  return (distance_a > distance_b) - (distance_a < distance_b);
+}
+
+TCOD_Error TCOD_dijkstra_compute_multi(TCOD_Dijkstra* data, int n, const TCOD_DijkstraRoot* roots) {
+  if (!data) {
+    TCOD_set_errorv("Dijkstra data must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (n < 0 || (n > 0 && !roots)) {
+    TCOD_set_errorv("Invalid roots.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  struct DijkstraNode* nodes = malloc((n ? n : 1) * sizeof(*nodes));
+  if (!nodes) {
+    TCOD_set_errorv("Out of memory.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  for (int i = 0; i < n; ++i) {
+    if ((unsigned)roots[i].x >= (unsigned)data->width || (unsigned)roots[i].y >= (unsigned)data->height) {
+      free(nodes);
+      TCOD_set_errorvf("Root %i at {%i, %i} is out of bounds.", i, roots[i].x, roots[i].y);
+      return TCOD_E_INVALID_ARGUMENT;
+    }
+    if (!(roots[i].distance >= 0.0f && roots[i].distance < 40000000.0f)) {
+      free(nodes);
+      TCOD_set_errorvf("Root %i has an invalid distance of %f.", i, roots[i].distance);
+      return TCOD_E_INVALID_ARGUMENT;
+    }
+    nodes[i].distance = (unsigned int)(roots[i].distance * 100.0f + 0.5f);
+    nodes[i].index = (roots[i].y * data->width) + roots[i].x;
+  }
+  /* roots are queued in order of distance */
+  qsort(nodes, n, sizeof(*nodes), compare_dijkstra_nodes);
+  const TCOD_Error err = dijkstra_compute_from(data, n, nodes);
+  free(nodes);
+  return err;
 }
 
 /* get distance from source */
@@ -655,6 +1637,11 @@ void TCOD_dijkstra_delete(TCOD_Dijkstra* data) {
   free(data);
 }
 
+void TCOD_dijkstra_set_workspace(TCOD_Dijkstra* data, TCOD_PathWorkspace* workspace) {
+  TCOD_IFNOT(data != NULL) return;
+  data->workspace = workspace;
+}
+
 bool TCOD_dijkstra_is_empty(TCOD_Dijkstra* data) {
   TCOD_IFNOT(data != NULL) return true;
   return TCOD_list_is_empty(data->path);
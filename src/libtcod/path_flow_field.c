@@ -0,0 +1,335 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "path_flow_field.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fov.h"
+#include "libtcod_int.h"
+#include "pathfinder_frontier.h"
+#include "utility.h"
+
+/// The distance of cells which can't reach the goal.
+#define FLOW_UNREACHABLE INT_MAX
+
+/// Straight directions come first so that 4-way movement can stop early.
+static const int DIR_X[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+static const int DIR_Y[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+/// The opposite of each direction.
+static const int DIR_REVERSE[8] = {2, 3, 0, 1, 6, 7, 4, 5};
+
+/// The cached field of one goal.
+struct FlowFieldEntry {
+  bool used;
+  int goal;  // The goal cell.
+  uint64_t version;  // The map version walkable was copied at.
+  uint64_t last_used;  // The value of TCOD_FlowField.clock when this was last selected.
+  bool* walkable;  // The walkable cells the field is based on.
+  int* distance;  // The distance from each cell to the goal.
+  uint8_t* directions;  // 4 bits per cell, 0 for no step or a direction index plus 1.  Even cells use the low bits.
+};
+struct TCOD_FlowField {
+  TCOD_Map* map;
+  int width;
+  int height;
+  int straight_cost;
+  int diagonal_cost;
+  int n_directions;  // 4 or 8.
+  int capacity;
+  struct FlowFieldEntry* entries;
+  struct FlowFieldEntry* current;  // The entry selected by the last TCOD_flow_field_compute, or NULL.
+  uint64_t clock;
+  struct TCOD_Frontier* frontier;
+  int* stack;  // Scratch space for the cells which a repair has to search from again.
+  int expanded;
+};
+
+/// Return the cost of a step in direction `dir`.
+static int step_cost(const TCOD_FlowField* flow, int dir) {
+  return dir < 4 ? flow->straight_cost : flow->diagonal_cost;
+}
+/// Return the neighbor of `cell` in direction `dir`, or -1 if it is out of bounds.
+static int neighbor(const TCOD_FlowField* flow, int cell, int dir) {
+  const int x = cell % flow->width + DIR_X[dir];
+  const int y = cell / flow->width + DIR_Y[dir];
+  if (x < 0 || y < 0 || x >= flow->width || y >= flow->height) return -1;
+  return x + y * flow->width;
+}
+/// Return the packed direction of `cell`, 0 for no step or a direction index plus 1.
+static int get_direction(const struct FlowFieldEntry* entry, int cell) {
+  return (entry->directions[cell / 2] >> ((cell & 1) * 4)) & 0xF;
+}
+static void set_direction(struct FlowFieldEntry* entry, int cell, int direction) {
+  const int shift = (cell & 1) * 4;
+  entry->directions[cell / 2] = (uint8_t)((entry->directions[cell / 2] & ~(0xF << shift)) | (direction << shift));
+}
+/// Set the distance of `cell` to the goal, stepping in direction `dir`, and queue it.
+static TCOD_Error relax(TCOD_FlowField* flow, struct FlowFieldEntry* entry, int cell, int distance, int dir) {
+  entry->distance[cell] = distance;
+  set_direction(entry, cell, dir + 1);
+  return TCOD_frontier_push(flow->frontier, &cell, distance, distance);
+}
+/// Expand queued cells until every distance is final.
+static TCOD_Error propagate(TCOD_FlowField* flow, struct FlowFieldEntry* entry) {
+  while (TCOD_frontier_size(flow->frontier)) {
+    TCOD_Error err = TCOD_frontier_pop(flow->frontier);
+    if (err < 0) return err;
+    const int cell = flow->frontier->active_index[0];
+    const int distance = flow->frontier->active_dist;
+    if (distance != entry->distance[cell]) continue;  // This cell was queued again with a lower distance since.
+    ++flow->expanded;
+    for (int dir = 0; dir < flow->n_directions; ++dir) {
+      const int next = neighbor(flow, cell, dir);
+      if (next < 0 || !entry->walkable[next]) continue;
+      const int next_distance = distance + step_cost(flow, dir);
+      if (next_distance >= entry->distance[next]) continue;
+      if ((err = relax(flow, entry, next, next_distance, DIR_REVERSE[dir])) < 0) return err;
+    }
+  }
+  return TCOD_E_OK;
+}
+/// Queue `cell` at the lowest distance it can get from its neighbors, if that's lower than its current distance.
+static TCOD_Error reseed(TCOD_FlowField* flow, struct FlowFieldEntry* entry, int cell) {
+  if (cell == entry->goal || !entry->walkable[cell]) return TCOD_E_OK;
+  int best = entry->distance[cell];
+  int best_dir = -1;
+  for (int dir = 0; dir < flow->n_directions; ++dir) {
+    const int next = neighbor(flow, cell, dir);
+    if (next < 0 || entry->distance[next] == FLOW_UNREACHABLE) continue;
+    const int distance = entry->distance[next] + step_cost(flow, dir);
+    if (distance < best) {
+      best = distance;
+      best_dir = dir;
+    }
+  }
+  if (best_dir < 0) return TCOD_E_OK;
+  return relax(flow, entry, cell, best, best_dir);
+}
+/// Compute the field of entry from scratch.
+static TCOD_Error compute_full(TCOD_FlowField* flow, struct FlowFieldEntry* entry) {
+  const TCOD_Map* map = flow->map;
+  for (int y = 0; y < flow->height; ++y) {
+    for (int x = 0; x < flow->width; ++x) entry->walkable[x + y * flow->width] = TCOD_map_get_walkable_(map, x, y);
+  }
+  for (int i = 0; i < flow->width * flow->height; ++i) entry->distance[i] = FLOW_UNREACHABLE;
+  memset(entry->directions, 0, (flow->width * flow->height + 1) / 2);
+  entry->version = map->version;
+  entry->distance[entry->goal] = 0;
+  TCOD_Error err = TCOD_frontier_push(flow->frontier, &entry->goal, 0, 0);
+  if (err < 0) return err;
+  return propagate(flow, entry);
+}
+/// Mark every cell whose route to the goal went through `cell` as unreachable and add them to the stack.
+static void invalidate_subtree(TCOD_FlowField* flow, struct FlowFieldEntry* entry, int cell, int* stack_size) {
+  int top = *stack_size;
+  entry->distance[cell] = FLOW_UNREACHABLE;
+  set_direction(entry, cell, 0);
+  flow->stack[top++] = cell;
+  for (int i = *stack_size; i < top; ++i) {
+    const int parent = flow->stack[i];
+    for (int dir = 0; dir < flow->n_directions; ++dir) {
+      const int child = neighbor(flow, parent, dir);
+      if (child < 0 || get_direction(entry, child) != DIR_REVERSE[dir] + 1) continue;
+      entry->distance[child] = FLOW_UNREACHABLE;
+      set_direction(entry, child, 0);
+      flow->stack[top++] = child;
+    }
+  }
+  *stack_size = top;
+}
+/// Update the field of entry for the cells which changed since it was computed.
+static TCOD_Error repair(TCOD_FlowField* flow, struct FlowFieldEntry* entry) {
+  const TCOD_Map* map = flow->map;
+  int stack_size = 0;  // Cells which opened or became unreachable.
+  for (int region_y = 0; region_y < flow->height; region_y += TCOD_MAP_REGION_SIZE) {
+    for (int region_x = 0; region_x < flow->width; region_x += TCOD_MAP_REGION_SIZE) {
+      if (TCOD_map_get_version(map, region_x, region_y, TCOD_MAP_REGION_SIZE, TCOD_MAP_REGION_SIZE) <= entry->version) {
+        continue;
+      }
+      const int x_end = TCOD_MIN(region_x + TCOD_MAP_REGION_SIZE, flow->width);
+      const int y_end = TCOD_MIN(region_y + TCOD_MAP_REGION_SIZE, flow->height);
+      for (int y = region_y; y < y_end; ++y) {
+        for (int x = region_x; x < x_end; ++x) {
+          const int cell = x + y * flow->width;
+          const bool walkable = TCOD_map_get_walkable_(map, x, y);
+          if (walkable == entry->walkable[cell]) continue;
+          entry->walkable[cell] = walkable;
+          if (cell == entry->goal) continue;  // The goal is never entered, its walkability doesn't matter.
+          if (walkable) {
+            flow->stack[stack_size++] = cell;  // Blocked cells are unreachable, so this is never in a subtree.
+          } else if (entry->distance[cell] != FLOW_UNREACHABLE) {
+            invalidate_subtree(flow, entry, cell, &stack_size);
+          }
+        }
+      }
+    }
+  }
+  entry->version = map->version;
+  // Opened cells and cells cut off from their old routes take the best route from their neighbors which are still
+  // valid, then the new routes spread from them.
+  for (int i = 0; i < stack_size; ++i) {
+    TCOD_Error err = reseed(flow, entry, flow->stack[i]);
+    if (err < 0) return err;
+  }
+  return propagate(flow, entry);
+}
+/// Return the entry to use for `goal`, either the one already holding it or the least recently used one.
+static struct FlowFieldEntry* find_entry(TCOD_FlowField* flow, int goal) {
+  struct FlowFieldEntry* oldest = &flow->entries[0];
+  for (int i = 0; i < flow->capacity; ++i) {
+    struct FlowFieldEntry* entry = &flow->entries[i];
+    if (entry->used && entry->goal == goal) return entry;
+    if (!entry->used || (oldest->used && entry->last_used < oldest->last_used)) oldest = entry;
+  }
+  return oldest;
+}
+
+TCOD_FlowField* TCOD_flow_field_new(TCOD_Map* map, float diagonal_cost, int max_goals) {
+  if (!map) {
+    TCOD_set_errorv("map must not be NULL.");
+    return NULL;
+  }
+  if (!(diagonal_cost >= 0.0f && diagonal_cost < 1000.0f)) {
+    TCOD_set_errorvf("Invalid diagonal_cost of %f.", diagonal_cost);
+    return NULL;
+  }
+  if (max_goals <= 0) {
+    TCOD_set_errorvf("max_goals must be positive, got %i.", max_goals);
+    return NULL;
+  }
+  TCOD_FlowField* flow = calloc(1, sizeof(*flow));
+  if (!flow) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  flow->map = map;
+  flow->width = map->width;
+  flow->height = map->height;
+  flow->straight_cost = 100;
+  flow->diagonal_cost = (int)((diagonal_cost * 100.0f) + 0.1f);
+  flow->n_directions = flow->diagonal_cost == 0 ? 4 : 8;
+  flow->capacity = max_goals;
+  flow->entries = calloc(max_goals, sizeof(*flow->entries));
+  flow->frontier = TCOD_frontier_new(1);
+  flow->stack = malloc(sizeof(*flow->stack) * (size_t)map->width * map->height);
+  if (!flow->entries || !flow->frontier || !flow->stack) {
+    TCOD_flow_field_delete(flow);
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  return flow;
+}
+
+void TCOD_flow_field_delete(TCOD_FlowField* flow) {
+  if (!flow) return;
+  if (flow->entries) {
+    for (int i = 0; i < flow->capacity; ++i) {
+      free(flow->entries[i].walkable);
+      free(flow->entries[i].distance);
+      free(flow->entries[i].directions);
+    }
+  }
+  free(flow->entries);
+  TCOD_frontier_delete(flow->frontier);
+  free(flow->stack);
+  free(flow);
+}
+
+TCOD_Error TCOD_flow_field_compute(TCOD_FlowField* flow, int goal_x, int goal_y) {
+  if (!flow) {
+    TCOD_set_errorv("flow must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  flow->expanded = 0;
+  flow->current = NULL;
+  if (!TCOD_map_in_bounds(flow->map, goal_x, goal_y)) {
+    TCOD_set_errorvf("Goal {%i, %i} is out of bounds.", goal_x, goal_y);
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  const int goal = goal_x + goal_y * flow->width;
+  struct FlowFieldEntry* entry = find_entry(flow, goal);
+  if (!entry->walkable) {
+    const size_t cells = (size_t)flow->width * flow->height;
+    entry->walkable = malloc(sizeof(*entry->walkable) * cells);
+    entry->distance = malloc(sizeof(*entry->distance) * cells);
+    entry->directions = malloc((cells + 1) / 2);
+    if (!entry->walkable || !entry->distance || !entry->directions) {
+      free(entry->walkable);
+      free(entry->distance);
+      free(entry->directions);
+      entry->walkable = NULL;
+      entry->distance = NULL;
+      entry->directions = NULL;
+      TCOD_set_errorv("Out of memory.");
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+  }
+  entry->last_used = ++flow->clock;
+  TCOD_Error err = TCOD_E_OK;
+  TCOD_frontier_clear(flow->frontier);
+  if (!entry->used || entry->goal != goal) {
+    entry->goal = goal;
+    entry->used = true;
+    err = compute_full(flow, entry);
+  } else if (entry->version != flow->map->version) {
+    err = repair(flow, entry);
+  }
+  if (err < 0) {
+    entry->used = false;  // The field is incomplete.
+    return err;
+  }
+  flow->current = entry;
+  return TCOD_E_OK;
+}
+
+bool TCOD_flow_field_get_direction(const TCOD_FlowField* flow, int x, int y, int* dx, int* dy) {
+  if (dx) *dx = 0;
+  if (dy) *dy = 0;
+  if (!flow || !flow->current || x < 0 || y < 0 || x >= flow->width || y >= flow->height) return false;
+  const int direction = get_direction(flow->current, x + y * flow->width);
+  if (direction == 0) return false;
+  if (dx) *dx = DIR_X[direction - 1];
+  if (dy) *dy = DIR_Y[direction - 1];
+  return true;
+}
+
+float TCOD_flow_field_get_distance(const TCOD_FlowField* flow, int x, int y) {
+  if (!flow || !flow->current || x < 0 || y < 0 || x >= flow->width || y >= flow->height) return -1.0f;
+  const int distance = flow->current->distance[x + y * flow->width];
+  if (distance == FLOW_UNREACHABLE) return -1.0f;
+  return (float)distance * 0.01f;
+}
+
+int TCOD_flow_field_get_expanded(const TCOD_FlowField* flow) { return flow ? flow->expanded : 0; }
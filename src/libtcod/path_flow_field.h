@@ -0,0 +1,128 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file path_flow_field.h
+/// Flow fields for moving many units towards the same goal.
+#pragma once
+#ifndef TCOD_PATH_FLOW_FIELD_H_
+#define TCOD_PATH_FLOW_FIELD_H_
+
+#include <stdbool.h>
+
+#include "config.h"
+#include "error.h"
+#include "fov_types.h"
+
+/**
+    @brief Flow fields over a TCOD_Map, cached per goal.
+
+    A flow field holds the distance from every cell to a goal and the direction of the next step towards it, so every
+    unit heading to that goal moves by looking up its own cell instead of computing a path.
+    Directions are packed into 4 bits per cell.
+
+    The fields of the most recently used goals are kept.
+    When cells change walkability, a cached field is repaired by searching again only from the cells whose distances
+    depended on the changed cells, instead of being computed from scratch.
+
+    Moves follow the same rules as TCOD_dijkstra_new: any walkable cell can be entered in one of 8 directions and the
+    goal itself does not need to be walkable.
+
+    Changes are detected with TCOD_map_get_version, so the map must be edited with TCOD_map_set_properties,
+    TCOD_map_clear, or TCOD_map_copy.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_FlowField TCOD_FlowField;
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup Pathfinding
+/// @{
+/**
+    @brief Return new flow fields for `map` which keep the fields of up to `max_goals` goals.
+
+    `map` must outlive the flow fields and must not be resized.
+    `diagonal_cost` is the cost of diagonal moves relative to straight moves, 0 disables diagonal moves.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_FlowField* TCOD_flow_field_new(TCOD_Map* map, float diagonal_cost, int max_goals);
+/**
+    @brief Free flow fields.  The map they use is not freed.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_flow_field_delete(TCOD_FlowField* flow);
+/**
+    @brief Make `{goal_x, goal_y}` the goal which is read by the other functions, computing its field if needed.
+
+    A cached field is reused as is if the map hasn't changed since and is repaired if it has.
+    If `max_goals` fields are already cached then the least recently used one is replaced.
+
+    Call this again after the map changes, it's cheap when the field is still up to date.
+
+    Returns an error code on failure.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_flow_field_compute(TCOD_FlowField* flow, int goal_x, int goal_y);
+/**
+    @brief Output the step to take from `{x, y}` towards the current goal as `{*dx, *dy}`, each from -1 to 1.
+
+    Returns false if `{x, y}` is out of bounds, is the goal, or can't reach the goal.
+    In that case `{*dx, *dy}` is set to `{0, 0}`.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_flow_field_get_direction(const TCOD_FlowField* flow, int x, int y, int* dx, int* dy);
+/**
+    @brief Return the distance from `{x, y}` to the current goal, with straight moves costing 1.
+
+    Returns -1 if `{x, y}` is out of bounds or can't reach the goal.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC float TCOD_flow_field_get_distance(const TCOD_FlowField* flow, int x, int y);
+/**
+    @brief Return the number of cells expanded by the last TCOD_flow_field_compute, which measures how much work it did.
+
+    This is zero when a cached field was reused.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_flow_field_get_expanded(const TCOD_FlowField* flow);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_PATH_FLOW_FIELD_H_
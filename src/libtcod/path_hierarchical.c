@@ -0,0 +1,609 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "path_hierarchical.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "fov.h"
+#include "heapq.h"
+#include "libtcod_int.h"
+#include "utility.h"
+
+/// Runs of crossable border cells at least this long get an entrance at both ends instead of one in the middle.
+#define HPA_LONG_RUN 6
+/// The sector index of the origin in the abstract search.
+#define HPA_START (-1)
+/// The sector index of the destination in the abstract search.
+#define HPA_GOAL (-2)
+
+/// Straight directions come first so that 4-way movement can stop early.
+static const int DIR_X[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+static const int DIR_Y[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+
+/// A reference to an entrance of a sector, or to the origin or destination.
+struct HpaRef {
+  int sector;
+  int node;
+};
+/// An element of the abstract search heap.
+struct HpaQueued {
+  struct HpaRef ref;
+  int distance;
+};
+/// An element of the local search heap.
+struct HpaLocalQueued {
+  int index;  // Index of the cell within the sector.
+  int distance;
+};
+struct HpaSector {
+  int x, y, width, height;  // The cells covered by this sector.
+  bool built;
+  uint64_t version;  // The map version when this sector was built.
+  unsigned int checked;  // The last query which checked this sector for changes.
+  int node_count;
+  int* nodes;  // The map cell index of each entrance.
+  int* costs;  // node_count * node_count costs between entrances within this sector, INT_MAX if unreachable.
+  unsigned int searched;  // The last query which used search_distance.
+  int* search_distance;
+  struct HpaRef* search_prev;
+};
+struct TCOD_HierarchicalPath {
+  TCOD_Map* map;
+  int sector_size;
+  int sectors_width;
+  int sectors_height;
+  int straight_cost;
+  int diagonal_cost;
+  int directions;  // 4 or 8.
+  struct HpaSector* sectors;
+  unsigned int query;  // Incremented once per query, used to lazily reset per-sector state.
+  struct TCOD_Heap heap;  // Abstract search frontier of HpaQueued.
+  struct TCOD_Heap local_heap;  // Local search frontier of HpaLocalQueued.
+  int* local_distance;  // Local search results, sector_size * sector_size.
+  signed char* local_prev;  // The direction each cell was entered from during a local search, -1 for the source.
+  int* start_costs;  // Costs from the origin to each entrance of its sector.
+  int start_costs_capacity;
+  int* goal_costs;  // Costs from each entrance of the destination sector to the destination.
+  int goal_costs_capacity;
+  struct HpaRef* refs;  // Entrances along the abstract path.
+  int refs_capacity;
+  int* steps;  // The map cell index of each step of the path.
+  int length;
+  int capacity;
+  int cost;
+};
+
+static bool is_walkable(const TCOD_HierarchicalPath* path, int x, int y) {
+  return TCOD_map_in_bounds(path->map, x, y) && TCOD_map_get_walkable_(path->map, x, y);
+}
+static int sector_at(const TCOD_HierarchicalPath* path, int x, int y) {
+  return (y / path->sector_size) * path->sectors_width + x / path->sector_size;
+}
+/// Return the cost of a step in direction `dir`.
+static int step_cost(const TCOD_HierarchicalPath* path, int dir) {
+  return dir < 4 ? path->straight_cost : path->diagonal_cost;
+}
+/// Return the lowest possible cost between two cells.
+static int heuristic(const TCOD_HierarchicalPath* path, int x0, int y0, int x1, int y1) {
+  const int dx = abs(x1 - x0);
+  const int dy = abs(y1 - y0);
+  if (path->directions == 4) return (dx + dy) * path->straight_cost;
+  const int diagonal = TCOD_MIN(path->diagonal_cost, path->straight_cost * 2);
+  return TCOD_MAX(dx, dy) * path->straight_cost + TCOD_MIN(dx, dy) * (diagonal - path->straight_cost);
+}
+/// Grow a buffer of `*capacity` elements of `size` to hold at least `count` elements.
+static bool reserve(void** buffer, int* capacity, int count, size_t size) {
+  if (count <= *capacity) return true;
+  const int new_capacity = TCOD_MAX(count, *capacity * 2);
+  void* new_buffer = realloc(*buffer, size * new_capacity);
+  if (!new_buffer) return false;
+  *buffer = new_buffer;
+  *capacity = new_capacity;
+  return true;
+}
+static TCOD_Error out_of_memory(void) {
+  TCOD_set_errorv("Out of memory.");
+  return TCOD_E_OUT_OF_MEMORY;
+}
+/**
+    Search the cells of `sector` from `{src_x, src_y}`.
+
+    If `dst_index` is a cell index within the sector then the search stops once it is reached, otherwise every cell
+    of the sector reachable without leaving it is given a distance in `local_distance`.
+ */
+static TCOD_Error local_search(
+    TCOD_HierarchicalPath* path, const struct HpaSector* sector, int src_x, int src_y, int dst_index) {
+  const int area = sector->width * sector->height;
+  int* distance = path->local_distance;
+  for (int i = 0; i < area; ++i) distance[i] = INT_MAX;
+  const int dst_x = dst_index >= 0 ? sector->x + dst_index % sector->width : 0;
+  const int dst_y = dst_index >= 0 ? sector->y + dst_index / sector->width : 0;
+  TCOD_heap_clear(&path->local_heap);
+  struct HpaLocalQueued current = {(src_x - sector->x) + (src_y - sector->y) * sector->width, 0};
+  distance[current.index] = 0;
+  path->local_prev[current.index] = -1;
+  if (TCOD_minheap_push(&path->local_heap, 0, &current) < 0) return out_of_memory();
+  while (path->local_heap.size) {
+    TCOD_minheap_pop(&path->local_heap, &current);
+    if (current.distance != distance[current.index]) continue;
+    if (current.index == dst_index) break;
+    const int x = sector->x + current.index % sector->width;
+    const int y = sector->y + current.index / sector->width;
+    for (int dir = 0; dir < path->directions; ++dir) {
+      const int nx = x + DIR_X[dir];
+      const int ny = y + DIR_Y[dir];
+      if (nx < sector->x || ny < sector->y || nx >= sector->x + sector->width || ny >= sector->y + sector->height) {
+        continue;
+      }
+      if (!TCOD_map_get_walkable_(path->map, nx, ny)) continue;
+      const struct HpaLocalQueued next = {
+          (nx - sector->x) + (ny - sector->y) * sector->width, current.distance + step_cost(path, dir)};
+      if (next.distance >= distance[next.index]) continue;
+      distance[next.index] = next.distance;
+      path->local_prev[next.index] = (signed char)dir;
+      const int estimate = dst_index >= 0 ? heuristic(path, nx, ny, dst_x, dst_y) : 0;
+      if (TCOD_minheap_push(&path->local_heap, next.distance + estimate, &next) < 0) return out_of_memory();
+    }
+  }
+  return TCOD_E_OK;
+}
+/// Append the steps found by the last local search from its source to `dst_index`.
+static TCOD_Error append_local_steps(TCOD_HierarchicalPath* path, const struct HpaSector* sector, int dst_index) {
+  int count = 0;
+  for (int index = dst_index; path->local_prev[index] >= 0; ++count) {
+    const int dir = path->local_prev[index];
+    index -= DIR_X[dir] + DIR_Y[dir] * sector->width;
+  }
+  if (!reserve((void**)&path->steps, &path->capacity, path->length + count, sizeof(*path->steps))) {
+    return out_of_memory();
+  }
+  const int map_width = path->map->width;
+  int index = dst_index;
+  for (int i = path->length + count - 1; i >= path->length; --i) {
+    path->steps[i] = (sector->x + index % sector->width) + (sector->y + index / sector->width) * map_width;
+    const int dir = path->local_prev[index];
+    index -= DIR_X[dir] + DIR_Y[dir] * sector->width;
+  }
+  path->length += count;
+  return TCOD_E_OK;
+}
+/// Add the cell `{x, y}` as an entrance of `sector` if it isn't one already.
+static TCOD_Error add_entrance(TCOD_HierarchicalPath* path, struct HpaSector* sector, int* capacity, int x, int y) {
+  const int cell = x + y * path->map->width;
+  for (int i = 0; i < sector->node_count; ++i) {
+    if (sector->nodes[i] == cell) return TCOD_E_OK;
+  }
+  if (!reserve((void**)&sector->nodes, capacity, sector->node_count + 1, sizeof(*sector->nodes))) {
+    return out_of_memory();
+  }
+  sector->nodes[sector->node_count++] = cell;
+  return TCOD_E_OK;
+}
+/**
+    Add the entrances of one side of `sector`.
+
+    The side is the line of `length` cells starting at `{x, y}` and advancing by `{step_x, step_y}`, the neighboring
+    sector is in the direction `{across_x, across_y}`.
+    The neighboring sector runs the same logic with the sides swapped, so both sides always agree on the crossings.
+ */
+static TCOD_Error add_side_entrances(
+    TCOD_HierarchicalPath* path,
+    struct HpaSector* sector,
+    int* capacity,
+    int x,
+    int y,
+    int step_x,
+    int step_y,
+    int length,
+    int across_x,
+    int across_y) {
+  if (!TCOD_map_in_bounds(path->map, x + across_x, y + across_y)) return TCOD_E_OK;
+#define SIDE_X(i) (x + (i) * step_x)
+#define SIDE_Y(i) (y + (i) * step_y)
+#define CROSSABLE(i) \
+  (is_walkable(path, SIDE_X(i), SIDE_Y(i)) && is_walkable(path, SIDE_X(i) + across_x, SIDE_Y(i) + across_y))
+  TCOD_Error err = TCOD_E_OK;
+  for (int i = 0; i < length && err >= 0;) {
+    if (!CROSSABLE(i)) {
+      ++i;
+      continue;
+    }
+    const int begin = i;
+    while (i < length && CROSSABLE(i)) ++i;
+    if (i - begin >= HPA_LONG_RUN) {
+      err = add_entrance(path, sector, capacity, SIDE_X(begin), SIDE_Y(begin));
+      if (err >= 0) err = add_entrance(path, sector, capacity, SIDE_X(i - 1), SIDE_Y(i - 1));
+    } else {
+      const int middle = (begin + i - 1) / 2;
+      err = add_entrance(path, sector, capacity, SIDE_X(middle), SIDE_Y(middle));
+    }
+  }
+  if (path->directions == 8) {
+    // Diagonal squeezes between walls which can't be crossed straight across.
+    for (int i = 0; i + 1 < length && err >= 0; ++i) {
+      if (CROSSABLE(i) || CROSSABLE(i + 1)) continue;
+      if (is_walkable(path, SIDE_X(i), SIDE_Y(i)) &&
+          is_walkable(path, SIDE_X(i + 1) + across_x, SIDE_Y(i + 1) + across_y)) {
+        err = add_entrance(path, sector, capacity, SIDE_X(i), SIDE_Y(i));
+      }
+      if (err >= 0 && is_walkable(path, SIDE_X(i + 1), SIDE_Y(i + 1)) &&
+          is_walkable(path, SIDE_X(i) + across_x, SIDE_Y(i) + across_y)) {
+        err = add_entrance(path, sector, capacity, SIDE_X(i + 1), SIDE_Y(i + 1));
+      }
+    }
+  }
+#undef CROSSABLE
+#undef SIDE_Y
+#undef SIDE_X
+  return err;
+}
+/// Rebuild the entrances of a sector and the costs between them.
+static TCOD_Error sector_build(TCOD_HierarchicalPath* path, struct HpaSector* sector) {
+  sector->built = false;
+  sector->node_count = 0;
+  int capacity = 0;
+  free(sector->nodes);
+  sector->nodes = NULL;
+  const int x0 = sector->x;
+  const int y0 = sector->y;
+  const int x1 = sector->x + sector->width - 1;
+  const int y1 = sector->y + sector->height - 1;
+  TCOD_Error err = add_side_entrances(path, sector, &capacity, x0, y0, 0, 1, sector->height, -1, 0);
+  if (err >= 0) err = add_side_entrances(path, sector, &capacity, x1, y0, 0, 1, sector->height, 1, 0);
+  if (err >= 0) err = add_side_entrances(path, sector, &capacity, x0, y0, 1, 0, sector->width, 0, -1);
+  if (err >= 0) err = add_side_entrances(path, sector, &capacity, x0, y1, 1, 0, sector->width, 0, 1);
+  if (path->directions == 8) {
+    // Corners which can only be crossed diagonally.
+    const int corners[4][4] = {{x0, y0, -1, -1}, {x1, y0, 1, -1}, {x0, y1, -1, 1}, {x1, y1, 1, 1}};
+    for (int i = 0; i < 4 && err >= 0; ++i) {
+      const int x = corners[i][0];
+      const int y = corners[i][1];
+      const int dx = corners[i][2];
+      const int dy = corners[i][3];
+      if (is_walkable(path, x, y) && is_walkable(path, x + dx, y + dy) && !is_walkable(path, x + dx, y) &&
+          !is_walkable(path, x, y + dy)) {
+        err = add_entrance(path, sector, &capacity, x, y);
+      }
+    }
+  }
+  if (err < 0) return err;
+  const int n = sector->node_count;
+  free(sector->costs);
+  free(sector->search_distance);
+  free(sector->search_prev);
+  sector->costs = malloc(sizeof(*sector->costs) * (n ? n * n : 1));
+  sector->search_distance = malloc(sizeof(*sector->search_distance) * (n ? n : 1));
+  sector->search_prev = malloc(sizeof(*sector->search_prev) * (n ? n : 1));
+  if (!sector->costs || !sector->search_distance || !sector->search_prev) return out_of_memory();
+  for (int i = 0; i < n; ++i) {
+    const int x = sector->nodes[i] % path->map->width;
+    const int y = sector->nodes[i] / path->map->width;
+    err = local_search(path, sector, x, y, -1);
+    if (err < 0) return err;
+    for (int j = 0; j < n; ++j) {
+      const int node_x = sector->nodes[j] % path->map->width;
+      const int node_y = sector->nodes[j] / path->map->width;
+      sector->costs[i * n + j] =
+          path->local_distance[(node_x - sector->x) + (node_y - sector->y) * sector->width];
+    }
+  }
+  sector->built = true;
+  sector->version = path->map->version;
+  sector->searched = 0;
+  return TCOD_E_OK;
+}
+/// Rebuild a sector if it was never built or its cells, or the cells just around it, have changed.
+static TCOD_Error sector_ensure(TCOD_HierarchicalPath* path, struct HpaSector* sector) {
+  if (sector->checked == path->query) return TCOD_E_OK;
+  sector->checked = path->query;
+  if (sector->built &&
+      (sector->version == path->map->version ||
+       TCOD_map_get_version(path->map, sector->x - 1, sector->y - 1, sector->width + 2, sector->height + 2) <=
+           sector->version)) {
+    return TCOD_E_OK;
+  }
+  return sector_build(path, sector);
+}
+/// Return the abstract search distances of a sector, resetting them if they are from an older query.
+static int* sector_distances(const TCOD_HierarchicalPath* path, struct HpaSector* sector) {
+  if (sector->searched != path->query) {
+    sector->searched = path->query;
+    for (int i = 0; i < sector->node_count; ++i) sector->search_distance[i] = INT_MAX;
+  }
+  return sector->search_distance;
+}
+/// Return the index of the entrance of `sector` at `cell`, or -1.
+static int sector_find_node(const struct HpaSector* sector, int cell) {
+  for (int i = 0; i < sector->node_count; ++i) {
+    if (sector->nodes[i] == cell) return i;
+  }
+  return -1;
+}
+/// Lower the distance of an entrance and queue it.
+static TCOD_Error relax(
+    TCOD_HierarchicalPath* path, struct HpaRef ref, int distance, struct HpaRef prev, int dst_x, int dst_y) {
+  struct HpaSector* sector = &path->sectors[ref.sector];
+  int* distances = sector_distances(path, sector);
+  if (distance >= distances[ref.node]) return TCOD_E_OK;
+  distances[ref.node] = distance;
+  sector->search_prev[ref.node] = prev;
+  const int cell = sector->nodes[ref.node];
+  const int estimate = heuristic(path, cell % path->map->width, cell / path->map->width, dst_x, dst_y);
+  const struct HpaQueued queued = {ref, distance};
+  if (TCOD_minheap_push(&path->heap, distance + estimate, &queued) < 0) return out_of_memory();
+  return TCOD_E_OK;
+}
+/// Copy the local search distances of every entrance of `sector` into `out`.
+static void gather_entrance_costs(const TCOD_HierarchicalPath* path, const struct HpaSector* sector, int* out) {
+  for (int i = 0; i < sector->node_count; ++i) {
+    const int x = sector->nodes[i] % path->map->width;
+    const int y = sector->nodes[i] / path->map->width;
+    out[i] = path->local_distance[(x - sector->x) + (y - sector->y) * sector->width];
+  }
+}
+/**
+    Search the abstract graph from `{ox, oy}` to `{dx, dy}` then refine it into steps.
+
+    Returns 1 if a path was found, 0 if there is no path, or a negative error code.
+ */
+static int abstract_search(TCOD_HierarchicalPath* path, int ox, int oy, int dx, int dy) {
+  const int map_width = path->map->width;
+  struct HpaSector* start_sector = &path->sectors[sector_at(path, ox, oy)];
+  struct HpaSector* goal_sector = &path->sectors[sector_at(path, dx, dy)];
+  const int goal_index = (int)(goal_sector - path->sectors);
+  if (!reserve(
+          (void**)&path->start_costs,
+          &path->start_costs_capacity,
+          start_sector->node_count,
+          sizeof(*path->start_costs)) ||
+      !reserve(
+          (void**)&path->goal_costs, &path->goal_costs_capacity, goal_sector->node_count, sizeof(*path->goal_costs))) {
+    return out_of_memory();
+  }
+  TCOD_Error err = local_search(path, start_sector, ox, oy, -1);
+  if (err < 0) return err;
+  gather_entrance_costs(path, start_sector, path->start_costs);
+  err = local_search(path, goal_sector, dx, dy, -1);
+  if (err < 0) return err;
+  gather_entrance_costs(path, goal_sector, path->goal_costs);
+
+  TCOD_heap_clear(&path->heap);
+  const struct HpaRef start = {HPA_START, 0};
+  for (int i = 0; i < start_sector->node_count; ++i) {
+    if (path->start_costs[i] == INT_MAX) continue;
+    const struct HpaRef ref = {(int)(start_sector - path->sectors), i};
+    err = relax(path, ref, path->start_costs[i], start, dx, dy);
+    if (err < 0) return err;
+  }
+  int best = INT_MAX;
+  struct HpaRef goal_prev = start;
+  while (path->heap.size) {
+    struct HpaQueued current;
+    TCOD_minheap_pop(&path->heap, &current);
+    if (current.ref.sector == HPA_GOAL) {
+      if (current.distance == best) break;
+      continue;
+    }
+    struct HpaSector* sector = &path->sectors[current.ref.sector];
+    if (current.distance != sector_distances(path, sector)[current.ref.node]) continue;
+    if (current.ref.sector == goal_index && path->goal_costs[current.ref.node] != INT_MAX) {
+      const int total = current.distance + path->goal_costs[current.ref.node];
+      if (total < best) {
+        best = total;
+        goal_prev = current.ref;
+        const struct HpaQueued goal = {{HPA_GOAL, 0}, total};
+        if (TCOD_minheap_push(&path->heap, total, &goal) < 0) return out_of_memory();
+      }
+    }
+    const int n = sector->node_count;
+    for (int j = 0; j < n; ++j) {
+      const int cost = sector->costs[current.ref.node * n + j];
+      if (cost == INT_MAX || j == current.ref.node) continue;
+      const struct HpaRef next = {current.ref.sector, j};
+      err = relax(path, next, current.distance + cost, current.ref, dx, dy);
+      if (err < 0) return err;
+    }
+    const int x = sector->nodes[current.ref.node] % map_width;
+    const int y = sector->nodes[current.ref.node] / map_width;
+    for (int dir = 0; dir < path->directions; ++dir) {
+      const int nx = x + DIR_X[dir];
+      const int ny = y + DIR_Y[dir];
+      if (!TCOD_map_in_bounds(path->map, nx, ny)) continue;
+      const int next_sector = sector_at(path, nx, ny);
+      if (next_sector == current.ref.sector) continue;
+      err = sector_ensure(path, &path->sectors[next_sector]);
+      if (err < 0) return err;
+      const int node = sector_find_node(&path->sectors[next_sector], nx + ny * map_width);
+      if (node < 0) continue;
+      const struct HpaRef next = {next_sector, node};
+      err = relax(path, next, current.distance + step_cost(path, dir), current.ref, dx, dy);
+      if (err < 0) return err;
+    }
+  }
+  if (best == INT_MAX) return 0;
+  // Collect the entrances along the path, from the destination back to the origin.
+  int count = 0;
+  for (struct HpaRef ref = goal_prev; ref.sector != HPA_START;
+       ref = path->sectors[ref.sector].search_prev[ref.node]) {
+    if (!reserve((void**)&path->refs, &path->refs_capacity, count + 1, sizeof(*path->refs))) return out_of_memory();
+    path->refs[count++] = ref;
+  }
+  // Refine each leg with a local search.
+  int cur_x = ox;
+  int cur_y = oy;
+  for (int i = count - 1; i >= -1; --i) {
+    const int cell = i >= 0 ? path->sectors[path->refs[i].sector].nodes[path->refs[i].node] : dx + dy * map_width;
+    const int next_x = cell % map_width;
+    const int next_y = cell / map_width;
+    struct HpaSector* sector = &path->sectors[sector_at(path, next_x, next_y)];
+    if (sector_at(path, cur_x, cur_y) != (int)(sector - path->sectors)) {
+      // A single step across a sector border.
+      if (!reserve((void**)&path->steps, &path->capacity, path->length + 1, sizeof(*path->steps))) {
+        return out_of_memory();
+      }
+      path->steps[path->length++] = cell;
+    } else if (cur_x != next_x || cur_y != next_y) {
+      const int dst_index = (next_x - sector->x) + (next_y - sector->y) * sector->width;
+      err = local_search(path, sector, cur_x, cur_y, dst_index);
+      if (err < 0) return err;
+      err = append_local_steps(path, sector, dst_index);
+      if (err < 0) return err;
+    }
+    cur_x = next_x;
+    cur_y = next_y;
+  }
+  path->cost = best;
+  return 1;
+}
+
+TCOD_HierarchicalPath* TCOD_hierarchical_path_new(TCOD_Map* map, int sector_size, float diagonal_cost) {
+  if (!map) {
+    TCOD_set_errorv("map must not be NULL.");
+    return NULL;
+  }
+  if (sector_size < 4 || sector_size > 128) {
+    TCOD_set_errorvf("sector_size must be from 4 to 128, got %i.", sector_size);
+    return NULL;
+  }
+  if (!(diagonal_cost >= 0.0f && diagonal_cost < 1000.0f)) {
+    TCOD_set_errorvf("Invalid diagonal_cost of %f.", diagonal_cost);
+    return NULL;
+  }
+  TCOD_HierarchicalPath* path = calloc(1, sizeof(*path));
+  if (!path) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  path->map = map;
+  path->sector_size = sector_size;
+  path->sectors_width = (map->width + sector_size - 1) / sector_size;
+  path->sectors_height = (map->height + sector_size - 1) / sector_size;
+  path->straight_cost = 100;
+  path->diagonal_cost = (int)((diagonal_cost * 100.0f) + 0.1f);
+  path->directions = path->diagonal_cost == 0 ? 4 : 8;
+  path->sectors = calloc((size_t)path->sectors_width * path->sectors_height, sizeof(*path->sectors));
+  path->local_distance = malloc(sizeof(*path->local_distance) * sector_size * sector_size);
+  path->local_prev = malloc(sizeof(*path->local_prev) * sector_size * sector_size);
+  if (!path->sectors || !path->local_distance || !path->local_prev ||
+      TCOD_heap_init(&path->heap, sizeof(struct HpaQueued)) < 0 ||
+      TCOD_heap_init(&path->local_heap, sizeof(struct HpaLocalQueued)) < 0) {
+    TCOD_hierarchical_path_delete(path);
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  for (int sector_y = 0; sector_y < path->sectors_height; ++sector_y) {
+    for (int sector_x = 0; sector_x < path->sectors_width; ++sector_x) {
+      struct HpaSector* sector = &path->sectors[sector_y * path->sectors_width + sector_x];
+      sector->x = sector_x * sector_size;
+      sector->y = sector_y * sector_size;
+      sector->width = TCOD_MIN(sector_size, map->width - sector->x);
+      sector->height = TCOD_MIN(sector_size, map->height - sector->y);
+    }
+  }
+  return path;
+}
+
+void TCOD_hierarchical_path_delete(TCOD_HierarchicalPath* path) {
+  if (!path) return;
+  if (path->sectors) {
+    for (int i = 0; i < path->sectors_width * path->sectors_height; ++i) {
+      free(path->sectors[i].nodes);
+      free(path->sectors[i].costs);
+      free(path->sectors[i].search_distance);
+      free(path->sectors[i].search_prev);
+    }
+  }
+  free(path->sectors);
+  TCOD_heap_uninit(&path->heap);
+  TCOD_heap_uninit(&path->local_heap);
+  free(path->local_distance);
+  free(path->local_prev);
+  free(path->start_costs);
+  free(path->goal_costs);
+  free(path->refs);
+  free(path->steps);
+  free(path);
+}
+
+bool TCOD_hierarchical_path_compute(TCOD_HierarchicalPath* path, int ox, int oy, int dx, int dy) {
+  if (!path) return false;
+  path->length = 0;
+  path->cost = 0;
+  if (!TCOD_map_in_bounds(path->map, ox, oy) || !TCOD_map_in_bounds(path->map, dx, dy)) return false;
+  if (ox == dx && oy == dy) return true;
+  if (!TCOD_map_get_walkable_(path->map, dx, dy)) return false;
+  if (++path->query == 0) {
+    // Stamps wrapped around, forget them all.
+    for (int i = 0; i < path->sectors_width * path->sectors_height; ++i) {
+      path->sectors[i].checked = path->sectors[i].searched = 0;
+    }
+    path->query = 1;
+  }
+  struct HpaSector* start_sector = &path->sectors[sector_at(path, ox, oy)];
+  struct HpaSector* goal_sector = &path->sectors[sector_at(path, dx, dy)];
+  if (sector_ensure(path, start_sector) < 0 || sector_ensure(path, goal_sector) < 0) return false;
+  if (start_sector == goal_sector) {
+    // Short paths within a sector don't need the abstract graph.
+    const int dst_index = (dx - goal_sector->x) + (dy - goal_sector->y) * goal_sector->width;
+    if (local_search(path, goal_sector, ox, oy, dst_index) < 0) return false;
+    if (path->local_distance[dst_index] != INT_MAX) {
+      path->cost = path->local_distance[dst_index];
+      if (append_local_steps(path, goal_sector, dst_index) < 0) {
+        path->length = 0;
+        return false;
+      }
+      return true;
+    }
+  }
+  const int result = abstract_search(path, ox, oy, dx, dy);
+  if (result <= 0) {
+    path->length = 0;
+    path->cost = 0;
+  }
+  return result > 0;
+}
+
+int TCOD_hierarchical_path_size(const TCOD_HierarchicalPath* path) { return path ? path->length : 0; }
+
+void TCOD_hierarchical_path_get(const TCOD_HierarchicalPath* path, int index, int* x, int* y) {
+  if (!path || index < 0 || index >= path->length) return;
+  if (x) *x = path->steps[index] % path->map->width;
+  if (y) *y = path->steps[index] / path->map->width;
+}
+
+float TCOD_hierarchical_path_get_cost(const TCOD_HierarchicalPath* path) {
+  return path ? (float)path->cost * 0.01f : 0.0f;
+}
@@ -0,0 +1,123 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file path_hierarchical.h
+/// Hierarchical pathfinding for large maps.
+#pragma once
+#ifndef TCOD_PATH_HIERARCHICAL_H_
+#define TCOD_PATH_HIERARCHICAL_H_
+
+#include <stdbool.h>
+
+#include "config.h"
+#include "fov_types.h"
+
+/**
+    @brief A hierarchical (HPA*) pathfinder over a TCOD_Map.
+
+    The map is split into square sectors.  Cells where a sector can be entered from its neighbors become entrances and
+    the distances between entrances of the same sector are precomputed.
+    Long paths are found by searching this much smaller graph of entrances and then refining each leg with a search
+    limited to a single sector, so the cost of a query no longer grows with the area of the map.
+
+    Paths are near-optimal, they may be slightly longer than the paths from TCOD_path_compute.
+    Moves follow the same rules as TCOD_path_new_using_map: any walkable cell can be entered in one of 8 directions.
+
+    Sectors are rebuilt lazily by the next query which reaches them after their cells change.
+    Changes are detected with TCOD_map_get_version, so the map must be edited with TCOD_map_set_properties,
+    TCOD_map_clear, or TCOD_map_copy.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_HierarchicalPath TCOD_HierarchicalPath;
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup Pathfinding
+/// @{
+/**
+    @brief Return a new hierarchical pathfinder for `map`.
+
+    `map` must outlive the pathfinder and must not be resized.
+    `sector_size` is the width and height of each sector, from 4 to 128.  Larger sectors mean a smaller abstract graph
+    but more work to build and refine each sector, 16 to 32 works well for most maps.
+    `diagonal_cost` is the cost of diagonal moves relative to straight moves, 0 disables diagonal moves.
+
+    Sectors are built on demand by TCOD_hierarchical_path_compute.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_HierarchicalPath* TCOD_hierarchical_path_new(TCOD_Map* map, int sector_size, float diagonal_cost);
+/**
+    @brief Free a hierarchical pathfinder.  The map it uses is not freed.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_hierarchical_path_delete(TCOD_HierarchicalPath* path);
+/**
+    @brief Find a path from `{ox, oy}` to `{dx, dy}`, returns true if a path was found.
+
+    The origin does not need to be walkable, the destination does.
+    Sectors touched by this search whose cells have changed since they were built are rebuilt first.
+
+    The path is read with TCOD_hierarchical_path_size and TCOD_hierarchical_path_get.
+    On failure the path is left empty, if this was caused by an error then TCOD_get_error will be set.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_hierarchical_path_compute(TCOD_HierarchicalPath* path, int ox, int oy, int dx, int dy);
+/**
+    @brief Return the number of steps in the last computed path, which does not include the origin.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_hierarchical_path_size(const TCOD_HierarchicalPath* path);
+/**
+    @brief Output the position of the step at `index` of the last computed path.
+
+    Step 0 is next to the origin and the last step is the destination.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_hierarchical_path_get(const TCOD_HierarchicalPath* path, int index, int* x, int* y);
+/**
+    @brief Return the cost of the last computed path, with straight moves costing 1.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC float TCOD_hierarchical_path_get_cost(const TCOD_HierarchicalPath* path);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_PATH_HIERARCHICAL_H_
@@ -0,0 +1,388 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "path_incremental.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "fov.h"
+#include "libtcod_int.h"
+#include "utility.h"
+
+/// The distance of cells which can't reach the destination.
+#define DSTAR_UNREACHABLE INT_MAX
+
+/// Straight directions come first so that 4-way movement can stop early and so that ties prefer straight moves.
+static const int DIR_X[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+static const int DIR_Y[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+
+/// The priority of a queued cell, compared by `k1` then by `k2`.
+struct DStarKey {
+  int64_t k1;
+  int64_t k2;
+};
+/// An element of the open list.
+struct DStarQueued {
+  struct DStarKey key;
+  int cell;
+};
+struct TCOD_IncrementalPath {
+  TCOD_Map* map;
+  int width;
+  int height;
+  int straight_cost;
+  int diagonal_cost;
+  int directions;  // 4 or 8.
+  bool has_goal;  // True once a search has been started.
+  int goal;  // The destination cell of the current search.
+  int start;  // The origin of the last search, keys are relative to it.
+  int position;  // The current origin, moved by TCOD_incremental_path_walk.
+  int64_t key_modifier;  // The sum of the heuristic distances the origin moved by, keeps old keys valid.
+  uint64_t version;  // The map version walkable was copied at.
+  bool* walkable;  // The walkable cells the current search is based on.
+  int* g;  // The distance from each cell to the destination as of its last expansion.
+  int* rhs;  // The distance from each cell to the destination as implied by the distances of its neighbors.
+  int* heap_index;  // The position of each cell in the heap, or -1.
+  struct DStarQueued* heap;  // The open list, a binary heap of cells whose g and rhs differ.
+  int heap_size;
+  int expanded;
+  int* steps;  // The map cell index of each step of the path.
+  int length;
+  int next_step;  // The first step of the path which hasn't been walked yet.
+  int cost;  // The cost of the path from the current position.
+};
+
+/// Return the cost of a step in direction `dir`.
+static int step_cost(const TCOD_IncrementalPath* path, int dir) {
+  return dir < 4 ? path->straight_cost : path->diagonal_cost;
+}
+/// Return the lowest possible cost between two cells.
+static int heuristic(const TCOD_IncrementalPath* path, int cell_a, int cell_b) {
+  const int dx = abs(cell_a % path->width - cell_b % path->width);
+  const int dy = abs(cell_a / path->width - cell_b / path->width);
+  if (path->directions == 4) return (dx + dy) * path->straight_cost;
+  const int diagonal = TCOD_MIN(path->diagonal_cost, path->straight_cost * 2);
+  return TCOD_MAX(dx, dy) * path->straight_cost + TCOD_MIN(dx, dy) * (diagonal - path->straight_cost);
+}
+/// Return the neighbor of `cell` in direction `dir`, or -1 if it is out of bounds.
+static int neighbor(const TCOD_IncrementalPath* path, int cell, int dir) {
+  const int x = cell % path->width + DIR_X[dir];
+  const int y = cell / path->width + DIR_Y[dir];
+  if (x < 0 || y < 0 || x >= path->width || y >= path->height) return -1;
+  return x + y * path->width;
+}
+static bool key_less(struct DStarKey a, struct DStarKey b) { return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2); }
+static struct DStarKey calculate_key(const TCOD_IncrementalPath* path, int cell) {
+  const int64_t distance = TCOD_MIN(path->g[cell], path->rhs[cell]);
+  return (struct DStarKey){distance + heuristic(path, path->start, cell) + path->key_modifier, distance};
+}
+/// Move the heap element at `index` to its place in the heap.
+static void heap_fix(TCOD_IncrementalPath* path, int index) {
+  struct DStarQueued* heap = path->heap;
+  const struct DStarQueued moving = heap[index];
+  while (index > 0 && key_less(moving.key, heap[(index - 1) / 2].key)) {
+    heap[index] = heap[(index - 1) / 2];
+    path->heap_index[heap[index].cell] = index;
+    index = (index - 1) / 2;
+  }
+  for (;;) {
+    int child = index * 2 + 1;
+    if (child >= path->heap_size) break;
+    if (child + 1 < path->heap_size && key_less(heap[child + 1].key, heap[child].key)) ++child;
+    if (!key_less(heap[child].key, moving.key)) break;
+    heap[index] = heap[child];
+    path->heap_index[heap[index].cell] = index;
+    index = child;
+  }
+  heap[index] = moving;
+  path->heap_index[moving.cell] = index;
+}
+/// Queue `cell` with `key`, or change its key if it is already queued.
+static void heap_set(TCOD_IncrementalPath* path, int cell, struct DStarKey key) {
+  int index = path->heap_index[cell];
+  if (index < 0) index = path->heap_size++;
+  path->heap[index] = (struct DStarQueued){key, cell};
+  heap_fix(path, index);
+}
+/// Remove `cell` from the heap if it is queued.
+static void heap_remove(TCOD_IncrementalPath* path, int cell) {
+  const int index = path->heap_index[cell];
+  if (index < 0) return;
+  path->heap_index[cell] = -1;
+  if (index == --path->heap_size) return;
+  path->heap[index] = path->heap[path->heap_size];
+  heap_fix(path, index);
+}
+/// Recompute the rhs of `cell` from its neighbors.
+static void update_rhs(TCOD_IncrementalPath* path, int cell) {
+  if (cell == path->goal) return;
+  int best = DSTAR_UNREACHABLE;
+  for (int dir = 0; dir < path->directions; ++dir) {
+    const int next = neighbor(path, cell, dir);
+    if (next < 0 || !path->walkable[next] || path->g[next] == DSTAR_UNREACHABLE) continue;
+    best = TCOD_MIN(best, path->g[next] + step_cost(path, dir));
+  }
+  path->rhs[cell] = best;
+}
+/// Queue `cell` if it is inconsistent, otherwise make sure it isn't queued.
+static void update_queue(TCOD_IncrementalPath* path, int cell) {
+  if (path->g[cell] != path->rhs[cell]) {
+    heap_set(path, cell, calculate_key(path, cell));
+  } else {
+    heap_remove(path, cell);
+  }
+}
+/// Expand inconsistent cells until the distance of the origin is known.
+static void compute_shortest_path(TCOD_IncrementalPath* path) {
+  path->expanded = 0;
+  while (path->heap_size > 0) {
+    const struct DStarQueued top = path->heap[0];
+    if (!key_less(top.key, calculate_key(path, path->start)) && path->rhs[path->start] == path->g[path->start]) break;
+    const int cell = top.cell;
+    const struct DStarKey new_key = calculate_key(path, cell);
+    if (key_less(top.key, new_key)) {
+      heap_set(path, cell, new_key);  // Queued before the origin moved.
+      continue;
+    }
+    ++path->expanded;
+    const int old_g = path->g[cell];
+    if (old_g > path->rhs[cell]) {
+      // The distance of this cell went down, which can only lower the distances of its neighbors.
+      path->g[cell] = path->rhs[cell];
+      heap_remove(path, cell);
+      if (!path->walkable[cell]) continue;
+      for (int dir = 0; dir < path->directions; ++dir) {
+        const int prev = neighbor(path, cell, dir);
+        if (prev < 0 || prev == path->goal) continue;
+        const int through = path->g[cell] + step_cost(path, dir);
+        if (through < path->rhs[prev]) {
+          path->rhs[prev] = through;
+          update_queue(path, prev);
+        }
+      }
+    } else {
+      // The distance of this cell went up, neighbors which depended on it have to look for another way.
+      path->g[cell] = DSTAR_UNREACHABLE;
+      update_rhs(path, cell);
+      update_queue(path, cell);
+      if (!path->walkable[cell] || old_g == DSTAR_UNREACHABLE) continue;
+      for (int dir = 0; dir < path->directions; ++dir) {
+        const int prev = neighbor(path, cell, dir);
+        if (prev < 0) continue;
+        if (path->rhs[prev] == old_g + step_cost(path, dir)) update_rhs(path, prev);
+        update_queue(path, prev);
+      }
+    }
+  }
+}
+/// Start a new search towards `goal`, forgetting everything from the previous one.
+static void reset_search(TCOD_IncrementalPath* path, int start, int goal) {
+  const int cells = path->width * path->height;
+  for (int i = 0; i < cells; ++i) {
+    path->walkable[i] = TCOD_map_get_walkable_(path->map, i % path->width, i / path->width);
+    path->g[i] = path->rhs[i] = DSTAR_UNREACHABLE;
+    path->heap_index[i] = -1;
+  }
+  path->version = path->map->version;
+  path->heap_size = 0;
+  path->key_modifier = 0;
+  path->has_goal = true;
+  path->goal = goal;
+  path->start = start;
+  path->rhs[goal] = 0;
+  update_queue(path, goal);
+}
+/// Repair the search for every cell whose walkability changed since it was last checked.
+static void apply_map_changes(TCOD_IncrementalPath* path) {
+  const TCOD_Map* map = path->map;
+  if (map->version == path->version) return;
+  for (int region_y = 0; region_y < path->height; region_y += TCOD_MAP_REGION_SIZE) {
+    for (int region_x = 0; region_x < path->width; region_x += TCOD_MAP_REGION_SIZE) {
+      if (TCOD_map_get_version(map, region_x, region_y, TCOD_MAP_REGION_SIZE, TCOD_MAP_REGION_SIZE) <= path->version) {
+        continue;
+      }
+      const int x_end = TCOD_MIN(region_x + TCOD_MAP_REGION_SIZE, path->width);
+      const int y_end = TCOD_MIN(region_y + TCOD_MAP_REGION_SIZE, path->height);
+      for (int y = region_y; y < y_end; ++y) {
+        for (int x = region_x; x < x_end; ++x) {
+          const int cell = x + y * path->width;
+          const bool walkable = TCOD_map_get_walkable_(map, x, y);
+          if (walkable == path->walkable[cell]) continue;
+          // Only the steps into this cell changed cost, which affects the neighbors stepping into it.
+          path->walkable[cell] = walkable;
+          for (int dir = 0; dir < path->directions; ++dir) {
+            const int prev = neighbor(path, cell, dir);
+            if (prev < 0) continue;
+            update_rhs(path, prev);
+            update_queue(path, prev);
+          }
+        }
+      }
+    }
+  }
+  path->version = map->version;
+}
+/// Follow the distances from the current position to the destination, returns false if the path can't be stored.
+static bool build_steps(TCOD_IncrementalPath* path) {
+  path->length = 0;
+  path->next_step = 0;
+  path->cost = path->g[path->start];
+  for (int cell = path->start; cell != path->goal;) {
+    int best = DSTAR_UNREACHABLE;
+    int best_cell = -1;
+    for (int dir = 0; dir < path->directions; ++dir) {
+      const int next = neighbor(path, cell, dir);
+      if (next < 0 || !path->walkable[next] || path->g[next] == DSTAR_UNREACHABLE) continue;
+      const int through = path->g[next] + step_cost(path, dir);
+      if (through < best) {
+        best = through;
+        best_cell = next;
+      }
+    }
+    if (best_cell < 0 || path->length >= path->width * path->height) return false;
+    path->steps[path->length++] = best_cell;
+    cell = best_cell;
+  }
+  return true;
+}
+
+TCOD_IncrementalPath* TCOD_incremental_path_new(TCOD_Map* map, float diagonal_cost) {
+  if (!map) {
+    TCOD_set_errorv("map must not be NULL.");
+    return NULL;
+  }
+  if (!(diagonal_cost >= 0.0f && diagonal_cost < 1000.0f)) {
+    TCOD_set_errorvf("Invalid diagonal_cost of %f.", diagonal_cost);
+    return NULL;
+  }
+  TCOD_IncrementalPath* path = calloc(1, sizeof(*path));
+  if (!path) {
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  const size_t cells = (size_t)map->width * map->height;
+  path->map = map;
+  path->width = map->width;
+  path->height = map->height;
+  path->straight_cost = 100;
+  path->diagonal_cost = (int)((diagonal_cost * 100.0f) + 0.1f);
+  path->directions = path->diagonal_cost == 0 ? 4 : 8;
+  path->walkable = malloc(sizeof(*path->walkable) * cells);
+  path->g = malloc(sizeof(*path->g) * cells);
+  path->rhs = malloc(sizeof(*path->rhs) * cells);
+  path->heap_index = malloc(sizeof(*path->heap_index) * cells);
+  path->heap = malloc(sizeof(*path->heap) * cells);
+  path->steps = malloc(sizeof(*path->steps) * cells);
+  if (!path->walkable || !path->g || !path->rhs || !path->heap_index || !path->heap || !path->steps) {
+    TCOD_incremental_path_delete(path);
+    TCOD_set_errorv("Out of memory.");
+    return NULL;
+  }
+  return path;
+}
+
+void TCOD_incremental_path_delete(TCOD_IncrementalPath* path) {
+  if (!path) return;
+  free(path->walkable);
+  free(path->g);
+  free(path->rhs);
+  free(path->heap_index);
+  free(path->heap);
+  free(path->steps);
+  free(path);
+}
+
+bool TCOD_incremental_path_compute(TCOD_IncrementalPath* path, int ox, int oy, int dx, int dy) {
+  if (!path) return false;
+  path->length = 0;
+  path->next_step = 0;
+  path->cost = 0;
+  if (!TCOD_map_in_bounds(path->map, ox, oy) || !TCOD_map_in_bounds(path->map, dx, dy)) return false;
+  const int start = ox + oy * path->width;
+  const int goal = dx + dy * path->width;
+  if (!path->has_goal || goal != path->goal) {
+    reset_search(path, start, goal);
+  } else {
+    path->key_modifier += heuristic(path, path->start, start);
+    path->start = start;
+    apply_map_changes(path);
+  }
+  path->position = start;
+  if (start == goal) return true;
+  compute_shortest_path(path);
+  if (path->g[start] == DSTAR_UNREACHABLE || !build_steps(path)) {
+    path->length = 0;
+    path->cost = 0;
+    return false;
+  }
+  return true;
+}
+
+bool TCOD_incremental_path_walk(TCOD_IncrementalPath* path, int* x, int* y) {
+  if (!path || !path->has_goal) return false;
+  if (path->map->version != path->version) {
+    if (!TCOD_incremental_path_compute(
+            path,
+            path->position % path->width,
+            path->position / path->width,
+            path->goal % path->width,
+            path->goal / path->width)) {
+      return false;
+    }
+  }
+  if (path->next_step >= path->length) return false;
+  const int previous = path->position;
+  path->position = path->steps[path->next_step++];
+  const int dx = abs(path->position % path->width - previous % path->width);
+  const int dy = abs(path->position / path->width - previous / path->width);
+  path->cost -= dx && dy ? path->diagonal_cost : path->straight_cost;
+  if (x) *x = path->position % path->width;
+  if (y) *y = path->position / path->width;
+  return true;
+}
+
+int TCOD_incremental_path_size(const TCOD_IncrementalPath* path) { return path ? path->length - path->next_step : 0; }
+
+void TCOD_incremental_path_get(const TCOD_IncrementalPath* path, int index, int* x, int* y) {
+  if (!path || index < 0 || index >= path->length - path->next_step) return;
+  const int cell = path->steps[path->next_step + index];
+  if (x) *x = cell % path->width;
+  if (y) *y = cell / path->width;
+}
+
+float TCOD_incremental_path_get_cost(const TCOD_IncrementalPath* path) {
+  return path ? (float)path->cost * 0.01f : 0.0f;
+}
+
+int TCOD_incremental_path_get_expanded(const TCOD_IncrementalPath* path) { return path ? path->expanded : 0; }
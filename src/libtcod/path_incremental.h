@@ -0,0 +1,136 @@
+/* BSD 3-Clause License
+ *
+ * Copyright © 2008-2026, Jice and the libtcod contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/// @file path_incremental.h
+/// Incremental replanning for agents moving through a changing map.
+#pragma once
+#ifndef TCOD_PATH_INCREMENTAL_H_
+#define TCOD_PATH_INCREMENTAL_H_
+
+#include <stdbool.h>
+
+#include "config.h"
+#include "fov_types.h"
+
+/**
+    @brief An incremental (D* Lite) pathfinder over a TCOD_Map.
+
+    The search runs from the destination back towards the origin and its results are kept between calls.
+    When cells change walkability or the origin moves along the path, only the part of the search affected by the change
+    is repaired, instead of searching again from scratch like TCOD_path_compute.
+    Changing the destination starts a new search.
+
+    Paths are always the shortest possible.
+    Moves follow the same rules as TCOD_path_new_using_map: any walkable cell can be entered in one of 8 directions.
+
+    Changes are detected with TCOD_map_get_version, so the map must be edited with TCOD_map_set_properties,
+    TCOD_map_clear, or TCOD_map_copy.
+
+    Koenig & Likhachev, "D* Lite", 2002.
+
+    @versionadded{Unreleased}
+ */
+typedef struct TCOD_IncrementalPath TCOD_IncrementalPath;
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+/// @addtogroup Pathfinding
+/// @{
+/**
+    @brief Return a new incremental pathfinder for `map`.
+
+    `map` must outlive the pathfinder and must not be resized.
+    `diagonal_cost` is the cost of diagonal moves relative to straight moves, 0 disables diagonal moves.
+
+    Returns NULL on error.  See TCOD_get_error for details.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_IncrementalPath* TCOD_incremental_path_new(TCOD_Map* map, float diagonal_cost);
+/**
+    @brief Free an incremental pathfinder.  The map it uses is not freed.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_incremental_path_delete(TCOD_IncrementalPath* path);
+/**
+    @brief Find a path from `{ox, oy}` to `{dx, dy}`, returns true if a path was found.
+
+    If the destination is the same as the previous call then the previous search is repaired to account for the moved
+    origin and for any cells which changed since.
+
+    The origin does not need to be walkable, the destination does.
+    The path is read with TCOD_incremental_path_size and TCOD_incremental_path_get.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_incremental_path_compute(TCOD_IncrementalPath* path, int ox, int oy, int dx, int dy);
+/**
+    @brief Move one step along the path, outputting the new position.  Returns false if there are no steps left or if
+    the destination can no longer be reached.
+
+    If the map has changed since the path was computed then the path is repaired first, so the step taken is always
+    on a shortest path from the current position.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC bool TCOD_incremental_path_walk(TCOD_IncrementalPath* path, int* x, int* y);
+/**
+    @brief Return the number of steps left in the path, which does not include the current position.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_incremental_path_size(const TCOD_IncrementalPath* path);
+/**
+    @brief Output the position of the step at `index` of the path.
+
+    Step 0 is next to the current position and the last step is the destination.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC void TCOD_incremental_path_get(const TCOD_IncrementalPath* path, int index, int* x, int* y);
+/**
+    @brief Return the cost of the remaining path, with straight moves costing 1.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC float TCOD_incremental_path_get_cost(const TCOD_IncrementalPath* path);
+/**
+    @brief Return the number of cells expanded by the last search or repair, which measures how much work it did.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC int TCOD_incremental_path_get_expanded(const TCOD_IncrementalPath* path);
+/// @}
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+#endif  // TCOD_PATH_INCREMENTAL_H_
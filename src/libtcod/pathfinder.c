@@ -141,7 +141,7 @@ static void array_traverse(struct TCOD_ArrayData* arr, ArrayTraverseFunc callbac
 
 static bool TCOD_pf_in_bounds(const struct TCOD_Pathfinder* path, const int* index) {
   for (int i = 0; i < path->ndim; ++i) {
-    if (0 < index[i] || (size_t)index[i] >= path->shape[i]) {
+    if (index[i] < 0 || (size_t)index[i] >= path->shape[i]) {
       return false;
     }
   }
@@ -152,20 +152,27 @@ static void TCOD_pf_add_edge(struct TCOD_Pathfinder* path, const int* origin, co
   if (!TCOD_pf_in_bounds(path, dest)) {
     return;
   }
+  if (path->graph.cost.data) {
+    const int tile_cost = array_get(&path->graph.cost, dest);
+    if (tile_cost <= 0) {
+      return;
+    }
+    cost *= tile_cost;
+  }
   int total_dist = array_get(&path->distance, origin) + cost;
-  if (array_get(&path->distance, dest) >= total_dist) {
+  if (array_get(&path->distance, dest) <= total_dist) {
     return;
   }
   array_set(&path->distance, dest, total_dist);
-  TCOD_minheap_push(&path->heap, total_dist, dest);
+  TCOD_frontier_push(path->frontier, dest, total_dist, total_dist);
   if (path->traversal.data) {
     int travel_index[TCOD_PATHFINDER_MAX_DIMENSIONS + 1];
     for (int i = 0; i < path->ndim; ++i) {
-      travel_index[i] = origin[i];
+      travel_index[i] = dest[i];
     }
     for (int i = 0; i < path->ndim; ++i) {
       travel_index[path->ndim] = i;
-      array_set(&path->traversal, travel_index, dest[i]);
+      array_set(&path->traversal, travel_index, origin[i]);
     }
   }
 }
@@ -207,11 +214,14 @@ int TCOD_pf_compute_step(struct TCOD_Pathfinder* path) {
   if (!path) {
     return -1;
   }
-  if (path->heap.size == 0) {
+  if (TCOD_frontier_size(path->frontier) == 0) {
     return 0;
   }
-  int current_pos[TCOD_PATHFINDER_MAX_DIMENSIONS];
-  TCOD_minheap_pop(&path->heap, current_pos);
+  TCOD_frontier_pop(path->frontier);
+  const int* current_pos = path->frontier->active_index;
+  if (array_get(&path->distance, current_pos) < path->frontier->active_dist) {
+    return 0;  // This node was queued again with a lower distance since.
+  }
   TCOD_pf_basic2d_edges(path, current_pos);
   return 0;
 }
@@ -225,7 +235,12 @@ struct TCOD_Pathfinder* TCOD_pf_new(int ndim, const size_t* shape) {
   for (int i = 0; i < ndim; ++i) {
     path->shape[i] = shape[i];
   }
-  TCOD_heap_init(&path->heap, sizeof(int) * (size_t)path->ndim);
+  path->frontier = TCOD_frontier_new(ndim);
+  if (!path->frontier) {
+    free(path);
+    return NULL;
+  }
+  TCOD_frontier_use_buckets(path->frontier, true);
   return path;
 }
 
@@ -233,7 +248,7 @@ void TCOD_pf_delete(struct TCOD_Pathfinder* path) {
   if (!path) {
     return;
   }
-  TCOD_heap_uninit(&path->heap);
+  TCOD_frontier_delete(path->frontier);
   free(path);
 }
 
@@ -288,23 +303,36 @@ void TCOD_pf_recompile_cb(void* userdata, const int* index) {
   if (array_is_max(&path->distance, index)) {
     return;
   }
-  TCOD_minheap_push(&path->heap, array_get(&path->distance, index), index);
+  const int dist = array_get(&path->distance, index);
+  TCOD_frontier_push(path->frontier, index, dist, dist);
 }
 
 int TCOD_pf_recompile(struct TCOD_Pathfinder* path) {
   if (!path) {
     return -1;
   }
-  TCOD_heap_clear(&path->heap);
+  TCOD_frontier_clear(path->frontier);
   array_traverse(&path->distance, &TCOD_pf_recompile_cb, path);
   return 0;
 }
 
+int TCOD_pf_add_root(struct TCOD_Pathfinder* path, const int* index, int value) {
+  if (!path || !TCOD_pf_in_bounds(path, index)) {
+    return -1;
+  }
+  if (array_get(&path->distance, index) <= value) {
+    return 0;
+  }
+  array_set(&path->distance, index, value);
+  TCOD_frontier_push(path->frontier, index, value, value);
+  return 0;
+}
+
 int TCOD_pf_compute(struct TCOD_Pathfinder* path) {
   if (!path) {
     return -1;
   }
-  while (path->heap.size) {
+  while (TCOD_frontier_size(path->frontier)) {
     TCOD_pf_compute_step(path);
   }
   return 0;
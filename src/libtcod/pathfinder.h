@@ -37,11 +37,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include "heapq.h"
+#include "pathfinder_frontier.h"
 #include "portability.h"
 
-#define TCOD_PATHFINDER_MAX_DIMENSIONS 4
-
 struct TCOD_ArrayData {
   int8_t ndim;
   int int_type;
@@ -65,7 +63,7 @@ struct TCOD_Pathfinder {
   struct TCOD_ArrayData distance;
   struct TCOD_BasicGraph2D graph;
   struct TCOD_ArrayData traversal;
-  struct TCOD_Heap heap;
+  struct TCOD_Frontier* frontier;  // Uses buckets, see TCOD_frontier_use_buckets.
 };
 
 TCODLIB_CAPI struct TCOD_Pathfinder* TCOD_pf_new(int ndim, const size_t* shape);
@@ -79,6 +77,17 @@ TCODLIB_CAPI void TCOD_pf_set_traversal_pointer(
     struct TCOD_Pathfinder* path, void* data, int int_type, const size_t* strides);
 
 TCODLIB_CAPI int TCOD_pf_recompile(struct TCOD_Pathfinder* path);
+/**
+    @brief Add a root with an initial distance of `value` to the frontier.
+
+    The distance at `index` is lowered to `value` and queued if it isn't already lower.
+    Any number of roots can be added, TCOD_pf_compute then finds the distances from all of them in a single pass.
+
+    Returns -1 if `index` is out of bounds.
+
+    @versionadded{Unreleased}
+ */
+TCODLIB_CAPI int TCOD_pf_add_root(struct TCOD_Pathfinder* path, const int* index, int value);
 TCODLIB_CAPI int TCOD_pf_compute(struct TCOD_Pathfinder* path);
 TCODLIB_CAPI int TCOD_pf_compute_step(struct TCOD_Pathfinder* path);
 
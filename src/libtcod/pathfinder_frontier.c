@@ -32,7 +32,170 @@
 #include "pathfinder_frontier.h"
 
 #include <stdlib.h>
+#include <string.h>
 
+/// The number of buckets allocated by the first push.
+#define FRONTIER_MIN_BUCKETS 64
+/// Priorities spread further apart than this switch the frontier to its heap.
+#define FRONTIER_MAX_BUCKETS 4096
+
+/// Return the number of ints in each node of the bucket pool.
+static int frontier_node_stride(const struct TCOD_Frontier* frontier) { return frontier->ndim + 2; }
+/// Return the bucket holding `priority`, which must be within the current range of the buckets.
+static int frontier_bucket_of(const struct TCOD_FrontierBuckets* buckets, int priority) {
+  return (int)(((unsigned)buckets->cursor + (unsigned)priority - (unsigned)buckets->min_priority) &
+               (unsigned)(buckets->bucket_count - 1));
+}
+/// Return true if new nodes are pushed onto the heap instead of the buckets.
+static bool frontier_uses_heap(const struct TCOD_Frontier* frontier) {
+  return !frontier->buckets.enabled || frontier->buckets.in_heap;
+}
+/// Free the memory of the buckets and return them to their initial state, disabled.
+static void frontier_buckets_uninit(struct TCOD_FrontierBuckets* buckets) {
+  free(buckets->heads);
+  free(buckets->tails);
+  free(buckets->nodes);
+  memset(buckets, 0, sizeof(*buckets));
+  buckets->free_node = -1;
+}
+/// Remove all nodes from the buckets, keeping their memory.
+static void frontier_buckets_clear(struct TCOD_FrontierBuckets* buckets) {
+  if (buckets->size) {
+    for (int i = 0; i < buckets->bucket_count; ++i) buckets->heads[i] = buckets->tails[i] = -1;
+  }
+  buckets->in_heap = false;
+  buckets->size = 0;
+  buckets->node_count = 0;
+  buckets->free_node = -1;
+}
+/**
+    Make room for at least `count` consecutive priorities.
+
+    Returns 1 on success, 0 if `count` is more than FRONTIER_MAX_BUCKETS, or a negative error code.
+ */
+static int frontier_buckets_grow(struct TCOD_FrontierBuckets* buckets, int64_t count) {
+  if (count > FRONTIER_MAX_BUCKETS) return 0;
+  int new_count = buckets->bucket_count ? buckets->bucket_count : FRONTIER_MIN_BUCKETS;
+  while (new_count < count) new_count *= 2;
+  if (new_count == buckets->bucket_count) return 1;
+  int* heads = malloc(sizeof(*heads) * new_count);
+  int* tails = malloc(sizeof(*tails) * new_count);
+  if (!heads || !tails) {
+    free(heads);
+    free(tails);
+    TCOD_set_errorv("Out of memory allocating frontier buckets.");
+    return TCOD_E_OUT_OF_MEMORY;
+  }
+  for (int i = 0; i < new_count; ++i) heads[i] = tails[i] = -1;
+  // Each bucket holds a single priority, so moving them keeps them in order starting from the cursor.
+  for (int i = 0; buckets->size && i < buckets->bucket_count; ++i) {
+    const int old_bucket = (buckets->cursor + i) & (buckets->bucket_count - 1);
+    heads[i] = buckets->heads[old_bucket];
+    tails[i] = buckets->tails[old_bucket];
+  }
+  free(buckets->heads);
+  free(buckets->tails);
+  buckets->heads = heads;
+  buckets->tails = tails;
+  buckets->bucket_count = new_count;
+  buckets->cursor = 0;
+  return 1;
+}
+/// Return a node from the pool, or -1 if out of memory.
+static int frontier_buckets_new_node(struct TCOD_FrontierBuckets* buckets, int stride) {
+  if (buckets->free_node >= 0) {
+    const int node = buckets->free_node;
+    buckets->free_node = buckets->nodes[node * stride];
+    return node;
+  }
+  if (buckets->node_count == buckets->node_capacity) {
+    const int new_capacity = buckets->node_capacity ? buckets->node_capacity * 2 : 256;
+    int* nodes = realloc(buckets->nodes, sizeof(*nodes) * stride * new_capacity);
+    if (!nodes) {
+      TCOD_set_errorv("Out of memory allocating frontier nodes.");
+      return -1;
+    }
+    buckets->nodes = nodes;
+    buckets->node_capacity = new_capacity;
+  }
+  return buckets->node_count++;
+}
+/**
+    Move every node from the buckets to the heap.
+
+    On failure the buckets are left as they were.
+ */
+static TCOD_Error frontier_buckets_to_heap(struct TCOD_Frontier* frontier) {
+  struct TCOD_FrontierBuckets* buckets = &frontier->buckets;
+  const int stride = frontier_node_stride(frontier);
+  for (int priority = buckets->min_priority; buckets->size; ++priority) {
+    const int bucket = frontier_bucket_of(buckets, priority);
+    for (int node = buckets->heads[bucket]; node >= 0; node = buckets->nodes[node * stride]) {
+      if (TCOD_minheap_push(&frontier->heap, priority, &buckets->nodes[node * stride + 1]) < 0) {
+        TCOD_heap_clear(&frontier->heap);
+        return TCOD_E_OUT_OF_MEMORY;
+      }
+    }
+    if (priority == buckets->max_priority) break;
+  }
+  frontier_buckets_clear(buckets);
+  buckets->in_heap = true;
+  return TCOD_E_OK;
+}
+/**
+    Push a node onto the buckets.
+
+    Returns 1 on success, 0 if `priority` is too far from the other priorities, or a negative error code.
+ */
+static int frontier_buckets_push(struct TCOD_Frontier* frontier, const int* node_data, int priority) {
+  struct TCOD_FrontierBuckets* buckets = &frontier->buckets;
+  const int low = buckets->size && buckets->min_priority < priority ? buckets->min_priority : priority;
+  const int high = buckets->size && buckets->max_priority > priority ? buckets->max_priority : priority;
+  if ((int64_t)high - low >= buckets->bucket_count) {
+    const int grown = frontier_buckets_grow(buckets, (int64_t)high - low + 1);
+    if (grown <= 0) return grown;
+  }
+  const int stride = frontier_node_stride(frontier);
+  const int node = frontier_buckets_new_node(buckets, stride);
+  if (node < 0) return TCOD_E_OUT_OF_MEMORY;
+  if (buckets->size == 0) {
+    buckets->min_priority = buckets->max_priority = priority;
+  } else if (priority < buckets->min_priority) {
+    buckets->cursor = frontier_bucket_of(buckets, priority);
+    buckets->min_priority = priority;
+  } else if (priority > buckets->max_priority) {
+    buckets->max_priority = priority;
+  }
+  int* node_ptr = &buckets->nodes[node * stride];
+  node_ptr[0] = -1;
+  memcpy(node_ptr + 1, node_data, sizeof(*node_data) * (frontier->ndim + 1));
+  const int bucket = frontier_bucket_of(buckets, priority);
+  if (buckets->tails[bucket] >= 0) {
+    buckets->nodes[buckets->tails[bucket] * stride] = node;
+  } else {
+    buckets->heads[bucket] = node;
+  }
+  buckets->tails[bucket] = node;
+  ++buckets->size;
+  return 1;
+}
+/// Pop the node with the lowest priority from the buckets into `out`, the buckets must not be empty.
+static void frontier_buckets_pop(struct TCOD_Frontier* frontier, int* out) {
+  struct TCOD_FrontierBuckets* buckets = &frontier->buckets;
+  const int stride = frontier_node_stride(frontier);
+  while (buckets->heads[buckets->cursor] < 0) {
+    buckets->cursor = (buckets->cursor + 1) & (buckets->bucket_count - 1);
+    ++buckets->min_priority;
+  }
+  const int node = buckets->heads[buckets->cursor];
+  int* node_ptr = &buckets->nodes[node * stride];
+  buckets->heads[buckets->cursor] = node_ptr[0];
+  if (node_ptr[0] < 0) buckets->tails[buckets->cursor] = -1;
+  memcpy(out, node_ptr + 1, sizeof(*out) * (frontier->ndim + 1));
+  node_ptr[0] = buckets->free_node;
+  buckets->free_node = node;
+  --buckets->size;
+}
 struct TCOD_Frontier* TCOD_frontier_new(int ndim) {
   if (ndim <= 0 || TCOD_PATHFINDER_MAX_DIMENSIONS < ndim) {
     TCOD_set_errorvf("Can not make a pathfinder with %i dimensions.", ndim);
@@ -45,6 +208,7 @@ struct TCOD_Frontier* TCOD_frontier_new(int ndim) {
   }
   frontier->ndim = (int8_t)ndim;
   TCOD_heap_init(&frontier->heap, sizeof(int) * (ndim + 1));
+  frontier->buckets.free_node = -1;
   return frontier;
 }
 void TCOD_frontier_delete(struct TCOD_Frontier* frontier) {
@@ -52,6 +216,7 @@ void TCOD_frontier_delete(struct TCOD_Frontier* frontier) {
     return;
   }
   TCOD_heap_uninit(&frontier->heap);
+  frontier_buckets_uninit(&frontier->buckets);
   free(frontier);
 }
 TCOD_Error TCOD_frontier_pop(struct TCOD_Frontier* frontier) {
@@ -59,12 +224,16 @@ TCOD_Error TCOD_frontier_pop(struct TCOD_Frontier* frontier) {
     TCOD_set_errorv("Pointer argument must not be NULL.");
     return TCOD_E_INVALID_ARGUMENT;
   }
-  if (frontier->heap.size == 0) {
+  if (frontier->heap.size == 0 && frontier->buckets.size == 0) {
     TCOD_set_errorv("Heap is empty.");
     return TCOD_E_ERROR;
   }
   int node[TCOD_PATHFINDER_MAX_DIMENSIONS + 1];
-  TCOD_minheap_pop(&frontier->heap, node);
+  if (frontier_uses_heap(frontier)) {
+    TCOD_minheap_pop(&frontier->heap, node);
+  } else {
+    frontier_buckets_pop(frontier, node);
+  }
   frontier->active_dist = node[0];
   for (int i = 0; i < frontier->ndim; ++i) {
     frontier->active_index[i] = node[i + 1];
@@ -82,7 +251,26 @@ TCOD_Error TCOD_frontier_push(
   for (int i = 0; i < frontier->ndim; ++i) {
     node[i + 1] = index[i];
   }
-  TCOD_minheap_push(&frontier->heap, heuristic, node);
+  if (!frontier_uses_heap(frontier)) {
+    const int pushed = frontier_buckets_push(frontier, node, heuristic);
+    if (pushed != 0) return pushed < 0 ? (TCOD_Error)pushed : TCOD_E_OK;
+    const TCOD_Error err = frontier_buckets_to_heap(frontier);
+    if (err < 0) return err;
+  }
+  return (TCOD_Error)TCOD_minheap_push(&frontier->heap, heuristic, node);
+}
+TCOD_Error TCOD_frontier_use_buckets(struct TCOD_Frontier* frontier, bool enable) {
+  if (!frontier) {
+    TCOD_set_errorv("Pointer argument must not be NULL.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (frontier->heap.size || frontier->buckets.size) {
+    TCOD_set_errorv("Frontier must be empty.");
+    return TCOD_E_INVALID_ARGUMENT;
+  }
+  if (!enable) frontier_buckets_uninit(&frontier->buckets);
+  frontier->buckets.enabled = enable;
+  frontier->buckets.in_heap = false;
   return TCOD_E_OK;
 }
 int TCOD_frontier_size(const struct TCOD_Frontier* frontier) {
@@ -90,7 +278,7 @@ int TCOD_frontier_size(const struct TCOD_Frontier* frontier) {
     TCOD_set_errorv("Pointer argument must not be NULL.");
     return 0;
   }
-  return frontier->heap.size;
+  return frontier->heap.size + frontier->buckets.size;
 }
 TCOD_Error TCOD_frontier_clear(struct TCOD_Frontier* frontier) {
   if (!frontier) {
@@ -98,5 +286,6 @@ TCOD_Error TCOD_frontier_clear(struct TCOD_Frontier* frontier) {
     return TCOD_E_INVALID_ARGUMENT;
   }
   TCOD_heap_clear(&frontier->heap);
+  frontier_buckets_clear(&frontier->buckets);
   return TCOD_E_OK;
 }
@@ -33,6 +33,7 @@
 #ifndef TCOD_PATHFINDER_FRONTIER_H
 #define TCOD_PATHFINDER_FRONTIER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "config.h"
@@ -41,11 +42,34 @@
 
 #define TCOD_PATHFINDER_MAX_DIMENSIONS 4
 
+/**
+    A ring of FIFO buckets, one per priority, which TCOD_Frontier can use while the queued priorities are close.
+
+    This is a Dial bucket queue: nodes are pushed and popped in constant time.
+    Every node is kept in `nodes` as a link to the next node of its bucket followed by its distance and index.
+ */
+struct TCOD_FrontierBuckets {
+  bool enabled;  // True if TCOD_frontier_use_buckets enabled the buckets, otherwise every node is kept in the heap.
+  bool in_heap;  // True once the nodes are kept in the heap instead, until the frontier is cleared.
+  int size;  // The number of nodes in the buckets.
+  int min_priority;  // The priority of the bucket at `cursor`, no node has a lower priority.
+  int max_priority;  // No node has a higher priority than this.
+  int cursor;  // The bucket of `min_priority`.
+  int bucket_count;  // The number of buckets, a power of two.
+  int* heads;  // The first node of each bucket, or -1.
+  int* tails;  // The last node of each bucket, or -1.
+  int* nodes;  // The node pool.
+  int node_count;  // The number of nodes ever taken from the pool since it was last cleared.
+  int node_capacity;  // The number of nodes the pool can hold.
+  int free_node;  // The first node of the list of released nodes, or -1.
+};
+
 struct TCOD_Frontier {
   int8_t ndim;
   int active_dist;
   int active_index[TCOD_PATHFINDER_MAX_DIMENSIONS];
-  struct TCOD_Heap heap;
+  struct TCOD_Heap heap;  // Holds every node unless `buckets` are enabled and in use.
+  struct TCOD_FrontierBuckets buckets;
 };
 #ifdef __cplusplus
 extern "C" {
@@ -54,8 +78,25 @@ extern "C" {
     Create a new pathfinder frontier.
 
     `ndim` is the number of dimensions.  Must be in the range `1 <= n <= 4`.
+
+    Nodes are kept in `heap` unless TCOD_frontier_use_buckets is called.
  */
 TCOD_PUBLIC TCOD_NODISCARD struct TCOD_Frontier* TCOD_frontier_new(int ndim);
+/**
+    Set whether this frontier may keep its nodes in a bucket queue instead of its heap.
+
+    While enabled, nodes are kept in a bucket queue as long as the priorities in the frontier are no more than a few
+    thousand apart, such as with small integer edge costs.  Otherwise the frontier switches to its heap until it is
+    cleared.
+
+    Only enable this if nothing reads or modifies `heap` directly, since it stays empty while the buckets are in use.
+    Use TCOD_frontier_size instead of reading `heap.size`.
+
+    The frontier must be empty.  Returns an error code on failure.
+
+    @versionadded{Unreleased}
+ */
+TCOD_PUBLIC TCOD_Error TCOD_frontier_use_buckets(struct TCOD_Frontier* frontier, bool enable);
 /**
     Delete a pathfinder frontier.
  */
@@ -37,6 +37,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "libtcod_int.h"
 #include "logging.h"
@@ -199,6 +200,7 @@ static int cache_console_update(struct TCOD_TilesetObserver* observer, int tile_
         continue;
       }
       console->tiles[i].ch = -1;
+      if (console->row_versions) console->row_versions[i / console->w] = 0;
     }
   }
   return 0;
@@ -261,6 +263,13 @@ static TCOD_Error setup_cache_console(
     for (int i = 0; i < (*cache)->elements; ++i) {
       (*cache)->tiles[i].ch = -1;
     }
+    // Rows of consoles which track changes can be skipped when their version matches the cache.
+    if (TCOD_console_set_change_tracking(*cache, true) < 0) {
+      TCOD_console_delete(*cache);
+      *cache = NULL;
+      return TCOD_E_OUT_OF_MEMORY;
+    }
+    memset((*cache)->row_versions, 0, sizeof(*(*cache)->row_versions) * (*cache)->h);
   }
   return TCOD_E_OK;
 }
@@ -431,6 +440,7 @@ static TCOD_Error TCOD_sdl2_render(
   buffer->index = 0;
   buffer->indices_initialized = 0;
   for (int y = 0; y < console->h; ++y) {
+    if (cache && TCOD_console_row_is_cached_(console, cache, y)) continue;  // This row has not changed.
     for (int x = 0; x < console->w; ++x) {
       const TCOD_ConsoleTile tile = normalize_tile_for_drawing(console->tiles[console->w * y + x], atlas->tileset);
       if (cache) {
@@ -462,6 +472,7 @@ static TCOD_Error TCOD_sdl2_render(
   const float u_multiply = 1.0f / (float)(tex_width);  // Used to transform texture pixel coordinates to UV coords.
   const float v_multiply = 1.0f / (float)(tex_height);
   for (int y = 0; y < console->h; ++y) {
+    if (cache && TCOD_console_row_is_cached_(console, cache, y)) continue;
     for (int x = 0; x < console->w; ++x) {
       const TCOD_ConsoleTile tile = normalize_tile_for_drawing(console->tiles[console->w * y + x], atlas->tileset);
       if (tile.ch == 0) continue;  // No FG glyph to draw.
@@ -478,6 +489,7 @@ static TCOD_Error TCOD_sdl2_render(
       }
       vertex_buffer_push_fg(buffer, x, y, tile, atlas, u_multiply, v_multiply);
     }
+    if (cache) TCOD_console_row_set_cached_(console, cache, y);
   }
   vertex_buffer_flush_fg(buffer, atlas);
   free(buffer);
@@ -486,6 +498,7 @@ static TCOD_Error TCOD_sdl2_render(
   SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
   SDL_SetTextureAlphaMod(atlas->texture, 0xff);
   for (int y = 0; y < console->h; ++y) {
+    if (cache && TCOD_console_row_is_cached_(console, cache, y)) continue;  // This row has not changed.
     for (int x = 0; x < console->w; ++x) {
       const SDL_Rect dest = get_aligned_tile(atlas->tileset, x, y);
       const TCOD_ConsoleTile tile = normalize_tile_for_drawing(console->tiles[console->w * y + x], atlas->tileset);
@@ -511,6 +524,7 @@ static TCOD_Error TCOD_sdl2_render(
       const SDL_Rect src = get_sdl2_atlas_tile(atlas, tile_id);
       SDL_RenderCopy(atlas->renderer, atlas->texture, &src, &dest);
     }
+    if (cache) TCOD_console_row_set_cached_(console, cache, y);
   }
 #endif  // SDL_VERSION_ATLEAST
   return TCOD_E_OK;
@@ -614,6 +628,12 @@ static bool sdl2_handle_event(void* userdata, SDL_Event* event) {
         for (int i = 0; i < context->cache_console->elements; ++i) {
           context->cache_console->tiles[i] = (struct TCOD_ConsoleTile){-1, {0}, {0}};
         }
+        if (context->cache_console->row_versions) {
+          memset(
+              context->cache_console->row_versions,
+              0,
+              sizeof(*context->cache_console->row_versions) * context->cache_console->h);
+        }
       }
       break;
   }
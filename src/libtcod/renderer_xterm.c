@@ -38,6 +38,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -49,6 +50,7 @@
 
 #include "console_types.h"
 #include "error.h"
+#include "libtcod_int.h"
 #include "logging.h"
 
 #define DOUBLE_CLICK_TIME 500
@@ -173,12 +175,16 @@ static TCOD_Error xterm_present(
   if (!context->cache) {
     context->cache = TCOD_console_new(console->w, console->h);
     for (int i = 0; i < context->cache->elements; ++i) context->cache->tiles[i].ch = -1;
+    if (TCOD_console_set_change_tracking(context->cache, true) == TCOD_E_OK) {
+      memset(context->cache->row_versions, 0, sizeof(*context->cache->row_versions) * context->cache->h);
+    }
   }
   struct TerminalSizeOut term_size;
   xterm_get_terminal_size(&term_size);  // This polls the terminal and might be too slow.
 
   fprintf(stdout, "\x1b[?25l");  // Cursor un-hiding on Windows after window is resized.
   for (int y = 0; y < console->h && y < term_size.rows; ++y) {
+    if (TCOD_console_row_is_cached_(console, context->cache, y)) continue;  // This row has not changed.
     fprintf(stdout, "\x1b[%d;0H", y);  // Move cursor to start of next line.
     int skip_tiles = 0;  // Skip unchanged tiles.
     for (int x = 0; x < console->w && x < term_size.columns; ++x) {
@@ -207,6 +213,7 @@ static TCOD_Error xterm_present(
           ucs4_to_utf8(tile->ch & 0x10FFFF, utf8));
       *prev_tile = *tile;
     }
+    if (console->w <= term_size.columns) TCOD_console_row_set_cached_(console, context->cache, y);
   }
   return TCOD_E_OK;
 }
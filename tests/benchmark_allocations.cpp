@@ -0,0 +1,110 @@
+#include "benchmark_allocations.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+
+// Only the benchmark executable defines TCOD_BENCHMARK_ALLOCATIONS, so that the unit tests keep glibc's allocator.
+#if defined(TCOD_BENCHMARK_ALLOCATIONS) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && \
+    !defined(__SANITIZE_THREAD__)
+#define BENCHMARK_COUNT_ALLOCATIONS 1
+#endif
+
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+#include <malloc.h>
+/*
+    Count heap allocations made by libtcod by replacing malloc in this executable.
+
+    glibc allows the application to replace the allocator, these forward to glibc's own implementation.
+    Every allocating function is replaced, including the aligned ones, since all of them are released by free.
+    Sizes are measured with malloc_usable_size so that free knows how much to subtract.
+*/
+static std::atomic<long> g_allocation_count{0};
+static std::atomic<long long> g_allocated_bytes{0};
+static std::atomic<long long> g_peak_allocated_bytes{0};
+
+/// Track `ptr` as newly allocated.
+static void track_allocation(void* ptr) {
+  if (!ptr) return;
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  const auto size = static_cast<long long>(malloc_usable_size(ptr));
+  const long long now = g_allocated_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  long long peak = g_peak_allocated_bytes.load(std::memory_order_relaxed);
+  while (now > peak && !g_peak_allocated_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+  }
+}
+/// Track `ptr` as about to be freed.
+static void track_free(void* ptr) {
+  if (!ptr) return;
+  g_allocated_bytes.fetch_sub(static_cast<long long>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+}
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+void* __libc_memalign(size_t alignment, size_t size);
+void* __libc_valloc(size_t size);
+void* __libc_pvalloc(size_t size);
+void* malloc(size_t size) noexcept {
+  void* ptr = __libc_malloc(size);
+  track_allocation(ptr);
+  return ptr;
+}
+void* calloc(size_t count, size_t size) noexcept {
+  void* ptr = __libc_calloc(count, size);
+  track_allocation(ptr);
+  return ptr;
+}
+void* realloc(void* ptr, size_t size) noexcept {
+  const auto old_size = ptr ? static_cast<long long>(malloc_usable_size(ptr)) : 0;
+  void* new_ptr = __libc_realloc(ptr, size);
+  if (new_ptr) {
+    g_allocated_bytes.fetch_sub(old_size, std::memory_order_relaxed);
+    track_allocation(new_ptr);
+  } else if (size == 0) {
+    g_allocated_bytes.fetch_sub(old_size, std::memory_order_relaxed);  // realloc(ptr, 0) may free ptr.
+  }
+  return new_ptr;
+}
+void* memalign(size_t alignment, size_t size) noexcept {
+  void* ptr = __libc_memalign(alignment, size);
+  track_allocation(ptr);
+  return ptr;
+}
+void* aligned_alloc(size_t alignment, size_t size) noexcept { return memalign(alignment, size); }
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept {
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+  void* ptr = memalign(alignment, size);
+  if (!ptr) return ENOMEM;
+  *out = ptr;
+  return 0;
+}
+void* valloc(size_t size) noexcept {
+  void* ptr = __libc_valloc(size);
+  track_allocation(ptr);
+  return ptr;
+}
+void* pvalloc(size_t size) noexcept {
+  void* ptr = __libc_pvalloc(size);
+  track_allocation(ptr);
+  return ptr;
+}
+void free(void* ptr) noexcept {
+  track_free(ptr);
+  __libc_free(ptr);
+}
+}
+long get_allocation_count() { return g_allocation_count.load(std::memory_order_relaxed); }
+long long get_allocated_bytes() { return g_allocated_bytes.load(std::memory_order_relaxed); }
+long long get_peak_allocated_bytes() { return g_peak_allocated_bytes.load(std::memory_order_relaxed); }
+void reset_peak_allocated_bytes() {
+  g_peak_allocated_bytes.store(g_allocated_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+#else
+long get_allocation_count() { return -1; }
+long long get_allocated_bytes() { return -1; }
+long long get_peak_allocated_bytes() { return -1; }
+void reset_peak_allocated_bytes() {}
+#endif  // BENCHMARK_COUNT_ALLOCATIONS
@@ -0,0 +1,16 @@
+#pragma once
+/*
+    Heap allocation tracking for benchmarks.
+
+    On glibc malloc is replaced in the benchmark executable to count allocations and the bytes in use, these return -1
+    everywhere else, including in the unittest executable.
+*/
+
+/// Return the number of allocations made so far, or -1 if allocations are not being counted.
+long get_allocation_count();
+/// Return the number of bytes currently allocated, or -1 if allocations are not being counted.
+long long get_allocated_bytes();
+/// Return the highest number of bytes allocated since the last reset_peak_allocated_bytes, or -1 if not counted.
+long long get_peak_allocated_bytes();
+/// Start tracking a new peak from the number of bytes currently allocated.
+void reset_peak_allocated_bytes();
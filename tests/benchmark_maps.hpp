@@ -0,0 +1,138 @@
+#pragma once
+/*
+    Procedural test maps shared by the benchmarks.
+
+    Every generator is seeded so the same size always gives the same map.
+    Only the raw output of std::mt19937 is used, its sequence is fixed by the standard while the standard distributions
+    and std::shuffle differ between standard libraries.
+*/
+#include <algorithm>
+#include <libtcod/bsp.hpp>
+#include <libtcod/fov.hpp>
+#include <libtcod/mersenne.hpp>
+#include <random>
+#include <utility>
+#include <vector>
+
+/// Set every cell of `map` to be open or blocked.
+inline void set_cell(TCOD_Map& map, int x, int y, bool is_open) {
+  TCOD_map_set_properties(&map, x, y, is_open, is_open);
+}
+
+/// Shuffle `items` with a Fisher-Yates shuffle, which gives the same order with every standard library.
+template <typename T>
+inline void shuffle_items(std::vector<T>& items, std::mt19937& rng) {
+  for (size_t i = items.size(); i > 1; --i) std::swap(items[i - 1], items[rng() % i]);
+}
+
+/// Return an open field with 1 in 50 cells blocked.
+inline tcod::MapPtr_ new_open_map(int width, int height) {
+  std::mt19937 rng(0);
+  tcod::MapPtr_ map{TCOD_map_new(width, height)};
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) set_cell(*map, x, y, rng() % 50 != 0);
+  }
+  return map;
+}
+
+/// Return rooms carved out of BSP leaves and connected by corridors, similar to the BSP sample.
+inline tcod::MapPtr_ new_bsp_map(int width, int height) {
+  tcod::MapPtr_ map{TCOD_map_new(width, height)};
+  TCOD_map_clear(map.get(), false, false);
+  TCODRandom rng{0u};
+  TCODBsp root{0, 0, width, height};
+  root.splitRecursive(&rng, 8, 8, 8, 1.5f, 1.5f);
+  const auto dig = [&](int x1, int y1, int x2, int y2) {
+    if (x1 > x2) std::swap(x1, x2);
+    if (y1 > y2) std::swap(y1, y2);
+    for (int y = std::max(1, y1); y <= std::min(height - 2, y2); ++y) {
+      for (int x = std::max(1, x1); x <= std::min(width - 2, x2); ++x) set_cell(*map, x, y, true);
+    }
+  };
+  root.traverseInvertedLevelOrder([&](TCODBsp& node) {
+    if (node.isLeaf()) {
+      // Rooms always cover the center of their leaf so that corridors between centers connect them.
+      const int left = rng.getInt(0, node.w / 4);
+      const int top = rng.getInt(0, node.h / 4);
+      const int right = rng.getInt(0, node.w / 4);
+      const int bottom = rng.getInt(0, node.h / 4);
+      dig(node.x + 1 + left, node.y + 1 + top, node.x + node.w - 2 - right, node.y + node.h - 2 - bottom);
+    } else {
+      const TCODBsp& a = *node.getLeft();
+      const TCODBsp& b = *node.getRight();
+      const int ax = a.x + a.w / 2;
+      const int ay = a.y + a.h / 2;
+      const int bx = b.x + b.w / 2;
+      const int by = b.y + b.h / 2;
+      dig(ax, ay, bx, ay);
+      dig(bx, ay, bx, by);
+    }
+    return true;
+  });
+  return map;
+}
+
+/// Return cellular automata caves.
+inline tcod::MapPtr_ new_cave_map(int width, int height) {
+  std::mt19937 rng(0);
+  std::vector<char> walls(width * height);
+  for (auto& it : walls) it = rng() % 100 < 45;
+  std::vector<char> next(walls.size());
+  for (int step = 0; step < 4; ++step) {
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        int neighbors = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+          for (int dx = -1; dx <= 1; ++dx) {
+            const int nx = x + dx;
+            const int ny = y + dy;
+            neighbors += (nx < 0 || ny < 0 || nx >= width || ny >= height) ? 1 : walls[nx + ny * width];
+          }
+        }
+        next[x + y * width] = neighbors >= 5;
+      }
+    }
+    std::swap(walls, next);
+  }
+  tcod::MapPtr_ map{TCOD_map_new(width, height)};
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) set_cell(*map, x, y, !walls[x + y * width]);
+  }
+  return map;
+}
+
+/// Return a perfect maze of one cell wide corridors, carved by a randomized depth-first search.
+inline tcod::MapPtr_ new_maze_map(int width, int height) {
+  tcod::MapPtr_ map{TCOD_map_new(width, height)};
+  TCOD_map_clear(map.get(), false, false);
+  std::mt19937 rng(0);
+  // Corridors join the cells at odd coordinates.
+  const int cells_w = (width - 1) / 2;
+  const int cells_h = (height - 1) / 2;
+  if (cells_w <= 0 || cells_h <= 0) return map;
+  std::vector<char> visited(cells_w * cells_h);
+  std::vector<std::pair<int, int>> stack{{0, 0}};
+  visited[0] = true;
+  set_cell(*map, 1, 1, true);
+  while (!stack.empty()) {
+    const auto [cx, cy] = stack.back();
+    std::pair<int, int> options[4];
+    int n_options = 0;
+    for (const auto& step : {std::pair<int, int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}}) {
+      const int nx = cx + step.first;
+      const int ny = cy + step.second;
+      if (nx < 0 || ny < 0 || nx >= cells_w || ny >= cells_h || visited[nx + ny * cells_w]) continue;
+      options[n_options++] = {nx, ny};
+    }
+    if (n_options == 0) {
+      stack.pop_back();
+      continue;
+    }
+    const auto next = options[rng() % n_options];
+    visited[next.first + next.second * cells_w] = true;
+    set_cell(*map, cx + next.first + 1, cy + next.second + 1, true);  // The wall between both cells.
+    set_cell(*map, next.first * 2 + 1, next.second * 2 + 1, true);
+    stack.push_back(next);
+  }
+  return map;
+}
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <array>
+#include <catch2/catch_all.hpp>
 #include <cstdlib>
 #include <libtcod/console.hpp>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.h>
+#include <libtcod/path_flow_field.h>
+#include <libtcod/path_hierarchical.h>
+#include <libtcod/path_incremental.h>
+#include <memory>
+#include <random>
 #include <string>
 
 #ifdef _MSC_VER
@@ -67,3 +76,92 @@ static inline auto ucs4_to_utf8(int ucs4) -> std::string {
   }
   throw std::invalid_argument("Invalid codepoint.");
 }
+/***************************************************************************
+    @brief Deletes a TCOD_Dijkstra, for use with std::unique_ptr.
+ */
+struct DijkstraDeleter {
+  void operator()(TCOD_Dijkstra* dijkstra) const { TCOD_dijkstra_delete(dijkstra); }
+};
+using DijkstraPtr = std::unique_ptr<TCOD_Dijkstra, DijkstraDeleter>;
+/***************************************************************************
+    @brief Deletes a TCOD_HierarchicalPath, for use with std::unique_ptr.
+ */
+struct HierarchicalPathDeleter {
+  void operator()(TCOD_HierarchicalPath* path) const { TCOD_hierarchical_path_delete(path); }
+};
+using HierarchicalPathPtr = std::unique_ptr<TCOD_HierarchicalPath, HierarchicalPathDeleter>;
+/***************************************************************************
+    @brief Deletes a TCOD_IncrementalPath, for use with std::unique_ptr.
+ */
+struct IncrementalPathDeleter {
+  void operator()(TCOD_IncrementalPath* path) const { TCOD_incremental_path_delete(path); }
+};
+using IncrementalPathPtr = std::unique_ptr<TCOD_IncrementalPath, IncrementalPathDeleter>;
+/***************************************************************************
+    @brief Deletes a TCOD_FlowField, for use with std::unique_ptr.
+ */
+struct FlowFieldDeleter {
+  void operator()(TCOD_FlowField* flow) const { TCOD_flow_field_delete(flow); }
+};
+using FlowFieldPtr = std::unique_ptr<TCOD_FlowField, FlowFieldDeleter>;
+/***************************************************************************
+    @brief Tally the cells expanded by the full searches and by the repairs of an incremental pathfinder.
+ */
+struct RepairStats {
+  long full_expanded = 0;
+  long full_searches = 0;
+  long repair_expanded = 0;
+  long repairs = 0;
+  void add(bool is_repair, int expanded) {
+    if (is_repair) {
+      repair_expanded += expanded;
+      ++repairs;
+    } else {
+      full_expanded += expanded;
+      ++full_searches;
+    }
+  }
+  /// Check that repairing a search after a local change did much less work than starting over.
+  void check_repairs_are_cheaper() const {
+    REQUIRE(full_searches > 0);
+    REQUIRE(repairs > 0);
+    CHECK(repair_expanded / repairs < full_expanded / full_searches / 2);
+  }
+};
+/***************************************************************************
+    @brief Make 1 in `wall_chance` cells of `map` walls and the rest open, using `rng`.
+ */
+static inline void fill_random_map(TCOD_Map* map, int wall_chance, std::mt19937& rng) {
+  for (int y = 0; y < TCOD_map_get_height(map); ++y) {
+    for (int x = 0; x < TCOD_map_get_width(map); ++x) {
+      const bool is_open = rng() % wall_chance != 0;
+      TCOD_map_set_properties(map, x, y, is_open, is_open);
+    }
+  }
+}
+/***************************************************************************
+    @brief Check that a path is a valid walk on `map` from `{ox, oy}` to `{dx, dy}` and return its cost.
+
+    `size` and `get` are the functions reading the steps of `path`, such as TCOD_path_size and TCOD_path_get.
+ */
+template <typename Path, typename SizeFunc, typename GetFunc>
+static inline float check_path_steps(
+    Path* path, SizeFunc size, GetFunc get, TCOD_Map* map, int ox, int oy, int dx, int dy, float diagonal) {
+  int x = ox;
+  int y = oy;
+  float cost = 0;
+  for (int i = 0; i < size(path); ++i) {
+    int next_x;
+    int next_y;
+    get(path, i, &next_x, &next_y);
+    INFO("step=" << i << " from " << x << "," << y << " to " << next_x << "," << next_y);
+    REQUIRE(std::abs(next_x - x) <= 1);
+    REQUIRE(std::abs(next_y - y) <= 1);
+    REQUIRE(TCOD_map_is_walkable(map, next_x, next_y));
+    cost += (next_x != x && next_y != y) ? diagonal : 1.0f;
+    x = next_x;
+    y = next_y;
+  }
+  REQUIRE(std::array<int, 2>{x, y} == std::array<int, 2>{dx, dy});
+  return cost;
+}
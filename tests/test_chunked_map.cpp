@@ -0,0 +1,208 @@
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <libtcod/chunked_map.h>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+struct ChunkedMapDeleter {
+  void operator()(TCOD_ChunkedMap* map) const { TCOD_chunked_map_delete(map); }
+};
+using ChunkedMapPtr = std::unique_ptr<TCOD_ChunkedMap, ChunkedMapDeleter>;
+
+/// Fill `dense` with random walls, then copy it onto `chunked` with its top-left corner at `{x, y}`.
+void fill_both(TCOD_Map& dense, TCOD_ChunkedMap& chunked, int x, int y, unsigned int seed) {
+  std::mt19937 rng(seed);
+  for (int j = 0; j < TCOD_map_get_height(&dense); ++j) {
+    for (int i = 0; i < TCOD_map_get_width(&dense); ++i) {
+      const bool is_open = rng() % 4 != 0;
+      TCOD_map_set_properties(&dense, i, j, is_open, is_open);
+      REQUIRE(TCOD_chunked_map_set_properties(&chunked, x + i, y + j, is_open, is_open) == TCOD_E_OK);
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("Chunked map cells", "[chunked_map]") {
+  ChunkedMapPtr map{TCOD_chunked_map_new(true, false)};
+  REQUIRE(map);
+  CHECK(TCOD_chunked_map_is_transparent(map.get(), -1000000, 2000000));
+  CHECK(!TCOD_chunked_map_is_walkable(map.get(), -1000000, 2000000));
+  CHECK(TCOD_chunked_map_get_chunk_count(map.get()) == 0);  // Reads do not allocate chunks.
+
+  for (const auto& xy : {std::array<int, 2>{-1, -1}, {0, 0}, {63, 63}, {64, -64}, {-65, 64}}) {
+    REQUIRE(TCOD_chunked_map_set_properties(map.get(), xy[0], xy[1], false, true) == TCOD_E_OK);
+  }
+  CHECK(TCOD_chunked_map_get_chunk_count(map.get()) == 4);  // {0, 0} and {63, 63} share a chunk.
+  CHECK(!TCOD_chunked_map_is_transparent(map.get(), -1, -1));
+  CHECK(TCOD_chunked_map_is_walkable(map.get(), -1, -1));
+  CHECK(TCOD_chunked_map_is_transparent(map.get(), -2, -1));
+  CHECK(!TCOD_chunked_map_is_walkable(map.get(), -2, -1));
+  CHECK(!TCOD_chunked_map_is_transparent(map.get(), 63, 63));
+  CHECK(!TCOD_chunked_map_is_transparent(map.get(), 64, -64));
+  CHECK(TCOD_chunked_map_is_transparent(map.get(), 64, -65));
+  CHECK(!TCOD_chunked_map_is_transparent(map.get(), -65, 64));
+}
+
+TEST_CASE("Chunked map FOV matches a dense map", "[chunked_map]") {
+  const int WIDTH = 150;
+  const int HEIGHT = 110;
+  const int OFFSET_X = -70;  // Spans chunks on both sides of zero.
+  const int OFFSET_Y = -100;
+  const int RADIUS = 12;
+  tcod::MapPtr_ dense{TCOD_map_new(WIDTH, HEIGHT)};
+  ChunkedMapPtr chunked{TCOD_chunked_map_new(true, true)};
+  fill_both(*dense, *chunked, OFFSET_X, OFFSET_Y, 1);
+  for (const auto algo : {FOV_BASIC, FOV_SHADOW, FOV_PERMISSIVE_4, FOV_RESTRICTIVE, FOV_SYMMETRIC_SHADOWCAST}) {
+    for (const auto& pov : {std::array<int, 2>{75, 55}, {70, 95}, {12, 12}, {137, 40}}) {
+      INFO("algo=" << algo << " pov=" << pov[0] << "," << pov[1]);
+      REQUIRE(TCOD_map_compute_fov(dense.get(), pov[0], pov[1], RADIUS, true, algo) == TCOD_E_OK);
+      REQUIRE(
+          TCOD_chunked_map_compute_fov(
+              chunked.get(), OFFSET_X + pov[0], OFFSET_Y + pov[1], RADIUS, true, algo) == TCOD_E_OK);
+      for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+          INFO("x=" << x << " y=" << y);
+          REQUIRE(
+              TCOD_chunked_map_is_in_fov(chunked.get(), OFFSET_X + x, OFFSET_Y + y) ==
+              TCOD_map_is_in_fov(dense.get(), x, y));
+        }
+      }
+    }
+  }
+  CHECK(TCOD_chunked_map_compute_fov(chunked.get(), 0, 0, 0, true, FOV_SHADOW) == TCOD_E_INVALID_ARGUMENT);
+}
+
+TEST_CASE("Chunked map regions for pathfinding", "[chunked_map]") {
+  const int WIDTH = 100;
+  const int HEIGHT = 90;
+  const int OFFSET_X = -40;
+  const int OFFSET_Y = 20;
+  tcod::MapPtr_ dense{TCOD_map_new(WIDTH, HEIGHT)};
+  ChunkedMapPtr chunked{TCOD_chunked_map_new(false, false)};
+  fill_both(*dense, *chunked, OFFSET_X, OFFSET_Y, 2);
+  tcod::MapPtr_ region{TCOD_map_new(WIDTH, HEIGHT)};
+  REQUIRE(TCOD_chunked_map_copy_region(chunked.get(), OFFSET_X, OFFSET_Y, region.get()) == TCOD_E_OK);
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      REQUIRE(TCOD_map_is_walkable(region.get(), x, y) == TCOD_map_is_walkable(dense.get(), x, y));
+      REQUIRE(TCOD_map_is_transparent(region.get(), x, y) == TCOD_map_is_transparent(dense.get(), x, y));
+    }
+  }
+  TCOD_map_set_properties(dense.get(), 1, 1, true, true);
+  TCOD_map_set_properties(dense.get(), 98, 88, true, true);
+  REQUIRE(TCOD_chunked_map_set_properties(chunked.get(), OFFSET_X + 1, OFFSET_Y + 1, true, true) == TCOD_E_OK);
+  REQUIRE(TCOD_chunked_map_set_properties(chunked.get(), OFFSET_X + 98, OFFSET_Y + 88, true, true) == TCOD_E_OK);
+  REQUIRE(TCOD_chunked_map_copy_region(chunked.get(), OFFSET_X, OFFSET_Y, region.get()) == TCOD_E_OK);
+
+  TCOD_Path* dense_path = TCOD_path_new_using_map(dense.get(), 1.41f);
+  TCOD_Path* region_path = TCOD_path_new_using_map(region.get(), 1.41f);
+  const bool found = TCOD_path_compute(dense_path, 1, 1, 98, 88);
+  REQUIRE(TCOD_path_compute(region_path, 1, 1, 98, 88) == found);
+  REQUIRE(TCOD_path_size(region_path) == TCOD_path_size(dense_path));
+  for (int i = 0; i < TCOD_path_size(dense_path); ++i) {
+    int dense_x, dense_y, region_x, region_y;
+    TCOD_path_get(dense_path, i, &dense_x, &dense_y);
+    TCOD_path_get(region_path, i, &region_x, &region_y);
+    REQUIRE(std::make_pair(region_x, region_y) == std::make_pair(dense_x, dense_y));
+  }
+  TCOD_path_delete(dense_path);
+  TCOD_path_delete(region_path);
+
+  TCOD_Dijkstra* dense_dijkstra = TCOD_dijkstra_new(dense.get(), 1.41f);
+  TCOD_Dijkstra* region_dijkstra = TCOD_dijkstra_new(region.get(), 1.41f);
+  TCOD_dijkstra_compute(dense_dijkstra, 1, 1);
+  TCOD_dijkstra_compute(region_dijkstra, 1, 1);
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      REQUIRE(TCOD_dijkstra_get_distance(region_dijkstra, x, y) == TCOD_dijkstra_get_distance(dense_dijkstra, x, y));
+    }
+  }
+  TCOD_dijkstra_delete(dense_dijkstra);
+  TCOD_dijkstra_delete(region_dijkstra);
+}
+
+TEST_CASE("Chunked map regions copy into either layout", "[chunked_map]") {
+  ChunkedMapPtr chunked{TCOD_chunked_map_new(true, false)};
+  std::mt19937 rng(3);
+  for (int y = -70; y < 70; ++y) {
+    for (int x = -70; x < 150; ++x) {
+      REQUIRE(TCOD_chunked_map_set_properties(chunked.get(), x, y, rng() % 2, rng() % 2) == TCOD_E_OK);
+    }
+  }
+  const std::array<std::pair<int, int>, 4> sizes{{{1, 1}, {64, 3}, {130, 40}, {200, 150}}};
+  for (const auto& size : sizes) {
+    for (const int offset : {-77, -64, -5, 0, 31}) {
+      tcod::MapPtr_ cells{TCOD_map_new(size.first, size.second)};
+      tcod::MapPtr_ bits{TCOD_map_new_bitpacked(size.first, size.second)};
+      const uint64_t version = TCOD_map_get_version(bits.get(), 0, 0, size.first, size.second);
+      REQUIRE(TCOD_chunked_map_copy_region(chunked.get(), offset, offset / 2, cells.get()) == TCOD_E_OK);
+      REQUIRE(TCOD_chunked_map_copy_region(chunked.get(), offset, offset / 2, bits.get()) == TCOD_E_OK);
+      REQUIRE(TCOD_map_get_version(bits.get(), 0, 0, size.first, size.second) == version + 1);
+      for (int y = 0; y < size.second; ++y) {
+        for (int x = 0; x < size.first; ++x) {
+          const bool transparent = TCOD_chunked_map_is_transparent(chunked.get(), offset + x, offset / 2 + y);
+          const bool walkable = TCOD_chunked_map_is_walkable(chunked.get(), offset + x, offset / 2 + y);
+          REQUIRE(TCOD_map_is_transparent(cells.get(), x, y) == transparent);
+          REQUIRE(TCOD_map_is_walkable(cells.get(), x, y) == walkable);
+          REQUIRE(TCOD_map_is_transparent(bits.get(), x, y) == transparent);
+          REQUIRE(TCOD_map_is_walkable(bits.get(), x, y) == walkable);
+        }
+      }
+    }
+  }
+}
+
+namespace {
+/// Saved chunks for the eviction test, keyed by chunk position.
+using ChunkStore = std::map<std::pair<int, int>, std::vector<bool>>;
+void save_chunk(TCOD_Map* chunk, int chunk_x, int chunk_y, void* userdata) {
+  auto& data = (*static_cast<ChunkStore*>(userdata))[{chunk_x, chunk_y}];
+  data.resize(TCOD_CHUNK_SIZE * TCOD_CHUNK_SIZE);
+  for (int i = 0; i < TCOD_CHUNK_SIZE * TCOD_CHUNK_SIZE; ++i) {
+    data.at(i) = TCOD_map_is_transparent(chunk, i % TCOD_CHUNK_SIZE, i / TCOD_CHUNK_SIZE);
+  }
+}
+void load_chunk(TCOD_Map* chunk, int chunk_x, int chunk_y, void* userdata) {
+  const auto& store = *static_cast<ChunkStore*>(userdata);
+  const auto it = store.find({chunk_x, chunk_y});
+  if (it == store.end()) return;
+  for (int i = 0; i < TCOD_CHUNK_SIZE * TCOD_CHUNK_SIZE; ++i) {
+    TCOD_map_set_properties(chunk, i % TCOD_CHUNK_SIZE, i / TCOD_CHUNK_SIZE, it->second.at(i), it->second.at(i));
+  }
+}
+}  // namespace
+
+TEST_CASE("Chunked map eviction", "[chunked_map]") {
+  ChunkStore store;
+  ChunkedMapPtr map{TCOD_chunked_map_new(true, true)};
+  TCOD_chunked_map_set_callbacks(map.get(), load_chunk, save_chunk, &store);
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> random_coord(-1000, 1000);
+  std::map<std::pair<int, int>, bool> expected;
+  for (int step = 0; step < 2000; ++step) {
+    const int x = random_coord(rng);
+    const int y = random_coord(rng);
+    const bool is_open = rng() % 2;
+    REQUIRE(TCOD_chunked_map_set_properties(map.get(), x, y, is_open, is_open) == TCOD_E_OK);
+    expected[{x, y}] = is_open;
+    if (step % 100 == 99) {
+      const int before = TCOD_chunked_map_get_chunk_count(map.get());
+      const int evicted = TCOD_chunked_map_evict_idle(map.get(), 50);
+      CHECK(evicted > 0);
+      CHECK(TCOD_chunked_map_get_chunk_count(map.get()) == before - evicted);
+      CHECK(TCOD_chunked_map_get_chunk_count(map.get()) <= 51);
+    }
+  }
+  for (const auto& it : expected) {
+    INFO("x=" << it.first.first << " y=" << it.first.second);
+    REQUIRE(TCOD_chunked_map_is_transparent(map.get(), it.first.first, it.first.second) == it.second);
+  }
+  REQUIRE(TCOD_chunked_map_evict_idle(map.get(), 0) == TCOD_chunked_map_get_chunk_count(map.get()) - 1);
+  REQUIRE(TCOD_chunked_map_get_chunk_count(map.get()) == 1);
+}
@@ -1,7 +1,10 @@
 
+#include <algorithm>
 #include <catch2/catch_all.hpp>
 #include <libtcod/console.hpp>
 #include <libtcod/console_printing.hpp>
+#include <random>
+#include <vector>
 
 #include "common.hpp"
 
@@ -27,6 +30,181 @@ TEST_CASE("Console bounds", "[!throws]") {
   auto console = tcod::Console{3, 2};
   REQUIRE_THROWS(console.at({1000, 1000}));
 }
+
+namespace {
+/// The per-tile blit from before row-major blits were added, used as a reference.
+uint8_t reference_alpha_blend(int src_c, int src_a, int dst_c, int dst_a, int out_a) {
+  return static_cast<uint8_t>(((src_c * src_a) + (dst_c * dst_a * (255 - src_a) / 255)) / out_a);
+}
+TCOD_ColorRGBA reference_lerp(const TCOD_ColorRGBA dst, const TCOD_ColorRGBA src, float interp) {
+  const auto out_a = static_cast<uint8_t>(src.a + dst.a * (255 - src.a) / 255);
+  if (out_a == 0) return dst;
+  const auto src_a = static_cast<uint8_t>(src.a * interp);
+  return {
+      reference_alpha_blend(src.r, src_a, dst.r, dst.a, out_a),
+      reference_alpha_blend(src.g, src_a, dst.g, dst.a, out_a),
+      reference_alpha_blend(src.b, src_a, dst.b, dst.a, out_a),
+      out_a,
+  };
+}
+TCOD_ConsoleTile reference_blit_cell(
+    const TCOD_ConsoleTile& src,
+    const TCOD_ConsoleTile& dst,
+    float fg_alpha,
+    float bg_alpha,
+    const TCOD_ColorRGB* key) {
+  if (key && key->r == src.bg.r && key->g == src.bg.g && key->b == src.bg.b) return dst;
+  fg_alpha *= src.fg.a / 255.0f;
+  bg_alpha *= src.bg.a / 255.0f;
+  if (fg_alpha > 254.5f / 255.0f && bg_alpha > 254.5f / 255.0f) return src;
+  TCOD_ConsoleTile out = dst;
+  out.bg = reference_lerp(out.bg, src.bg, bg_alpha);
+  if (src.ch == ' ') {
+    out.fg = reference_lerp(out.fg, src.bg, bg_alpha);
+  } else if (out.ch == ' ') {
+    out.ch = src.ch;
+    out.fg = reference_lerp(out.bg, src.fg, fg_alpha);
+  } else if (out.ch == src.ch) {
+    out.fg = reference_lerp(out.fg, src.fg, fg_alpha);
+  } else if (fg_alpha < 0.5f) {
+    out.fg = reference_lerp(out.fg, out.bg, fg_alpha * 2);
+  } else {
+    out.ch = src.ch;
+    out.fg = reference_lerp(out.bg, src.fg, (fg_alpha - 0.5f) * 2);
+  }
+  return out;
+}
+void reference_blit(
+    const TCOD_Console& src,
+    int src_x,
+    int src_y,
+    int width,
+    int height,
+    TCOD_Console& dst,
+    int dst_x,
+    int dst_y,
+    float fg_alpha,
+    float bg_alpha,
+    const TCOD_ColorRGB* key) {
+  for (int cy = src_y; cy < src_y + height; ++cy) {
+    for (int cx = src_x; cx < src_x + width; ++cx) {
+      const int dx = cx - src_x + dst_x;
+      const int dy = cy - src_y + dst_y;
+      if (!src.in_bounds({cx, cy}) || !dst.in_bounds({dx, dy})) continue;
+      dst.at(dx, dy) = reference_blit_cell(src.at(cx, cy), dst.at(dx, dy), fg_alpha, bg_alpha, key);
+    }
+  }
+}
+void fill_random_tiles(tcod::Console& console, std::mt19937& rng) {
+  const int glyphs[] = {' ', '@', '#'};
+  const uint8_t alphas[] = {0, 1, 64, 127, 128, 200, 254, 255, 255, 255, 255, 255};
+  auto channel = [&]() {  // Half of these are from a few values so that key colors will match.
+    return static_cast<uint8_t>(rng() % 2 ? rng() % 4 * 85 : rng() % 256);
+  };
+  for (auto& tile : console) {
+    tile.ch = glyphs[rng() % 3];
+    tile.fg = {channel(), channel(), channel(), alphas[rng() % std::size(alphas)]};
+    tile.bg = {channel(), channel(), channel(), alphas[rng() % std::size(alphas)]};
+  }
+}
+}  // namespace
+
+TEST_CASE("Console blit matches per-tile blending") {
+  std::mt19937 rng{42};
+  const float alphas[] = {0.0f, 0.25f, 0.5f, 0.75f, 0.999f, 1.0f, 1.0f, 1.5f};
+  const TCOD_ColorRGB key{85, 170, 0};
+  for (int i = 0; i < 500; ++i) {
+    auto src = tcod::Console{1 + static_cast<int>(rng() % 12), 1 + static_cast<int>(rng() % 8)};
+    auto dst = tcod::Console{1 + static_cast<int>(rng() % 12), 1 + static_cast<int>(rng() % 8)};
+    fill_random_tiles(src, rng);
+    fill_random_tiles(dst, rng);
+    auto expected = tcod::Console{dst.get_width(), dst.get_height()};
+    std::copy(dst.begin(), dst.end(), expected.begin());
+    const int src_x = static_cast<int>(rng() % 7) - 3;
+    const int src_y = static_cast<int>(rng() % 7) - 3;
+    const int width = static_cast<int>(rng() % 14);
+    const int height = static_cast<int>(rng() % 10);
+    const int dst_x = static_cast<int>(rng() % 15) - 7;
+    const int dst_y = static_cast<int>(rng() % 11) - 5;
+    const float fg_alpha = alphas[rng() % std::size(alphas)];
+    const float bg_alpha = alphas[rng() % std::size(alphas)];
+    const TCOD_ColorRGB* key_color = (rng() % 3 == 0) ? &key : nullptr;
+    INFO("iteration " << i);
+    reference_blit(
+        *src.get(),
+        src_x,
+        src_y,
+        width ? width : src.get_width(),
+        height ? height : src.get_height(),
+        *expected.get(),
+        dst_x,
+        dst_y,
+        fg_alpha,
+        bg_alpha,
+        key_color);
+    TCOD_console_blit_key_color(
+        src.get(), src_x, src_y, width, height, dst.get(), dst_x, dst_y, fg_alpha, bg_alpha, key_color);
+    REQUIRE(std::equal(dst.begin(), dst.end(), expected.begin()));
+  }
+}
+TEST_CASE("Console change tracking") {
+  auto console = tcod::Console{8, 4};
+  CHECK(TCOD_console_get_version(console.get(), 0, 0, 8, 4) == UINT64_MAX);
+  REQUIRE(TCOD_console_set_change_tracking(console.get(), true) == TCOD_E_OK);
+  const uint64_t start = TCOD_console_get_version(console.get(), 0, 0, 8, 4);
+  CHECK(start > 0);
+  CHECK(start != UINT64_MAX);
+  // Returns the rows which were changed since `version`.
+  const auto changed_rows = [&](uint64_t version) {
+    std::vector<int> rows;
+    for (int y = 0; y < console.get_height(); ++y) {
+      if (TCOD_console_get_version(console.get(), 0, y, 8, 1) > version) rows.emplace_back(y);
+    }
+    return rows;
+  };
+  CHECK(changed_rows(start).empty());
+
+  SECTION("Writes change only their rows") {
+    TCOD_console_put_rgb(console.get(), 1, 2, '@', nullptr, nullptr, TCOD_BKGND_SET);
+    CHECK(changed_rows(start) == std::vector<int>{2});
+    const uint64_t after_put = console.get()->version;
+    TCOD_console_put_char(console.get(), 7, 0, '#', TCOD_BKGND_NONE);
+    CHECK(changed_rows(after_put) == std::vector<int>{0});
+    const uint64_t after_char = console.get()->version;
+    TCOD_console_mark_changed(console.get(), -5, 3, 6, 10);
+    CHECK(changed_rows(after_char) == std::vector<int>{3});
+    const uint64_t after_mark = console.get()->version;
+    TCOD_console_mark_changed(console.get(), 8, 0, 1, 4);  // Out of bounds.
+    TCOD_console_put_rgb(console.get(), -1, 1, '@', nullptr, nullptr, TCOD_BKGND_SET);
+    CHECK(changed_rows(after_mark).empty());
+    TCOD_console_clear(console.get());
+    CHECK(changed_rows(after_mark) == std::vector<int>{0, 1, 2, 3});
+  }
+  SECTION("Blits change the clipped destination rows") {
+    auto source = tcod::Console{3, 3};
+    TCOD_console_blit(source.get(), 0, 0, 3, 3, console.get(), 2, 2, 1.0f, 1.0f);
+    CHECK(changed_rows(start) == std::vector<int>{2, 3});
+    CHECK(source.get()->row_versions == nullptr);
+  }
+  SECTION("Versions are never reused by another console") {
+    auto other = tcod::Console{8, 4};
+    REQUIRE(TCOD_console_set_change_tracking(other.get(), true) == TCOD_E_OK);
+    CHECK(other.get()->version > console.get()->version);
+    TCOD_console_put_rgb(console.get(), 0, 0, '@', nullptr, nullptr, TCOD_BKGND_SET);
+    CHECK(console.get()->version > other.get()->version);
+  }
+  SECTION("Tracking survives a resize") {
+    TCOD_console_resize_(console.get(), 5, 6);
+    REQUIRE(console.get()->row_versions != nullptr);
+    CHECK(TCOD_console_get_version(console.get(), 0, 5, 5, 1) > start);
+  }
+  SECTION("Disabling tracking") {
+    REQUIRE(TCOD_console_set_change_tracking(console.get(), false) == TCOD_E_OK);
+    CHECK(console.get()->row_versions == nullptr);
+    CHECK(TCOD_console_get_version(console.get(), 0, 0, 1, 1) == UINT64_MAX);
+    TCOD_console_put_rgb(console.get(), 0, 0, '@', nullptr, nullptr, TCOD_BKGND_SET);
+  }
+}
 #ifndef TCOD_NO_UNICODE
 TEST_CASE("TCODConsole conversion") {
   auto console = TCODConsole(3, 2);
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <libtcod/console_compositor.h>
+#include <libtcod/console_drawing.h>
+#include <libtcod/console_types.hpp>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+struct CompositorDeleter {
+  void operator()(TCOD_Compositor* compositor) const { TCOD_compositor_delete(compositor); }
+};
+using CompositorPtr = std::unique_ptr<TCOD_Compositor, CompositorDeleter>;
+
+struct TestLayer {
+  tcod::Console console;
+  int x;
+  int y;
+  float fg_alpha;
+  float bg_alpha;
+  std::optional<TCOD_ColorRGB> key_color;
+  bool visible;
+};
+
+/// Compose all layers from scratch by clearing the output and blitting every visible layer.
+tcod::Console reference_composite(
+    const std::vector<TestLayer>& layers,
+    int width,
+    int height,
+    TCOD_ColorRGB fore = {255, 255, 255},
+    TCOD_ColorRGB back = {0, 0, 0}) {
+  auto output = tcod::Console{width, height};
+  output.get()->fore = fore;
+  output.get()->back = back;
+  TCOD_console_clear(output.get());
+  for (const auto& layer : layers) {
+    if (!layer.visible) continue;
+    TCOD_console_blit_key_color(
+        layer.console.get(),
+        0,
+        0,
+        0,
+        0,
+        output.get(),
+        layer.x,
+        layer.y,
+        layer.fg_alpha,
+        layer.bg_alpha,
+        layer.key_color ? &*layer.key_color : nullptr);
+  }
+  return output;
+}
+
+void fill_random_tiles(tcod::Console& console, int x, int y, int width, int height, std::mt19937& rng) {
+  const uint8_t alphas[] = {0, 128, 255, 255};
+  for (int j = std::max(y, 0); j < std::min(y + height, console.get_height()); ++j) {
+    for (int i = std::max(x, 0); i < std::min(x + width, console.get_width()); ++i) {
+      auto& tile = console.at(i, j);
+      tile.ch = rng() % 2 ? ' ' : '#';
+      tile.fg = {static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), 0, alphas[rng() % 4]};
+      tile.bg = {static_cast<uint8_t>(rng() % 2 * 255), 0, 0, alphas[rng() % 4]};
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("Compositor matches a full composite") {
+  const int WIDTH = 40;
+  const int HEIGHT = 25;
+  std::mt19937 rng{0};
+  const TCOD_ColorRGB key{255, 0, 0};
+  auto compositor = CompositorPtr{TCOD_compositor_new()};
+  REQUIRE(compositor);
+  std::vector<TestLayer> layers;
+  layers.reserve(6);
+  for (int i = 0; i < 6; ++i) {
+    auto& layer = layers.emplace_back(TestLayer{
+        tcod::Console{5 + static_cast<int>(rng() % 30), 3 + static_cast<int>(rng() % 20)},
+        static_cast<int>(rng() % 50) - 10,
+        static_cast<int>(rng() % 30) - 5,
+        i == 0 ? 1.0f : 0.5f,
+        i == 0 ? 1.0f : 0.75f,
+        i % 2 ? std::optional<TCOD_ColorRGB>{key} : std::nullopt,
+        true});
+    fill_random_tiles(layer.console, 0, 0, layer.console.get_width(), layer.console.get_height(), rng);
+    REQUIRE(
+        TCOD_compositor_add_layer(
+            compositor.get(),
+            layer.console.get(),
+            layer.x,
+            layer.y,
+            layer.fg_alpha,
+            layer.bg_alpha,
+            layer.key_color ? &*layer.key_color : nullptr) == i);
+  }
+  auto output = tcod::Console{WIDTH, HEIGHT};
+  REQUIRE(TCOD_compositor_draw(compositor.get(), output.get()) == WIDTH * HEIGHT);
+  REQUIRE(std::equal(output.begin(), output.end(), reference_composite(layers, WIDTH, HEIGHT).begin()));
+
+  SECTION("A static frame redraws nothing") {
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) == 0);
+  }
+  SECTION("A small change redraws only its region") {
+    fill_random_tiles(layers.at(2).console, 1, 1, 2, 1, rng);
+    REQUIRE(TCOD_compositor_layer_changed(compositor.get(), 2, 1, 1, 2, 1) == TCOD_E_OK);
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) <= 2);
+    CHECK(std::equal(output.begin(), output.end(), reference_composite(layers, WIDTH, HEIGHT).begin()));
+  }
+  SECTION("Many changes to one layer are merged") {
+    auto& layer = layers.at(0);
+    for (int i = 0; i < 20; ++i) {
+      const int x = static_cast<int>(rng() % layer.console.get_width());
+      const int y = static_cast<int>(rng() % layer.console.get_height());
+      fill_random_tiles(layer.console, x, y, 1, 1, rng);
+      REQUIRE(TCOD_compositor_layer_changed(compositor.get(), 0, x, y, 1, 1) == TCOD_E_OK);
+    }
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) >= 0);
+    CHECK(std::equal(output.begin(), output.end(), reference_composite(layers, WIDTH, HEIGHT).begin()));
+  }
+  SECTION("Changes to consoles which track them are found automatically") {
+    auto& layer = layers.at(2);
+    REQUIRE(TCOD_console_set_change_tracking(layer.console.get(), true) == TCOD_E_OK);
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) >= 0);
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) == 0);
+    const TCOD_ColorRGB fg{1, 2, 3};
+    const TCOD_ColorRGB bg{4, 5, 6};
+    TCOD_console_put_rgb(layer.console.get(), 1, 1, '@', &fg, &bg, TCOD_BKGND_SET);
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) <= layer.console.get_width());
+    CHECK(std::equal(output.begin(), output.end(), reference_composite(layers, WIDTH, HEIGHT).begin()));
+  }
+  SECTION("Random changes") {
+    for (int step = 0; step < 200; ++step) {
+      const int layer_id = static_cast<int>(rng() % layers.size());
+      auto& layer = layers.at(layer_id);
+      switch (rng() % 8) {
+        case 0:  // Move the layer.
+          layer.x += static_cast<int>(rng() % 5) - 2;
+          layer.y += static_cast<int>(rng() % 5) - 2;
+          break;
+        case 1:
+          layer.fg_alpha = (rng() % 5) / 4.0f;
+          layer.bg_alpha = (rng() % 5) / 4.0f;
+          break;
+        case 2:
+          layer.key_color = rng() % 2 ? std::optional<TCOD_ColorRGB>{key} : std::nullopt;
+          break;
+        case 3:
+          layer.visible = !layer.visible;
+          REQUIRE(TCOD_compositor_set_layer_visible(compositor.get(), layer_id, layer.visible) == TCOD_E_OK);
+          break;
+        default: {  // Change some tiles, sometimes more regions than a layer keeps separately.
+          const int regions = 1 + static_cast<int>(rng() % 12);
+          for (int i = 0; i < regions; ++i) {
+            const int x = static_cast<int>(rng() % 40) - 5;
+            const int y = static_cast<int>(rng() % 25) - 5;
+            const int width = static_cast<int>(rng() % 8);
+            const int height = static_cast<int>(rng() % 4);
+            fill_random_tiles(
+                layer.console,
+                x,
+                y,
+                width ? width : layer.console.get_width(),
+                height ? height : layer.console.get_height(),
+                rng);
+            REQUIRE(TCOD_compositor_layer_changed(compositor.get(), layer_id, x, y, width, height) == TCOD_E_OK);
+          }
+          break;
+        }
+      }
+      REQUIRE(
+          TCOD_compositor_set_layer(
+              compositor.get(),
+              layer_id,
+              layer.x,
+              layer.y,
+              layer.fg_alpha,
+              layer.bg_alpha,
+              layer.key_color ? &*layer.key_color : nullptr) == TCOD_E_OK);
+      if (rng() % 3 == 0) continue;  // Let some changes accumulate over several steps.
+      INFO("step " << step);
+      REQUIRE(TCOD_compositor_draw(compositor.get(), output.get()) >= 0);
+      REQUIRE(std::equal(output.begin(), output.end(), reference_composite(layers, WIDTH, HEIGHT).begin()));
+    }
+  }
+  SECTION("Resizing the output redraws everything") {
+    auto bigger = tcod::Console{WIDTH + 10, HEIGHT + 5};
+    CHECK(TCOD_compositor_draw(compositor.get(), bigger.get()) == (WIDTH + 10) * (HEIGHT + 5));
+    CHECK(std::equal(bigger.begin(), bigger.end(), reference_composite(layers, WIDTH + 10, HEIGHT + 5).begin()));
+  }
+  SECTION("Regions are cleared to the default colors of the output") {
+    const TCOD_ColorRGB fore{10, 20, 30};
+    const TCOD_ColorRGB back{40, 50, 60};
+    output.get()->fore = fore;
+    output.get()->back = back;
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) == WIDTH * HEIGHT);
+    CHECK(std::equal(output.begin(), output.end(), reference_composite(layers, WIDTH, HEIGHT, fore, back).begin()));
+    CHECK(TCOD_compositor_draw(compositor.get(), output.get()) == 0);
+  }
+  SECTION("A layer can not be the output") {
+    const std::vector<TCOD_ConsoleTile> before(layers.at(1).console.begin(), layers.at(1).console.end());
+    CHECK(TCOD_compositor_draw(compositor.get(), layers.at(1).console.get()) == TCOD_E_INVALID_ARGUMENT);
+    CHECK(std::equal(before.begin(), before.end(), layers.at(1).console.begin()));
+  }
+  SECTION("Invalid layers") {
+    CHECK(TCOD_compositor_set_layer_visible(compositor.get(), 6, false) == TCOD_E_INVALID_ARGUMENT);
+    CHECK(TCOD_compositor_layer_changed(compositor.get(), -1, 0, 0, 0, 0) == TCOD_E_INVALID_ARGUMENT);
+    CHECK(TCOD_compositor_add_layer(compositor.get(), nullptr, 0, 0, 1, 1, nullptr) == TCOD_E_INVALID_ARGUMENT);
+  }
+}
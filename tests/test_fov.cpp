@@ -0,0 +1,429 @@
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <array>
+#include <libtcod/bresenham.h>
+#include <libtcod/console_init.h>
+#include <libtcod/fov.hpp>
+#include <libtcod/fov_tracker.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Every algorithm in TCOD_fov_algorithm_t.
+static const std::vector<TCOD_fov_algorithm_t> ALL_FOV_ALGORITHMS{
+    FOV_BASIC,
+    FOV_DIAMOND,
+    FOV_SHADOW,
+    FOV_PERMISSIVE_0,
+    FOV_PERMISSIVE_4,
+    FOV_PERMISSIVE_8,
+    FOV_RESTRICTIVE,
+    FOV_SYMMETRIC_SHADOWCAST,
+};
+
+/// Fill `map` with randomly placed walls using `seed`.
+static void fill_random_walls(TCOD_Map& map, unsigned int seed, int wall_chance = 4) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> chance(0, wall_chance - 1);
+  for (int y = 0; y < TCOD_map_get_height(&map); ++y) {
+    for (int x = 0; x < TCOD_map_get_width(&map); ++x) {
+      const bool is_open = chance(rng) != 0;
+      TCOD_map_set_properties(&map, x, y, is_open, is_open);
+    }
+  }
+}
+
+/// Convert the fov flags of `map` to a string for easy comparison.
+static std::string fov_to_string(const TCOD_Map& map) {
+  std::string result;
+  for (int y = 0; y < TCOD_map_get_height(&map); ++y) {
+    if (y != 0) result += '\n';
+    for (int x = 0; x < TCOD_map_get_width(&map); ++x) {
+      result += TCOD_map_is_in_fov(&map, x, y) ? '*' : '.';
+    }
+  }
+  return result;
+}
+
+TEST_CASE("Bit-packed map attributes", "[fov]") {
+  tcod::MapPtr_ map{TCOD_map_new_bitpacked(70, 3)};  // Wider than one 64-bit word.
+  REQUIRE(map);
+  REQUIRE(TCOD_map_is_bitpacked(map.get()));
+  REQUIRE(map->cells == nullptr);
+  REQUIRE(map->bits_stride == 2);
+  REQUIRE(TCOD_map_get_nb_cells(map.get()) == 70 * 3);
+  TCOD_map_clear(map.get(), true, false);
+  CHECK(TCOD_map_is_transparent(map.get(), 69, 2));
+  CHECK(!TCOD_map_is_walkable(map.get(), 69, 2));
+  CHECK(map->transparent_bits[1] == (uint64_t{1} << 6) - 1);  // Row padding stays zeroed.
+  TCOD_map_set_properties(map.get(), 65, 1, false, true);
+  CHECK(!TCOD_map_is_transparent(map.get(), 65, 1));
+  CHECK(TCOD_map_is_walkable(map.get(), 65, 1));
+  CHECK(TCOD_map_is_transparent(map.get(), 64, 1));
+  TCOD_map_set_in_fov(map.get(), 63, 0, true);
+  CHECK(TCOD_map_is_in_fov(map.get(), 63, 0));
+  CHECK(!TCOD_map_is_in_fov(map.get(), 64, 0));
+
+  tcod::MapPtr_ copy{TCOD_map_new(1, 1)};
+  REQUIRE(TCOD_map_copy(map.get(), copy.get()) == TCOD_E_OK);
+  CHECK(TCOD_map_is_bitpacked(copy.get()));
+  CHECK(fov_to_string(*copy) == fov_to_string(*map));
+  CHECK(!TCOD_map_is_transparent(copy.get(), 65, 1));
+  tcod::MapPtr_ unpacked{TCOD_map_new(2, 2)};
+  REQUIRE(TCOD_map_copy(unpacked.get(), copy.get()) == TCOD_E_OK);
+  CHECK(!TCOD_map_is_bitpacked(copy.get()));
+  CHECK(TCOD_map_get_width(copy.get()) == 2);
+}
+
+TEST_CASE("Bit-packed maps match the default layout", "[fov]") {
+  const int WIDTH = 75;
+  const int HEIGHT = 41;
+  tcod::MapPtr_ cell_map{TCOD_map_new(WIDTH, HEIGHT)};
+  tcod::MapPtr_ bit_map{TCOD_map_new_bitpacked(WIDTH, HEIGHT)};
+  fill_random_walls(*cell_map, 0);
+  fill_random_walls(*bit_map, 0);
+  for (const TCOD_fov_algorithm_t algorithm : ALL_FOV_ALGORITHMS) {
+    for (const int radius : {0, 5, 20}) {
+      for (const bool light_walls : {false, true}) {
+        for (const auto& pov : {std::array<int, 2>{0, 0}, {37, 20}, {70, 40}}) {
+          INFO("algorithm=" << algorithm << " radius=" << radius << " light_walls=" << light_walls);
+          INFO("pov=" << pov[0] << "," << pov[1]);
+          REQUIRE(TCOD_map_compute_fov(cell_map.get(), pov[0], pov[1], radius, light_walls, algorithm) == TCOD_E_OK);
+          REQUIRE(TCOD_map_compute_fov(bit_map.get(), pov[0], pov[1], radius, light_walls, algorithm) == TCOD_E_OK);
+          REQUIRE(fov_to_string(*cell_map) == fov_to_string(*bit_map));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Batched FOV matches sequential FOV", "[fov]") {
+  const int WIDTH = 70;
+  const int HEIGHT = 30;
+  const int STRIDE = (WIDTH + 63) / 64;
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_walls(*map, 1);
+  std::vector<TCOD_FovOrigin> origins;
+  for (int i = 0; i < 24; ++i) origins.push_back({(i * 37) % WIDTH, (i * 11) % HEIGHT, i % 3 * 6});
+  for (const TCOD_fov_algorithm_t algorithm : ALL_FOV_ALGORITHMS) {
+    INFO("algorithm=" << algorithm);
+    std::vector<uint64_t> bits(origins.size() * HEIGHT * STRIDE);
+    std::vector<int> counts(WIDTH * HEIGHT);
+    REQUIRE(
+        TCOD_map_compute_fov_batch(
+            map.get(), static_cast<int>(origins.size()), origins.data(), true, algorithm, bits.data(), counts.data()) ==
+        TCOD_E_OK);
+    std::vector<int> expected_counts(WIDTH * HEIGHT);
+    tcod::MapPtr_ sequential{TCOD_map_new(1, 1)};
+    REQUIRE(TCOD_map_copy(map.get(), sequential.get()) == TCOD_E_OK);
+    for (size_t i = 0; i < origins.size(); ++i) {
+      REQUIRE(
+          TCOD_map_compute_fov(
+              sequential.get(), origins[i].x, origins[i].y, origins[i].max_radius, true, algorithm) == TCOD_E_OK);
+      for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+          const bool in_fov = TCOD_map_is_in_fov(sequential.get(), x, y);
+          const uint64_t word = bits[(i * HEIGHT + y) * STRIDE + x / 64];
+          INFO("origin=" << i << " x=" << x << " y=" << y);
+          REQUIRE(((word >> (x % 64)) & 1) == in_fov);
+          expected_counts[x + y * WIDTH] += in_fov;
+        }
+      }
+    }
+    CHECK(counts == expected_counts);
+    // Only counting should give the same result.
+    std::vector<int> counts_only(WIDTH * HEIGHT, -1);
+    REQUIRE(
+        TCOD_map_compute_fov_batch(
+            map.get(), static_cast<int>(origins.size()), origins.data(), true, algorithm, nullptr,
+            counts_only.data()) == TCOD_E_OK);
+    CHECK(counts_only == expected_counts);
+  }
+  CHECK(!TCOD_map_is_in_fov(map.get(), origins[0].x, origins[0].y));  // The source map is left untouched.
+  const TCOD_FovOrigin bad_origin{WIDTH, 0, 0};
+  CHECK(TCOD_map_compute_fov_batch(map.get(), 1, &bad_origin, true, FOV_BASIC, nullptr, nullptr) < 0);
+}
+
+TEST_CASE("FOV into caller buffers from multiple threads", "[fov]") {
+  const int WIDTH = 50;
+  const int HEIGHT = 40;
+  tcod::MapPtr_ map{TCOD_map_new_bitpacked(WIDTH, HEIGHT)};
+  fill_random_walls(*map, 2);
+  const std::array<int, 2> POVS[]{{5, 5}, {25, 20}, {49, 39}, {0, 39}};
+  for (const TCOD_fov_algorithm_t algorithm : ALL_FOV_ALGORITHMS) {
+    INFO("algorithm=" << algorithm);
+    std::vector<std::vector<bool>> expected;
+    tcod::MapPtr_ sequential{TCOD_map_new(1, 1)};
+    REQUIRE(TCOD_map_copy(map.get(), sequential.get()) == TCOD_E_OK);
+    for (const auto& pov : POVS) {
+      REQUIRE(TCOD_map_compute_fov(sequential.get(), pov[0], pov[1], 10, true, algorithm) == TCOD_E_OK);
+      expected.emplace_back();
+      for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+        expected.back().push_back(TCOD_map_is_in_fov(sequential.get(), i % WIDTH, i / WIDTH));
+      }
+    }
+    std::vector<std::unique_ptr<bool[]>> buffers;
+    std::vector<TCOD_Error> results(std::size(POVS));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < std::size(POVS); ++i) {
+      buffers.emplace_back(new bool[WIDTH * HEIGHT]);
+      std::fill_n(buffers[i].get(), WIDTH * HEIGHT, true);  // Must be overwritten.
+      threads.emplace_back([&, i]() {
+        results[i] = TCOD_map_compute_fov_to_buffer(
+            map.get(), POVS[i][0], POVS[i][1], 10, true, algorithm, buffers[i].get());
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    for (size_t i = 0; i < std::size(POVS); ++i) {
+      REQUIRE(results[i] == TCOD_E_OK);
+      CHECK(std::vector<bool>(buffers[i].get(), buffers[i].get() + WIDTH * HEIGHT) == expected[i]);
+    }
+  }
+  for (int i = 0; i < WIDTH * HEIGHT; ++i) REQUIRE(!TCOD_map_is_in_fov(map.get(), i % WIDTH, i / WIDTH));
+}
+
+TEST_CASE("FOV bounds tracking", "[fov]") {
+  const int WIDTH = 100;
+  const int HEIGHT = 90;
+  for (const bool bitpacked : {false, true}) {
+    INFO("bitpacked=" << bitpacked);
+    tcod::MapPtr_ map{bitpacked ? TCOD_map_new_bitpacked(WIDTH, HEIGHT) : TCOD_map_new(WIDTH, HEIGHT)};
+    tcod::MapPtr_ fresh{bitpacked ? TCOD_map_new_bitpacked(WIDTH, HEIGHT) : TCOD_map_new(WIDTH, HEIGHT)};
+    fill_random_walls(*map, 3);
+    fill_random_walls(*fresh, 3);
+    int x, y, width, height;
+    REQUIRE(TCOD_map_get_fov_bounds(map.get(), &x, &y, &width, &height) == TCOD_E_OK);
+    CHECK(std::array<int, 4>{x, y, width, height} == std::array<int, 4>{0, 0, 0, 0});
+    for (const TCOD_fov_algorithm_t algorithm : ALL_FOV_ALGORITHMS) {
+      for (const auto& pov : {std::array<int, 2>{50, 45}, {2, 3}, {97, 88}, {60, 10}}) {
+        INFO("algorithm=" << algorithm << " pov=" << pov[0] << "," << pov[1]);
+        const int radius = 8;
+        REQUIRE(TCOD_map_compute_fov(map.get(), pov[0], pov[1], radius, true, algorithm) == TCOD_E_OK);
+        // Computing on a fresh copy ensures nothing stale was left behind by the bounded clear.
+        TCOD_map_clear(fresh.get(), true, true);
+        fill_random_walls(*fresh, 3);
+        REQUIRE(TCOD_map_compute_fov(fresh.get(), pov[0], pov[1], radius, true, algorithm) == TCOD_E_OK);
+        REQUIRE(fov_to_string(*map) == fov_to_string(*fresh));
+        REQUIRE(TCOD_map_get_fov_bounds(map.get(), &x, &y, &width, &height) == TCOD_E_OK);
+        CHECK(x >= pov[0] - radius);
+        CHECK(y >= pov[1] - radius);
+        CHECK(x + width <= pov[0] + radius + 1);
+        CHECK(y + height <= pov[1] + radius + 1);
+        for (int cy = 0; cy < HEIGHT; ++cy) {
+          for (int cx = 0; cx < WIDTH; ++cx) {
+            if (cx < x || cy < y || cx >= x + width || cy >= y + height) {
+              REQUIRE(!TCOD_map_is_in_fov(map.get(), cx, cy));
+            }
+          }
+        }
+      }
+    }
+    TCOD_map_set_in_fov(map.get(), 0, 0, true);
+    REQUIRE(TCOD_map_get_fov_bounds(map.get(), &x, &y, &width, &height) == TCOD_E_OK);
+    CHECK(x == 0);
+    CHECK(y == 0);
+    REQUIRE(TCOD_map_compute_fov(map.get(), 50, 45, 3, true, FOV_SHADOW) == TCOD_E_OK);
+    CHECK(!TCOD_map_is_in_fov(map.get(), 0, 0));
+    TCOD_map_clear(map.get(), true, true);
+    REQUIRE(TCOD_map_get_fov_bounds(map.get(), &x, &y, &width, &height) == TCOD_E_OK);
+    CHECK(width == 0);
+    // Flags written directly are outside of the tracked bounds until the bounds are invalidated.
+    if (bitpacked) {
+      map->fov_bits[1] = 1;
+    } else {
+      map->cells[WIDTH * 2 + 70].fov = true;
+    }
+    TCOD_map_invalidate_fov_bounds(map.get());
+    REQUIRE(TCOD_map_get_fov_bounds(map.get(), &x, &y, &width, &height) == TCOD_E_OK);
+    CHECK(std::array<int, 4>{x, y, width, height} == std::array<int, 4>{0, 0, WIDTH, HEIGHT});
+    REQUIRE(TCOD_map_compute_fov(map.get(), 10, 80, 3, true, FOV_SHADOW) == TCOD_E_OK);
+    CHECK(!TCOD_map_is_in_fov(map.get(), 64, 0));
+    CHECK(!TCOD_map_is_in_fov(map.get(), 70, 2));
+  }
+}
+
+TEST_CASE("Incremental FOV tracker", "[fov]") {
+  const int WIDTH = 60;
+  const int HEIGHT = 50;
+  for (const TCOD_fov_algorithm_t algorithm : ALL_FOV_ALGORITHMS) {
+    INFO("algorithm=" << algorithm);
+    tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+    fill_random_walls(*map, 4);
+    std::unique_ptr<TCOD_FovTracker, decltype(&TCOD_fov_tracker_delete)> tracker{
+        TCOD_fov_tracker_new(map.get(), true, algorithm), &TCOD_fov_tracker_delete};
+    REQUIRE(tracker);
+    const std::array<int, 3> VIEWERS[]{{10, 10, 8}, {30, 25, 12}, {59, 49, 6}, {45, 5, 0}};
+    std::vector<int> ids;
+    for (const auto& viewer : VIEWERS) {
+      ids.push_back(TCOD_fov_tracker_add_viewer(tracker.get(), viewer[0], viewer[1], viewer[2]));
+      REQUIRE(ids.back() >= 0);
+    }
+    tcod::MapPtr_ reference{TCOD_map_new(1, 1)};
+    const auto check_viewers = [&]() {
+      REQUIRE(TCOD_map_copy(map.get(), reference.get()) == TCOD_E_OK);
+      for (size_t i = 0; i < ids.size(); ++i) {
+        INFO("viewer=" << i);
+        REQUIRE(
+            TCOD_map_compute_fov(reference.get(), VIEWERS[i][0], VIEWERS[i][1], VIEWERS[i][2], true, algorithm) ==
+            TCOD_E_OK);
+        for (int y = 0; y < HEIGHT; ++y) {
+          for (int x = 0; x < WIDTH; ++x) {
+            INFO("x=" << x << " y=" << y);
+            REQUIRE(
+                TCOD_fov_tracker_is_in_fov(tracker.get(), ids[i], x, y) == TCOD_map_is_in_fov(reference.get(), x, y));
+          }
+        }
+      }
+    };
+    REQUIRE(TCOD_fov_tracker_update(tracker.get()) > 0);
+    check_viewers();
+    REQUIRE(TCOD_fov_tracker_update(tracker.get()) == 0);  // Nothing has changed.
+    std::mt19937 rng(5);
+    for (int step = 0; step < 40; ++step) {
+      const int x = std::uniform_int_distribution<int>(0, WIDTH - 1)(rng);
+      const int y = std::uniform_int_distribution<int>(0, HEIGHT - 1)(rng);
+      const bool transparent = !TCOD_map_is_transparent(map.get(), x, y);
+      TCOD_map_set_properties(map.get(), x, y, transparent, transparent);
+      REQUIRE(TCOD_fov_tracker_cell_changed(tracker.get(), x, y) == TCOD_E_OK);
+      REQUIRE(TCOD_fov_tracker_update(tracker.get()) >= 0);
+      check_viewers();
+    }
+  }
+}
+
+TEST_CASE("Incremental FOV only recomputes affected octants", "[fov]") {
+  tcod::MapPtr_ map{TCOD_map_new(40, 40)};
+  TCOD_map_clear(map.get(), true, true);
+  std::unique_ptr<TCOD_FovTracker, decltype(&TCOD_fov_tracker_delete)> tracker{
+      TCOD_fov_tracker_new(map.get(), true, FOV_SHADOW), &TCOD_fov_tracker_delete};
+  const int viewer = TCOD_fov_tracker_add_viewer(tracker.get(), 20, 20, 10);
+  REQUIRE(TCOD_fov_tracker_update(tracker.get()) == 8);
+  CHECK(TCOD_fov_tracker_is_in_fov(tracker.get(), viewer, 25, 22));
+  // Outside of the viewers radius.
+  TCOD_map_set_properties(map.get(), 0, 0, false, false);
+  REQUIRE(TCOD_fov_tracker_cell_changed(tracker.get(), 0, 0) == TCOD_E_OK);
+  CHECK(TCOD_fov_tracker_update(tracker.get()) == 0);
+  // A wall in the middle of one octant.
+  TCOD_map_set_properties(map.get(), 24, 21, false, false);
+  REQUIRE(TCOD_fov_tracker_cell_changed(tracker.get(), 24, 21) == TCOD_E_OK);
+  CHECK(TCOD_fov_tracker_update(tracker.get()) == 1);
+  CHECK(!TCOD_fov_tracker_is_in_fov(tracker.get(), viewer, 28, 22));
+  REQUIRE(TCOD_fov_tracker_remove_viewer(tracker.get(), viewer) == TCOD_E_OK);
+  CHECK(!TCOD_fov_tracker_is_in_fov(tracker.get(), viewer, 20, 20));
+  CHECK(TCOD_fov_tracker_add_viewer(tracker.get(), 5, 5, 3) == viewer);  // Ids are reused.
+}
+
+TEST_CASE("FOV_SHADOW_TABLE matches Bresenham line-of-sight", "[fov]") {
+  const int WIDTH = 50;
+  const int HEIGHT = 45;
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_walls(*map, 6, 5);
+  for (const int radius : {1, 2, 7, 13, FOV_SHADOW_TABLE_MAX_RADIUS}) {
+    for (const bool light_walls : {false, true}) {
+      for (const auto& pov : {std::array<int, 2>{25, 22}, {0, 0}, {49, 3}, {10, 44}}) {
+        INFO("radius=" << radius << " light_walls=" << light_walls << " pov=" << pov[0] << "," << pov[1]);
+        REQUIRE(TCOD_map_compute_fov(map.get(), pov[0], pov[1], radius, light_walls, FOV_SHADOW_TABLE) == TCOD_E_OK);
+        for (int y = 0; y < HEIGHT; ++y) {
+          for (int x = 0; x < WIDTH; ++x) {
+            const int dx = x - pov[0];
+            const int dy = y - pov[1];
+            bool expected = dx * dx + dy * dy <= radius * radius &&
+                            (light_walls || TCOD_map_is_transparent(map.get(), x, y) || (dx == 0 && dy == 0));
+            if (expected && !(dx == 0 && dy == 0)) {
+              TCOD_bresenham_data_t line;
+              TCOD_line_init_mt(pov[0], pov[1], x, y, &line);
+              int line_x;
+              int line_y;
+              while (!TCOD_line_step_mt(&line_x, &line_y, &line) && (line_x != x || line_y != y)) {
+                if (!TCOD_map_is_transparent(map.get(), line_x, line_y)) expected = false;
+              }
+            }
+            INFO("x=" << x << " y=" << y);
+            REQUIRE(TCOD_map_is_in_fov(map.get(), x, y) == expected);
+          }
+        }
+      }
+    }
+  }
+  CHECK(TCOD_map_compute_fov(map.get(), 0, 0, 0, true, FOV_SHADOW_TABLE) == TCOD_E_INVALID_ARGUMENT);
+  CHECK(
+      TCOD_map_compute_fov(map.get(), 0, 0, FOV_SHADOW_TABLE_MAX_RADIUS + 1, true, FOV_SHADOW_TABLE) ==
+      TCOD_E_INVALID_ARGUMENT);
+  TCOD_quit();  // Frees the shadow tables, they are rebuilt when used again.
+  REQUIRE(TCOD_map_compute_fov(map.get(), 25, 22, 7, false, FOV_SHADOW_TABLE) == TCOD_E_OK);
+  CHECK(TCOD_map_is_in_fov(map.get(), 25, 22));
+}
+
+TEST_CASE("FOV_BASIC matches per-ray Bresenham casting", "[fov]") {
+  const int WIDTH = 37;  // Not a multiple of the ray batch size.
+  const int HEIGHT = 29;
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_walls(*map, 7, 6);
+  for (const int radius : {0, 1, 5, 12}) {
+    for (const auto& pov : {std::array<int, 2>{18, 14}, {0, 0}, {36, 28}, {3, 20}}) {
+      for (const bool light_walls : {false, true}) {
+        INFO("radius=" << radius << " pov=" << pov[0] << "," << pov[1] << " light_walls=" << light_walls);
+        // Trace one ray to each tile on the perimeter of the radius box, the same as the original scalar version.
+        const int x_min = radius > 0 ? std::max(0, pov[0] - radius) : 0;
+        const int y_min = radius > 0 ? std::max(0, pov[1] - radius) : 0;
+        const int x_max = radius > 0 ? std::min(WIDTH, pov[0] + radius + 1) : WIDTH;
+        const int y_max = radius > 0 ? std::min(HEIGHT, pov[1] + radius + 1) : HEIGHT;
+        std::vector<bool> expected(WIDTH * HEIGHT);
+        expected.at(pov[0] + pov[1] * WIDTH) = true;
+        const auto cast_ray = [&](int x_dest, int y_dest) {
+          TCOD_bresenham_data_t line;
+          TCOD_line_init_mt(pov[0], pov[1], x_dest, y_dest, &line);
+          int x;
+          int y;
+          while (!TCOD_line_step_mt(&x, &y, &line)) {
+            if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+            if (radius > 0 && (x - pov[0]) * (x - pov[0]) + (y - pov[1]) * (y - pov[1]) > radius * radius) return;
+            if (!TCOD_map_is_transparent(map.get(), x, y)) {
+              if (light_walls) expected.at(x + y * WIDTH) = true;
+              return;
+            }
+            expected.at(x + y * WIDTH) = true;
+          }
+        };
+        for (int x = x_min; x < x_max; ++x) {
+          cast_ray(x, y_min);
+          cast_ray(x, y_max - 1);
+        }
+        for (int y = y_min; y < y_max; ++y) {
+          cast_ray(x_min, y);
+          cast_ray(x_max - 1, y);
+        }
+        if (light_walls) {
+          // Light the walls next to visible floors, facing away from the point of view in each quadrant.
+          const auto light_quadrant = [&](int x0, int y0, int x1, int y1, int dx, int dy) {
+            for (int x = x0; x <= x1; ++x) {
+              for (int y = y0; y <= y1; ++y) {
+                if (!expected.at(x + y * WIDTH) || !TCOD_map_is_transparent(map.get(), x, y)) continue;
+                const auto light = [&](int wall_x, int wall_y) {
+                  if (wall_x < x0 || wall_x > x1 || wall_y < y0 || wall_y > y1) return;
+                  if (!TCOD_map_is_transparent(map.get(), wall_x, wall_y)) expected.at(wall_x + wall_y * WIDTH) = true;
+                };
+                light(x + dx, y);
+                light(x, y + dy);
+                light(x + dx, y + dy);
+              }
+            }
+          };
+          light_quadrant(x_min, y_min, pov[0], pov[1], -1, -1);
+          light_quadrant(pov[0], y_min, x_max - 1, pov[1], 1, -1);
+          light_quadrant(x_min, pov[1], pov[0], y_max - 1, -1, 1);
+          light_quadrant(pov[0], pov[1], x_max - 1, y_max - 1, 1, 1);
+        }
+        REQUIRE(TCOD_map_compute_fov(map.get(), pov[0], pov[1], radius, light_walls, FOV_BASIC) == TCOD_E_OK);
+        for (int y = 0; y < HEIGHT; ++y) {
+          for (int x = 0; x < WIDTH; ++x) {
+            INFO("x=" << x << " y=" << y);
+            REQUIRE(TCOD_map_is_in_fov(map.get(), x, y) == expected.at(x + y * WIDTH));
+          }
+        }
+      }
+    }
+  }
+}
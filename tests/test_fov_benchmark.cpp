@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdio>
+#include <libtcod/fov.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_allocations.hpp"
+#include "benchmark_maps.hpp"
+
+/*
+    Field-of-view benchmarks.
+
+    These are hidden by the [.benchmark] tag, run them with: benchmark "[.benchmark][fov]"
+    They can also be run from unittest, but heap allocations are only counted by the benchmark executable.
+
+    "FOV algorithm benchmarks" uses Catch2 BENCHMARK for tracking regressions.
+    "FOV algorithm report" prints a table of cells/sec and heap allocations per call to help choose an algorithm.
+*/
+
+namespace {
+/// Every algorithm in TCOD_fov_algorithm_t along with its name.
+const std::vector<std::pair<TCOD_fov_algorithm_t, std::string>> BENCHMARK_ALGORITHMS{
+    {FOV_BASIC, "FOV_BASIC"},
+    {FOV_DIAMOND, "FOV_DIAMOND"},
+    {FOV_SHADOW, "FOV_SHADOW"},
+    {FOV_PERMISSIVE_0, "FOV_PERMISSIVE_0"},
+    {FOV_PERMISSIVE_2, "FOV_PERMISSIVE_2"},
+    {FOV_PERMISSIVE_4, "FOV_PERMISSIVE_4"},
+    {FOV_PERMISSIVE_8, "FOV_PERMISSIVE_8"},
+    {FOV_RESTRICTIVE, "FOV_RESTRICTIVE"},
+    {FOV_SYMMETRIC_SHADOWCAST, "FOV_SYMMETRIC_SHADOWCAST"},
+    {FOV_SHADOW_TABLE, "FOV_SHADOW_TABLE"},
+};
+/// Radii to test, zero is unlimited.
+const std::vector<int> BENCHMARK_RADII{4, 10, 20, 0};
+
+/// Return true if `algorithm` supports `radius`.
+bool algorithm_supports_radius(TCOD_fov_algorithm_t algorithm, int radius) {
+  if (algorithm == FOV_SHADOW_TABLE) return radius > 0 && radius <= FOV_SHADOW_TABLE_MAX_RADIUS;
+  return true;
+}
+
+/// A named test map with the points of view which will be checked on it.
+struct BenchmarkMap {
+  std::string name;
+  tcod::MapPtr_ map;
+  std::vector<std::pair<int, int>> povs;
+};
+
+/// Return a sample of open cells spread over `map`.
+std::vector<std::pair<int, int>> pick_povs(const TCOD_Map& map) {
+  std::vector<std::pair<int, int>> open;
+  for (int y = 0; y < TCOD_map_get_height(&map); ++y) {
+    for (int x = 0; x < TCOD_map_get_width(&map); ++x) {
+      if (TCOD_map_is_transparent(&map, x, y)) open.emplace_back(x, y);
+    }
+  }
+  std::mt19937 rng(0);
+  shuffle_items(open, rng);
+  open.resize(std::min<size_t>(open.size(), 64));
+  return open;
+}
+
+/// Return every benchmark map.
+std::vector<BenchmarkMap> new_benchmark_maps() {
+  std::vector<BenchmarkMap> maps;
+  for (const auto& size : {std::pair<int, int>{80, 50}, {256, 256}}) {
+    const std::string suffix = " " + std::to_string(size.first) + "x" + std::to_string(size.second);
+    maps.push_back({"open" + suffix, new_open_map(size.first, size.second), {}});
+    maps.push_back({"bsp" + suffix, new_bsp_map(size.first, size.second), {}});
+    maps.push_back({"cave" + suffix, new_cave_map(size.first, size.second), {}});
+  }
+  for (auto& it : maps) it.povs = pick_povs(*it.map);
+  return maps;
+}
+
+/// Return the number of cells within `radius` of `pov` on `map`, this is the work done per call.
+long cells_in_radius(const TCOD_Map& map, std::pair<int, int> pov, int radius) {
+  const int width = TCOD_map_get_width(&map);
+  const int height = TCOD_map_get_height(&map);
+  if (radius <= 0) return static_cast<long>(width) * height;
+  const long clipped_width = std::min(width, pov.first + radius + 1) - std::max(0, pov.first - radius);
+  const long clipped_height = std::min(height, pov.second + radius + 1) - std::max(0, pov.second - radius);
+  return clipped_width * clipped_height;
+}
+}  // namespace
+
+TEST_CASE("FOV algorithm benchmarks", "[.benchmark][fov]") {
+  auto maps = new_benchmark_maps();
+  for (auto& test_map : maps) {
+    TCOD_Map* map = test_map.map.get();
+    const auto& povs = test_map.povs;
+    for (const int radius : BENCHMARK_RADII) {
+      for (const auto& algorithm : BENCHMARK_ALGORITHMS) {
+        if (!algorithm_supports_radius(algorithm.first, radius)) continue;
+        size_t i = 0;
+        BENCHMARK(test_map.name + " r" + std::to_string(radius) + " " + algorithm.second) {
+          const auto& pov = povs[i++ % povs.size()];
+          return TCOD_map_compute_fov(map, pov.first, pov.second, radius, true, algorithm.first);
+        };
+      }
+    }
+  }
+}
+
+TEST_CASE("FOV algorithm report", "[.benchmark][fov]") {
+  using Clock = std::chrono::steady_clock;
+  const auto MIN_DURATION = std::chrono::milliseconds(100);
+  auto maps = new_benchmark_maps();
+  std::printf("%-14s %6s %-26s %14s %12s\n", "map", "radius", "algorithm", "cells/sec", "allocs/call");
+  for (auto& test_map : maps) {
+    TCOD_Map* map = test_map.map.get();
+    const auto& povs = test_map.povs;
+    for (const int radius : BENCHMARK_RADII) {
+      for (const auto& algorithm : BENCHMARK_ALGORITHMS) {
+        if (!algorithm_supports_radius(algorithm.first, radius)) continue;
+        (void)!TCOD_map_compute_fov(map, povs[0].first, povs[0].second, radius, true, algorithm.first);  // Warm up.
+        long calls = 0;
+        long cells = 0;
+        const long allocations_start = get_allocation_count();
+        const auto time_start = Clock::now();
+        auto elapsed = Clock::duration{};
+        while (elapsed < MIN_DURATION) {
+          for (const auto& pov : povs) {
+            REQUIRE(TCOD_map_compute_fov(map, pov.first, pov.second, radius, true, algorithm.first) == TCOD_E_OK);
+            cells += cells_in_radius(*map, pov, radius);
+          }
+          calls += static_cast<long>(povs.size());
+          elapsed = Clock::now() - time_start;
+        }
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const std::string radius_str = radius ? std::to_string(radius) : "inf";
+        if (allocations_start >= 0) {
+          const double allocations = static_cast<double>(get_allocation_count() - allocations_start) / calls;
+          std::printf(
+              "%-14s %6s %-26s %14.4g %12.2f\n",
+              test_map.name.c_str(),
+              radius_str.c_str(),
+              algorithm.second.c_str(),
+              cells / seconds,
+              allocations);
+        } else {
+          std::printf(
+              "%-14s %6s %-26s %14.4g %12s\n",
+              test_map.name.c_str(),
+              radius_str.c_str(),
+              algorithm.second.c_str(),
+              cells / seconds,
+              "n/a");
+        }
+      }
+    }
+  }
+}
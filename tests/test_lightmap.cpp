@@ -0,0 +1,164 @@
+#include <catch2/catch_all.hpp>
+#include <libtcod/fov.hpp>
+#include <libtcod/lightmap.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+struct LightmapDeleter {
+  void operator()(TCOD_Lightmap* lightmap) const { TCOD_lightmap_delete(lightmap); }
+};
+using LightmapPtr = std::unique_ptr<TCOD_Lightmap, LightmapDeleter>;
+
+struct TestLight {
+  bool active;
+  int x;
+  int y;
+  int radius;
+  TCOD_ColorRGB color;
+  float falloff;
+};
+
+/// Compute the light grid from scratch by calling TCOD_map_compute_fov once per light.
+std::vector<float> reference_lightmap(TCOD_Map& map, const std::vector<TestLight>& lights, TCOD_fov_algorithm_t algo) {
+  const int width = TCOD_map_get_width(&map);
+  const int height = TCOD_map_get_height(&map);
+  std::vector<float> rgb(width * height * 3);
+  for (const auto& light : lights) {
+    if (!light.active) continue;
+    REQUIRE(TCOD_map_compute_fov(&map, light.x, light.y, light.radius, true, algo) == TCOD_E_OK);
+    const float offset = 1.0f / (1.0f + static_cast<float>(light.radius * light.radius) / light.falloff);
+    const float factor = 1.0f / (1.0f - offset);
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        if (!TCOD_map_is_in_fov(&map, x, y)) continue;
+        const int distance_squared = (x - light.x) * (x - light.x) + (y - light.y) * (y - light.y);
+        const float coef = (1.0f / (1.0f + static_cast<float>(distance_squared) / light.falloff) - offset) * factor;
+        if (coef <= 0) continue;
+        rgb.at((x + y * width) * 3 + 0) += light.color.r * coef;
+        rgb.at((x + y * width) * 3 + 1) += light.color.g * coef;
+        rgb.at((x + y * width) * 3 + 2) += light.color.b * coef;
+      }
+    }
+  }
+  return rgb;
+}
+}  // namespace
+
+TEST_CASE("Lightmap matches per-light FOV", "[fov]") {
+  const int WIDTH = 60;
+  const int HEIGHT = 40;
+  const auto algo = GENERATE(FOV_SHADOW, FOV_SYMMETRIC_SHADOWCAST, FOV_PERMISSIVE_2);
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  std::mt19937 rng(algo);
+  std::uniform_int_distribution<int> random_x(0, WIDTH - 1);
+  std::uniform_int_distribution<int> random_y(0, HEIGHT - 1);
+  std::uniform_int_distribution<int> random_byte(0, 255);
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      const bool is_open = rng() % 5 != 0;
+      TCOD_map_set_properties(map.get(), x, y, is_open, is_open);
+    }
+  }
+  const auto random_color = [&]() {
+    return TCOD_ColorRGB{
+        static_cast<uint8_t>(random_byte(rng)),
+        static_cast<uint8_t>(random_byte(rng)),
+        static_cast<uint8_t>(random_byte(rng))};
+  };
+  LightmapPtr lightmap{TCOD_lightmap_new(map.get(), true, algo)};
+  REQUIRE(lightmap);
+  std::vector<TestLight> lights;
+  for (int i = 0; i < 12; ++i) {
+    const TestLight light{true, random_x(rng), random_y(rng), 2 + static_cast<int>(rng() % 10), random_color(), 20.0f};
+    REQUIRE(TCOD_lightmap_add_light(lightmap.get(), light.x, light.y, light.radius, light.color, light.falloff) == i);
+    lights.push_back(light);
+  }
+  REQUIRE(TCOD_lightmap_update(lightmap.get()) == 12);
+  for (int step = 0; step < 40; ++step) {
+    const int id = static_cast<int>(rng() % lights.size());
+    TestLight& light = lights.at(id);
+    switch (rng() % 5) {
+      case 0:  // Move.
+        if (!light.active) break;
+        light.x = random_x(rng);
+        light.y = random_y(rng);
+        REQUIRE(
+            TCOD_lightmap_set_light(lightmap.get(), id, light.x, light.y, light.radius, light.color, light.falloff) ==
+            TCOD_E_OK);
+        break;
+      case 1:  // Change color only.
+        if (!light.active) break;
+        light.color = random_color();
+        light.falloff = 5.0f + static_cast<float>(rng() % 30);
+        REQUIRE(
+            TCOD_lightmap_set_light(lightmap.get(), id, light.x, light.y, light.radius, light.color, light.falloff) ==
+            TCOD_E_OK);
+        REQUIRE(TCOD_lightmap_update(lightmap.get()) == 0);  // FOV is reused.
+        break;
+      case 2:  // Remove or re-add.
+        if (light.active) {
+          REQUIRE(TCOD_lightmap_remove_light(lightmap.get(), id) == TCOD_E_OK);
+          light.active = false;
+        } else {
+          // The lowest free id is reused, which might not be this one.
+          const int new_id =
+              TCOD_lightmap_add_light(lightmap.get(), light.x, light.y, light.radius, light.color, light.falloff);
+          REQUIRE(new_id >= 0);
+          REQUIRE(new_id <= id);
+          REQUIRE(!lights.at(new_id).active);
+          lights.at(new_id) = light;
+          lights.at(new_id).active = true;
+        }
+        break;
+      default: {  // Toggle some walls.
+        for (int i = 0; i < 5; ++i) {
+          const int x = random_x(rng);
+          const int y = random_y(rng);
+          const bool is_open = !TCOD_map_is_transparent(map.get(), x, y);
+          TCOD_map_set_properties(map.get(), x, y, is_open, is_open);
+          REQUIRE(TCOD_lightmap_cell_changed(lightmap.get(), x, y) == TCOD_E_OK);
+        }
+        break;
+      }
+    }
+    REQUIRE(TCOD_lightmap_update(lightmap.get()) >= 0);
+    const auto expected = reference_lightmap(*map, lights, algo);
+    const float* data = TCOD_lightmap_get_data(lightmap.get());
+    for (int i = 0; i < WIDTH * HEIGHT * 3; ++i) {
+      INFO("step=" << step << " x=" << (i / 3) % WIDTH << " y=" << (i / 3) / WIDTH);
+      REQUIRE(data[i] == Catch::Approx(expected.at(i)).margin(0.01));
+    }
+  }
+}
+
+TEST_CASE("Lightmap only recomputes affected lights", "[fov]") {
+  tcod::MapPtr_ map{TCOD_map_new(50, 20)};
+  TCOD_map_clear(map.get(), true, true);
+  LightmapPtr lightmap{TCOD_lightmap_new(map.get(), true, FOV_SHADOW)};
+  const TCOD_ColorRGB white{255, 255, 255};
+  const int left = TCOD_lightmap_add_light(lightmap.get(), 5, 10, 4, white, 20.0f);
+  const int right = TCOD_lightmap_add_light(lightmap.get(), 45, 10, 4, white, 20.0f);
+  REQUIRE(left >= 0);
+  REQUIRE(right >= 0);
+  CHECK(TCOD_lightmap_update(lightmap.get()) == 2);
+  CHECK(TCOD_lightmap_update(lightmap.get()) == 0);
+  CHECK(TCOD_lightmap_get_color(lightmap.get(), 5, 10) == white);
+  CHECK(TCOD_lightmap_get_color(lightmap.get(), 25, 10) == TCOD_ColorRGB{0, 0, 0});
+
+  TCOD_map_set_properties(map.get(), 7, 10, false, false);
+  REQUIRE(TCOD_lightmap_cell_changed(lightmap.get(), 7, 10) == TCOD_E_OK);
+  CHECK(TCOD_lightmap_update(lightmap.get()) == 1);
+  CHECK(TCOD_lightmap_get_color(lightmap.get(), 8, 10) == TCOD_ColorRGB{0, 0, 0});
+
+  REQUIRE(TCOD_lightmap_set_light(lightmap.get(), right, 40, 10, 4, white, 20.0f) == TCOD_E_OK);
+  CHECK(TCOD_lightmap_update(lightmap.get()) == 1);
+  CHECK(TCOD_lightmap_get_color(lightmap.get(), 45, 10) == TCOD_ColorRGB{0, 0, 0});
+  CHECK(TCOD_lightmap_get_color(lightmap.get(), 40, 10) == white);
+
+  CHECK(TCOD_lightmap_add_light(lightmap.get(), 0, 0, 0, white, 20.0f) == TCOD_E_INVALID_ARGUMENT);
+  CHECK(TCOD_lightmap_add_light(lightmap.get(), 0, 0, 4, white, 0.0f) == TCOD_E_INVALID_ARGUMENT);
+  CHECK(TCOD_lightmap_add_light(lightmap.get(), -1, 0, 4, white, 20.0f) == TCOD_E_INVALID_ARGUMENT);
+  CHECK(TCOD_lightmap_remove_light(lightmap.get(), 5) == TCOD_E_INVALID_ARGUMENT);
+}
@@ -0,0 +1,607 @@
+#include <array>
+#include <cmath>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.hpp>
+#include <libtcod/pathfinder.h>
+#include <libtcod/pathfinder_frontier.h>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+namespace {
+/// Return a map with 1 in `wall_chance` cells blocked.
+tcod::MapPtr_ new_random_map(int width, int height, int wall_chance, unsigned int seed) {
+  std::mt19937 rng(seed);
+  tcod::MapPtr_ map{TCOD_map_new(width, height)};
+  fill_random_map(map.get(), wall_chance, rng);
+  return map;
+}
+
+/// Random step costs for TCOD_dijkstra_new_using_function, zero marks a blocked cell.
+struct CostGrid {
+  int width;
+  std::vector<float> costs;
+};
+float cost_callback(int, int, int xTo, int yTo, void* user_data) {
+  const auto& grid = *static_cast<const CostGrid*>(user_data);
+  return grid.costs.at(xTo + yTo * grid.width);
+}
+
+/// Return Dijkstra distances in hundredths by relaxing every edge until nothing changes.
+/// `get_step` returns the integer cost of a step or -1 if it is blocked.
+template <typename StepFunc>
+std::vector<uint32_t> reference_dijkstra(
+    int width, int height, int root_x, int root_y, int diagonal_cost, StepFunc get_step) {
+  static constexpr int DX[8] = {-1, 0, 1, 0, -1, 1, 1, -1};
+  static constexpr int DY[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+  const int steps = diagonal_cost == 0 ? 4 : 8;
+  std::vector<uint32_t> distances(width * height, UINT32_MAX);
+  distances.at(root_x + root_y * width) = 0;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        const uint32_t here = distances.at(x + y * width);
+        if (here == UINT32_MAX) continue;
+        for (int i = 0; i < steps; ++i) {
+          const int tx = x + DX[i];
+          const int ty = y + DY[i];
+          if (tx < 0 || ty < 0 || tx >= width || ty >= height) continue;
+          const int64_t step = get_step(x, y, tx, ty, i < 4 ? 100 : diagonal_cost);
+          if (step < 0) continue;
+          const uint32_t dist = here + static_cast<uint32_t>(step);
+          if (dist < distances.at(tx + ty * width)) {
+            distances.at(tx + ty * width) = dist;
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+  return distances;
+}
+
+/// Check that every distance of `dijkstra` matches `expected`.
+void check_distances(TCOD_Dijkstra* dijkstra, int width, int height, const std::vector<uint32_t>& expected) {
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      INFO("x=" << x << " y=" << y);
+      const uint32_t dist = expected.at(x + y * width);
+      REQUIRE(TCOD_dijkstra_get_distance(dijkstra, x, y) == (dist == UINT32_MAX ? -1.0f : dist * 0.01f));
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("Dijkstra distances on a map", "[path]") {
+  const int WIDTH = 40;
+  const int HEIGHT = 30;
+  const float diagonal = GENERATE(0.0f, 1.0f, 1.41f, 2.5f);
+  const int diagonal_cost = static_cast<int>(diagonal * 100.0f + 0.1f);
+  tcod::MapPtr_ map = new_random_map(WIDTH, HEIGHT, 4, 1);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal)};
+  for (const auto root : {std::array<int, 2>{0, 0}, {20, 15}, {39, 29}}) {
+    INFO("diagonal=" << diagonal << " root=" << root[0] << "," << root[1]);
+    TCOD_dijkstra_compute(dijkstra.get(), root[0], root[1]);
+    const auto expected =
+        reference_dijkstra(WIDTH, HEIGHT, root[0], root[1], diagonal_cost, [&](int, int, int tx, int ty, int cost) {
+          return TCOD_map_is_walkable(map.get(), tx, ty) ? cost : -1;
+        });
+    check_distances(dijkstra.get(), WIDTH, HEIGHT, expected);
+  }
+  // Invalid roots set an error and keep the last distances.
+  for (const auto root : {std::array<int, 2>{WIDTH, 0}, {0, -1}}) {
+    TCOD_clear_error();
+    TCOD_dijkstra_compute(dijkstra.get(), root[0], root[1]);
+    CHECK(std::string(TCOD_get_error()) != "");
+    CHECK(TCOD_dijkstra_get_distance(dijkstra.get(), 39, 29) == 0.0f);
+  }
+  TCOD_clear_error();
+  TCOD_dijkstra_compute(nullptr, 0, 0);
+  CHECK(std::string(TCOD_get_error()) != "");
+}
+
+TEST_CASE("Dijkstra distances using a callback", "[path]") {
+  const int WIDTH = 40;
+  const int HEIGHT = 30;
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<float> random_cost(0.0f, 20.0f);
+  CostGrid grid{WIDTH, std::vector<float>(WIDTH * HEIGHT)};
+  for (auto& cost : grid.costs) cost = rng() % 5 == 0 ? 0.0f : random_cost(rng);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new_using_function(WIDTH, HEIGHT, cost_callback, &grid, 1.41f)};
+  for (const auto root : {std::array<int, 2>{0, 0}, {20, 15}, {39, 29}}) {
+    INFO("root=" << root[0] << "," << root[1]);
+    TCOD_dijkstra_compute(dijkstra.get(), root[0], root[1]);
+    const auto expected =
+        reference_dijkstra(WIDTH, HEIGHT, root[0], root[1], 141, [&](int, int, int tx, int ty, int dd) {
+          const float cost = grid.costs.at(tx + ty * WIDTH);
+          return cost <= 0.0f ? int64_t{-1} : static_cast<int64_t>(static_cast<unsigned int>(cost * dd));
+        });
+    check_distances(dijkstra.get(), WIDTH, HEIGHT, expected);
+  }
+}
+
+TEST_CASE("Multi-root Dijkstra matches the minimum of single roots", "[path]") {
+  const int WIDTH = 40;
+  const int HEIGHT = 30;
+  tcod::MapPtr_ map = new_random_map(WIDTH, HEIGHT, 4, 3);
+  const std::vector<TCOD_DijkstraRoot> roots{{3, 4, 0.0f}, {30, 20, 2.5f}, {15, 25, 7.0f}, {30, 20, 1.0f}};
+  std::vector<float> expected(WIDTH * HEIGHT, -1.0f);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), 1.41f)};
+  for (const auto& root : roots) {
+    TCOD_dijkstra_compute(dijkstra.get(), root.x, root.y);
+    for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+      const float dist = TCOD_dijkstra_get_distance(dijkstra.get(), i % WIDTH, i / WIDTH);
+      if (dist < 0) continue;
+      const float total = dist + root.distance;
+      if (expected.at(i) < 0 || total < expected.at(i)) expected.at(i) = total;
+    }
+  }
+  TCODMap cpp_map{WIDTH, HEIGHT};
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      cpp_map.setProperties(x, y, TCOD_map_is_transparent(map.get(), x, y), TCOD_map_is_walkable(map.get(), x, y));
+    }
+  }
+  TCODDijkstra cpp_dijkstra{&cpp_map};
+  cpp_dijkstra.compute(roots);
+  REQUIRE(TCOD_dijkstra_compute_multi(dijkstra.get(), static_cast<int>(roots.size()), roots.data()) == TCOD_E_OK);
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      INFO("x=" << x << " y=" << y);
+      REQUIRE(TCOD_dijkstra_get_distance(dijkstra.get(), x, y) == Catch::Approx(expected.at(x + y * WIDTH)));
+      REQUIRE(cpp_dijkstra.getDistance(x, y) == Catch::Approx(expected.at(x + y * WIDTH)));
+    }
+  }
+  // Paths lead downhill to a root, which is left out of the path.
+  REQUIRE(cpp_dijkstra.setPath(20, 12));
+  int end_x;
+  int end_y;
+  cpp_dijkstra.get(0, &end_x, &end_y);
+  bool next_to_root = false;
+  for (const auto& root : roots) next_to_root |= std::abs(root.x - end_x) <= 1 && std::abs(root.y - end_y) <= 1;
+  CHECK(next_to_root);
+
+  const TCOD_DijkstraRoot out_of_bounds{WIDTH, 0, 0.0f};
+  CHECK(TCOD_dijkstra_compute_multi(dijkstra.get(), 1, &out_of_bounds) == TCOD_E_INVALID_ARGUMENT);
+  const TCOD_DijkstraRoot negative{0, 0, -1.0f};
+  CHECK(TCOD_dijkstra_compute_multi(dijkstra.get(), 1, &negative) == TCOD_E_INVALID_ARGUMENT);
+  REQUIRE_THROWS(cpp_dijkstra.compute(std::vector<TCOD_DijkstraRoot>{negative}));
+  REQUIRE(TCOD_dijkstra_compute_multi(dijkstra.get(), 0, nullptr) == TCOD_E_OK);
+  CHECK(TCOD_dijkstra_get_distance(dijkstra.get(), 3, 4) == -1.0f);
+}
+
+TEST_CASE("Pathfinder with multiple roots", "[path]") {
+  const int WIDTH = 20;
+  const int HEIGHT = 10;
+  std::vector<uint8_t> cost(WIDTH * HEIGHT, 1);
+  for (int y = 0; y < HEIGHT - 1; ++y) cost.at(10 + y * WIDTH) = 0;  // A wall with a gap at the bottom.
+  std::vector<int32_t> distance(WIDTH * HEIGHT, INT32_MAX);
+  std::vector<int32_t> traversal(WIDTH * HEIGHT * 2, -1);
+  const size_t shape[] = {HEIGHT, WIDTH};
+  const size_t strides[] = {WIDTH * sizeof(uint8_t), sizeof(uint8_t)};
+  const size_t int_strides[] = {WIDTH * sizeof(int32_t), sizeof(int32_t)};
+  const size_t traversal_strides[] = {WIDTH * 2 * sizeof(int32_t), 2 * sizeof(int32_t), sizeof(int32_t)};
+  struct TCOD_Pathfinder* pf = TCOD_pf_new(2, shape);
+  REQUIRE(pf);
+  TCOD_pf_set_distance_pointer(pf, distance.data(), -4, int_strides);
+  TCOD_pf_set_graph2d_pointer(pf, cost.data(), 1, strides, 2, 3);
+  TCOD_pf_set_traversal_pointer(pf, traversal.data(), -4, traversal_strides);
+  const int left[] = {0, 0};
+  const int right[] = {0, 19};
+  const int outside[] = {0, 20};
+  REQUIRE(TCOD_pf_add_root(pf, left, 0) == 0);
+  REQUIRE(TCOD_pf_add_root(pf, right, 5) == 0);
+  CHECK(TCOD_pf_add_root(pf, outside, 0) == -1);
+  REQUIRE(TCOD_pf_compute(pf) == 0);
+  CHECK(distance.at(0) == 0);
+  CHECK(distance.at(19) == 5);
+  CHECK(distance.at(9) == 18);  // Reached from the left root.
+  CHECK(distance.at(11) == 5 + 16);  // Reached from the right root.
+  CHECK(distance.at(10) == INT32_MAX);  // Walls are never reached.
+  CHECK(distance.at(10 + (HEIGHT - 1) * WIDTH) == 3 * 9 + 2);  // The gap, reached from the left root.
+  // Traversal points back towards the root.
+  CHECK(traversal.at(1 * 2 + 0) == 0);
+  CHECK(traversal.at(1 * 2 + 1) == 0);
+  TCOD_pf_delete(pf);
+}
+
+TEST_CASE("Map region versions", "[path]") {
+  tcod::MapPtr_ map{TCOD_map_new(40, 30)};
+  CHECK(TCOD_map_get_version(map.get(), 0, 0, 40, 30) == 0);
+  TCOD_map_set_properties(map.get(), 35, 5, true, true);
+  const uint64_t version = TCOD_map_get_version(map.get(), 0, 0, 40, 30);
+  CHECK(version > 0);
+  CHECK(TCOD_map_get_version(map.get(), 32, 0, 8, 16) == version);
+  CHECK(TCOD_map_get_version(map.get(), 0, 0, TCOD_MAP_REGION_SIZE, 30) == 0);
+  CHECK(TCOD_map_get_version(map.get(), 0, 16, 40, 14) == 0);
+  CHECK(TCOD_map_get_version(map.get(), 35, 5, 0, 0) == 0);
+  TCOD_map_clear(map.get(), true, true);
+  CHECK(TCOD_map_get_version(map.get(), 0, 16, 40, 14) > version);
+}
+
+TEST_CASE("Path cache matches uncached paths", "[path]") {
+  const int WIDTH = 60;
+  const int HEIGHT = 40;
+  std::mt19937 rng(4);
+  std::uniform_int_distribution<int> random_x(0, WIDTH - 1);
+  std::uniform_int_distribution<int> random_y(0, HEIGHT - 1);
+  const auto algorithm = GENERATE(TCOD_PATH_ASTAR, TCOD_PATH_JUMP_POINT);
+  tcod::MapPtr_ map = new_random_map(WIDTH, HEIGHT, 5, 4);
+  TCOD_Path* cached_path = TCOD_path_new_using_map_ex(map.get(), 1.41f, algorithm);
+  TCOD_Path* plain_path = TCOD_path_new_using_map_ex(map.get(), 1.41f, algorithm);
+  TCOD_PathCache* cache = TCOD_path_cache_new(cached_path, 64);
+  REQUIRE(cache);
+  std::vector<std::array<int, 4>> queries;
+  for (int i = 0; i < 24; ++i) queries.push_back({random_x(rng), random_y(rng), random_x(rng), random_y(rng)});
+  for (int turn = 0; turn < 30; ++turn) {
+    for (const auto& query : queries) {
+      INFO("turn=" << turn << " query=" << query[0] << "," << query[1] << " -> " << query[2] << "," << query[3]);
+      const bool found = TCOD_path_compute(plain_path, query[0], query[1], query[2], query[3]);
+      REQUIRE(TCOD_path_cache_compute(cache, query[0], query[1], query[2], query[3]) == found);
+      REQUIRE(TCOD_path_size(cached_path) == TCOD_path_size(plain_path));
+      for (int i = 0; i < TCOD_path_size(plain_path); ++i) {
+        int plain_x, plain_y, cached_x, cached_y;
+        TCOD_path_get(plain_path, i, &plain_x, &plain_y);
+        TCOD_path_get(cached_path, i, &cached_x, &cached_y);
+        REQUIRE(std::array<int, 2>{cached_x, cached_y} == std::array<int, 2>{plain_x, plain_y});
+      }
+    }
+    // Toggle a few cells between turns.
+    for (int i = 0; i < 3; ++i) {
+      const int x = random_x(rng);
+      const int y = random_y(rng);
+      const bool is_open = !TCOD_map_is_walkable(map.get(), x, y);
+      TCOD_map_set_properties(map.get(), x, y, is_open, is_open);
+    }
+  }
+  int hits;
+  int misses;
+  TCOD_path_cache_get_stats(cache, &hits, &misses);
+  CHECK(hits + misses == 24 * 30);
+  CHECK(hits > 0);
+  CHECK(misses >= 24);
+  TCOD_path_cache_clear(cache);
+  TCOD_path_cache_compute(cache, queries[0][0], queries[0][1], queries[0][2], queries[0][3]);
+  int misses_after_clear;
+  TCOD_path_cache_get_stats(cache, nullptr, &misses_after_clear);
+  CHECK(misses_after_clear == misses + 1);
+  TCOD_path_cache_delete(cache);
+  TCOD_path_delete(cached_path);
+  TCOD_path_delete(plain_path);
+}
+
+TEST_CASE("Jump Point Search finds shortest paths", "[path]") {
+  const int WIDTH = 70;
+  const int HEIGHT = 45;
+  const bool bitpacked = GENERATE(false, true);
+  const int wall_chance = GENERATE(3, 6, 40);
+  const float diagonal_cost = GENERATE(1.0f, 1.41f, 2.0f);
+  INFO("bitpacked=" << bitpacked << " wall_chance=" << wall_chance << " diagonal_cost=" << diagonal_cost);
+  std::mt19937 rng(wall_chance);
+  tcod::MapPtr_ map{bitpacked ? TCOD_map_new_bitpacked(WIDTH, HEIGHT) : TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_map(map.get(), wall_chance, rng);
+  TCOD_Path* path = TCOD_path_new_using_map_ex(map.get(), diagonal_cost, TCOD_PATH_JUMP_POINT);
+  REQUIRE(path);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal_cost)};
+  std::uniform_int_distribution<int> random_x(0, WIDTH - 1);
+  std::uniform_int_distribution<int> random_y(0, HEIGHT - 1);
+  for (int i = 0; i < 10; ++i) {
+    const int ox = random_x(rng);
+    const int oy = random_y(rng);
+    TCOD_map_set_properties(map.get(), ox, oy, true, true);
+    TCOD_dijkstra_compute(dijkstra.get(), ox, oy);
+    for (int j = 0; j < 20; ++j) {
+      const int dx = random_x(rng);
+      const int dy = random_y(rng);
+      INFO("origin=" << ox << "," << oy << " destination=" << dx << "," << dy);
+      const float expected = TCOD_dijkstra_get_distance(dijkstra.get(), dx, dy);
+      const bool found = TCOD_path_compute(path, ox, oy, dx, dy);
+      REQUIRE(found == (expected >= 0));
+      if (!found || (ox == dx && oy == dy)) continue;
+      const float cost =
+          check_path_steps(path, TCOD_path_size, TCOD_path_get, map.get(), ox, oy, dx, dy, diagonal_cost);
+      REQUIRE(cost == Catch::Approx(expected).margin(0.01));
+    }
+  }
+  TCOD_path_delete(path);
+}
+
+TEST_CASE("Jump Point Search fallbacks", "[path]") {
+  tcod::MapPtr_ map = new_random_map(20, 20, 4, 1);
+  TCOD_map_set_properties(map.get(), 1, 1, true, true);
+  TCOD_map_set_properties(map.get(), 18, 18, true, true);
+  TCOD_Path* astar = TCOD_path_new_using_map(map.get(), 0.0f);
+  TCOD_Path* jps = TCOD_path_new_using_map_ex(map.get(), 0.0f, TCOD_PATH_JUMP_POINT);  // Falls back to A*.
+  const bool found = TCOD_path_compute(astar, 1, 1, 18, 18);
+  REQUIRE(TCOD_path_compute(jps, 1, 1, 18, 18) == found);
+  REQUIRE(TCOD_path_size(jps) == TCOD_path_size(astar));
+  TCOD_path_delete(astar);
+  TCOD_path_delete(jps);
+  CHECK(TCOD_path_new_using_map_ex(map.get(), 1.41f, static_cast<TCOD_PathAlgorithm>(99)) == nullptr);
+  CHECK(TCOD_path_new_using_map_ex(nullptr, 1.41f, TCOD_PATH_JUMP_POINT) == nullptr);
+}
+
+TEST_CASE("Shared path workspace", "[path]") {
+  struct WorkspaceDeleter {
+    void operator()(TCOD_PathWorkspace* workspace) const { TCOD_path_workspace_delete(workspace); }
+  };
+  std::unique_ptr<TCOD_PathWorkspace, WorkspaceDeleter> workspace{TCOD_path_workspace_new()};
+  REQUIRE(workspace);
+  tcod::MapPtr_ small_map = new_random_map(30, 20, 4, 5);
+  tcod::MapPtr_ large_map = new_random_map(80, 60, 4, 6);
+  std::mt19937 rng(5);
+  for (const auto algorithm : {TCOD_PATH_ASTAR, TCOD_PATH_JUMP_POINT}) {
+    std::vector<TCOD_Path*> shared;
+    std::vector<TCOD_Path*> alone;
+    for (TCOD_Map* map : {small_map.get(), large_map.get(), small_map.get()}) {
+      shared.push_back(TCOD_path_new_using_map_ex(map, 1.41f, algorithm));
+      alone.push_back(TCOD_path_new_using_map_ex(map, 1.41f, algorithm));
+      TCOD_path_set_workspace(shared.back(), workspace.get());
+    }
+    // Interleave searches so that every search starts on grids left over from another one.
+    for (int i = 0; i < 60; ++i) {
+      const size_t index = rng() % shared.size();
+      const int width = index == 1 ? 80 : 30;
+      const int height = index == 1 ? 60 : 20;
+      const std::array<int, 4> query{
+          static_cast<int>(rng() % width),
+          static_cast<int>(rng() % height),
+          static_cast<int>(rng() % width),
+          static_cast<int>(rng() % height)};
+      INFO("i=" << i << " index=" << index);
+      const bool found = TCOD_path_compute(alone.at(index), query[0], query[1], query[2], query[3]);
+      REQUIRE(TCOD_path_compute(shared.at(index), query[0], query[1], query[2], query[3]) == found);
+      REQUIRE(TCOD_path_size(shared.at(index)) == TCOD_path_size(alone.at(index)));
+      for (int k = 0; k < TCOD_path_size(alone.at(index)); ++k) {
+        int alone_x, alone_y, shared_x, shared_y;
+        TCOD_path_get(alone.at(index), k, &alone_x, &alone_y);
+        TCOD_path_get(shared.at(index), k, &shared_x, &shared_y);
+        REQUIRE(std::array<int, 2>{shared_x, shared_y} == std::array<int, 2>{alone_x, alone_y});
+      }
+    }
+    // Going back to private grids.
+    TCOD_path_set_workspace(shared.at(1), nullptr);
+    REQUIRE(TCOD_path_compute(shared.at(1), 0, 0, 79, 59) == TCOD_path_compute(alone.at(1), 0, 0, 79, 59));
+    CHECK(TCOD_path_size(shared.at(1)) == TCOD_path_size(alone.at(1)));
+    for (auto* path : shared) TCOD_path_delete(path);
+    for (auto* path : alone) TCOD_path_delete(path);
+  }
+
+  DijkstraPtr shared_dijkstra{TCOD_dijkstra_new(large_map.get(), 1.41f)};
+  DijkstraPtr alone_dijkstra{TCOD_dijkstra_new(large_map.get(), 1.41f)};
+  TCOD_dijkstra_set_workspace(shared_dijkstra.get(), workspace.get());
+  for (const auto& root : {std::array<int, 2>{3, 3}, {70, 50}}) {
+    TCOD_dijkstra_compute(shared_dijkstra.get(), root[0], root[1]);
+    TCOD_dijkstra_compute(alone_dijkstra.get(), root[0], root[1]);
+    for (int y = 0; y < 60; ++y) {
+      for (int x = 0; x < 80; ++x) {
+        REQUIRE(
+            TCOD_dijkstra_get_distance(shared_dijkstra.get(), x, y) ==
+            TCOD_dijkstra_get_distance(alone_dijkstra.get(), x, y));
+      }
+    }
+  }
+}
+
+TEST_CASE("Batched paths match sequential paths", "[path]") {
+  const int WIDTH = 90;
+  const int HEIGHT = 60;
+  const auto algorithm = GENERATE(TCOD_PATH_ASTAR, TCOD_PATH_JUMP_POINT);
+  tcod::MapPtr_ map = new_random_map(WIDTH, HEIGHT, 4, 7);
+  std::mt19937 rng(7);
+  std::vector<TCOD_PathQuery> queries;
+  for (int i = 0; i < 100; ++i) {
+    const int ox = static_cast<int>(rng() % WIDTH);
+    const int oy = static_cast<int>(rng() % HEIGHT);
+    queries.push_back({ox, oy, i % 10 == 0 ? ox : static_cast<int>(rng() % WIDTH), static_cast<int>(rng() % HEIGHT)});
+  }
+  // Zero workspaces allocates temporary ones, otherwise the same workspaces are reused by every batch.
+  const int n_workspaces = GENERATE(0, 1, 3);
+  INFO("n_workspaces=" << n_workspaces);
+  std::vector<TCOD_PathWorkspace*> workspaces;
+  for (int i = 0; i < n_workspaces; ++i) workspaces.push_back(TCOD_path_workspace_new());
+  std::vector<TCOD_PathRoute> routes(queries.size());
+  TCOD_Path* path = TCOD_path_new_using_map_ex(map.get(), 1.41f, algorithm);
+  for (int batch = 0; batch < 2; ++batch) {
+    REQUIRE(
+        TCOD_path_compute_batch(
+            map.get(),
+            1.41f,
+            algorithm,
+            static_cast<int>(queries.size()),
+            queries.data(),
+            routes.data(),
+            n_workspaces,
+            workspaces.data()) == TCOD_E_OK);
+    for (size_t i = 0; i < queries.size(); ++i) {
+      const TCOD_PathQuery& query = queries[i];
+      INFO("query=" << query.ox << "," << query.oy << " -> " << query.dx << "," << query.dy);
+      const bool found = TCOD_path_compute(path, query.ox, query.oy, query.dx, query.dy);
+      REQUIRE(routes[i].length == (found ? TCOD_path_size(path) : -1));
+      for (int k = 0; k < routes[i].length; ++k) {
+        int x, y;
+        TCOD_path_get(path, k, &x, &y);
+        REQUIRE(std::array<int, 2>{routes[i].xy[k * 2], routes[i].xy[k * 2 + 1]} == std::array<int, 2>{x, y});
+      }
+      TCOD_path_route_clear(&routes[i]);
+      CHECK(routes[i].length == -1);
+    }
+  }
+  TCOD_path_delete(path);
+  const TCOD_PathQuery bad_query{0, 0, WIDTH, 0};
+  CHECK(TCOD_path_compute_batch(map.get(), 1.41f, algorithm, 1, &bad_query, routes.data(), 0, nullptr) < 0);
+  CHECK(TCOD_path_compute_batch(map.get(), 1.41f, algorithm, 1, queries.data(), routes.data(), 1, nullptr) < 0);
+  for (TCOD_PathWorkspace* workspace : workspaces) TCOD_path_workspace_delete(workspace);
+}
+
+TEST_CASE("Frontier pops nodes in priority order", "[path]") {
+  struct FrontierDeleter {
+    void operator()(TCOD_Frontier* frontier) const { TCOD_frontier_delete(frontier); }
+  };
+  std::unique_ptr<TCOD_Frontier, FrontierDeleter> frontier{TCOD_frontier_new(2)};
+  REQUIRE(frontier);
+  // With buckets, small steps stay in the bucket queue and a large step forces the heap.
+  const bool use_buckets = GENERATE(false, true);
+  const int max_step = GENERATE(3, 1000, 100000);
+  INFO("use_buckets=" << use_buckets << " max_step=" << max_step);
+  REQUIRE(TCOD_frontier_use_buckets(frontier.get(), use_buckets) == TCOD_E_OK);
+  std::mt19937 rng(max_step);
+  std::multiset<std::array<int, 3>> expected;  // {priority, x, y} of every queued node.
+  int last_popped = 0;
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 2000; ++i) {
+      if (expected.empty() || rng() % 3 != 0) {
+        // Like Dijkstra, push nodes a short distance past the last one popped.
+        const int priority = last_popped + static_cast<int>(rng() % (max_step + 1));
+        const int index[2] = {i, static_cast<int>(rng() % 100)};
+        REQUIRE(TCOD_frontier_push(frontier.get(), index, priority, priority) == TCOD_E_OK);
+        expected.insert({priority, index[0], index[1]});
+      } else {
+        REQUIRE(TCOD_frontier_pop(frontier.get()) == TCOD_E_OK);
+        const std::array<int, 3> popped{
+            frontier->active_dist, frontier->active_index[0], frontier->active_index[1]};
+        REQUIRE(popped[0] == (*expected.begin())[0]);
+        REQUIRE(expected.count(popped) > 0);
+        expected.erase(expected.find(popped));
+        last_popped = popped[0];
+      }
+      REQUIRE(TCOD_frontier_size(frontier.get()) == static_cast<int>(expected.size()));
+      // Without buckets every node is in the heap, as code reading the heap directly expects.
+      if (!use_buckets) REQUIRE(frontier->heap.size == static_cast<int>(expected.size()));
+    }
+    // Pushing below the lowest priority is also allowed.
+    const int low_index[2] = {-1, -1};
+    REQUIRE(TCOD_frontier_push(frontier.get(), low_index, last_popped - 5, last_popped - 5) == TCOD_E_OK);
+    REQUIRE(TCOD_frontier_pop(frontier.get()) == TCOD_E_OK);
+    CHECK(frontier->active_dist == last_popped - 5);
+    if (!expected.empty()) CHECK(TCOD_frontier_use_buckets(frontier.get(), !use_buckets) < 0);
+    REQUIRE(TCOD_frontier_clear(frontier.get()) == TCOD_E_OK);
+    CHECK(TCOD_frontier_size(frontier.get()) == 0);
+    CHECK(TCOD_frontier_pop(frontier.get()) < 0);
+    expected.clear();
+    last_popped = -50;
+  }
+}
+
+TEST_CASE("Cost grids match cost callbacks", "[path]") {
+  const int WIDTH = 40;
+  const int HEIGHT = 30;
+  const auto type = GENERATE(TCOD_PATH_COST_UINT8, TCOD_PATH_COST_UINT16, TCOD_PATH_COST_FLOAT);
+  INFO("type=" << type);
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> random_cost(0.5f, 20.0f);
+  CostGrid grid{WIDTH, std::vector<float>(WIDTH * HEIGHT)};
+  for (auto& cost : grid.costs) {
+    cost = rng() % 5 == 0 ? 0.0f : type == TCOD_PATH_COST_FLOAT ? random_cost(rng) : static_cast<float>(rng() % 20);
+  }
+  // Store the costs in column-major order to test the strides.
+  const size_t type_size = type == TCOD_PATH_COST_UINT8 ? 1 : type == TCOD_PATH_COST_UINT16 ? 2 : 4;
+  std::vector<unsigned char> data(WIDTH * HEIGHT * type_size);
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      const float cost = grid.costs.at(x + y * WIDTH);
+      unsigned char* out = &data.at((x * HEIGHT + y) * type_size);
+      if (type == TCOD_PATH_COST_UINT8) *out = static_cast<uint8_t>(cost);
+      if (type == TCOD_PATH_COST_UINT16) *reinterpret_cast<uint16_t*>(out) = static_cast<uint16_t>(cost);
+      if (type == TCOD_PATH_COST_FLOAT) *reinterpret_cast<float*>(out) = cost;
+    }
+  }
+  const auto stride_x = static_cast<ptrdiff_t>(HEIGHT * type_size);
+  const auto stride_y = static_cast<ptrdiff_t>(type_size);
+  const TCOD_PathCostGrid costs{data.data(), type, WIDTH, HEIGHT, stride_x, stride_y, nullptr};
+
+  DijkstraPtr grid_dijkstra{TCOD_dijkstra_new_using_costs(&costs, 1.41f)};
+  DijkstraPtr func_dijkstra{TCOD_dijkstra_new_using_function(WIDTH, HEIGHT, cost_callback, &grid, 1.41f)};
+  REQUIRE(grid_dijkstra);
+  TCOD_Path* grid_path = TCOD_path_new_using_costs(&costs, 1.41f);
+  TCOD_Path* func_path = TCOD_path_new_using_function(WIDTH, HEIGHT, cost_callback, &grid, 1.41f);
+  REQUIRE(grid_path);
+  for (const auto root : {std::array<int, 2>{0, 0}, {20, 15}, {39, 29}}) {
+    INFO("root=" << root[0] << "," << root[1]);
+    TCOD_dijkstra_compute(grid_dijkstra.get(), root[0], root[1]);
+    TCOD_dijkstra_compute(func_dijkstra.get(), root[0], root[1]);
+    for (int y = 0; y < HEIGHT; ++y) {
+      for (int x = 0; x < WIDTH; ++x) {
+        REQUIRE(
+            TCOD_dijkstra_get_distance(grid_dijkstra.get(), x, y) ==
+            TCOD_dijkstra_get_distance(func_dijkstra.get(), x, y));
+      }
+    }
+    for (const auto dest : {std::array<int, 2>{39, 0}, {5, 25}, {30, 20}}) {
+      INFO("dest=" << dest[0] << "," << dest[1]);
+      const bool found = TCOD_path_compute(grid_path, root[0], root[1], dest[0], dest[1]);
+      REQUIRE(found == TCOD_path_compute(func_path, root[0], root[1], dest[0], dest[1]));
+      REQUIRE(TCOD_path_size(grid_path) == TCOD_path_size(func_path));
+      for (int i = 0; i < TCOD_path_size(grid_path); ++i) {
+        std::array<int, 2> grid_xy;
+        std::array<int, 2> func_xy;
+        TCOD_path_get(grid_path, i, &grid_xy[0], &grid_xy[1]);
+        TCOD_path_get(func_path, i, &func_xy[0], &func_xy[1]);
+        REQUIRE(grid_xy == func_xy);
+      }
+    }
+  }
+  TCOD_path_delete(grid_path);
+  TCOD_path_delete(func_path);
+
+  // A heuristic grid holding the straight-line distances must give the same paths as the default heuristic.
+  std::vector<float> heuristic(WIDTH * HEIGHT);
+  TCOD_PathCostGrid guided_costs = costs;
+  guided_costs.heuristic = heuristic.data();
+  TCOD_Path* guided_path = TCOD_path_new_using_costs(&guided_costs, 1.41f);
+  grid_path = TCOD_path_new_using_costs(&costs, 1.41f);
+  for (const auto dest : {std::array<int, 2>{39, 0}, {5, 25}, {30, 20}}) {
+    INFO("dest=" << dest[0] << "," << dest[1]);
+    for (int y = 0; y < HEIGHT; ++y) {
+      for (int x = 0; x < WIDTH; ++x) {
+        const int dx = x - dest[0];
+        const int dy = y - dest[1];
+        heuristic.at(x + y * WIDTH) = static_cast<float>(std::sqrt(dx * dx + dy * dy));
+      }
+    }
+    const bool found = TCOD_path_compute(guided_path, 2, 3, dest[0], dest[1]);
+    REQUIRE(found == TCOD_path_compute(grid_path, 2, 3, dest[0], dest[1]));
+    REQUIRE(TCOD_path_size(guided_path) == TCOD_path_size(grid_path));
+    for (int i = 0; i < TCOD_path_size(guided_path); ++i) {
+      std::array<int, 2> guided_xy;
+      std::array<int, 2> grid_xy;
+      TCOD_path_get(guided_path, i, &guided_xy[0], &guided_xy[1]);
+      TCOD_path_get(grid_path, i, &grid_xy[0], &grid_xy[1]);
+      REQUIRE(guided_xy == grid_xy);
+    }
+  }
+  TCOD_path_delete(guided_path);
+  TCOD_path_delete(grid_path);
+
+  TCOD_PathCostGrid bad_costs = costs;
+  bad_costs.width = 0;
+  CHECK(TCOD_path_new_using_costs(&bad_costs, 1.41f) == nullptr);
+  CHECK(TCOD_dijkstra_new_using_costs(nullptr, 1.41f) == nullptr);
+}
+
+TEST_CASE("Dijkstra distances saturate instead of wrapping", "[path]") {
+  // Each step costs 6553500 hundredths, so the distances pass the maximum after 656 steps.
+  const int WIDTH = 1000;
+  const std::vector<uint16_t> data(WIDTH, UINT16_MAX);
+  const TCOD_PathCostGrid costs{data.data(), TCOD_PATH_COST_UINT16, WIDTH, 1, 0, 0, nullptr};
+  DijkstraPtr dijkstra{TCOD_dijkstra_new_using_costs(&costs, 1.41f)};
+  REQUIRE(dijkstra);
+  TCOD_dijkstra_compute(dijkstra.get(), 0, 0);
+  CHECK(TCOD_dijkstra_get_distance(dijkstra.get(), 1, 0) == Catch::Approx(65535.0f));
+  float previous = 0.0f;
+  for (int x = 1; x < WIDTH; ++x) {
+    INFO("x=" << x);
+    const float distance = TCOD_dijkstra_get_distance(dijkstra.get(), x, 0);
+    REQUIRE(distance >= previous);
+    previous = distance;
+  }
+  CHECK(previous == 0xFFFFFFFEu * 0.01f);
+}
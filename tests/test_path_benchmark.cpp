@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.h>
+#include <libtcod/pathfinder.h>
+#include <libtcod/pathfinder_frontier.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_allocations.hpp"
+#include "benchmark_maps.hpp"
+#include "common.hpp"
+
+/*
+    Pathfinding benchmarks and golden results.
+
+    The benchmarks are hidden by the [.benchmark] tag, run them with: benchmark "[.benchmark][path]"
+    They can also be run from unittest, but heap allocations are only counted by the benchmark executable.
+
+    "Pathfinding benchmarks" uses Catch2 BENCHMARK for tracking regressions.
+    "Pathfinding report" prints a table of nodes expanded, time, and peak heap usage per query.
+
+    "Pathfinding golden results" checks that the paths found on every benchmark map are the same as those saved in
+    data/golden/pathfinding.txt, so that optimizations can't silently change results.
+    Run it with the TCOD_UPDATE_GOLDEN environment variable set to rewrite that file after an intended change.
+*/
+
+namespace {
+/// Pathfinders which are benchmarked.
+enum class PathAlgorithm { AStar, Dijkstra, Pathfinder };
+const std::vector<std::pair<PathAlgorithm, std::string>> BENCHMARK_ALGORITHMS{
+    {PathAlgorithm::AStar, "TCOD_path"},
+    {PathAlgorithm::Dijkstra, "TCOD_dijkstra"},
+    {PathAlgorithm::Pathfinder, "TCOD_pf"},
+};
+/// The diagonal cost used by every pathfinder, in hundredths where needed.
+constexpr float DIAGONAL_COST = 1.41f;
+constexpr int CARDINAL_COST_INT = 100;
+constexpr int DIAGONAL_COST_INT = 141;
+
+/// A named test map with the paths which will be computed on it.
+struct PathBenchmarkMap {
+  std::string name;
+  tcod::MapPtr_ map;
+  std::vector<std::array<int, 4>> queries;  // {ox, oy, dx, dy}
+};
+
+/// Return pairs of open cells spread over `map`.
+std::vector<std::array<int, 4>> pick_queries(TCOD_Map& map) {
+  std::vector<std::pair<int, int>> open;
+  for (int y = 0; y < TCOD_map_get_height(&map); ++y) {
+    for (int x = 0; x < TCOD_map_get_width(&map); ++x) {
+      if (TCOD_map_is_walkable(&map, x, y)) open.emplace_back(x, y);
+    }
+  }
+  std::mt19937 rng(0);
+  shuffle_items(open, rng);
+  std::vector<std::array<int, 4>> queries;
+  for (size_t i = 0; i + 1 < open.size() && queries.size() < 16; i += 2) {
+    queries.push_back({open[i].first, open[i].second, open[i + 1].first, open[i + 1].second});
+  }
+  return queries;
+}
+
+/// Return every benchmark map of the given sizes.
+std::vector<PathBenchmarkMap> new_path_benchmark_maps(const std::vector<std::pair<int, int>>& sizes) {
+  std::vector<PathBenchmarkMap> maps;
+  for (const auto& size : sizes) {
+    const std::string suffix = " " + std::to_string(size.first) + "x" + std::to_string(size.second);
+    maps.push_back({"maze" + suffix, new_maze_map(size.first, size.second), {}});
+    maps.push_back({"cave" + suffix, new_cave_map(size.first, size.second), {}});
+    maps.push_back({"open" + suffix, new_open_map(size.first, size.second), {}});
+    maps.push_back({"bsp" + suffix, new_bsp_map(size.first, size.second), {}});
+  }
+  for (auto& it : maps) it.queries = pick_queries(*it.map);
+  return maps;
+}
+
+/// Return the golden result of one query, the number of steps and the cost in hundredths, or "-" if there is no path.
+std::string format_result(int steps, long cost) {
+  if (steps < 0) return "-";
+  return std::to_string(steps) + "/" + std::to_string(cost);
+}
+
+/// A path callback which counts how many cells a search expanded, each expansion calls it with a new origin.
+struct ExpansionCounter {
+  TCOD_Map* map;
+  int last_x = -1;
+  int last_y = -1;
+  long expanded = 0;
+};
+float counting_walk_cost(int xFrom, int yFrom, int xTo, int yTo, void* user_data) {
+  auto& counter = *static_cast<ExpansionCounter*>(user_data);
+  if (xFrom != counter.last_x || yFrom != counter.last_y) {
+    ++counter.expanded;
+    counter.last_x = xFrom;
+    counter.last_y = yFrom;
+  }
+  return TCOD_map_is_walkable(counter.map, xTo, yTo) ? 1.0f : 0.0f;
+}
+
+/// Run A* over every query.  With a counter this uses an equivalent callback so that expanded cells can be counted.
+std::vector<std::string> run_astar(const PathBenchmarkMap& test_map, ExpansionCounter* counter) {
+  TCOD_Map* map = test_map.map.get();
+  const int width = TCOD_map_get_width(map);
+  const int height = TCOD_map_get_height(map);
+  TCOD_Path* path = counter ? TCOD_path_new_using_function(width, height, counting_walk_cost, counter, DIAGONAL_COST)
+                            : TCOD_path_new_using_map(map, DIAGONAL_COST);
+  std::vector<std::string> results;
+  for (const auto& query : test_map.queries) {
+    if (counter) counter->last_x = counter->last_y = -1;
+    if (!TCOD_path_compute(path, query[0], query[1], query[2], query[3])) {
+      results.push_back(format_result(-1, 0));
+      continue;
+    }
+    long cost = 0;
+    int x = query[0];
+    int y = query[1];
+    for (int i = 0; i < TCOD_path_size(path); ++i) {
+      int next_x, next_y;
+      TCOD_path_get(path, i, &next_x, &next_y);
+      cost += (next_x != x && next_y != y) ? DIAGONAL_COST_INT : CARDINAL_COST_INT;
+      x = next_x;
+      y = next_y;
+    }
+    results.push_back(format_result(TCOD_path_size(path), cost));
+  }
+  TCOD_path_delete(path);
+  return results;
+}
+
+/// Run Dijkstra from the origin of every query.  A counter works the same as in run_astar.
+std::vector<std::string> run_dijkstra(const PathBenchmarkMap& test_map, ExpansionCounter* counter) {
+  TCOD_Map* map = test_map.map.get();
+  const int width = TCOD_map_get_width(map);
+  const int height = TCOD_map_get_height(map);
+  TCOD_Dijkstra* dijkstra =
+      counter ? TCOD_dijkstra_new_using_function(width, height, counting_walk_cost, counter, DIAGONAL_COST)
+              : TCOD_dijkstra_new(map, DIAGONAL_COST);
+  std::vector<std::string> results;
+  for (const auto& query : test_map.queries) {
+    if (counter) counter->last_x = counter->last_y = -1;
+    TCOD_dijkstra_compute(dijkstra, query[0], query[1]);
+    const float distance = TCOD_dijkstra_get_distance(dijkstra, query[2], query[3]);
+    if (distance < 0.0f || !TCOD_dijkstra_path_set(dijkstra, query[2], query[3])) {
+      results.push_back(format_result(-1, 0));
+      continue;
+    }
+    results.push_back(format_result(TCOD_dijkstra_size(dijkstra), std::lround(distance * 100.0f)));
+  }
+  TCOD_dijkstra_delete(dijkstra);
+  return results;
+}
+
+/// Run TCOD_pf from the origin of every query.  If `expanded` isn't NULL then expanded cells are added to it.
+std::vector<std::string> run_pf(const PathBenchmarkMap& test_map, long* expanded) {
+  TCOD_Map* map = test_map.map.get();
+  const int width = TCOD_map_get_width(map);
+  const int height = TCOD_map_get_height(map);
+  std::vector<uint8_t> cost(width * height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) cost[x + y * width] = TCOD_map_is_walkable(map, x, y) ? 1 : 0;
+  }
+  std::vector<int32_t> distance(width * height);
+  std::vector<int32_t> traversal(width * height * 2);
+  const size_t shape[] = {static_cast<size_t>(height), static_cast<size_t>(width)};
+  const size_t strides[] = {width * sizeof(uint8_t), sizeof(uint8_t)};
+  const size_t int_strides[] = {width * sizeof(int32_t), sizeof(int32_t)};
+  const size_t traversal_strides[] = {width * 2 * sizeof(int32_t), 2 * sizeof(int32_t), sizeof(int32_t)};
+  struct TCOD_Pathfinder* pf = TCOD_pf_new(2, shape);
+  TCOD_pf_set_distance_pointer(pf, distance.data(), -4, int_strides);
+  TCOD_pf_set_graph2d_pointer(pf, cost.data(), 1, strides, CARDINAL_COST_INT, DIAGONAL_COST_INT);
+  TCOD_pf_set_traversal_pointer(pf, traversal.data(), -4, traversal_strides);
+  std::vector<std::string> results;
+  for (const auto& query : test_map.queries) {
+    std::fill(distance.begin(), distance.end(), INT32_MAX);
+    const int root[] = {query[1], query[0]};
+    TCOD_pf_add_root(pf, root, 0);
+    if (expanded) {
+      while (TCOD_frontier_size(pf->frontier)) {
+        TCOD_pf_compute_step(pf);
+        const int* index = pf->frontier->active_index;
+        if (distance[index[0] * width + index[1]] == pf->frontier->active_dist) ++*expanded;  // Not a stale node.
+      }
+    } else {
+      TCOD_pf_compute(pf);
+    }
+    const int dest = query[3] * width + query[2];
+    if (distance[dest] == INT32_MAX) {
+      results.push_back(format_result(-1, 0));
+      continue;
+    }
+    // Follow the traversal back to the root.
+    int steps = 0;
+    for (int i = dest; i != query[1] * width + query[0] && steps <= width * height; ++steps) {
+      i = traversal[i * 2] * width + traversal[i * 2 + 1];
+    }
+    results.push_back(format_result(steps, distance[dest]));
+  }
+  TCOD_pf_delete(pf);
+  return results;
+}
+
+/// Run `algorithm` over every query of `test_map`.  If `expanded` isn't NULL then expanded cells are added to it.
+std::vector<std::string> run_path_algorithm(
+    PathAlgorithm algorithm, const PathBenchmarkMap& test_map, long* expanded = nullptr) {
+  ExpansionCounter counter{test_map.map.get()};
+  std::vector<std::string> results;
+  switch (algorithm) {
+    case PathAlgorithm::AStar:
+      results = run_astar(test_map, expanded ? &counter : nullptr);
+      break;
+    case PathAlgorithm::Dijkstra:
+      results = run_dijkstra(test_map, expanded ? &counter : nullptr);
+      break;
+    case PathAlgorithm::Pathfinder:
+      return run_pf(test_map, expanded);
+  }
+  if (expanded) *expanded += counter.expanded;
+  return results;
+}
+
+/// Return the golden line of one algorithm on one map.
+std::string golden_line(const PathBenchmarkMap& test_map, const std::string& algorithm_name,
+                        const std::vector<std::string>& results) {
+  std::string line = test_map.name + " " + algorithm_name + ":";
+  for (const auto& result : results) line += " " + result;
+  return line;
+}
+}  // namespace
+
+TEST_CASE("Pathfinding benchmarks", "[.benchmark][path]") {
+  const auto maps = new_path_benchmark_maps({{80, 50}, {256, 256}});
+  for (const auto& test_map : maps) {
+    for (const auto& algorithm : BENCHMARK_ALGORITHMS) {
+      BENCHMARK(test_map.name + " " + algorithm.second) { return run_path_algorithm(algorithm.first, test_map); };
+    }
+  }
+}
+
+TEST_CASE("Pathfinding report", "[.benchmark][path]") {
+  using Clock = std::chrono::steady_clock;
+  const auto MIN_DURATION = std::chrono::milliseconds(100);
+  const auto maps = new_path_benchmark_maps({{80, 50}, {256, 256}, {512, 512}});
+  std::printf("%-14s %-14s %14s %14s %14s\n", "map", "algorithm", "expanded/query", "usec/query", "peak KiB");
+  for (const auto& test_map : maps) {
+    for (const auto& algorithm : BENCHMARK_ALGORITHMS) {
+      const auto queries = static_cast<long>(test_map.queries.size());
+      long expanded = 0;
+      const auto counted_results = run_path_algorithm(algorithm.first, test_map, &expanded);
+      // Measure the heap used by a whole run, including the pathfinder itself.
+      const long long bytes_start = get_allocated_bytes();
+      reset_peak_allocated_bytes();
+      REQUIRE(run_path_algorithm(algorithm.first, test_map) == counted_results);
+      const long long peak_bytes = get_peak_allocated_bytes() - bytes_start;
+      long runs = 0;
+      const auto time_start = Clock::now();
+      auto elapsed = Clock::duration{};
+      while (elapsed < MIN_DURATION) {
+        run_path_algorithm(algorithm.first, test_map);
+        ++runs;
+        elapsed = Clock::now() - time_start;
+      }
+      const double usec = std::chrono::duration<double, std::micro>(elapsed).count() / (runs * queries);
+      const std::string peak = bytes_start >= 0 ? std::to_string((peak_bytes + 1023) / 1024) : "n/a";
+      std::printf(
+          "%-14s %-14s %14ld %14.1f %14s\n",
+          test_map.name.c_str(),
+          algorithm.second.c_str(),
+          expanded / queries,
+          usec,
+          peak.c_str());
+    }
+  }
+}
+
+TEST_CASE("Pathfinding golden results", "[path]") {
+  const auto maps = new_path_benchmark_maps({{80, 50}, {256, 256}});
+  std::vector<std::string> lines;
+  for (const auto& test_map : maps) {
+    for (const auto& algorithm : BENCHMARK_ALGORITHMS) {
+      lines.push_back(golden_line(test_map, algorithm.second, run_path_algorithm(algorithm.first, test_map)));
+    }
+  }
+  const std::string golden_path = get_file("golden/pathfinding.txt");
+  KNOWN_DEPRECATION const char* update_golden = std::getenv("TCOD_UPDATE_GOLDEN");  // Ignore MSVC warning.
+  if (update_golden) {
+    std::ofstream file{golden_path};
+    REQUIRE(file);
+    for (const auto& line : lines) file << line << '\n';
+    WARN("Updated " << golden_path);
+    return;
+  }
+  std::ifstream file{golden_path};
+  INFO("Missing " << golden_path << ", set TCOD_UPDATE_GOLDEN to create it.");
+  REQUIRE(file);
+  std::vector<std::string> expected;
+  for (std::string line; std::getline(file, line);) {
+    if (!line.empty()) expected.push_back(line);
+  }
+  REQUIRE(expected.size() == lines.size());
+  for (size_t i = 0; i < lines.size(); ++i) CHECK(lines[i] == expected[i]);
+}
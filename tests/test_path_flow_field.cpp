@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.h>
+#include <random>
+
+#include "common.hpp"
+
+namespace {
+/// Check that the distances of `flow` match a Dijkstra map from the goal and that every direction is a shortest step.
+void check_flow_field(TCOD_FlowField* flow, TCOD_Map* map, int goal_x, int goal_y, float diagonal) {
+  const int width = TCOD_map_get_width(map);
+  const int height = TCOD_map_get_height(map);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map, diagonal)};
+  TCOD_dijkstra_compute(dijkstra.get(), goal_x, goal_y);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      INFO("x=" << x << " y=" << y);
+      const float distance = TCOD_flow_field_get_distance(flow, x, y);
+      REQUIRE(distance == TCOD_dijkstra_get_distance(dijkstra.get(), x, y));
+      int dx;
+      int dy;
+      const bool has_step = TCOD_flow_field_get_direction(flow, x, y, &dx, &dy);
+      REQUIRE(has_step == (distance > 0.0f));
+      if (!has_step) {
+        REQUIRE(std::array<int, 2>{dx, dy} == std::array<int, 2>{0, 0});
+        continue;
+      }
+      REQUIRE(TCOD_map_is_walkable(map, x + dx, y + dy) | (x + dx == goal_x && y + dy == goal_y));
+      const float step = (dx != 0 && dy != 0) ? diagonal : 1.0f;
+      REQUIRE(TCOD_flow_field_get_distance(flow, x + dx, y + dy) + step == Catch::Approx(distance).margin(0.005));
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("Flow fields match Dijkstra maps through a changing map", "[path]") {
+  const int WIDTH = 83;
+  const int HEIGHT = 61;
+  const int wall_chance = GENERATE(3, 5);
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  INFO("wall_chance=" << wall_chance << " diagonal=" << diagonal);
+  std::mt19937 rng(wall_chance);
+  std::uniform_int_distribution<int> random_x(0, WIDTH - 1);
+  std::uniform_int_distribution<int> random_y(0, HEIGHT - 1);
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_map(map.get(), wall_chance, rng);
+  FlowFieldPtr flow{TCOD_flow_field_new(map.get(), diagonal, 2)};
+  REQUIRE(flow);
+  const std::array<std::array<int, 2>, 2> goals{{{random_x(rng), random_y(rng)}, {random_x(rng), random_y(rng)}}};
+  RepairStats stats;
+  for (int turn = 0; turn < 30; ++turn) {
+    for (const auto& goal : goals) {
+      INFO("turn=" << turn << " goal=" << goal[0] << "," << goal[1]);
+      REQUIRE(TCOD_flow_field_compute(flow.get(), goal[0], goal[1]) == TCOD_E_OK);
+      stats.add(turn > 0, TCOD_flow_field_get_expanded(flow.get()));
+      check_flow_field(flow.get(), map.get(), goal[0], goal[1], diagonal);
+      // Both goals are cached, nothing changed since the last call.
+      REQUIRE(TCOD_flow_field_compute(flow.get(), goal[0], goal[1]) == TCOD_E_OK);
+      CHECK(TCOD_flow_field_get_expanded(flow.get()) == 0);
+    }
+    // Toggle a few cells inside one small area, including the goals on some turns.
+    const int area_x = random_x(rng);
+    const int area_y = random_y(rng);
+    for (int i = 0; i < 6; ++i) {
+      const int cx = std::clamp(area_x + random_x(rng) % 7 - 3, 0, WIDTH - 1);
+      const int cy = std::clamp(area_y + random_y(rng) % 7 - 3, 0, HEIGHT - 1);
+      const bool is_open = !TCOD_map_is_walkable(map.get(), cx, cy);
+      TCOD_map_set_properties(map.get(), cx, cy, is_open, is_open);
+    }
+    if (turn % 10 == 5) TCOD_map_set_properties(map.get(), goals[0][0], goals[0][1], false, false);
+  }
+  stats.check_repairs_are_cheaper();
+}
+
+TEST_CASE("Flow fields evict the least recently used goal while the map changes", "[path]") {
+  const int WIDTH = 60;
+  const int HEIGHT = 40;
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  INFO("diagonal=" << diagonal);
+  std::mt19937 rng(11);
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_map(map.get(), 5, rng);
+  const std::array<std::array<int, 2>, 4> goals{{{2, 2}, {57, 3}, {30, 37}, {5, 35}}};
+  for (const auto& goal : goals) TCOD_map_set_properties(map.get(), goal[0], goal[1], true, true);
+  FlowFieldPtr flow{TCOD_flow_field_new(map.get(), diagonal, 3)};
+  REQUIRE(flow);
+  // Compute and check the field of a goal, returning the number of cells it expanded.
+  const auto compute = [&](int goal) {
+    INFO("goal=" << goal);
+    REQUIRE(TCOD_flow_field_compute(flow.get(), goals[goal][0], goals[goal][1]) == TCOD_E_OK);
+    check_flow_field(flow.get(), map.get(), goals[goal][0], goals[goal][1], diagonal);
+    return TCOD_flow_field_get_expanded(flow.get());
+  };
+  // Return the number of cells which can reach a goal, a field computed from scratch expands each of them once.
+  const auto reachable = [&](int goal) {
+    DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal)};
+    TCOD_dijkstra_compute(dijkstra.get(), goals[goal][0], goals[goal][1]);
+    int count = 0;
+    for (int y = 0; y < HEIGHT; ++y) {
+      for (int x = 0; x < WIDTH; ++x) count += TCOD_dijkstra_get_distance(dijkstra.get(), x, y) >= 0;
+    }
+    return count;
+  };
+  // Toggle a few cells in the middle of the map, away from the goals.
+  const auto change_map = [&]() {
+    for (int i = 0; i < 8; ++i) {
+      const int x = WIDTH / 2 - 4 + static_cast<int>(rng() % 9);
+      const int y = HEIGHT / 2 - 4 + static_cast<int>(rng() % 9);
+      const bool is_open = !TCOD_map_is_walkable(map.get(), x, y);
+      TCOD_map_set_properties(map.get(), x, y, is_open, is_open);
+    }
+  };
+  CHECK(TCOD_flow_field_get_distance(flow.get(), 2, 2) == -1.0f);  // No goal yet.
+  for (int goal = 0; goal < 3; ++goal) CHECK(compute(goal) == reachable(goal));
+  change_map();
+  CHECK(compute(0) < reachable(0));  // Cached and repaired, goal 1 is now the least recently used.
+  change_map();
+  CHECK(compute(3) == reachable(3));  // Replaces goal 1.
+  CHECK(compute(2) < reachable(2));  // Still cached, repaired for both changes at once.
+  CHECK(compute(1) == reachable(1));  // Computed from scratch on the changed map, replacing goal 0.
+  CHECK(compute(3) == 0);  // Nothing changed since it was computed.
+  change_map();
+  CHECK(compute(0) == reachable(0));  // Replaces goal 2.
+  CHECK(compute(1) < reachable(1));
+  CHECK(compute(3) < reachable(3));
+  // A failed call keeps the cached goals but doesn't select any of them.
+  CHECK(TCOD_flow_field_compute(flow.get(), WIDTH, 0) == TCOD_E_INVALID_ARGUMENT);
+  CHECK(!TCOD_flow_field_get_direction(flow.get(), 1, 1, nullptr, nullptr));
+  CHECK(compute(0) < reachable(0));
+  CHECK(!TCOD_flow_field_new(map.get(), diagonal, 0));
+}
@@ -0,0 +1,161 @@
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.h>
+#include <random>
+
+#include "common.hpp"
+
+namespace {
+/// Compute a path and check it against a Dijkstra map of `map`, returns true if a path was found.
+bool check_query(TCOD_HierarchicalPath* path, TCOD_Map* map, float diagonal, int ox, int oy, int dx, int dy) {
+  INFO("from " << ox << "," << oy << " to " << dx << "," << dy << " diagonal=" << diagonal);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map, diagonal)};
+  TCOD_dijkstra_compute(dijkstra.get(), ox, oy);
+  const float best = TCOD_dijkstra_get_distance(dijkstra.get(), dx, dy);
+  const bool found = TCOD_hierarchical_path_compute(path, ox, oy, dx, dy);
+  REQUIRE(found == (best >= 0));
+  if (found) {
+    const float cost =
+        check_path_steps(path, TCOD_hierarchical_path_size, TCOD_hierarchical_path_get, map, ox, oy, dx, dy, diagonal);
+    CHECK(cost >= best - 0.05f);
+    CHECK(cost <= best * 1.5f + 2.0f);
+  }
+  return found;
+}
+/// Return true if the last path computed by `path` steps on `{x, y}`.
+bool path_visits(const TCOD_HierarchicalPath* path, int x, int y) {
+  for (int i = 0; i < TCOD_hierarchical_path_size(path); ++i) {
+    int step_x;
+    int step_y;
+    TCOD_hierarchical_path_get(path, i, &step_x, &step_y);
+    if (step_x == x && step_y == y) return true;
+  }
+  return false;
+}
+}  // namespace
+
+TEST_CASE("Hierarchical paths match the connectivity of Dijkstra maps", "[path]") {
+  const int WIDTH = 97;  // Not a multiple of the sector size.
+  const int HEIGHT = 71;
+  const int wall_chance = GENERATE(3, 4, 8);
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  const int sector_size = GENERATE(8, 16);
+  INFO("wall_chance=" << wall_chance << " diagonal=" << diagonal << " sector_size=" << sector_size);
+  std::mt19937 rng(wall_chance);
+  std::uniform_int_distribution<int> random_x(0, WIDTH - 1);
+  std::uniform_int_distribution<int> random_y(0, HEIGHT - 1);
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_map(map.get(), wall_chance, rng);
+  HierarchicalPathPtr path{TCOD_hierarchical_path_new(map.get(), sector_size, diagonal)};
+  REQUIRE(path);
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal)};
+  for (int query = 0; query < 60; ++query) {
+    const int ox = random_x(rng);
+    const int oy = random_y(rng);
+    const int dx = random_x(rng);
+    const int dy = random_y(rng);
+    INFO("query=" << query << " from " << ox << "," << oy << " to " << dx << "," << dy);
+    TCOD_dijkstra_compute(dijkstra.get(), ox, oy);
+    const float best = TCOD_dijkstra_get_distance(dijkstra.get(), dx, dy);
+    const bool found = TCOD_hierarchical_path_compute(path.get(), ox, oy, dx, dy);
+    REQUIRE(found == (best >= 0));
+    if (found) {
+      const float cost = check_path_steps(
+          path.get(), TCOD_hierarchical_path_size, TCOD_hierarchical_path_get, map.get(), ox, oy, dx, dy, diagonal);
+      CHECK(TCOD_hierarchical_path_get_cost(path.get()) == Catch::Approx(cost).margin(0.05));
+      CHECK(cost >= best - 0.05f);
+      CHECK(cost <= best * 1.5f + 2.0f);  // Near-optimal.
+    } else {
+      CHECK(TCOD_hierarchical_path_size(path.get()) == 0);
+    }
+    // Toggle some cells, sectors are rebuilt by the next query.
+    for (int i = 0; i < 5; ++i) {
+      const int x = random_x(rng);
+      const int y = random_y(rng);
+      const bool is_open = !TCOD_map_is_walkable(map.get(), x, y);
+      TCOD_map_set_properties(map.get(), x, y, is_open, is_open);
+    }
+  }
+}
+
+TEST_CASE("Hierarchical paths cross sector seams through single gaps", "[path]") {
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  tcod::MapPtr_ map{TCOD_map_new(24, 24)};
+  TCOD_map_clear(map.get(), true, true);
+  // Walls along the first column of the second and third sector columns, each with one gap next to a sector row seam.
+  for (int y = 0; y < 24; ++y) {
+    TCOD_map_set_properties(map.get(), 8, y, y == 15, y == 15);
+    TCOD_map_set_properties(map.get(), 16, y, y == 8, y == 8);
+  }
+  HierarchicalPathPtr path{TCOD_hierarchical_path_new(map.get(), 8, diagonal)};
+  REQUIRE(path);
+  REQUIRE(check_query(path.get(), map.get(), diagonal, 0, 23, 23, 23));
+  CHECK(path_visits(path.get(), 8, 15));
+  CHECK(path_visits(path.get(), 16, 8));
+  REQUIRE(check_query(path.get(), map.get(), diagonal, 23, 0, 0, 0));
+  CHECK(path_visits(path.get(), 16, 8));
+  CHECK(path_visits(path.get(), 8, 15));
+  // Moving a gap along a seam rebuilds the sectors on both sides of it, even though only one side changed.
+  TCOD_map_set_properties(map.get(), 16, 8, false, false);
+  CHECK(!check_query(path.get(), map.get(), diagonal, 0, 23, 23, 23));
+  TCOD_map_set_properties(map.get(), 16, 12, true, true);
+  REQUIRE(check_query(path.get(), map.get(), diagonal, 0, 23, 23, 23));
+  CHECK(path_visits(path.get(), 16, 12));
+}
+
+TEST_CASE("Hierarchical paths squeeze diagonally between sectors", "[path]") {
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  INFO("diagonal=" << diagonal);
+  SECTION("Through the corner where four sectors meet") {
+    tcod::MapPtr_ map{TCOD_map_new(16, 16)};
+    for (int y = 0; y < 16; ++y) {
+      for (int x = 0; x < 16; ++x) {
+        const bool is_open = (x < 8) == (y < 8);
+        TCOD_map_set_properties(map.get(), x, y, is_open, is_open);
+      }
+    }
+    HierarchicalPathPtr path{TCOD_hierarchical_path_new(map.get(), 8, diagonal)};
+    REQUIRE(path);
+    REQUIRE(check_query(path.get(), map.get(), diagonal, 0, 0, 15, 15) == (diagonal != 0));
+    if (diagonal != 0) {
+      CHECK(path_visits(path.get(), 7, 7));
+      CHECK(path_visits(path.get(), 8, 8));
+    }
+  }
+  SECTION("Between two walls along a sector side") {
+    tcod::MapPtr_ map{TCOD_map_new(16, 8)};
+    TCOD_map_clear(map.get(), true, true);
+    for (int y = 0; y < 8; ++y) {
+      TCOD_map_set_properties(map.get(), 7, y, y == 3, y == 3);
+      TCOD_map_set_properties(map.get(), 8, y, y == 4, y == 4);
+    }
+    HierarchicalPathPtr path{TCOD_hierarchical_path_new(map.get(), 8, diagonal)};
+    REQUIRE(path);
+    REQUIRE(check_query(path.get(), map.get(), diagonal, 0, 0, 15, 7) == (diagonal != 0));
+    if (diagonal != 0) {
+      CHECK(path_visits(path.get(), 7, 3));
+      CHECK(path_visits(path.get(), 8, 4));
+    }
+    // Closing the far side of the squeeze must drop the entrance of the near side.
+    TCOD_map_set_properties(map.get(), 8, 4, false, false);
+    CHECK(!check_query(path.get(), map.get(), diagonal, 0, 0, 15, 7));
+    TCOD_map_set_properties(map.get(), 8, 3, true, true);
+    REQUIRE(check_query(path.get(), map.get(), diagonal, 0, 0, 15, 7));
+    CHECK(path_visits(path.get(), 8, 3));
+  }
+}
+
+TEST_CASE("Hierarchical path sector sizes", "[path]") {
+  tcod::MapPtr_ map{TCOD_map_new(40, 20)};
+  TCOD_map_clear(map.get(), true, true);
+  CHECK(!TCOD_hierarchical_path_new(map.get(), 3, 1.41f));
+  CHECK(!TCOD_hierarchical_path_new(map.get(), 129, 1.41f));
+  for (const int sector_size : {4, 40, 128}) {
+    INFO("sector_size=" << sector_size);
+    HierarchicalPathPtr path{TCOD_hierarchical_path_new(map.get(), sector_size, 1.41f)};
+    REQUIRE(path);
+    REQUIRE(check_query(path.get(), map.get(), 1.41f, 0, 10, 39, 10));
+    CHECK(TCOD_hierarchical_path_size(path.get()) == 39);
+  }
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <libtcod/fov.hpp>
+#include <libtcod/path.h>
+#include <random>
+
+#include "common.hpp"
+
+TEST_CASE("Incremental paths stay shortest while walking through a changing map", "[path]") {
+  const int WIDTH = 83;
+  const int HEIGHT = 61;
+  const int wall_chance = GENERATE(3, 5);
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  INFO("wall_chance=" << wall_chance << " diagonal=" << diagonal);
+  std::mt19937 rng(wall_chance);
+  std::uniform_int_distribution<int> random_x(0, WIDTH - 1);
+  std::uniform_int_distribution<int> random_y(0, HEIGHT - 1);
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_map(map.get(), wall_chance, rng);
+  IncrementalPathPtr path{TCOD_incremental_path_new(map.get(), diagonal)};
+  REQUIRE(path);
+  RepairStats stats;
+  for (int trip = 0; trip < 8; ++trip) {
+    int x = random_x(rng);
+    int y = random_y(rng);
+    const int dx = random_x(rng);
+    const int dy = random_y(rng);
+    TCOD_map_set_properties(map.get(), x, y, true, true);  // So that distances from the destination are the same.
+    TCOD_map_set_properties(map.get(), dx, dy, true, true);
+    for (int turn = 0; turn < 40; ++turn) {
+      INFO("trip=" << trip << " turn=" << turn << " from " << x << "," << y << " to " << dx << "," << dy);
+      // Dijkstra maps are computed from the destination since the map isn't changed during a turn.
+      DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal)};
+      TCOD_dijkstra_compute(dijkstra.get(), dx, dy);
+      const float best = TCOD_dijkstra_get_distance(dijkstra.get(), x, y);
+      const bool found = TCOD_incremental_path_compute(path.get(), x, y, dx, dy);
+      REQUIRE(found == (best >= 0));
+      stats.add(turn > 0, TCOD_incremental_path_get_expanded(path.get()));
+      if (!found) break;
+      const float cost = check_path_steps(
+          path.get(), TCOD_incremental_path_size, TCOD_incremental_path_get, map.get(), x, y, dx, dy, diagonal);
+      REQUIRE(cost == Catch::Approx(best).margin(0.05));
+      CHECK(TCOD_incremental_path_get_cost(path.get()) == Catch::Approx(cost).margin(0.05));
+      if (!TCOD_incremental_path_walk(path.get(), &x, &y)) break;  // Reached the destination.
+      // Block and open cells around the walker, the next call repairs the search.
+      for (int i = 0; i < 4; ++i) {
+        const int cx = std::clamp(x + random_x(rng) % 9 - 4, 0, WIDTH - 1);
+        const int cy = std::clamp(y + random_y(rng) % 9 - 4, 0, HEIGHT - 1);
+        if ((cx == x && cy == y) || (cx == dx && cy == dy)) continue;
+        const bool is_open = !TCOD_map_is_walkable(map.get(), cx, cy);
+        TCOD_map_set_properties(map.get(), cx, cy, is_open, is_open);
+      }
+    }
+  }
+  stats.check_repairs_are_cheaper();
+}
+
+TEST_CASE("Incremental paths keep their keys valid over long walks", "[path]") {
+  const int WIDTH = 150;
+  const int HEIGHT = 21;
+  const float diagonal = GENERATE(0.0f, 1.41f);
+  INFO("diagonal=" << diagonal);
+  std::mt19937 rng(7);
+  tcod::MapPtr_ map{TCOD_map_new(WIDTH, HEIGHT)};
+  fill_random_map(map.get(), 6, rng);
+  for (int x = 0; x < WIDTH; ++x) TCOD_map_set_properties(map.get(), x, HEIGHT / 2, true, true);
+  const int goal_x = WIDTH - 1;
+  const int goal_y = HEIGHT / 2;
+  IncrementalPathPtr path{TCOD_incremental_path_new(map.get(), diagonal)};
+  REQUIRE(path);
+  int x = 0;
+  int y = HEIGHT / 2;
+  REQUIRE(TCOD_incremental_path_compute(path.get(), x, y, goal_x, goal_y));
+  int repairs = 0;
+  for (;;) {
+    // Walk far from where the queued keys were computed, nothing changes so the search isn't touched.
+    for (int i = 0; i < 12 && TCOD_incremental_path_walk(path.get(), &x, &y); ++i) {
+    }
+    if (TCOD_incremental_path_size(path.get()) < 3) break;
+    // Block the path just ahead, the repair has to account for every step walked since the search started.
+    int block_x;
+    int block_y;
+    TCOD_incremental_path_get(path.get(), 1, &block_x, &block_y);
+    TCOD_map_set_properties(map.get(), block_x, block_y, false, false);
+    INFO("repair=" << repairs << " at " << x << "," << y << " blocking " << block_x << "," << block_y);
+    DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal)};
+    TCOD_dijkstra_compute(dijkstra.get(), goal_x, goal_y);
+    const float best = TCOD_dijkstra_get_distance(dijkstra.get(), x, y);
+    REQUIRE(best >= 0);
+    REQUIRE(TCOD_incremental_path_compute(path.get(), x, y, goal_x, goal_y));
+    const float cost = check_path_steps(
+        path.get(), TCOD_incremental_path_size, TCOD_incremental_path_get, map.get(), x, y, goal_x, goal_y, diagonal);
+    REQUIRE(cost == Catch::Approx(best).margin(0.05));
+    // A new search from the same position does the work which the repair reused.
+    IncrementalPathPtr fresh{TCOD_incremental_path_new(map.get(), diagonal)};
+    REQUIRE(TCOD_incremental_path_compute(fresh.get(), x, y, goal_x, goal_y));
+    CHECK(TCOD_incremental_path_get_expanded(path.get()) < TCOD_incremental_path_get_expanded(fresh.get()));
+    ++repairs;
+  }
+  CHECK(repairs >= 8);
+  while (TCOD_incremental_path_walk(path.get(), &x, &y)) {
+  }
+  CHECK(std::array<int, 2>{x, y} == std::array<int, 2>{goal_x, goal_y});
+  // Jumping back to the far end moves the origin against the walk, the old keys must still order the queue.
+  DijkstraPtr dijkstra{TCOD_dijkstra_new(map.get(), diagonal)};
+  TCOD_dijkstra_compute(dijkstra.get(), goal_x, goal_y);
+  REQUIRE(TCOD_incremental_path_compute(path.get(), 0, HEIGHT / 2, goal_x, goal_y));
+  const float cost = check_path_steps(
+      path.get(), TCOD_incremental_path_size, TCOD_incremental_path_get, map.get(), 0, HEIGHT / 2, goal_x, goal_y,
+      diagonal);
+  CHECK(cost == Catch::Approx(TCOD_dijkstra_get_distance(dijkstra.get(), 0, HEIGHT / 2)).margin(0.05));
+}